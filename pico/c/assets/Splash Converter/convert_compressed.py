@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+Convert images to the compressed formats decoded by drivers/st7789_lcd.c.
+
+Images (splash screens) become RGB565 run-length data for lcd_draw_rle_image():
+    control byte c, then
+      c & 0x80:  one pixel repeated (c & 0x7F) + 1 times
+      otherwise: c + 1 literal pixels
+    Pixels are 2 bytes, little-endian (native framebuffer order).
+
+Icons become span masks for lcd_draw_icon_mask(): the colors are dropped
+(the firmware recolors icons anyway) and each row is stored as
+    span count, then (x start, length) byte pairs for every opaque run.
+
+Inputs:
+    .png            alpha < 128 is transparent (icons)
+    .bin            raw big-endian RGB565, needs width and height (splash)
+    .h              an old uncompressed RGB565 header, 0xFFFF is transparent
+
+Usage:
+    python3 convert_compressed.py image <input> <output.h> <name> [width height]
+    python3 convert_compressed.py icon  <input> <output.h> <name>
+
+Example:
+    python3 convert_compressed.py image ../img/splash_320x240.bin ../img/splash_data.h splash 320 240
+    python3 convert_compressed.py icon wifi24.png ../img/wifi_icon.h wifi_icon
+"""
+
+import os
+import re
+import struct
+import sys
+
+TRANSPARENT = 0xFFFF
+MAX_RUN = 128
+
+
+def rgb888_to_rgb565(r, g, b):
+    r5 = (r >> 3) & 0x1F
+    g6 = (g >> 2) & 0x3F
+    b5 = (b >> 3) & 0x1F
+    return (r5 << 11) | (g6 << 5) | b5
+
+
+def load_pixels(path, width=None, height=None):
+    """Return (width, height, pixels) with transparent pixels set to 0xFFFF"""
+    ext = os.path.splitext(path)[1].lower()
+
+    if ext == '.bin':
+        data = open(path, 'rb').read()
+        if width is None or height is None or len(data) != width * height * 2:
+            sys.exit(f"{path}: expected {width}x{height} big-endian RGB565")
+        return width, height, list(struct.unpack(f'>{width * height}H', data))
+
+    if ext == '.h':
+        text = open(path).read()
+        w = re.search(r'#define\s+\w+_WIDTH\s+(\d+)', text)
+        h = re.search(r'#define\s+\w+_HEIGHT\s+(\d+)', text)
+        body = re.search(r'uint16_t\s+\w+\[\d*\]\s*=\s*\{(.*?)\}', text, re.S)
+        if not (w and h and body):
+            sys.exit(f"{path}: not an RGB565 array header")
+        values = re.sub(r'//[^\n]*', '', body.group(1))
+        pixels = [int(v, 16) for v in re.findall(r'0x[0-9A-Fa-f]+', values)]
+        width, height = int(w.group(1)), int(h.group(1))
+        # Some old headers are short (rows missing); C zero-filled them, which
+        # drew as solid bars, so treat the missing pixels as transparent
+        return width, height, pixels + [TRANSPARENT] * (width * height - len(pixels))
+
+    from PIL import Image
+    img = Image.open(path).convert('RGBA')
+    if width and height and img.size != (width, height):
+        img = img.resize((width, height), Image.Resampling.LANCZOS)
+    w, h = img.size
+    pixels = []
+    for r, g, b, a in img.getdata():
+        pixels.append(TRANSPARENT if a < 128 else rgb888_to_rgb565(r, g, b))
+    return w, h, pixels
+
+
+def encode_rle(pixels):
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        if literal:
+            out.append(len(literal) - 1)
+            for p in literal:
+                out.extend(struct.pack('<H', p))
+            literal.clear()
+
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and pixels[i + run] == pixels[i] and run < MAX_RUN:
+            run += 1
+        if run >= 2:
+            flush_literal()
+            out.append(0x80 | (run - 1))
+            out.extend(struct.pack('<H', pixels[i]))
+        else:
+            literal.append(pixels[i])
+            if len(literal) == MAX_RUN:
+                flush_literal()
+        i += run
+    flush_literal()
+    return out
+
+
+def encode_spans(width, height, pixels):
+    out = bytearray()
+    for y in range(height):
+        row = pixels[y * width:(y + 1) * width]
+        spans = []
+        x = 0
+        while x < width:
+            if row[x] == TRANSPARENT:
+                x += 1
+                continue
+            start = x
+            while x < width and row[x] != TRANSPARENT:
+                x += 1
+            spans.append((start, x - start))
+        out.append(len(spans))
+        for start, length in spans:
+            out.extend((start, length))
+    return out
+
+
+def write_header(path, name, suffix, comment, data, width, height):
+    guard = f"{name.upper()}_H"
+    with open(path, 'w') as f:
+        f.write(f"// {comment}\n")
+        f.write(f"// Generated by assets/Splash Converter/convert_compressed.py\n")
+        f.write(f"#ifndef {guard}\n")
+        f.write(f"#define {guard}\n\n")
+        f.write(f"#include <stdint.h>\n\n")
+        f.write(f"#define {name.upper()}_WIDTH {width}\n")
+        f.write(f"#define {name.upper()}_HEIGHT {height}\n")
+        f.write(f"#define {name.upper()}_LEN {len(data)}\n\n")
+        f.write(f"static const uint8_t {name}_{suffix}[{len(data)}] = {{\n")
+        for i in range(0, len(data), 16):
+            chunk = ', '.join(f"0x{b:02X}" for b in data[i:i + 16])
+            f.write(f"    {chunk},\n")
+        f.write("};\n\n")
+        f.write(f"#endif\n")
+
+
+def convert_image(src, dst, name, width=None, height=None):
+    w, h, pixels = load_pixels(src, width, height)
+    data = encode_rle(pixels)
+    write_header(dst, name, "rle", f"{w}x{h} RGB565 image, run-length encoded", data, w, h)
+    print(f"✅ {src} -> {dst}: {w * h * 2} -> {len(data)} bytes")
+
+
+def convert_icon(src, dst, name):
+    w, h, pixels = load_pixels(src)
+    if w > 255:
+        sys.exit(f"{src}: icons must be at most 255 pixels wide")
+    data = encode_spans(w, h, pixels)
+    write_header(dst, name, "mask", f"{w}x{h} icon mask, opaque spans per row", data, w, h)
+    print(f"✅ {src} -> {dst}: {w * h * 2} -> {len(data)} bytes")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) >= 5 and sys.argv[1] == 'image':
+        size = [int(v) for v in sys.argv[5:7]] if len(sys.argv) >= 7 else [None, None]
+        convert_image(sys.argv[2], sys.argv[3], sys.argv[4], *size)
+    elif len(sys.argv) == 5 and sys.argv[1] == 'icon':
+        convert_icon(sys.argv[2], sys.argv[3], sys.argv[4])
+    else:
+        print(__doc__)
+        sys.exit(1)
@@ -1,48 +1,20 @@
-// 24x24 RGB565 icon
+// 24x24 icon mask, opaque spans per row
+// Generated by assets/Splash Converter/convert_compressed.py
 #ifndef GPS_ICON_H
 #define GPS_ICON_H
 
 #include <stdint.h>
 
-const uint16_t gps_icon_data[576] = {
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0x2D8A, 0x358A, 0x2D6A, 0x2D6A, 0x358A, 0x358A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x35AA, 0x35CB, 0x358A, 0x2D6A, 0x2D6A, 0x358A, 0x35CB, 0x35AA, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x35AA, 
-    0x358A, 0x2D6A, 0x35CA, 0x35CA, 0x35CA, 0x35CA, 0x2D6A, 0x358A, 0x35AA, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x2D6A, 0x35AA, 0x2D6A, 0x358A, 0x2D8A, 0xFFFF, 0xFFFF, 0x2D6A, 0x35AA, 0x2D6A, 
-    0x35AA, 0x2D6A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x35CA, 0x2D6A, 
-    0x35AA, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x35AA, 0x2D6A, 0x35CA, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x2D6A, 0x35CA, 0x358A, 0x2D6A, 0xFFFF, 0xFFFF, 0x35AA, 0x35AA, 0xFFFF, 0xFFFF, 0x2D6A, 
-    0x358A, 0x35CA, 0x2D6A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x2D6A, 0x35AA, 0x35CA, 
-    0x2D6A, 0xFFFF, 0x2D6A, 0x35AA, 0x35AA, 0x2D6A, 0xFFFF, 0x2D6A, 0x35CA, 0x35AA, 0x2D6A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x2D69, 0x35CA, 0x35AA, 0x2D69, 0xFFFF, 0x2D49, 0x360B, 0x35EB, 0x2D6A, 0xFFFF, 0x2D6A, 
-    0x35AA, 0x35CA, 0x2D6A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x35CA, 0x2D6A, 
-    0x35AA, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x35AA, 0x2D6A, 0x35CA, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x2D6A, 0x35AA, 0x2D8A, 0x358A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x358A, 0x2D8A, 
-    0x35AA, 0x2D6A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x35CA, 
-    0x2D6A, 0x358A, 0x35CA, 0x2D6A, 0x2D6A, 0x35CA, 0x358A, 0x2D6A, 0x35CA, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x2D69, 0x35EB, 0x2D6A, 0x2D6A, 0x358A, 0x358A, 0x2D6A, 0x2D6A, 0x35EB, 
-    0x2D4A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0x2D6A, 0x35AA, 0x2D6A, 0x2D6A, 0x2D6A, 0x2D6A, 0x35AA, 0x2D8A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x35AA, 0x2D8A, 0x2D6A, 0x2D6A, 0x2D8A, 0x35AA, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0x35EB, 0x2D6A, 0x2D6A, 0x35EB, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x2D6A, 0x35AA, 0x35AA, 0x2D6A, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0x2D8A, 0x2D8A, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 
-    0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF
-};
-
 #define GPS_ICON_WIDTH 24
 #define GPS_ICON_HEIGHT 24
+#define GPS_ICON_LEN 78
+
+static const uint8_t gps_icon_mask[78] = {
+    0x00, 0x00, 0x00, 0x01, 0x09, 0x06, 0x01, 0x08, 0x08, 0x01, 0x07, 0x0A, 0x02, 0x06, 0x05, 0x0D,
+    0x05, 0x02, 0x06, 0x03, 0x0F, 0x03, 0x03, 0x05, 0x04, 0x0B, 0x02, 0x0F, 0x04, 0x03, 0x05, 0x04,
+    0x0A, 0x04, 0x0F, 0x04, 0x03, 0x05, 0x04, 0x0A, 0x04, 0x0F, 0x04, 0x02, 0x06, 0x03, 0x0F, 0x03,
+    0x02, 0x06, 0x04, 0x0E, 0x04, 0x01, 0x07, 0x0A, 0x01, 0x07, 0x0A, 0x01, 0x08, 0x08, 0x01, 0x09,
+    0x06, 0x01, 0x0A, 0x04, 0x01, 0x0A, 0x04, 0x01, 0x0B, 0x02, 0x00, 0x00, 0x00, 0x00,
+};
+
 #endif
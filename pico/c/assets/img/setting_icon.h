@@ -1,3 +1,5 @@
+// 24x24 icon mask, opaque spans per row
+// Generated by assets/Splash Converter/convert_compressed.py
 #ifndef SETTINGS_ICON_H
 #define SETTINGS_ICON_H
 
@@ -5,46 +7,20 @@
 
 #define SETTINGS_ICON_WIDTH 24
 #define SETTINGS_ICON_HEIGHT 24
-
-// 0xFFFF = transparent
-// 0x0000 = icon color (same as your Bluetooth)
-
-const uint16_t settings_icon_data[576] = {
-    // Row 0–3 (padding)
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,
-
-    // Upper gear teeth
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,
-    0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,
-
-    // Upper ring
-    0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,
-    0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,
-
-    // Middle (circle with hole)
-    0xFFFF,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0xFFFF,
-    0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,
-
-    // Center hub
-    0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0xFFFF,0x0000,0x0000,0x0000,0xFFFF,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,
-    0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0xFFFF,0x0000,0x0000,0x0000,0xFFFF,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,
-
-    // Lower ring
-    0xFFFF,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0xFFFF,
-    0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,
-
-    // Bottom teeth
-    0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,
-    0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,
-
-    // Bottom padding
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0x0000,0x0000,0x0000,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,
-    0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF,0xFFFF
+#define SETTINGS_ICON_LEN 166
+
+static const uint8_t settings_icon_mask[166] = {
+    0x00, 0x00, 0x02, 0x08, 0x03, 0x0D, 0x03, 0x01, 0x05, 0x0E, 0x03, 0x04, 0x02, 0x08, 0x08, 0x12,
+    0x02, 0x04, 0x03, 0x02, 0x07, 0x02, 0x0F, 0x02, 0x13, 0x02, 0x04, 0x02, 0x02, 0x06, 0x02, 0x10,
+    0x02, 0x14, 0x02, 0x05, 0x01, 0x02, 0x05, 0x02, 0x09, 0x06, 0x11, 0x02, 0x15, 0x02, 0x06, 0x01,
+    0x01, 0x04, 0x02, 0x08, 0x02, 0x0E, 0x02, 0x12, 0x02, 0x16, 0x01, 0x06, 0x00, 0x02, 0x04, 0x02,
+    0x08, 0x01, 0x0F, 0x01, 0x12, 0x02, 0x16, 0x02, 0x07, 0x00, 0x02, 0x04, 0x02, 0x08, 0x01, 0x0A,
+    0x03, 0x0E, 0x01, 0x11, 0x02, 0x15, 0x03, 0x08, 0x00, 0x01, 0x03, 0x02, 0x07, 0x01, 0x09, 0x03,
+    0x0D, 0x01, 0x10, 0x02, 0x14, 0x02, 0x17, 0x01, 0x06, 0x02, 0x02, 0x06, 0x02, 0x0C, 0x02, 0x10,
+    0x02, 0x14, 0x01, 0x17, 0x01, 0x05, 0x00, 0x01, 0x03, 0x02, 0x07, 0x06, 0x0F, 0x02, 0x13, 0x02,
+    0x04, 0x00, 0x02, 0x04, 0x02, 0x0E, 0x02, 0x12, 0x02, 0x04, 0x01, 0x02, 0x05, 0x02, 0x0D, 0x02,
+    0x11, 0x02, 0x03, 0x02, 0x02, 0x06, 0x08, 0x10, 0x02, 0x01, 0x03, 0x0E, 0x02, 0x06, 0x03, 0x0B,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -4,16 +4,41 @@
 
 #include "ahrs_core.h"
 #include "icm20948_sensor.h"
-#include "madgwick_filter.h"
+#include "attitude_estimator.h"
+#include "notch_filter.h"
+#include "mag_calibration.h"
+#include "profiler.h"
+#include "imu_stream.h"
+#include "boot_timeline.h"
 #include "pico/stdlib.h"
 #include "pico/multicore.h"
 #include "pico/mutex.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
 
 #define D2R (M_PI / 180.0f)
 
+// Vibration notch bank: nominal rate until the loop rate has been measured
+#define NOTCH_NOMINAL_RATE_HZ   1000.0f
+#define NOTCH_GYRO_MIN_LEVEL    0.05f    // (deg/s)^2 in-band before tracking
+#define NOTCH_ACCEL_MIN_LEVEL   1e-5f    // g^2 in-band before tracking
+
+// Reject magnetometer samples whose corrected field deviates this much (fraction)
+// from the calibrated field strength (nearby iron, motors, radios)
+#define MAG_FIELD_TOLERANCE     0.3f
+
+// Start-up gyro/accel bias calibration
+#define CAL_SAMPLES             150
+#define CAL_PERIOD_US           889     // Gyro ODR, 1.125 kHz
+
+// Samples buffered while Core 1 has flash busy (a sector erase can take
+// 400 ms worst case, so this covers it at 1 kHz)
+#define FLASH_BACKLOG_LEN       512
+#define FLASH_WINDOW_TIMEOUT_US 50000   // Core 0 parks within one iteration
+
 // Shared attitude data (protected by mutex)
 static AHRSAttitude shared_attitude = {0};
 static mutex_t attitude_mutex;
@@ -22,6 +47,27 @@ static mutex_t attitude_mutex;
 static volatile bool ahrs_running = false;
 static volatile bool ahrs_stop_requested = false;
 
+// Magnetometer correction and calibration envelope (protected by attitude_mutex)
+static MagCalibration mag_cal;
+static MagCalCollector mag_collector;
+static volatile bool mag_cal_active = false;
+static volatile bool mag_cal_changed = false;
+
+// Flash window handshake: Core 1 requests, Core 0 parks in RAM and acknowledges
+static volatile bool flash_window_requested = false;
+static volatile bool flash_window_open = false;
+
+// Sensor samples taken while parked, processed once the window closes
+typedef struct {
+    SensorData accel, gyro, mag;
+    bool mag_fresh;
+    uint32_t t_us;          // time_us_32() at the read
+} BufferedSample;
+
+static BufferedSample backlog[FLASH_BACKLOG_LEN];
+static uint32_t backlog_len = 0;    // Samples captured (Core 0 only)
+static uint32_t backlog_pos = 0;    // Samples processed
+
 // Core 0 entry point (AHRS processing loop)
 static void ahrs_core0_entry(void);
 
@@ -40,22 +86,20 @@ void ahrs_core_start(void) {
     memset(&shared_attitude, 0, sizeof(shared_attitude));
     mutex_exit(&attitude_mutex);
 
-    printf("[AHRS] Launching Core 0...\n");
+    // Stored hard/soft-iron correction (identity if never calibrated)
+    mag_calibration_load(&mag_cal);
+    mag_cal_active = false;
+    mag_cal_changed = true;
 
-    // Launch AHRS on Core 0
-    multicore_launch_core1(ahrs_core0_entry);
+    // Binary USB stream: fed by Core 0, drained by Core 1 (imu_stream_service)
+    imu_stream_init();
 
-    // Wait for Core 0 to signal it's running
-    uint32_t timeout = 0;
-    while (!ahrs_running && timeout++ < 100) {
-        sleep_ms(10);
-    }
+    printf("[AHRS] Launching Core 0...\n");
 
-    if (ahrs_running) {
-        printf("[AHRS] Core 0 started successfully\n");
-    } else {
-        printf("[AHRS] ERROR: Core 0 failed to start\n");
-    }
+    // Launch AHRS on Core 0. No waiting for it: sensor init and calibration
+    // overlap the rest of the boot, and the UI shows "AHRS INIT" until
+    // ahrs_core_get_attitude() reports valid data.
+    multicore_launch_core1(ahrs_core0_entry);
 }
 
 void ahrs_core_stop(void) {
@@ -97,47 +141,213 @@ void ahrs_core_reset_filter(void) {
     printf("[AHRS] Filter reset not yet implemented\n");
 }
 
+void ahrs_core_mag_cal_start(void) {
+    mutex_enter_blocking(&attitude_mutex);
+    mag_cal_collect_reset(&mag_collector);
+    mag_cal_active = true;
+    mutex_exit(&attitude_mutex);
+    printf("[AHRS] Magnetometer calibration started\n");
+}
+
+bool ahrs_core_mag_cal_progress(MagCalCollector* progress) {
+    if (!mag_cal_active) return false;
+
+    mutex_enter_blocking(&attitude_mutex);
+    if (progress) *progress = mag_collector;
+    mutex_exit(&attitude_mutex);
+    return true;
+}
+
+bool ahrs_core_mag_cal_finish(void) {
+    MagCalibration cal;
+
+    mutex_enter_blocking(&attitude_mutex);
+    bool ok = mag_cal_active && mag_cal_collect_finish(&mag_collector, &cal);
+    if (ok) {
+        mag_cal = cal;
+        mag_cal_changed = true;
+        mag_cal_active = false;
+    }
+    mutex_exit(&attitude_mutex);
+
+    if (!ok) return false;
+    return mag_calibration_save(&cal);
+}
+
+void ahrs_core_mag_cal_cancel(void) {
+    mag_cal_active = false;
+    printf("[AHRS] Magnetometer calibration cancelled\n");
+}
+
+// Release Core 0 and wait until it has left the RAM loop, so the next
+// request cannot mistake this window's flash_window_open for a fresh ack
+static void flash_window_close(void) {
+    flash_window_requested = false;
+    __dmb();
+    while (flash_window_open) {
+        tight_loop_contents();
+    }
+}
+
+bool ahrs_core_flash_op(void (*op)(void*), void* param) {
+    if (ahrs_running) {
+        flash_window_requested = true;
+
+        uint32_t start = time_us_32();
+        while (!flash_window_open && ahrs_running &&
+               time_us_32() - start < FLASH_WINDOW_TIMEOUT_US) {
+            tight_loop_contents();
+        }
+
+        if (flash_window_open) {
+            // Core 0 runs only RAM code with interrupts off until released
+            uint32_t irq = save_and_disable_interrupts();
+            op(param);
+            restore_interrupts(irq);
+            __dmb();
+            flash_window_close();
+            return true;
+        }
+        flash_window_close();
+    }
+
+    // AHRS not running (or not answering): park Core 0 the SDK way
+    return flash_safe_execute(op, param, 100) == PICO_OK;
+}
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+// AK09916 axes relative to accel/gyro: X same, Y and Z inverted
+static void mag_to_body(const SensorData* mag, float* mx, float* my, float* mz) {
+    *mx =  icm20948_mag_to_ut(mag->x);
+    *my = -icm20948_mag_to_ut(mag->y);
+    *mz = -icm20948_mag_to_ut(mag->z);
+}
+
+// Filter yaw (radians, counter-clockwise in the sensor frame) to compass heading.
+// Roll and pitch are negated for the mounting (board yawed 180° in the airframe),
+// so heading = 180° - yaw.
+static float yaw_to_heading(float yaw_deg) {
+    float heading = 180.0f - yaw_deg;
+    while (heading < 0.0f) heading += 360.0f;
+    while (heading >= 360.0f) heading -= 360.0f;
+    return heading;
+}
+
+// ── Flash Window (RAM-resident) ───────────────────────────────────────────────
+
+// Append one sensor read to the backlog; safe while flash is unavailable
+static bool __not_in_flash_func(backlog_capture)(void) {
+    if (backlog_len >= FLASH_BACKLOG_LEN) return false;
+
+    BufferedSample* s = &backlog[backlog_len];
+    if (!icm20948_read_all(&s->accel, &s->gyro, &s->mag, &s->mag_fresh)) return false;
+    s->t_us = time_us_32();
+    backlog_len++;
+    return true;
+}
+
+// Parked here while Core 1 erases/programs flash: interrupts off, nothing
+// fetched from flash, and the sensor still read every period_us so the
+// samples keep their usual spacing
+static void __not_in_flash_func(flash_window_sample)(uint32_t period_us) {
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t next = time_us_32() + period_us;
+    flash_window_open = true;
+
+    while (flash_window_requested) {
+        if ((int32_t)(time_us_32() - next) >= 0) {
+            backlog_capture();
+            next += period_us;
+        }
+    }
+
+    flash_window_open = false;
+    restore_interrupts(irq);
+}
+
+// Boot-relative time of a buffered sample
+static absolute_time_t backlog_time(const BufferedSample* s) {
+    uint32_t age_us = time_us_32() - s->t_us;
+    return from_us_since_boot(time_us_64() - age_us);
+}
+
+// Everything a capture needs to turn raw counts back into calibrated units
+static void stream_set_info(const MagCalibration* cal, float abx, float aby, float abz) {
+    ImuStreamInfo info = {0};
+    info.accel_lsb_per_g = 1.0f / icm20948_accel_to_g(1, ACCEL_RANGE_4G);
+    info.gyro_lsb_per_dps = 1.0f / icm20948_gyro_to_dps(1, GYRO_RANGE_500DPS);
+    info.mag_ut_per_lsb = icm20948_mag_to_ut(1);
+    info.accel_bias[0] = abx;
+    info.accel_bias[1] = aby;
+    info.accel_bias[2] = abz;
+    for (int i = 0; i < 3; i++) {
+        info.mag_offset[i] = cal->offset[i];
+        info.mag_scale[i] = cal->scale[i];
+    }
+    info.mag_field_ut = cal->magic != 0 ? cal->field_ut : 0.0f;
+    strncpy(info.estimator, ATTITUDE_ESTIMATOR_NAME, sizeof(info.estimator));
+    imu_stream_set_info(&info);
+}
+
 // ── Core 0 AHRS Processing Loop ───────────────────────────────────────────────
 
 static void ahrs_core0_entry(void) {
     printf("[Core 0] AHRS starting...\n");
+    prof_init_core();
+
+    // Allow Core 1 to park this core for flash writes (calibration save)
+    multicore_lockout_victim_init();
 
     // Initialize sensor
     if (!icm20948_init()) {
         printf("[Core 0] ERROR: ICM20948 init failed!\n");
         mutex_enter_blocking(&attitude_mutex);
         shared_attitude.valid = false;
+        shared_attitude.init_failed = true;
         mutex_exit(&attitude_mutex);
         return;
     }
 
     printf("[Core 0] ICM20948 initialized\n");
+    boot_mark("imu init");
 
-    // Initialize Madgwick filter
-    MadgwickFilter filter;
-    madgwick_init(&filter, 100.0f, 0.02f);  // 100 Hz, beta=0.02
+    // Magnetometer auto-read through the ICM20948 I2C master (optional)
+    bool mag_ok = icm20948_init_magnetometer();
+    if (!mag_ok) {
+        printf("[Core 0] WARNING: magnetometer unavailable, heading will drift\n");
+    }
+    boot_mark("mag init");
+
+    // Initialize attitude estimator (engine chosen at build time, see attitude_estimator.h)
+    AttitudeEstimator filter;
+    estimator_init(&filter, 100.0f);
+    printf("[Core 0] Attitude estimator: %s\n", ATTITUDE_ESTIMATOR_NAME);
 
-    SensorData accel, gyro;
+    SensorData accel, gyro, mag = {0};
+    bool mag_fresh = false;
 
     // ── Calibration Phase ─────────────────────────────────────────────────────
 
-    printf("[Core 0] Calibrating (200 samples)...\n");
+    // Sampled at the gyro ODR (1.125 kHz): 150 ms on the boot critical path.
+    // Residual bias is tracked by the adaptive estimate while stationary.
+    printf("[Core 0] Calibrating (%d samples)...\n", CAL_SAMPLES);
     float gyro_bias_x = 0, gyro_bias_y = 0, gyro_bias_z = 0;
     float accel_bias_x = 0, accel_bias_y = 0, accel_bias_z = 0;
-    const int CAL_N = 200;
+    const int CAL_N = CAL_SAMPLES;
+    absolute_time_t cal_next = get_absolute_time();
 
     for (int i = 0; i < CAL_N; i++) {
-        if (icm20948_read_gyro(&gyro)) {
+        if (icm20948_read_all(&accel, &gyro, &mag, &mag_fresh)) {
             gyro_bias_x += icm20948_gyro_to_dps(gyro.x, GYRO_RANGE_500DPS);
             gyro_bias_y += icm20948_gyro_to_dps(gyro.y, GYRO_RANGE_500DPS);
             gyro_bias_z += icm20948_gyro_to_dps(gyro.z, GYRO_RANGE_500DPS);
-        }
-        if (icm20948_read_accel(&accel)) {
             accel_bias_x += icm20948_accel_to_g(accel.x, ACCEL_RANGE_4G);
             accel_bias_y += icm20948_accel_to_g(accel.y, ACCEL_RANGE_4G);
             accel_bias_z += icm20948_accel_to_g(accel.z, ACCEL_RANGE_4G);
         }
-        sleep_ms(10);
+        cal_next = delayed_by_us(cal_next, CAL_PERIOD_US);
+        sleep_until(cal_next);
     }
 
     gyro_bias_x /= CAL_N;
@@ -151,36 +361,77 @@ static void ahrs_core0_entry(void) {
     printf("[Core 0] Gyro bias: X=%.3f Y=%.3f Z=%.3f deg/s\n", gyro_bias_x, gyro_bias_y, gyro_bias_z);
     printf("[Core 0] Accel bias: X=%.3f Y=%.3f Z=%.3f g\n", accel_bias_x, accel_bias_y, accel_bias_z);
 
-    // Seed quaternion from initial accelerometer reading
-    if (icm20948_read_accel(&accel)) {
+    // Current magnetometer correction
+    MagCalibration cal;
+    mutex_enter_blocking(&attitude_mutex);
+    cal = mag_cal;
+    mag_cal_changed = false;
+    mutex_exit(&attitude_mutex);
+    stream_set_info(&cal, accel_bias_x, accel_bias_y, accel_bias_z);
+
+    // Wait briefly for a fresh magnetometer sample (100 Hz) to seed heading
+    bool have_mag = false;
+    for (int i = 0; mag_ok && i < 20 && !have_mag; i++) {
+        have_mag = icm20948_read_all(&accel, &gyro, &mag, &mag_fresh) && mag_fresh;
+        if (!have_mag) sleep_ms(2);
+    }
+
+    // Seed quaternion from initial accelerometer (and magnetometer) reading
+    if (icm20948_read_all(&accel, &gyro, &mag, &mag_fresh)) {
         float ax0 = icm20948_accel_to_g(accel.x, ACCEL_RANGE_4G) - accel_bias_x;
         float ay0 = icm20948_accel_to_g(accel.y, ACCEL_RANGE_4G) - accel_bias_y;
         float az0 = icm20948_accel_to_g(accel.z, ACCEL_RANGE_4G) - accel_bias_z;
 
         float r = atan2f(ay0, az0);
         float p = atan2f(-ax0, sqrtf(ay0*ay0 + az0*az0));
+        float y = 0.0f;
+
+        // Tilt-compensated heading so MARG does not have to slew from yaw=0
+        if (have_mag && cal.magic != 0) {
+            float mx0, my0, mz0;
+            mag_to_body(&mag, &mx0, &my0, &mz0);
+            mag_calibration_apply(&cal, &mx0, &my0, &mz0);
+            float bx = mx0 * cosf(p) + my0 * sinf(r) * sinf(p) + mz0 * cosf(r) * sinf(p);
+            float by = my0 * cosf(r) - mz0 * sinf(r);
+            y = atan2f(-by, bx);
+        }
 
-        filter.q.q0 =  cosf(r/2) * cosf(p/2);
-        filter.q.q1 =  sinf(r/2) * cosf(p/2);
-        filter.q.q2 =  cosf(r/2) * sinf(p/2);
-        filter.q.q3 = -sinf(r/2) * sinf(p/2);
+        Quaternion q0;
+        quaternion_from_euler(&q0, r, p, y);
+        estimator_set_quaternion(&filter, &q0);
 
-        printf("[Core 0] Initial attitude: Roll=%.1f° Pitch=%.1f°\n", r * 180.0f / M_PI, p * 180.0f / M_PI);
+        printf("[Core 0] Initial attitude: Roll=%.1f° Pitch=%.1f° Yaw=%.1f°\n",
+               r * 180.0f / M_PI, p * 180.0f / M_PI, y * 180.0f / M_PI);
     }
 
-    // Output smoothing
+    // Last corrected magnetometer sample (held between 100 Hz updates)
+    float mx = 0.0f, my = 0.0f, mz = 0.0f;
+    bool mag_usable = false;
+
+    // Vibration notch filters (one bank per sensor, 3 axes each)
+    NotchConfig notch_cfg;
+    NotchFilterBank gyro_notch, accel_notch;
+    notch_default_config(&notch_cfg, 3, NOTCH_NOMINAL_RATE_HZ);
+    notch_cfg.min_level = NOTCH_GYRO_MIN_LEVEL;
+    notch_bank_init(&gyro_notch, &notch_cfg);
+    notch_cfg.min_level = NOTCH_ACCEL_MIN_LEVEL;
+    notch_bank_init(&accel_notch, &notch_cfg);
+
+    // Output smoothing (vibration is notched out upstream, so keep this light)
     float smooth_roll = 0.0f;
     float smooth_pitch = 0.0f;
-    const float smooth_alpha = 0.15f;  // Lower = smoother (0.15 = gentle smoothing)
+    const float smooth_alpha = 0.5f;  // Lower = smoother
 
     // Timing
     absolute_time_t last_update = get_absolute_time();
     absolute_time_t last_diag = get_absolute_time();
     float dt_min = 1.0f, dt_max = 0.0f, dt_sum = 0.0f;
     uint32_t dt_samples = 0;
+    float period_us = 1000.0f;      // Smoothed loop period, paces the flash-window sampling
     uint32_t update_count = 0;
 
     printf("[Core 0] Calibration complete, starting AHRS loop...\n");
+    boot_mark("calibrated");
     ahrs_running = true;
 
     // Mark as calibrated
@@ -194,13 +445,62 @@ static void ahrs_core0_entry(void) {
     // ── Main AHRS Loop ────────────────────────────────────────────────────────
 
     while (!ahrs_stop_requested) {
-        // Read sensors
-        if (!icm20948_read_accel(&accel) || !icm20948_read_gyro(&gyro)) {
+        uint32_t loop_t = prof_begin();
+        bool read_ok;
+        absolute_time_t now;
+
+        if (backlog_pos < backlog_len) {
+            // Catch up on samples taken during a flash window, still reading the
+            // sensor at the usual rate so the sample spacing is unchanged
+            if ((float)(time_us_32() - backlog[backlog_len - 1].t_us) >= period_us) {
+                backlog_capture();
+            }
+            const BufferedSample* s = &backlog[backlog_pos++];
+            accel = s->accel;
+            gyro = s->gyro;
+            mag_fresh = s->mag_fresh;
+            if (mag_fresh) mag = s->mag;
+            now = backlog_time(s);
+            if (backlog_pos == backlog_len) backlog_pos = backlog_len = 0;
+            read_ok = true;
+        } else {
+            // Read accel, gyro and magnetometer in one SPI transaction
+            read_ok = icm20948_read_all(&accel, &gyro, &mag, &mag_fresh);
+            now = get_absolute_time();
+        }
+        prof_end(PROF_SENSOR_READ, loop_t);
+        if (!read_ok) {
             continue;
         }
 
+        // Pick up a new correction from Core 1
+        if (mag_cal_changed) {
+            mutex_enter_blocking(&attitude_mutex);
+            cal = mag_cal;
+            mag_cal_changed = false;
+            mutex_exit(&attitude_mutex);
+            mag_usable = false;
+            stream_set_info(&cal, accel_bias_x, accel_bias_y, accel_bias_z);
+        }
+
+        if (mag_ok && mag_fresh) {
+            float bx, by, bz;
+            mag_to_body(&mag, &bx, &by, &bz);
+
+            if (mag_cal_active) {
+                mutex_enter_blocking(&attitude_mutex);
+                mag_cal_collect_add(&mag_collector, bx, by, bz);
+                mutex_exit(&attitude_mutex);
+            }
+
+            mag_calibration_apply(&cal, &bx, &by, &bz);
+            float field = sqrtf(bx*bx + by*by + bz*bz);
+            mag_usable = cal.magic != 0 && !mag_cal_active && isfinite(field) &&
+                         fabsf(field - cal.field_ut) < MAG_FIELD_TOLERANCE * cal.field_ut;
+            mx = bx; my = by; mz = bz;
+        }
+
         // Calculate delta time
-        absolute_time_t now = get_absolute_time();
         int64_t dt_us = absolute_time_diff_us(last_update, now);
         last_update = now;
         float dt = (float)dt_us / 1000000.0f;
@@ -212,6 +512,7 @@ static void ahrs_core0_entry(void) {
             if (dt > dt_max) dt_max = dt;
             dt_sum += dt;
             dt_samples++;
+            period_us += 0.01f * (dt * 1e6f - period_us);
         }
 
         // Convert sensor readings
@@ -223,11 +524,20 @@ static void ahrs_core0_entry(void) {
         float gy_raw = icm20948_gyro_to_dps(gyro.y, GYRO_RANGE_500DPS);
         float gz_raw = icm20948_gyro_to_dps(gyro.z, GYRO_RANGE_500DPS);
 
+        // Remove engine/propeller vibration (notches sit above DC, bias is unaffected)
+        uint32_t filter_t = prof_begin();
+        float accel_ch[3] = {ax, ay, az};
+        float gyro_ch[3] = {gx_raw, gy_raw, gz_raw};
+        notch_bank_apply(&accel_notch, accel_ch);
+        notch_bank_apply(&gyro_notch, gyro_ch);
+        ax = accel_ch[0]; ay = accel_ch[1]; az = accel_ch[2];
+        gx_raw = gyro_ch[0]; gy_raw = gyro_ch[1]; gz_raw = gyro_ch[2];
+
         float gx_dps = gx_raw - gyro_bias_x;
         float gy_dps = gy_raw - gyro_bias_y;
         float gz_dps = gz_raw - gyro_bias_z;
 
-        // Sanity checks
+        // Sanity checks (filter zone not closed on rejected samples)
         if (!isfinite(gx_dps) || !isfinite(gy_dps) || !isfinite(gz_dps)) continue;
         if (fabsf(gx_dps) > 2000.0f || fabsf(gy_dps) > 2000.0f || fabsf(gz_dps) > 2000.0f) continue;
 
@@ -263,18 +573,24 @@ static void ahrs_core0_entry(void) {
         float gy = gy_dps * D2R;
         float gz = gz_dps * D2R;
 
-        // Update Madgwick filter
-        filter.sample_freq = 1.0f / dt;
-        filter.inv_sample_freq = dt;
-        madgwick_update_imu(&filter, gx, gy, gz, ax, ay, az);
+        // Update estimator (MARG when a trusted magnetometer sample is available)
+        if (mag_usable) {
+            estimator_update(&filter, dt, gx, gy, gz, ax, ay, az, mx, my, mz);
+        } else {
+            estimator_update_imu(&filter, dt, gx, gy, gz, ax, ay, az);
+        }
+        prof_end(PROF_FILTER_UPDATE, filter_t);
 
         // Get attitude (invert pitch so nose-up is positive)
-        float roll = -madgwick_get_roll_deg(&filter);
-        float pitch = -madgwick_get_pitch_deg(&filter);
+        float roll, pitch, yaw;
+        estimator_get_euler_deg(&filter, &roll, &pitch, &yaw);
+        roll = -roll;
+        pitch = -pitch;
+        float heading = yaw_to_heading(yaw);
 
         // Sanity check
-        if (!isfinite(roll) || !isfinite(pitch)) {
-            madgwick_init(&filter, 100.0f, 0.02f);
+        if (!isfinite(roll) || !isfinite(pitch) || !isfinite(heading)) {
+            estimator_init(&filter, 100.0f);
             continue;
         }
 
@@ -289,7 +605,9 @@ static void ahrs_core0_entry(void) {
         mutex_enter_blocking(&attitude_mutex);
         shared_attitude.roll = roll;
         shared_attitude.pitch = pitch;
-        shared_attitude.yaw = 0.0f;  // Not yet implemented
+        shared_attitude.yaw = heading;
+        shared_attitude.heading_valid = mag_usable;
+        shared_attitude.mag_calibrating = mag_cal_active;
         shared_attitude.valid = true;
         shared_attitude.stationary = stationary;
         shared_attitude.gyro_bias_x = gyro_bias_x;
@@ -303,14 +621,56 @@ static void ahrs_core0_entry(void) {
             shared_attitude.timing_jitter_ms = (dt_max - dt_min) * 1000.0f;
         }
         mutex_exit(&attitude_mutex);
+        boot_mark_attitude();
+
+        // Raw sample and output for the binary USB stream (no-op unless enabled)
+        if (imu_stream_enabled()) {
+            ImuStreamSample s = {
+                .t_us = to_us_since_boot(now),
+                .accel = {accel.x, accel.y, accel.z},
+                .gyro = {gyro.x, gyro.y, gyro.z},
+                .mag = {mag.x, mag.y, mag.z},
+                .flags = (mag_fresh ? IMU_STREAM_FLAG_MAG_FRESH : 0) |
+                         (mag_usable ? IMU_STREAM_FLAG_MAG_USED : 0) |
+                         (stationary ? IMU_STREAM_FLAG_STATIONARY : 0),
+                .roll = roll,
+                .pitch = pitch,
+                .heading = heading,
+                .gyro_bias = {gyro_bias_x, gyro_bias_y, gyro_bias_z},
+            };
+            imu_stream_push_sample(&s);
+        } else {
+            imu_stream_producer_flush();
+        }
+        prof_end(PROF_AHRS_LOOP, loop_t);
+
+        // Core 1 wants to erase/program flash: keep sampling from RAM until done
+        if (flash_window_requested) {
+            flash_window_sample((uint32_t)period_us);
+        }
 
         // Print diagnostics every 5 seconds
         if (absolute_time_diff_us(last_diag, now) > 5000000) {
             if (dt_samples > 0) {
                 float dt_avg = dt_sum / dt_samples;
                 float jitter_ms = (dt_max - dt_min) * 1000.0f;
-                printf("[Core 0] Roll:%+7.2f Pitch:%+7.2f | Rate:%.1fHz Jitter:%.3fms | %s\n",
-                       roll, pitch, 1.0f / dt_avg, jitter_ms, stationary ? "CAL" : "MOV");
+                float vib_hz = 0.0f;
+                bool vib = notch_bank_dominant(&gyro_notch, &vib_hz) >= 0;
+
+                // Text would interleave with the binary stream
+                if (!imu_stream_enabled()) {
+                    printf("[Core 0] Roll:%+7.2f Pitch:%+7.2f Hdg:%5.1f%s | Rate:%.1fHz Jitter:%.3fms | %s | Vib:%s%.0fHz\n",
+                           roll, pitch, heading, mag_usable ? "M" : "G",
+                           1.0f / dt_avg, jitter_ms, stationary ? "CAL" : "MOV",
+                           vib ? "" : "-", vib_hz);
+                }
+
+                // Keep notch tuning in step with the measured loop rate
+                float rate = 1.0f / dt_avg;
+                if (fabsf(rate - gyro_notch.cfg.sample_freq) > 0.05f * gyro_notch.cfg.sample_freq) {
+                    notch_bank_set_sample_rate(&gyro_notch, rate);
+                    notch_bank_set_sample_rate(&accel_notch, rate);
+                }
             }
             dt_min = 1.0f; dt_max = 0.0f; dt_sum = 0.0f; dt_samples = 0;
             last_diag = now;
@@ -5,7 +5,7 @@
  * CPU core to ensure timing isolation from WiFi, Bluetooth, and LCD operations.
  *
  * Architecture:
- * - Core 0: AHRS loop (this module) - 100 Hz sensor reads, Madgwick filter
+ * - Core 0: AHRS loop (this module) - burst sensor reads (accel, gyro, mag), attitude estimator
  * - Core 1: Main application - WiFi, BT, LCD, touch, menu system
  * - Communication: Mutex-protected shared memory
  */
@@ -15,12 +15,13 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "mag_calibration.h"
 
 // Shared attitude data structure (updated by Core 0, read by Core 1)
 typedef struct {
     float roll;           // Roll angle in degrees (-180 to +180)
     float pitch;          // Pitch angle in degrees (-90 to +90)
-    float yaw;            // Yaw angle in degrees (0 to 360) - reserved for magnetometer
+    float yaw;            // Magnetic heading in degrees (0 to 360), see heading_valid
 
     // Gyro bias tracking
     float gyro_bias_x;
@@ -31,6 +32,9 @@ typedef struct {
     bool valid;           // True if AHRS is running and data is valid
     bool stationary;      // True if device is stationary (calibrating)
     bool calibrated;      // True if initial calibration complete
+    bool heading_valid;   // True if yaw is magnetometer-referenced (MARG update)
+    bool mag_calibrating; // True while a magnetometer calibration is collecting
+    bool init_failed;     // True if sensor init failed and Core 0 has stopped
 
     // Diagnostics
     uint32_t update_count;    // Total AHRS updates since start
@@ -79,4 +83,43 @@ bool ahrs_core_is_healthy(void);
  */
 void ahrs_core_reset_filter(void);
 
+/**
+ * Start magnetometer calibration
+ * The AHRS core collects the field envelope while the user rotates the
+ * device through all orientations. Heading falls back to gyro-only
+ * integration until calibration finishes or is cancelled.
+ */
+void ahrs_core_mag_cal_start(void);
+
+/**
+ * Get a snapshot of calibration progress
+ * Returns: false if no calibration is in progress
+ */
+bool ahrs_core_mag_cal_progress(MagCalCollector* progress);
+
+/**
+ * Finish magnetometer calibration
+ * Computes hard/soft-iron correction, hands it to the AHRS core and
+ * saves it to flash. Must be called from Core 1.
+ *
+ * Returns: true if accepted and saved, false if rejected (calibration stays active)
+ */
+bool ahrs_core_mag_cal_finish(void);
+
+/**
+ * Abandon magnetometer calibration and keep the previous correction
+ */
+void ahrs_core_mag_cal_cancel(void);
+
+/**
+ * Run a flash erase/program operation from Core 1 without stalling the AHRS
+ * Core 0 parks in RAM-resident code for the duration, still sampling the
+ * sensor at its loop rate, and processes the buffered samples afterwards,
+ * so attitude timing is unaffected. op runs with interrupts disabled.
+ * Falls back to flash_safe_execute() when the AHRS is not running.
+ *
+ * Returns: true if op ran
+ */
+bool ahrs_core_flash_op(void (*op)(void*), void* param);
+
 #endif // AHRS_CORE_H
@@ -0,0 +1,133 @@
+/**
+ * Attitude Estimator Interface
+ *
+ * One API over the available fusion engines, selected at build time:
+ *
+ *   ATTITUDE_ESTIMATOR_MADGWICK  gradient-descent filter
+ *   ATTITUDE_ESTIMATOR_MAHONY    PI complementary filter, cheapest
+ *   ATTITUDE_ESTIMATOR_ESKF      error-state Kalman filter with gyro bias (default)
+ *
+ * Set ATTITUDE_ESTIMATOR to one of these (CMake: -DAHRS_ESTIMATOR=madgwick|
+ * mahony|eskf). Only the selected engine's source is compiled into the
+ * application, and these wrappers are static inline, so the other engines
+ * cost nothing in flash. Gains can be overridden with the ESTIMATOR_*
+ * defines below. Compare engines with the estimator_bench executable.
+ *
+ * All engines share the conventions of quaternion.h: gyroscope in rad/s,
+ * accelerometer in g, magnetometer in µT (any consistent unit), sensor
+ * axes as mounted.
+ */
+
+#ifndef ATTITUDE_ESTIMATOR_H
+#define ATTITUDE_ESTIMATOR_H
+
+#include "quaternion.h"
+
+#define ATTITUDE_ESTIMATOR_MADGWICK 1
+#define ATTITUDE_ESTIMATOR_MAHONY   2
+#define ATTITUDE_ESTIMATOR_ESKF     3
+
+#ifndef ATTITUDE_ESTIMATOR
+#define ATTITUDE_ESTIMATOR ATTITUDE_ESTIMATOR_ESKF
+#endif
+
+// Default gains (tuned on the estimator_bench datasets)
+#ifndef ESTIMATOR_MADGWICK_BETA
+#define ESTIMATOR_MADGWICK_BETA 0.02f
+#endif
+#ifndef ESTIMATOR_MAHONY_KP
+#define ESTIMATOR_MAHONY_KP 0.2f
+#endif
+#ifndef ESTIMATOR_MAHONY_KI
+#define ESTIMATOR_MAHONY_KI 0.002f
+#endif
+
+#if ATTITUDE_ESTIMATOR == ATTITUDE_ESTIMATOR_MADGWICK
+
+#include "madgwick_filter.h"
+typedef MadgwickFilter AttitudeEstimator;
+#define ATTITUDE_ESTIMATOR_NAME "Madgwick"
+
+static inline void estimator_init(AttitudeEstimator* est, float sample_freq) {
+    madgwick_init(est, sample_freq, ESTIMATOR_MADGWICK_BETA);
+}
+
+#define ESTIMATOR_UPDATE_MARG madgwick_update
+#define ESTIMATOR_UPDATE_IMU  madgwick_update_imu
+
+#elif ATTITUDE_ESTIMATOR == ATTITUDE_ESTIMATOR_MAHONY
+
+#include "mahony_filter.h"
+typedef MahonyFilter AttitudeEstimator;
+#define ATTITUDE_ESTIMATOR_NAME "Mahony"
+
+static inline void estimator_init(AttitudeEstimator* est, float sample_freq) {
+    mahony_init(est, sample_freq, ESTIMATOR_MAHONY_KP, ESTIMATOR_MAHONY_KI);
+}
+
+#define ESTIMATOR_UPDATE_MARG mahony_update
+#define ESTIMATOR_UPDATE_IMU  mahony_update_imu
+
+#elif ATTITUDE_ESTIMATOR == ATTITUDE_ESTIMATOR_ESKF
+
+#include "eskf_filter.h"
+typedef EskfFilter AttitudeEstimator;
+#define ATTITUDE_ESTIMATOR_NAME "ESKF"
+
+static inline void estimator_init(AttitudeEstimator* est, float sample_freq) {
+    eskf_init(est, sample_freq);
+}
+
+#define ESTIMATOR_UPDATE_MARG eskf_update
+#define ESTIMATOR_UPDATE_IMU  eskf_update_imu
+
+#else
+#error "Unknown ATTITUDE_ESTIMATOR"
+#endif
+
+/**
+ * Overwrite the orientation (e.g. seeded from accelerometer/magnetometer)
+ */
+static inline void estimator_set_quaternion(AttitudeEstimator* est, const Quaternion* q) {
+    est->q = *q;
+#if ATTITUDE_ESTIMATOR == ATTITUDE_ESTIMATOR_ESKF
+    eskf_reset_covariance(est);
+#endif
+}
+
+/**
+ * 6-DOF update with the time since the previous update (s)
+ */
+static inline void estimator_update_imu(AttitudeEstimator* est, float dt,
+                                        float gx, float gy, float gz,
+                                        float ax, float ay, float az) {
+    est->sample_freq = 1.0f / dt;
+    est->inv_sample_freq = dt;
+    ESTIMATOR_UPDATE_IMU(est, gx, gy, gz, ax, ay, az);
+}
+
+/**
+ * 9-DOF update with the time since the previous update (s)
+ */
+static inline void estimator_update(AttitudeEstimator* est, float dt,
+                                    float gx, float gy, float gz,
+                                    float ax, float ay, float az,
+                                    float mx, float my, float mz) {
+    est->sample_freq = 1.0f / dt;
+    est->inv_sample_freq = dt;
+    ESTIMATOR_UPDATE_MARG(est, gx, gy, gz, ax, ay, az, mx, my, mz);
+}
+
+/**
+ * Roll, pitch and yaw in degrees from a single quaternion conversion
+ */
+static inline void estimator_get_euler_deg(const AttitudeEstimator* est,
+                                           float* roll, float* pitch, float* yaw) {
+    const float r2d = 180.0f / 3.14159265f;
+    quaternion_to_euler(&est->q, roll, pitch, yaw);
+    *roll *= r2d;
+    *pitch *= r2d;
+    *yaw *= r2d;
+}
+
+#endif // ATTITUDE_ESTIMATOR_H
@@ -41,9 +41,8 @@ bool bt_init(void) {
 
     current_state = BT_STATE_INITIALIZING;
 
-    // TODO: Initialize BTstack when ready
-    // For now, simulate initialization
-    sleep_ms(100);
+    // TODO: Initialize BTstack when ready (no simulated delay: this runs
+    // during boot, see the boot timeline)
 
     device_count = 0;
     connected_device_idx = -1;
@@ -0,0 +1,78 @@
+/**
+ * Boot Timeline - Implementation
+ */
+
+#include "boot_timeline.h"
+#include "pico/stdlib.h"
+#include "pico/critical_section.h"
+#include <stdio.h>
+
+typedef struct {
+    const char* stage;
+    uint64_t t_us;
+} BootStage;
+
+static BootStage stages[BOOT_MAX_STAGES];
+static uint32_t stage_count = 0;
+static volatile uint64_t attitude_us = 0;
+static critical_section_t lock;
+static bool lock_ready = false;
+
+void boot_timeline_init(void) {
+    critical_section_init(&lock);
+    lock_ready = true;
+    boot_mark("main");
+}
+
+static void mark_at(const char* stage, uint64_t now) {
+    if (!lock_ready) return;
+
+    // Both cores mark stages, so appends are serialised
+    critical_section_enter_blocking(&lock);
+    if (stage_count < BOOT_MAX_STAGES) {
+        stages[stage_count].stage = stage;
+        stages[stage_count].t_us = now;
+        stage_count++;
+    }
+    critical_section_exit(&lock);
+}
+
+void boot_mark(const char* stage) {
+    mark_at(stage, time_us_64());
+}
+
+void boot_mark_attitude(void) {
+    if (attitude_us != 0) return;
+    uint64_t now = time_us_64();
+    mark_at("first attitude", now);
+    attitude_us = now;
+}
+
+uint64_t boot_attitude_us(void) {
+    return attitude_us;
+}
+
+void boot_timeline_print(void) {
+    BootStage copy[BOOT_MAX_STAGES];
+    uint32_t n;
+
+    critical_section_enter_blocking(&lock);
+    n = stage_count;
+    for (uint32_t i = 0; i < n; i++) copy[i] = stages[i];
+    critical_section_exit(&lock);
+
+    printf("[BOOT] Stage                  t (ms)   step (ms)\n");
+    uint64_t prev = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        printf("[BOOT] %-20s %8.1f %10.1f\n", copy[i].stage,
+               copy[i].t_us / 1000.0f, (copy[i].t_us - prev) / 1000.0f);
+        prev = copy[i].t_us;
+    }
+
+    if (attitude_us != 0) {
+        printf("[BOOT] Time to first attitude: %lu ms\n",
+               (unsigned long)(attitude_us / 1000));
+    } else {
+        printf("[BOOT] No valid attitude yet\n");
+    }
+}
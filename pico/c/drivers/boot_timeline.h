@@ -0,0 +1,46 @@
+/**
+ * Boot Timeline
+ *
+ * Records when each start-up stage finished (µs since reset, from either
+ * core) so boot time can be measured on the device rather than guessed.
+ * The headline figure is time-to-first-attitude: the moment the AHRS core
+ * first publishes a valid attitude.
+ *
+ * The timeline stays in RAM; boot_timeline_print() sends it to the USB
+ * console, which may not be connected yet when the stages happen.
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BOOT_MAX_STAGES 24
+
+/**
+ * Prepare the timeline (call first thing in main, before Core 0 starts)
+ */
+void boot_timeline_init(void);
+
+/**
+ * Record that a stage has finished (any core; stage must be a string literal)
+ */
+void boot_mark(const char* stage);
+
+/**
+ * Record the first valid attitude (AHRS core; only the first call counts)
+ */
+void boot_mark_attitude(void);
+
+/**
+ * Time of the first valid attitude in µs since reset, 0 if not reached yet
+ */
+uint64_t boot_attitude_us(void);
+
+/**
+ * Print every stage with its time and the step from the previous one
+ */
+void boot_timeline_print(void);
+
+#endif // BOOT_TIMELINE_H
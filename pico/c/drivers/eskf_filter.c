@@ -0,0 +1,300 @@
+/**
+ * Error-State Kalman Filter Implementation
+ *
+ * Error state dx = [dtheta (3), dbias (3)], where the true orientation is
+ * q ⊗ exp(dtheta/2) and the true bias is bias + dbias. The covariance is
+ * propagated in 3x3 blocks (the transition matrix is mostly identity),
+ * which keeps the cost per update low enough for the 1 kHz AHRS loop.
+ */
+
+#include "eskf_filter.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Initial uncertainty
+#define ESKF_INIT_ANGLE_SIGMA  0.1f    // rad
+#define ESKF_INIT_BIAS_SIGMA   0.01f   // rad/s
+
+// Skip the gravity update when |a| is this far from 1 g (not a gravity reading)
+#define ESKF_ACCEL_GATE        0.5f
+
+// |a| - 1 g below this is sensor noise, not manoeuvring (no extra distrust)
+#define ESKF_ACCEL_DEADBAND    0.03f
+
+// Largest bias the filter may estimate (rad/s, ~6 deg/s)
+#define ESKF_BIAS_LIMIT        0.1f
+
+/**
+ * Initialize ESKF
+ */
+void eskf_init(EskfFilter* filter, float sample_freq) {
+    memset(filter, 0, sizeof(*filter));
+    quaternion_identity(&filter->q);
+
+    filter->gyro_noise = 0.005f;
+    filter->bias_walk = 0.0002f;
+    filter->accel_noise = 0.03f;
+    filter->accel_dynamic = 10.0f;
+    filter->turn_dynamic = 4.0f;
+    filter->heading_noise = 0.3f;
+
+    filter->sample_freq = sample_freq;
+    filter->inv_sample_freq = 1.0f / sample_freq;
+    eskf_reset_covariance(filter);
+}
+
+void eskf_reset_covariance(EskfFilter* filter) {
+    memset(filter->P, 0, sizeof(filter->P));
+    for (int i = 0; i < 3; i++) {
+        filter->P[i][i] = ESKF_INIT_ANGLE_SIGMA * ESKF_INIT_ANGLE_SIGMA;
+        filter->P[i + 3][i + 3] = ESKF_INIT_BIAS_SIGMA * ESKF_INIT_BIAS_SIGMA;
+    }
+}
+
+// ── Prediction ────────────────────────────────────────────────────────────────
+
+// Returns the bias-corrected rotation rate about earth vertical (rad/s)
+static float eskf_predict(EskfFilter* filter, float gx, float gy, float gz) {
+    const float dt = filter->inv_sample_freq;
+    float (*P)[6] = filter->P;
+
+    float wx = gx - filter->bias[0];
+    float wy = gy - filter->bias[1];
+    float wz = gz - filter->bias[2];
+
+    float up[3];
+    quaternion_up_vector(&filter->q, up);
+    float turn_rate = wx * up[0] + wy * up[1] + wz * up[2];
+
+    // Nominal quaternion: q = q ⊗ [1, w dt / 2]
+    float hx = 0.5f * wx * dt, hy = 0.5f * wy * dt, hz = 0.5f * wz * dt;
+    float q0 = filter->q.q0, q1 = filter->q.q1, q2 = filter->q.q2, q3 = filter->q.q3;
+    filter->q.q0 = q0 - q1 * hx - q2 * hy - q3 * hz;
+    filter->q.q1 = q1 + q0 * hx + q2 * hz - q3 * hy;
+    filter->q.q2 = q2 + q0 * hy - q1 * hz + q3 * hx;
+    filter->q.q3 = q3 + q0 * hz + q1 * hy - q2 * hx;
+    quaternion_normalize(&filter->q);
+
+    // F = [Phi -I dt; 0 I], Phi = I - [w×] dt
+    // With P = [A B; B' C]:  A' = (Phi A - dt B') Phi' - dt (Phi B - dt C),  B' = Phi B - dt C
+    const float Phi[3][3] = {
+        { 1.0f,     wz * dt, -wy * dt},
+        {-wz * dt,  1.0f,     wx * dt},
+        { wy * dt, -wx * dt,  1.0f   }
+    };
+    float M[3][3], N[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            float pa = 0.0f, pb = 0.0f;
+            for (int k = 0; k < 3; k++) {
+                pa += Phi[i][k] * P[k][j];
+                pb += Phi[i][k] * P[k][j + 3];
+            }
+            M[i][j] = pa - dt * P[i + 3][j];
+            N[i][j] = pb - dt * P[i + 3][j + 3];
+        }
+    }
+
+    const float q_angle = filter->gyro_noise * filter->gyro_noise * dt;
+    const float q_bias = filter->bias_walk * filter->bias_walk * dt;
+    for (int i = 0; i < 3; i++) {
+        for (int j = i; j < 3; j++) {
+            float a = M[i][0] * Phi[j][0] + M[i][1] * Phi[j][1] + M[i][2] * Phi[j][2]
+                    - dt * N[i][j];
+            if (i == j) a += q_angle;
+            P[i][j] = a;
+            P[j][i] = a;
+        }
+        for (int j = 0; j < 3; j++) {
+            P[i][j + 3] = N[i][j];
+            P[j + 3][i] = N[i][j];
+        }
+        P[i + 3][i + 3] += q_bias;
+    }
+    return turn_rate;
+}
+
+// ── Correction ────────────────────────────────────────────────────────────────
+
+// Fold the estimated error into the nominal state (covariance reset Jacobian ~ I)
+static void eskf_inject(EskfFilter* filter, const float dx[6]) {
+    float hx = 0.5f * dx[0], hy = 0.5f * dx[1], hz = 0.5f * dx[2];
+    float q0 = filter->q.q0, q1 = filter->q.q1, q2 = filter->q.q2, q3 = filter->q.q3;
+    filter->q.q0 = q0 - q1 * hx - q2 * hy - q3 * hz;
+    filter->q.q1 = q1 + q0 * hx + q2 * hz - q3 * hy;
+    filter->q.q2 = q2 + q0 * hy - q1 * hz + q3 * hx;
+    filter->q.q3 = q3 + q0 * hz + q1 * hy - q2 * hx;
+    quaternion_normalize(&filter->q);
+
+    for (int i = 0; i < 3; i++) {
+        float b = filter->bias[i] + dx[i + 3];
+        if (b > ESKF_BIAS_LIMIT) b = ESKF_BIAS_LIMIT;
+        if (b < -ESKF_BIAS_LIMIT) b = -ESKF_BIAS_LIMIT;
+        filter->bias[i] = b;
+    }
+}
+
+// Gravity direction update: z = a / |a|, h = up vector, H = [[h×] 0]
+static void eskf_correct_gravity(EskfFilter* filter, float ax, float ay, float az,
+                                 float turn_rate) {
+    float (*P)[6] = filter->P;
+
+    float norm = sqrtf(ax * ax + ay * ay + az * az);
+    float dev = fabsf(norm - 1.0f);
+    if (!isfinite(norm) || norm < 1e-6f || dev > ESKF_ACCEL_GATE) return;
+
+    float z[3] = {ax / norm, ay / norm, az / norm};
+    float h[3];
+    quaternion_up_vector(&filter->q, h);
+
+    const float Hx[3][3] = {
+        { 0.0f,  -h[2],  h[1]},
+        { h[2],   0.0f, -h[0]},
+        {-h[1],   h[0],  0.0f}
+    };
+
+    // PHt = P[:, 0:3] Hx'  (6x3)
+    float PHt[6][3];
+    for (int i = 0; i < 6; i++) {
+        for (int k = 0; k < 3; k++) {
+            PHt[i][k] = P[i][0] * Hx[k][0] + P[i][1] * Hx[k][1] + P[i][2] * Hx[k][2];
+        }
+    }
+
+    // S = Hx A Hx' + R
+    float excess = dev > ESKF_ACCEL_DEADBAND ? dev - ESKF_ACCEL_DEADBAND : 0.0f;
+    float sigma = filter->accel_noise + filter->accel_dynamic * excess +
+                  filter->turn_dynamic * fabsf(turn_rate);
+    float r = sigma * sigma * filter->sample_freq;
+    float S[3][3];
+    for (int k = 0; k < 3; k++) {
+        for (int l = 0; l < 3; l++) {
+            S[k][l] = Hx[k][0] * PHt[0][l] + Hx[k][1] * PHt[1][l] + Hx[k][2] * PHt[2][l];
+        }
+        S[k][k] += r;
+    }
+
+    // S^-1 by cofactors (S is symmetric positive definite)
+    float c00 = S[1][1] * S[2][2] - S[1][2] * S[2][1];
+    float c01 = S[1][2] * S[2][0] - S[1][0] * S[2][2];
+    float c02 = S[1][0] * S[2][1] - S[1][1] * S[2][0];
+    float det = S[0][0] * c00 + S[0][1] * c01 + S[0][2] * c02;
+    if (!(fabsf(det) > 1e-30f)) return;
+    float inv_det = 1.0f / det;
+    const float Si[3][3] = {
+        {c00 * inv_det, (S[0][2] * S[2][1] - S[0][1] * S[2][2]) * inv_det, (S[0][1] * S[1][2] - S[0][2] * S[1][1]) * inv_det},
+        {c01 * inv_det, (S[0][0] * S[2][2] - S[0][2] * S[2][0]) * inv_det, (S[0][2] * S[1][0] - S[0][0] * S[1][2]) * inv_det},
+        {c02 * inv_det, (S[0][1] * S[2][0] - S[0][0] * S[2][1]) * inv_det, (S[0][0] * S[1][1] - S[0][1] * S[1][0]) * inv_det}
+    };
+
+    // K = PHt S^-1, dx = K (z - h)
+    float y[3] = {z[0] - h[0], z[1] - h[1], z[2] - h[2]};
+    float K[6][3];
+    float dx[6];
+    for (int i = 0; i < 6; i++) {
+        for (int k = 0; k < 3; k++) {
+            K[i][k] = PHt[i][0] * Si[0][k] + PHt[i][1] * Si[1][k] + PHt[i][2] * Si[2][k];
+        }
+        dx[i] = K[i][0] * y[0] + K[i][1] * y[1] + K[i][2] * y[2];
+    }
+
+    // P = P - K PHt'
+    for (int i = 0; i < 6; i++) {
+        for (int j = i; j < 6; j++) {
+            float p = P[i][j] - (K[i][0] * PHt[j][0] + K[i][1] * PHt[j][1] + K[i][2] * PHt[j][2]);
+            P[i][j] = p;
+            P[j][i] = p;
+        }
+    }
+
+    eskf_inject(filter, dx);
+}
+
+// Heading update: the horizontal field, rotated to the earth frame, should point along X.
+// A yaw error about earth Z maps to u' dtheta, with u the up vector in the sensor frame.
+static void eskf_correct_heading(EskfFilter* filter, float mx, float my, float mz) {
+    float (*P)[6] = filter->P;
+    const float q0 = filter->q.q0, q1 = filter->q.q1, q2 = filter->q.q2, q3 = filter->q.q3;
+
+    float ex = (1.0f - 2.0f * (q2 * q2 + q3 * q3)) * mx + 2.0f * (q1 * q2 - q0 * q3) * my +
+               2.0f * (q1 * q3 + q0 * q2) * mz;
+    float ey = 2.0f * (q1 * q2 + q0 * q3) * mx + (1.0f - 2.0f * (q1 * q1 + q3 * q3)) * my +
+               2.0f * (q2 * q3 - q0 * q1) * mz;
+    if (!isfinite(ex) || !isfinite(ey) || ex * ex + ey * ey < 1e-6f) return;
+    float y = -atan2f(ey, ex);
+
+    float u[3];
+    quaternion_up_vector(&filter->q, u);
+
+    float PHt[6];
+    for (int i = 0; i < 6; i++) {
+        PHt[i] = P[i][0] * u[0] + P[i][1] * u[1] + P[i][2] * u[2];
+    }
+    float S = PHt[0] * u[0] + PHt[1] * u[1] + PHt[2] * u[2] +
+              filter->heading_noise * filter->heading_noise * filter->sample_freq;
+    if (!(S > 0.0f)) return;
+
+    float K[6], dx[6];
+    for (int i = 0; i < 6; i++) {
+        K[i] = PHt[i] / S;
+        dx[i] = K[i] * y;
+    }
+    for (int i = 0; i < 6; i++) {
+        for (int j = i; j < 6; j++) {
+            float p = P[i][j] - K[i] * PHt[j];
+            P[i][j] = p;
+            P[j][i] = p;
+        }
+    }
+
+    eskf_inject(filter, dx);
+}
+
+/**
+ * Update filter with 9-DOF sensor data (accel + gyro + mag)
+ */
+void eskf_update(EskfFilter* filter,
+                 float gx, float gy, float gz,
+                 float ax, float ay, float az,
+                 float mx, float my, float mz) {
+    float turn_rate = eskf_predict(filter, gx, gy, gz);
+    eskf_correct_gravity(filter, ax, ay, az, turn_rate);
+    if ((mx != 0.0f) || (my != 0.0f) || (mz != 0.0f)) {
+        eskf_correct_heading(filter, mx, my, mz);
+    }
+}
+
+/**
+ * Update filter with 6-DOF sensor data (accel + gyro, no mag)
+ */
+void eskf_update_imu(EskfFilter* filter,
+                     float gx, float gy, float gz,
+                     float ax, float ay, float az) {
+    float turn_rate = eskf_predict(filter, gx, gy, gz);
+    eskf_correct_gravity(filter, ax, ay, az, turn_rate);
+}
+
+/**
+ * Helper functions to get angles in degrees
+ */
+float eskf_get_roll_deg(const EskfFilter* filter) {
+    float roll, pitch, yaw;
+    quaternion_to_euler(&filter->q, &roll, &pitch, &yaw);
+    return roll * 180.0f / M_PI;
+}
+
+float eskf_get_pitch_deg(const EskfFilter* filter) {
+    float roll, pitch, yaw;
+    quaternion_to_euler(&filter->q, &roll, &pitch, &yaw);
+    return pitch * 180.0f / M_PI;
+}
+
+float eskf_get_yaw_deg(const EskfFilter* filter) {
+    float roll, pitch, yaw;
+    quaternion_to_euler(&filter->q, &roll, &pitch, &yaw);
+    return yaw * 180.0f / M_PI;
+}
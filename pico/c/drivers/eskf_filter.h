@@ -0,0 +1,93 @@
+/**
+ * Error-State Kalman Filter (ESKF) for Attitude
+ *
+ * Nominal state is the orientation quaternion plus gyro bias; the filter
+ * tracks a 6-element error state (small rotation in the sensor frame and
+ * bias error) with its covariance. Gyro drives the prediction, gravity
+ * direction from the accelerometer corrects roll/pitch, and the
+ * magnetometer corrects heading only (it never tilts the horizon).
+ *
+ * Noise parameters are densities, so the behaviour does not change with
+ * the loop rate. Accelerometer trust drops automatically when the measured
+ * magnitude departs from 1 g (turbulence, pull-ups) and while turning, where
+ * a coordinated turn makes the accelerometer read "down" through the floor.
+ *
+ * Reference: J. Solà, "Quaternion kinematics for the error-state Kalman
+ * filter," arXiv:1711.02508, 2017.
+ */
+
+#ifndef ESKF_FILTER_H
+#define ESKF_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quaternion.h"
+
+/**
+ * ESKF filter state
+ */
+typedef struct {
+    Quaternion q;           // Current orientation quaternion
+    float bias[3];          // Estimated gyro bias (rad/s)
+    float P[6][6];          // Error covariance: [rotation (rad), bias (rad/s)]
+
+    // Tuning (densities, per square root of a second)
+    float gyro_noise;       // Gyro angle random walk (rad/s/√Hz)
+    float bias_walk;        // Gyro bias instability (rad/s/√s)
+    float accel_noise;      // Gravity direction noise (g/√Hz)
+    float accel_dynamic;    // Extra noise per g of |a| - 1 g
+    float turn_dynamic;     // Extra noise per rad/s of turn rate (centripetal acceleration)
+    float heading_noise;    // Magnetometer heading noise (rad/√Hz)
+
+    float sample_freq;      // Sampling frequency (Hz)
+    float inv_sample_freq;  // 1 / sample_freq (cached for performance)
+} EskfFilter;
+
+/**
+ * Initialize ESKF with default tuning (level attitude, zero bias)
+ *
+ * @param filter Pointer to filter structure
+ * @param sample_freq Sampling frequency in Hz (e.g., 200.0)
+ */
+void eskf_init(EskfFilter* filter, float sample_freq);
+
+/**
+ * Reset covariance to the initial uncertainty (keeps q and bias)
+ * Call after overwriting q from an external attitude.
+ */
+void eskf_reset_covariance(EskfFilter* filter);
+
+/**
+ * Update filter with 9-DOF sensor data
+ * Gyroscope in rad/s, accelerometer in g, magnetometer in µT.
+ * An all-zero magnetometer sample falls back to the 6-DOF update.
+ */
+void eskf_update(EskfFilter* filter,
+                 float gx, float gy, float gz,
+                 float ax, float ay, float az,
+                 float mx, float my, float mz);
+
+/**
+ * Update filter with 6-DOF sensor data (no magnetometer)
+ * Yaw will drift over time without magnetometer correction.
+ */
+void eskf_update_imu(EskfFilter* filter,
+                     float gx, float gy, float gz,
+                     float ax, float ay, float az);
+
+/**
+ * Get roll angle in degrees
+ */
+float eskf_get_roll_deg(const EskfFilter* filter);
+
+/**
+ * Get pitch angle in degrees
+ */
+float eskf_get_pitch_deg(const EskfFilter* filter);
+
+/**
+ * Get yaw angle in degrees (heading)
+ */
+float eskf_get_yaw_deg(const EskfFilter* filter);
+
+#endif // ESKF_FILTER_H
@@ -0,0 +1,320 @@
+/**
+ * Flight Log Implementation
+ */
+
+#include "flight_log.h"
+#include "ahrs_core.h"
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#define FLIGHT_LOG_MAGIC    0x474F4C50  // "PLOG"
+#define FLIGHT_LOG_VERSION  1
+
+// Below the mag calibration (second-to-last) and Bluetooth (last) sectors
+#define LOG_FLASH_OFFSET    (PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE - FLIGHT_LOG_SIZE_BYTES)
+#define LOG_PAGES           (FLIGHT_LOG_SIZE_BYTES / FLASH_PAGE_SIZE)
+#define PAGES_PER_SECTOR    (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+
+_Static_assert(FLIGHT_LOG_SIZE_BYTES % FLASH_SECTOR_SIZE == 0,
+               "Flight log must be a whole number of sectors");
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;         // FLIGHT_LOG_MAGIC
+    uint32_t seq;           // Page sequence number, +1 per page, never reused
+    uint16_t session;       // Power cycle the page was written in
+    uint8_t  version;       // FLIGHT_LOG_VERSION
+    uint8_t  used;          // Payload bytes holding records
+    uint32_t crc;           // CRC-32 of the whole page with this field zero
+} PageHeader;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  type;          // FLIGHT_LOG_ATTITUDE / DIAG / TRAFFIC
+    uint8_t  len;           // Payload length
+    uint32_t t_ms;          // Time since boot
+} RecordHeader;
+
+#define PAGE_PAYLOAD        (FLASH_PAGE_SIZE - sizeof(PageHeader))
+
+_Static_assert(PAGE_PAYLOAD <= 255, "PageHeader.used is a byte");
+
+static uint8_t fill_page[FLASH_PAGE_SIZE];      // Collecting records
+static uint8_t write_page[FLASH_PAGE_SIZE];     // Complete, waiting for flash
+static uint32_t fill_used = 0;
+static bool write_pending = false;
+
+static uint32_t next_slot = 0;      // Page index of the next write
+static uint32_t next_seq = 1;
+static uint16_t session = 1;
+static bool initialized = false;
+
+// ── CRC-32 (IEEE, reflected, nibble table) ────────────────────────────────────
+
+static const uint32_t crc_nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+static uint32_t page_crc(const uint8_t* page) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < FLASH_PAGE_SIZE; i++) {
+        // CRC field counts as zero
+        uint8_t b = (i >= offsetof(PageHeader, crc) && i < offsetof(PageHeader, crc) + 4) ? 0 : page[i];
+        crc = (crc >> 4) ^ crc_nibble[(crc ^ b) & 0x0F];
+        crc = (crc >> 4) ^ crc_nibble[(crc ^ (b >> 4)) & 0x0F];
+    }
+    return ~crc;
+}
+
+// ── Flash access ──────────────────────────────────────────────────────────────
+
+static const uint8_t* slot_data(uint32_t slot) {
+    return (const uint8_t*)(XIP_BASE + LOG_FLASH_OFFSET + slot * FLASH_PAGE_SIZE);
+}
+
+static bool page_valid(const uint8_t* page) {
+    const PageHeader* hdr = (const PageHeader*)page;
+    return hdr->magic == FLIGHT_LOG_MAGIC && hdr->version == FLIGHT_LOG_VERSION &&
+           hdr->used <= PAGE_PAYLOAD && hdr->crc == page_crc(page);
+}
+
+typedef struct {
+    uint32_t offset;        // Flash offset of the page (or sector to erase)
+    const uint8_t* data;    // Page to program, NULL to only erase
+    bool erase;             // Erase the sector containing offset first
+} FlashJob;
+
+// Runs with interrupts disabled while the AHRS core samples from RAM
+static void log_flash_job(void* param) {
+    const FlashJob* job = (const FlashJob*)param;
+    if (job->erase) {
+        flash_range_erase(job->offset & ~(FLASH_SECTOR_SIZE - 1), FLASH_SECTOR_SIZE);
+    }
+    if (job->data) {
+        flash_range_program(job->offset, job->data, FLASH_PAGE_SIZE);
+    }
+}
+
+// Program one page into the next slot, erasing its sector when entering it
+static void write_next_page(const uint8_t* page) {
+    FlashJob job = {
+        .offset = LOG_FLASH_OFFSET + next_slot * FLASH_PAGE_SIZE,
+        .data = page,
+        .erase = (next_slot % PAGES_PER_SECTOR) == 0,
+    };
+
+    if (!ahrs_core_flash_op(log_flash_job, &job)) {
+        printf("[LOG] ERROR: flash write failed (slot %lu)\n", (unsigned long)next_slot);
+    } else if (memcmp(slot_data(next_slot), page, FLASH_PAGE_SIZE) != 0) {
+        printf("[LOG] ERROR: verify failed (slot %lu)\n", (unsigned long)next_slot);
+    }
+
+    next_slot = (next_slot + 1) % LOG_PAGES;
+}
+
+// ── Page assembly ─────────────────────────────────────────────────────────────
+
+static void finish_fill_page(void) {
+    if (fill_used == 0) return;
+
+    // Only one page can wait; write the older one now if needed
+    if (write_pending) flight_log_poll();
+
+    PageHeader hdr = {
+        .magic = FLIGHT_LOG_MAGIC,
+        .seq = next_seq++,
+        .session = session,
+        .version = FLIGHT_LOG_VERSION,
+        .used = (uint8_t)fill_used,
+        .crc = 0,
+    };
+    memcpy(fill_page, &hdr, sizeof(hdr));
+    hdr.crc = page_crc(fill_page);
+    memcpy(fill_page, &hdr, sizeof(hdr));
+
+    memcpy(write_page, fill_page, FLASH_PAGE_SIZE);
+    write_pending = true;
+
+    memset(fill_page, 0xFF, FLASH_PAGE_SIZE);
+    fill_used = 0;
+}
+
+static void append_record(uint8_t type, const void* data, uint8_t len) {
+    if (!initialized) return;
+
+    uint32_t need = sizeof(RecordHeader) + len;
+    if (fill_used + need > PAGE_PAYLOAD) finish_fill_page();
+
+    RecordHeader rec = {
+        .type = type,
+        .len = len,
+        .t_ms = to_ms_since_boot(get_absolute_time()),
+    };
+    uint8_t* p = fill_page + sizeof(PageHeader) + fill_used;
+    memcpy(p, &rec, sizeof(rec));
+    memcpy(p + sizeof(rec), data, len);
+    fill_used += need;
+}
+
+// ── Public API ────────────────────────────────────────────────────────────────
+
+void flight_log_init(void) {
+    int32_t newest = -1;
+    const PageHeader* newest_hdr = NULL;
+
+    for (uint32_t slot = 0; slot < LOG_PAGES; slot++) {
+        const uint8_t* page = slot_data(slot);
+        if (!page_valid(page)) continue;
+        const PageHeader* hdr = (const PageHeader*)page;
+        if (newest < 0 || (int32_t)(hdr->seq - newest_hdr->seq) > 0) {
+            newest = (int32_t)slot;
+            newest_hdr = hdr;
+        }
+    }
+
+    if (newest >= 0) {
+        next_seq = newest_hdr->seq + 1;
+        session = (uint16_t)(newest_hdr->session + 1);
+        // The rest of the newest sector may hold a torn page: start clean
+        next_slot = ((uint32_t)newest / PAGES_PER_SECTOR + 1) * PAGES_PER_SECTOR % LOG_PAGES;
+    } else {
+        next_seq = 1;
+        session = 1;
+        next_slot = 0;
+    }
+
+    memset(fill_page, 0xFF, sizeof(fill_page));
+    fill_used = 0;
+    write_pending = false;
+    initialized = true;
+
+    printf("[LOG] Session %u, next page %lu (seq %lu)\n",
+           session, (unsigned long)next_slot, (unsigned long)next_seq);
+}
+
+void flight_log_attitude(float roll, float pitch, float heading, uint8_t flags) {
+    FlightLogAttitude a = {
+        .roll_cd = (int16_t)lroundf(roll * 100.0f),
+        .pitch_cd = (int16_t)lroundf(pitch * 100.0f),
+        .heading_cd = (uint16_t)lroundf(heading * 100.0f),
+        .flags = flags,
+    };
+    append_record(FLIGHT_LOG_ATTITUDE, &a, sizeof(a));
+}
+
+void flight_log_diag(const FlightLogDiag* diag) {
+    append_record(FLIGHT_LOG_DIAG, diag, sizeof(*diag));
+}
+
+void flight_log_traffic(const TrafficData* traffic) {
+    FlightLogTraffic t = {0};
+    strncpy(t.id, traffic->id, sizeof(t.id));
+    t.lat_e7 = traffic->lat * 10;
+    t.lon_e7 = traffic->lon * 10;
+    int32_t alt_ft = geo_alt_to_ft(traffic->alt);
+    t.alt_ft = alt_ft > 0 ? (uint16_t)(alt_ft < 65535 ? alt_ft : 65535) : 0;
+    t.heading_dd = (uint16_t)((traffic->heading + 5) / 10 % 3600);
+    t.speed_kt = traffic->speed > 0 ? (uint16_t)traffic->speed : 0;
+    append_record(FLIGHT_LOG_TRAFFIC, &t, sizeof(t));
+}
+
+void flight_log_poll(void) {
+    if (!write_pending) return;
+    write_next_page(write_page);
+    write_pending = false;
+}
+
+void flight_log_flush(void) {
+    finish_fill_page();
+    flight_log_poll();
+}
+
+void flight_log_get_status(FlightLogStatus* status) {
+    memset(status, 0, sizeof(*status));
+    status->pages_total = LOG_PAGES;
+    status->session = session;
+
+    bool first = true;
+    for (uint32_t slot = 0; slot < LOG_PAGES; slot++) {
+        const uint8_t* page = slot_data(slot);
+        if (!page_valid(page)) continue;
+        uint32_t seq = ((const PageHeader*)page)->seq;
+        if (first || (int32_t)(seq - status->oldest_seq) < 0) status->oldest_seq = seq;
+        if (first || (int32_t)(seq - status->newest_seq) > 0) status->newest_seq = seq;
+        first = false;
+        status->pages_valid++;
+    }
+}
+
+static void dump_record(uint16_t page_session, const RecordHeader* rec, const uint8_t* data) {
+    printf("%u,%lu,", page_session, (unsigned long)rec->t_ms);
+
+    if (rec->type == FLIGHT_LOG_ATTITUDE && rec->len == sizeof(FlightLogAttitude)) {
+        FlightLogAttitude a;
+        memcpy(&a, data, sizeof(a));
+        printf("ATT,%.2f,%.2f,%.2f,%u\n", a.roll_cd / 100.0f, a.pitch_cd / 100.0f,
+               a.heading_cd / 100.0f, a.flags);
+    } else if (rec->type == FLIGHT_LOG_DIAG && rec->len == sizeof(FlightLogDiag)) {
+        FlightLogDiag d;
+        memcpy(&d, data, sizeof(d));
+        printf("DIAG,%.1f,%u,%.3f,%.3f,%.3f,%u,%u\n", d.loop_rate_dhz / 10.0f, d.jitter_us,
+               d.gyro_bias_mdps[0] / 1000.0f, d.gyro_bias_mdps[1] / 1000.0f,
+               d.gyro_bias_mdps[2] / 1000.0f, d.wifi_up, d.bt_connected);
+    } else if (rec->type == FLIGHT_LOG_TRAFFIC && rec->len == sizeof(FlightLogTraffic)) {
+        FlightLogTraffic t;
+        memcpy(&t, data, sizeof(t));
+        printf("TFC,%.8s,%.7f,%.7f,%u,%.1f,%u\n", t.id, t.lat_e7 / 1e7, t.lon_e7 / 1e7,
+               t.alt_ft, t.heading_dd / 10.0f, t.speed_kt);
+    } else {
+        printf("UNKNOWN,%u,%u\n", rec->type, rec->len);
+    }
+}
+
+void flight_log_dump(void) {
+    flight_log_flush();
+
+    printf("# session,t_ms,ATT,roll,pitch,heading,flags\n");
+    printf("# session,t_ms,DIAG,loop_hz,jitter_us,bias_x,bias_y,bias_z,wifi,bt\n");
+    printf("# session,t_ms,TFC,id,lat,lon,alt_ft,track,speed_kt\n");
+
+    // The ring is written in order, so the slot after the write position is the oldest
+    uint32_t pages = 0;
+    for (uint32_t i = 0; i < LOG_PAGES; i++) {
+        uint32_t slot = (next_slot + i) % LOG_PAGES;
+        const uint8_t* page = slot_data(slot);
+        if (!page_valid(page)) continue;
+
+        const PageHeader* hdr = (const PageHeader*)page;
+        uint32_t off = 0;
+        while (off + sizeof(RecordHeader) <= hdr->used) {
+            RecordHeader rec;
+            memcpy(&rec, page + sizeof(PageHeader) + off, sizeof(rec));
+            if (off + sizeof(rec) + rec.len > hdr->used) break;
+            dump_record(hdr->session, &rec, page + sizeof(PageHeader) + off + sizeof(rec));
+            off += sizeof(rec) + rec.len;
+        }
+        pages++;
+    }
+    printf("# %lu pages\n", (unsigned long)pages);
+}
+
+void flight_log_erase(void) {
+    // One sector per flash window keeps each AHRS backlog short
+    for (uint32_t s = 0; s < FLIGHT_LOG_SIZE_BYTES / FLASH_SECTOR_SIZE; s++) {
+        FlashJob job = {
+            .offset = LOG_FLASH_OFFSET + s * FLASH_SECTOR_SIZE,
+            .data = NULL,
+            .erase = true,
+        };
+        ahrs_core_flash_op(log_flash_job, &job);
+    }
+
+    memset(fill_page, 0xFF, sizeof(fill_page));
+    fill_used = 0;
+    write_pending = false;
+    next_slot = 0;
+    printf("[LOG] Erased %u KB\n", FLIGHT_LOG_SIZE_BYTES / 1024);
+}
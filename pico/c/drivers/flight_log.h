@@ -0,0 +1,110 @@
+/**
+ * Flight Log - Flash Ring Buffer for the Standalone Pico
+ *
+ * Attitude, diagnostics and traffic snapshots are batched into 256-byte
+ * RAM pages and appended to a reserved flash region used as a ring, so
+ * every sector is erased equally often (wear levelling). Each page has a
+ * header with a magic number, a sequence number that never repeats, and
+ * a CRC-32 of the page. A page torn by a power loss fails its CRC and is
+ * skipped, and after each boot writing resumes in a freshly erased sector.
+ *
+ * Flash writes go through ahrs_core_flash_op(), so the AHRS core keeps
+ * sampling from RAM while a sector is erased.
+ *
+ * All functions are called from Core 1 (UI core).
+ */
+
+#ifndef FLIGHT_LOG_H
+#define FLIGHT_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../src/telemetry_parser.h"
+
+// Reserved flash: the 512 KB below the magnetometer calibration and
+// Bluetooth sectors at the top of flash. 2048 pages of 240 payload bytes:
+// at the default rates (13 B attitude records at 5 Hz, 20 B diagnostics
+// every 5 s) the ring holds ~2 h; every traffic record (28 B per target
+// and refresh) shortens that.
+#define FLIGHT_LOG_SIZE_BYTES   (512 * 1024)
+
+// Record types
+#define FLIGHT_LOG_ATTITUDE     1
+#define FLIGHT_LOG_DIAG         2
+#define FLIGHT_LOG_TRAFFIC      3
+
+// Attitude flags
+#define FLIGHT_LOG_FLAG_HEADING_VALID   0x01
+#define FLIGHT_LOG_FLAG_STATIONARY      0x02
+
+typedef struct __attribute__((packed)) {
+    int16_t  roll_cd;           // Roll (0.01°)
+    int16_t  pitch_cd;          // Pitch (0.01°, nose up positive)
+    uint16_t heading_cd;        // Magnetic heading (0.01°)
+    uint8_t  flags;             // FLIGHT_LOG_FLAG_*
+} FlightLogAttitude;
+
+typedef struct __attribute__((packed)) {
+    uint16_t loop_rate_dhz;     // AHRS loop rate (0.1 Hz)
+    uint16_t jitter_us;         // AHRS dt max - min
+    int16_t  gyro_bias_mdps[3]; // Gyro bias (0.001 °/s)
+    uint8_t  wifi_up;
+    uint8_t  bt_connected;
+} FlightLogDiag;
+
+typedef struct __attribute__((packed)) {
+    char     id[8];             // Callsign / ICAO24, NUL padded
+    int32_t  lat_e7;            // Latitude (1e-7°)
+    int32_t  lon_e7;            // Longitude (1e-7°)
+    uint16_t alt_ft;
+    uint16_t heading_dd;        // Track (0.1°)
+    uint16_t speed_kt;
+} FlightLogTraffic;
+
+typedef struct {
+    uint32_t pages_valid;       // Pages that pass magic and CRC
+    uint32_t pages_total;
+    uint32_t oldest_seq;
+    uint32_t newest_seq;
+    uint16_t session;           // Current power cycle number
+} FlightLogStatus;
+
+/**
+ * Scan flash for the newest page and prepare a fresh sector for this boot
+ */
+void flight_log_init(void);
+
+/**
+ * Append records (buffered in RAM; a full page is written by flight_log_poll)
+ */
+void flight_log_attitude(float roll, float pitch, float heading, uint8_t flags);
+void flight_log_diag(const FlightLogDiag* diag);
+void flight_log_traffic(const TrafficData* traffic);
+
+/**
+ * Write a completed page if one is waiting (call from the UI poll loop)
+ */
+void flight_log_poll(void);
+
+/**
+ * Write the partly filled page now
+ */
+void flight_log_flush(void);
+
+/**
+ * Page counts and sequence range
+ */
+void flight_log_get_status(FlightLogStatus* status);
+
+/**
+ * Print every record, oldest first, as CSV on stdout
+ * session,t_ms,type,fields...
+ */
+void flight_log_dump(void);
+
+/**
+ * Erase the whole log region
+ */
+void flight_log_erase(void);
+
+#endif // FLIGHT_LOG_H
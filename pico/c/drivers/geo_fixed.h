@@ -0,0 +1,115 @@
+/**
+ * Fixed-Point Positions and Radar Projection
+ *
+ * Traffic and own-ship data are stored packed, in integer units:
+ *   position   int32_t microdegrees (1e-6°, ~0.11 m of latitude)
+ *   altitude   int16_t tens of feet (±327,670 ft)
+ *   speed      int16_t knots
+ *   heading    uint16_t centidegrees, 0..35999 (pitch/roll: int16_t)
+ *
+ * The conversions below are used where data comes in (parsers) and goes
+ * out (text, logs). In between, the radar projects positions with a
+ * per-redraw GeoProjection: two 32x32->64 multiplies per point and no
+ * float or double arithmetic (on the M33 doubles are soft-float).
+ *
+ * The projection is an equirectangular one around the centre; at radar
+ * ranges (tens of km) it is within a pixel of the great-circle offset.
+ */
+
+#ifndef GEO_FIXED_H
+#define GEO_FIXED_H
+
+#include <stdint.h>
+#include <math.h>
+
+#define GEO_UDEG_PER_DEG 1000000
+#define GEO_UDEG_HALF_TURN (180 * GEO_UDEG_PER_DEG)
+#define GEO_KM_PER_DEG 111.195f         // Mean Earth radius 6371 km
+
+// ── Conversions ──────────────────────────────────────────────────────────────
+
+static inline int32_t geo_deg_to_udeg(double deg) {
+    return (int32_t)lround(deg * GEO_UDEG_PER_DEG);
+}
+
+static inline double geo_udeg_to_deg(int32_t udeg) {
+    return udeg / (double)GEO_UDEG_PER_DEG;
+}
+
+static inline int16_t geo_ft_to_alt(float ft) {
+    float a = ft * 0.1f;
+    if (a >= 32767.0f) return 32767;
+    if (a <= -32768.0f) return -32768;
+    return (int16_t)lroundf(a);
+}
+
+static inline int32_t geo_alt_to_ft(int16_t alt) {
+    return alt * 10;
+}
+
+static inline int16_t geo_kt_to_speed(float kt) {
+    if (kt >= 32767.0f) return 32767;
+    if (kt <= -32768.0f) return -32768;
+    return (int16_t)lroundf(kt);
+}
+
+// Any angle -> 0..35999
+static inline uint16_t geo_deg_to_heading(float deg) {
+    int32_t cd = (int32_t)lroundf(fmodf(deg, 360.0f) * 100.0f);
+    if (cd < 0) cd += 36000;
+    if (cd >= 36000) cd -= 36000;
+    return (uint16_t)cd;
+}
+
+static inline float geo_heading_to_deg(uint16_t heading) {
+    return heading * 0.01f;
+}
+
+// Pitch and roll, ±327°
+static inline int16_t geo_deg_to_angle(float deg) {
+    return (int16_t)lroundf(deg * 100.0f);
+}
+
+static inline float geo_angle_to_deg(int16_t angle) {
+    return angle * 0.01f;
+}
+
+// ── Projection ───────────────────────────────────────────────────────────────
+
+typedef struct {
+    int32_t lat;                // Centre, microdegrees
+    int32_t lon;
+    int32_t kx;                 // Output units per microdegree, Q32
+    int32_t ky;
+} GeoProjection;
+
+/**
+ * Set up a projection around (lat, lon) in microdegrees
+ * units_per_km: output scale (pixels per km for the radar, 1000 for metres);
+ * a microdegree must come out below 0.5 units.
+ */
+static inline void geo_projection_init(GeoProjection* proj, int32_t lat, int32_t lon,
+                                       float units_per_km) {
+    float per_udeg = units_per_km * GEO_KM_PER_DEG / GEO_UDEG_PER_DEG * 4294967296.0f;
+    float cos_lat = cosf(lat * (float)M_PI / (180.0f * GEO_UDEG_PER_DEG));
+    proj->lat = lat;
+    proj->lon = lon;
+    proj->ky = (int32_t)lroundf(per_udeg);
+    proj->kx = (int32_t)lroundf(per_udeg * cos_lat);
+}
+
+/**
+ * Offset of (lat, lon) from the centre, east and north, in output units
+ * (rounded). Longitude differences wrap across the antimeridian.
+ */
+static inline void geo_project(const GeoProjection* proj, int32_t lat, int32_t lon,
+                               int32_t* east, int32_t* north) {
+    int32_t dlon = lon - proj->lon;
+    if (dlon > GEO_UDEG_HALF_TURN) dlon -= 2 * GEO_UDEG_HALF_TURN;
+    else if (dlon < -GEO_UDEG_HALF_TURN) dlon += 2 * GEO_UDEG_HALF_TURN;
+    int32_t dlat = lat - proj->lat;
+    *east = (int32_t)(((int64_t)dlon * proj->kx + 0x80000000) >> 32);
+    *north = (int32_t)(((int64_t)dlat * proj->ky + 0x80000000) >> 32);
+}
+
+#endif // GEO_FIXED_H
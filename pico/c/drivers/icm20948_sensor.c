@@ -24,7 +24,11 @@ static uint8_t read_ak09916_register(uint8_t reg);
 
 // ── SPI transport ─────────────────────────────────────────────────────────────
 
-static void select_bank(uint8_t bank) {
+// select_bank, read_registers and icm20948_read_all run from RAM so the AHRS
+// core can keep sampling while the other core erases or programs flash
+// (the SDK's blocking SPI calls are RAM-resident too)
+
+static void __not_in_flash_func(select_bank)(uint8_t bank) {
     if (bank == current_bank) return;
     gpio_put(ICM20948_CS_PIN, 0);
     uint8_t tx[2] = {ICM20948_REG_BANK_SEL, (uint8_t)(bank << 4)};
@@ -50,7 +54,7 @@ static void write_register(uint8_t reg, uint8_t value) {
     gpio_put(ICM20948_CS_PIN, 1);
 }
 
-static void read_registers(uint8_t reg, uint8_t *buffer, size_t len) {
+static void __not_in_flash_func(read_registers)(uint8_t reg, uint8_t *buffer, size_t len) {
     gpio_put(ICM20948_CS_PIN, 0);
     uint8_t tx = reg | 0x80;
     spi_write_blocking(ICM20948_SPI, &tx, 1);
@@ -58,6 +62,16 @@ static void read_registers(uint8_t reg, uint8_t *buffer, size_t len) {
     gpio_put(ICM20948_CS_PIN, 1);
 }
 
+// Poll a Bank 0 register until (value & mask) == expected, up to timeout_ms
+static bool wait_for_register(uint8_t reg, uint8_t mask, uint8_t expected, uint32_t timeout_ms) {
+    absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
+    do {
+        if ((read_register(reg) & mask) == expected) return true;
+        sleep_us(500);
+    } while (absolute_time_diff_us(get_absolute_time(), deadline) > 0);
+    return false;
+}
+
 // ── Init ──────────────────────────────────────────────────────────────────────
 
 bool icm20948_init(void) {
@@ -73,13 +87,16 @@ bool icm20948_init(void) {
     gpio_set_dir(ICM20948_CS_PIN, GPIO_OUT);
     gpio_put(ICM20948_CS_PIN, 1);
 
-    sleep_ms(100);
-
+    // Poll instead of fixed delays: the chip is usually ready long before
+    // the 100 ms worst case, and this sits on the time-to-first-attitude path
     select_bank(ICM20948_BANK_0);
+    wait_for_register(ICM20948_WHO_AM_I, 0xFF, ICM20948_DEVICE_ID, 100);  // power-up
+
     write_register(ICM20948_PWR_MGMT_1, 0x80);  // reset
-    sleep_ms(100);
+    sleep_ms(1);
+    wait_for_register(ICM20948_PWR_MGMT_1, 0x80, 0x00, 100);   // reset bit self-clears
     write_register(ICM20948_PWR_MGMT_1, 0x01);  // wake, auto-clock
-    sleep_ms(10);
+    sleep_ms(1);
 
     uint8_t who = read_register(ICM20948_WHO_AM_I);
     printf("WHO_AM_I: 0x%02X (expected 0x%02X)\n", who, ICM20948_DEVICE_ID);
@@ -99,7 +116,7 @@ bool icm20948_init(void) {
 
     select_bank(ICM20948_BANK_0);
     write_register(ICM20948_PWR_MGMT_2, 0x00);  // enable all sensors
-    sleep_ms(100);
+    sleep_ms(40);   // Gyro start-up time is 35 ms max (accel 20 ms)
 
     printf("ICM20948 initialized successfully!\n");
     return true;
@@ -221,10 +238,12 @@ bool icm20948_init_magnetometer(void) {
     write_ak09916_register(AK09916_CNTL2, AK09916_MODE_CONT_100HZ);
     sleep_ms(10);
 
+    // Continuous SLV0 read ST1..ST2 into EXT_SLV_SENS_DATA_00, right after TEMP_OUT,
+    // so a single burst from ACCEL_XOUT_H returns all nine axes
     select_bank(ICM20948_BANK_3);
     write_register(ICM20948_I2C_SLV0_ADDR, AK09916_I2C_ADDR | 0x80);
     write_register(ICM20948_I2C_SLV0_REG,  AK09916_ST1);
-    write_register(ICM20948_I2C_SLV0_CTRL, 0x88);
+    write_register(ICM20948_I2C_SLV0_CTRL, 0x80 | ICM20948_MAG_AUTO_LEN);
 
     select_bank(ICM20948_BANK_0);
     printf("AK09916 initialized successfully!\n");
@@ -234,16 +253,39 @@ bool icm20948_init_magnetometer(void) {
 bool icm20948_read_mag(SensorData *data) {
     if (!data) return false;
     select_bank(ICM20948_BANK_0);
-    uint8_t buf[8];
-    read_registers(ICM20948_EXT_SLV_SENS_DATA_00, buf, 8);
-    if (!(buf[0] & 0x01)) return false;
-    if (  buf[7] & 0x08)  return false;
+    uint8_t buf[ICM20948_MAG_AUTO_LEN];
+    read_registers(ICM20948_EXT_SLV_SENS_DATA_00, buf, ICM20948_MAG_AUTO_LEN);
+    if (!(buf[0] & 0x01)) return false;  // ST1.DRDY
+    if (  buf[8] & 0x08)  return false;  // ST2.HOFL
     data->x = (int16_t)((buf[2] << 8) | buf[1]);
     data->y = (int16_t)((buf[4] << 8) | buf[3]);
     data->z = (int16_t)((buf[6] << 8) | buf[5]);
     return true;
 }
 
+bool __not_in_flash_func(icm20948_read_all)(SensorData *accel, SensorData *gyro, SensorData *mag, bool *mag_fresh) {
+    if (!accel || !gyro || !mag || !mag_fresh) return false;
+    select_bank(ICM20948_BANK_0);
+    uint8_t buf[ICM20948_BURST_LEN];
+    read_registers(ICM20948_ACCEL_XOUT_H, buf, ICM20948_BURST_LEN);
+    accel->x = (int16_t)((buf[0]  << 8) | buf[1]);
+    accel->y = (int16_t)((buf[2]  << 8) | buf[3]);
+    accel->z = (int16_t)((buf[4]  << 8) | buf[5]);
+    gyro->x  = (int16_t)((buf[6]  << 8) | buf[7]);
+    gyro->y  = (int16_t)((buf[8]  << 8) | buf[9]);
+    gyro->z  = (int16_t)((buf[10] << 8) | buf[11]);
+
+    // Magnetometer block (little-endian), starts after TEMP_OUT
+    const uint8_t *m = &buf[14];
+    *mag_fresh = (m[0] & 0x01) && !(m[8] & 0x08);
+    if (*mag_fresh) {
+        mag->x = (int16_t)((m[2] << 8) | m[1]);
+        mag->y = (int16_t)((m[4] << 8) | m[3]);
+        mag->z = (int16_t)((m[6] << 8) | m[5]);
+    }
+    return true;
+}
+
 float icm20948_mag_to_ut(int16_t raw) {
     return (float)raw * 0.15f;
 }
@@ -66,6 +66,12 @@
 // Device ID
 #define ICM20948_DEVICE_ID      0xEA
 
+// SLV0 auto-read: ST1, HXL..HZH, TMPS, ST2 (ST2 must be read to release the data latch)
+#define ICM20948_MAG_AUTO_LEN   9
+
+// Single burst: accel (6) + gyro (6) + temp (2) + SLV0 auto-read data
+#define ICM20948_BURST_LEN      (14 + ICM20948_MAG_AUTO_LEN)
+
 // Full-scale range options
 typedef enum {
     GYRO_RANGE_250DPS = 0,   // ±250 degrees/sec
@@ -124,6 +130,20 @@ bool icm20948_read_accel_gyro(SensorData* accel, SensorData* gyro);
  */
 bool icm20948_read_mag(SensorData* data);
 
+/**
+ * Read accelerometer, gyroscope and magnetometer in one SPI burst.
+ * Requires icm20948_init_magnetometer() so the I2C master keeps
+ * EXT_SLV_SENS_DATA_00.. refreshed in the background.
+ *
+ * mag is returned in the AK09916 frame (X same, Y and Z inverted
+ * relative to the accel/gyro axes). mag_fresh is set when the burst
+ * contains a new, non-overflowed magnetometer sample; mag is only
+ * written in that case.
+ *
+ * Returns: true on success, false on failure
+ */
+bool icm20948_read_all(SensorData* accel, SensorData* gyro, SensorData* mag, bool* mag_fresh);
+
 /**
  * Read temperature sensor (raw 16-bit value)
  * Returns: true on success, false on failure
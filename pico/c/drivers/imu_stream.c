@@ -0,0 +1,212 @@
+/**
+ * Binary IMU Stream - Implementation
+ */
+
+#include "imu_stream.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+// 8 KB per buffer: ~130 ms of samples at 1 kHz, so the UI core can stall
+// for a full redraw or a WiFi poll without losing data
+#define STREAM_BUF_SIZE  8192
+
+// Longest wait in imu_stream_enable(false) for the producer to hand over
+// the last, partly filled buffer (it checks once per AHRS loop, ~1 ms)
+#define STREAM_FLUSH_TIMEOUT_US 20000
+
+typedef struct {
+    uint8_t data[STREAM_BUF_SIZE];
+    uint32_t len;               // Bytes queued (producer-owned until ready)
+    uint32_t packets;           // Packets queued
+    volatile bool ready;        // Handed over to the consumer
+} StreamBuffer;
+
+static StreamBuffer bufs[2];
+static uint16_t crc_table[256];
+
+// Control (written by the UI core)
+static volatile bool stream_on = false;
+static volatile uint32_t start_gen = 0;
+static volatile bool flush_requested = false;
+
+// Producer state (AHRS core)
+static uint32_t seen_gen = 0;
+static uint8_t fill_idx = 0;
+static uint32_t next_seq = 0;
+static volatile uint32_t dropped = 0;
+static ImuStreamInfo info;
+static bool info_due = false;
+static uint64_t last_info_us = 0;
+
+// Consumer state (UI core)
+static uint8_t drain_idx = 0;
+static uint32_t sent = 0;
+
+// ── CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) ─────────────────────────────
+
+static void crc_table_init(void) {
+    for (int i = 0; i < 256; i++) {
+        uint16_t c = (uint16_t)(i << 8);
+        for (int b = 0; b < 8; b++) {
+            c = (c & 0x8000) ? (uint16_t)((c << 1) ^ 0x1021) : (uint16_t)(c << 1);
+        }
+        crc_table[i] = c;
+    }
+}
+
+static uint16_t crc16(const uint8_t* p, uint32_t n) {
+    uint16_t crc = 0xFFFF;
+    while (n--) {
+        crc = (uint16_t)((crc << 8) ^ crc_table[((crc >> 8) ^ *p++) & 0xFF]);
+    }
+    return crc;
+}
+
+// ── Producer ──────────────────────────────────────────────────────────────────
+
+// Frame one packet into the fill buffer; false if it had to be dropped
+static bool append_packet(uint8_t type, const void* payload, uint8_t len) {
+    uint32_t seq = next_seq++;
+    StreamBuffer* b = &bufs[fill_idx];
+
+    if (b->ready) {
+        dropped++;      // Both buffers are still waiting for USB
+        return false;
+    }
+
+    uint8_t* p = &b->data[b->len];
+    ImuStreamHeader hdr = {
+        .sync = {IMU_STREAM_SYNC0, IMU_STREAM_SYNC1},
+        .type = type,
+        .len = len,
+        .seq = seq,
+    };
+    memcpy(p, &hdr, sizeof(hdr));
+    memcpy(p + sizeof(hdr), payload, len);
+
+    // CRC covers everything after the sync bytes
+    uint16_t crc = crc16(p + 2, sizeof(hdr) - 2 + len);
+    p[sizeof(hdr) + len] = (uint8_t)(crc & 0xFF);
+    p[sizeof(hdr) + len + 1] = (uint8_t)(crc >> 8);
+
+    b->len += sizeof(hdr) + len + IMU_STREAM_CRC_LEN;
+    b->packets++;
+
+    // Hand over when the next packet might not fit
+    if (b->len + IMU_STREAM_MAX_PACKET > STREAM_BUF_SIZE) {
+        __dmb();
+        b->ready = true;
+        fill_idx ^= 1;
+    }
+    return true;
+}
+
+void imu_stream_set_info(const ImuStreamInfo* new_info) {
+    info = *new_info;
+    info.version = IMU_STREAM_VERSION;
+    info_due = true;
+}
+
+void imu_stream_push_sample(const ImuStreamSample* sample) {
+    if (!stream_on) return;
+
+    // Fresh start after (re)enable: restart numbering, lead with INFO
+    uint32_t gen = start_gen;
+    if (seen_gen != gen) {
+        seen_gen = gen;
+        next_seq = 0;
+        dropped = 0;
+        info_due = true;
+        StreamBuffer* b = &bufs[fill_idx];
+        if (!b->ready) {
+            b->len = 0;
+            b->packets = 0;
+        }
+    }
+
+    if (info_due || sample->t_us - last_info_us >= 1000000) {
+        if (append_packet(IMU_STREAM_TYPE_INFO, &info, sizeof(info))) {
+            info_due = false;
+            last_info_us = sample->t_us;
+        }
+    }
+
+    append_packet(IMU_STREAM_TYPE_SAMPLE, sample, sizeof(*sample));
+}
+
+void imu_stream_producer_flush(void) {
+    if (!flush_requested) return;
+
+    StreamBuffer* b = &bufs[fill_idx];
+    if (b->len > 0 && !b->ready) {
+        __dmb();
+        b->ready = true;
+        fill_idx ^= 1;
+    }
+    __dmb();
+    flush_requested = false;
+}
+
+// ── Consumer ──────────────────────────────────────────────────────────────────
+
+void imu_stream_service(void) {
+    while (bufs[drain_idx].ready) {
+        StreamBuffer* b = &bufs[drain_idx];
+        __dmb();
+
+        // Raw write: no CR/LF translation, the stream is binary
+        if (stdio_usb_connected()) {
+            stdio_put_string((const char*)b->data, (int)b->len, false, false);
+            sent += b->packets;
+        }
+
+        b->len = 0;
+        b->packets = 0;
+        __dmb();
+        b->ready = false;
+        drain_idx ^= 1;
+    }
+}
+
+// ── Control ───────────────────────────────────────────────────────────────────
+
+void imu_stream_init(void) {
+    crc_table_init();
+    memset(bufs, 0, sizeof(bufs));
+    stream_on = false;
+    fill_idx = drain_idx = 0;
+    sent = 0;
+}
+
+void imu_stream_enable(bool enable) {
+    if (enable) {
+        sent = 0;
+        flush_requested = false;
+        start_gen = start_gen + 1;
+        __dmb();
+        stream_on = true;
+        return;
+    }
+    if (!stream_on) return;
+
+    // Stop first, then ask for the tail: the producer flushes from its own
+    // loop once it sees streaming off, never in the middle of an append
+    stream_on = false;
+    __dmb();
+    flush_requested = true;
+
+    uint32_t start = time_us_32();
+    while (flush_requested && time_us_32() - start < STREAM_FLUSH_TIMEOUT_US) {
+        tight_loop_contents();
+    }
+}
+
+bool imu_stream_enabled(void) {
+    return stream_on;
+}
+
+void imu_stream_get_stats(uint32_t* sent_out, uint32_t* dropped_out) {
+    if (sent_out) *sent_out = sent;
+    if (dropped_out) *dropped_out = dropped;
+}
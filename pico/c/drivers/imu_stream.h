@@ -0,0 +1,127 @@
+/**
+ * Binary IMU Stream over USB CDC
+ *
+ * Raw ICM-20948 samples and the AHRS output of every loop iteration,
+ * framed as packets on the USB serial port so flight data can be
+ * recorded on a laptop (rpi/c/debug/imu_capture.c, format documented in
+ * documentation/IMU_STREAM.md).
+ *
+ * The AHRS core is the only producer: it appends packets to one of two
+ * RAM buffers and hands the buffer over when it fills. The UI core drains
+ * handed-over buffers to USB from its poll loop. The producer never
+ * blocks; if both buffers are still owned by the UI core the packet is
+ * dropped, and the sequence number gap shows it in the capture.
+ *
+ * Packet layout (little-endian, packed):
+ *   sync[2]   0xA5 0x5A
+ *   type      IMU_STREAM_TYPE_*
+ *   len       payload length in bytes
+ *   seq       packet counter (every packet, including dropped ones)
+ *   payload   ImuStreamInfo or ImuStreamSample
+ *   crc       CRC-16/CCITT-FALSE over type, len, seq and payload
+ *
+ * This header is shared with the host tool, so it only depends on the C
+ * standard library.
+ */
+
+#ifndef IMU_STREAM_H
+#define IMU_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define IMU_STREAM_SYNC0    0xA5
+#define IMU_STREAM_SYNC1    0x5A
+#define IMU_STREAM_VERSION  1
+
+#define IMU_STREAM_TYPE_INFO    1   // Scale factors and calibration (start of stream, then 1 Hz)
+#define IMU_STREAM_TYPE_SAMPLE  2   // One AHRS loop iteration
+
+// Sample flags
+#define IMU_STREAM_FLAG_MAG_FRESH   0x01    // mag[] is a new AK09916 reading
+#define IMU_STREAM_FLAG_MAG_USED    0x02    // Estimator ran the 9-DOF update
+#define IMU_STREAM_FLAG_STATIONARY  0x04    // Adaptive gyro bias was updated
+
+typedef struct __attribute__((packed)) {
+    uint8_t  sync[2];
+    uint8_t  type;
+    uint8_t  len;
+    uint32_t seq;
+} ImuStreamHeader;
+
+typedef struct __attribute__((packed)) {
+    uint16_t version;           // IMU_STREAM_VERSION
+    uint16_t reserved;
+    float    accel_lsb_per_g;   // Raw accel counts per g
+    float    gyro_lsb_per_dps;  // Raw gyro counts per deg/s
+    float    mag_ut_per_lsb;    // Raw magnetometer µT per count
+    float    accel_bias[3];     // Subtracted from accel (g), start-up calibration
+    float    mag_offset[3];     // Hard-iron offset (µT, body frame)
+    float    mag_scale[3];      // Soft-iron scale
+    float    mag_field_ut;      // Calibrated field strength (0 = uncalibrated)
+    char     estimator[8];      // Fusion engine name, NUL padded
+} ImuStreamInfo;
+
+typedef struct __attribute__((packed)) {
+    uint64_t t_us;              // Time since boot of the sensor read
+    int16_t  accel[3];          // Raw accelerometer (chip axes)
+    int16_t  gyro[3];           // Raw gyroscope (chip axes)
+    int16_t  mag[3];            // Raw AK09916 (its own axes: body = X, -Y, -Z)
+    uint8_t  flags;             // IMU_STREAM_FLAG_*
+    uint8_t  reserved;
+    float    roll;              // AHRS output as displayed (deg)
+    float    pitch;             // (deg, nose up positive)
+    float    heading;           // (deg, 0-360)
+    float    gyro_bias[3];      // Current gyro bias estimate (deg/s)
+} ImuStreamSample;
+
+#define IMU_STREAM_CRC_LEN      2
+#define IMU_STREAM_MAX_PACKET   (sizeof(ImuStreamHeader) + sizeof(ImuStreamInfo) + IMU_STREAM_CRC_LEN)
+
+// ── Firmware API ──────────────────────────────────────────────────────────────
+
+/**
+ * Reset buffers and counters (call once before either core uses the stream)
+ */
+void imu_stream_init(void);
+
+/**
+ * Start or stop streaming (UI core). Stopping waits briefly for the
+ * producer to hand over its partly filled buffer; imu_stream_service()
+ * then sends the last samples of the capture.
+ */
+void imu_stream_enable(bool enable);
+
+/**
+ * True while streaming
+ */
+bool imu_stream_enabled(void);
+
+/**
+ * Set the INFO packet contents (producer core only)
+ * Sent when streaming starts and once per second afterwards.
+ */
+void imu_stream_set_info(const ImuStreamInfo* info);
+
+/**
+ * Queue one sample (producer core only, never blocks)
+ */
+void imu_stream_push_sample(const ImuStreamSample* sample);
+
+/**
+ * Hand over the partly filled buffer after streaming was stopped
+ * (producer core, every loop while streaming is off)
+ */
+void imu_stream_producer_flush(void);
+
+/**
+ * Send handed-over buffers to USB (consumer core, from its poll loop)
+ */
+void imu_stream_service(void);
+
+/**
+ * Packets sent and dropped since streaming was last enabled
+ */
+void imu_stream_get_stats(uint32_t* sent, uint32_t* dropped);
+
+#endif // IMU_STREAM_H
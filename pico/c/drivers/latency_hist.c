@@ -0,0 +1,63 @@
+/**
+ * Latency Histogram - Implementation
+ */
+
+#include "latency_hist.h"
+#include <string.h>
+
+void latency_hist_init(LatencyHist* hist, uint32_t bin_us) {
+    hist->bin_us = bin_us > 0 ? bin_us : 1;
+    latency_hist_reset(hist);
+}
+
+void latency_hist_reset(LatencyHist* hist) {
+    uint32_t bin_us = hist->bin_us;
+    memset(hist, 0, sizeof(*hist));
+    hist->bin_us = bin_us;
+    hist->min_us = UINT32_MAX;
+}
+
+void latency_hist_add(LatencyHist* hist, uint32_t latency_us) {
+    uint32_t bin = latency_us / hist->bin_us;
+    if (bin >= LATENCY_HIST_BINS) bin = LATENCY_HIST_BINS - 1;
+    hist->bins[bin]++;
+
+    hist->count++;
+    hist->total_us += latency_us;
+    if (latency_us < hist->min_us) hist->min_us = latency_us;
+    if (latency_us > hist->max_us) hist->max_us = latency_us;
+}
+
+uint32_t latency_hist_percentile(const LatencyHist* hist, float p) {
+    if (hist->count == 0) return 0;
+
+    // Rank of the sample (1-based) that the percentile falls on
+    uint32_t rank = (uint32_t)(p * (float)hist->count + 0.999f);
+    if (rank < 1) rank = 1;
+    if (rank > hist->count) rank = hist->count;
+
+    uint32_t seen = 0;
+    for (uint32_t bin = 0; bin < LATENCY_HIST_BINS; bin++) {
+        seen += hist->bins[bin];
+        if (seen >= rank) {
+            // The open-ended last bin (and any bin holding the maximum) is
+            // better described by the exact maximum
+            uint32_t edge = (bin + 1) * hist->bin_us;
+            return (bin == LATENCY_HIST_BINS - 1 || edge > hist->max_us) ? hist->max_us : edge;
+        }
+    }
+    return hist->max_us;
+}
+
+void latency_hist_summary(const LatencyHist* hist, LatencySummary* out) {
+    memset(out, 0, sizeof(*out));
+    if (hist->count == 0) return;
+
+    out->count = hist->count;
+    out->min_us = hist->min_us;
+    out->max_us = hist->max_us;
+    out->mean_us = (uint32_t)(hist->total_us / hist->count);
+    out->p50_us = latency_hist_percentile(hist, 0.50f);
+    out->p95_us = latency_hist_percentile(hist, 0.95f);
+    out->p99_us = latency_hist_percentile(hist, 0.99f);
+}
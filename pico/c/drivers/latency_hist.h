@@ -0,0 +1,64 @@
+/**
+ * Latency Histogram
+ *
+ * Fixed-width microsecond bins with exact min/max/mean, for sensor-to-
+ * display latency (sample timestamp to the end of the panel transfer).
+ * Percentiles are reported as the upper edge of the bin that holds them,
+ * so they are never optimistic by more than one bin.
+ *
+ * Not thread-safe: record and read from the same thread/core.
+ */
+
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>
+
+#define LATENCY_HIST_BINS 256   // Last bin is open-ended
+
+typedef struct {
+    uint32_t bin_us;
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t bins[LATENCY_HIST_BINS];
+} LatencyHist;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t mean_us;
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t p99_us;
+} LatencySummary;
+
+/**
+ * Initialize empty, with bins bin_us wide (range LATENCY_HIST_BINS * bin_us)
+ */
+void latency_hist_init(LatencyHist* hist, uint32_t bin_us);
+
+/**
+ * Forget all samples (keeps the bin width)
+ */
+void latency_hist_reset(LatencyHist* hist);
+
+/**
+ * Record one latency
+ */
+void latency_hist_add(LatencyHist* hist, uint32_t latency_us);
+
+/**
+ * Latency below which a fraction p (0..1) of the samples fall
+ * Returns 0 when empty.
+ */
+uint32_t latency_hist_percentile(const LatencyHist* hist, float p);
+
+/**
+ * Count, min/max/mean and p50/p95/p99 in one pass
+ */
+void latency_hist_summary(const LatencyHist* hist, LatencySummary* out);
+
+#endif // LATENCY_HIST_H
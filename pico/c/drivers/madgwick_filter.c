@@ -272,29 +272,6 @@ integrate_6dof:
     filter->q.q3 *= recipNorm;
 }
 
-/**
- * Convert quaternion to Euler angles
- */
-void quaternion_to_euler(const Quaternion* q, float* roll, float* pitch, float* yaw) {
-    // Roll (X-axis rotation)
-    float sinr_cosp = 2.0f * (q->q0 * q->q1 + q->q2 * q->q3);
-    float cosr_cosp = 1.0f - 2.0f * (q->q1 * q->q1 + q->q2 * q->q2);
-    *roll = atan2f(sinr_cosp, cosr_cosp);
-
-    // Pitch (Y-axis rotation)
-    float sinp = 2.0f * (q->q0 * q->q2 - q->q3 * q->q1);
-    if (fabsf(sinp) >= 1.0f) {
-        *pitch = copysignf(M_PI / 2.0f, sinp);  // Use 90 degrees if out of range
-    } else {
-        *pitch = asinf(sinp);
-    }
-
-    // Yaw (Z-axis rotation)
-    float siny_cosp = 2.0f * (q->q0 * q->q3 + q->q1 * q->q2);
-    float cosy_cosp = 1.0f - 2.0f * (q->q2 * q->q2 + q->q3 * q->q3);
-    *yaw = atan2f(siny_cosp, cosy_cosp);
-}
-
 /**
  * Helper functions to get angles in degrees
  */
@@ -13,17 +13,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-
-/**
- * Quaternion representation (w, x, y, z)
- * Represents 3D rotation: q = w + xi + yj + zk
- */
-typedef struct {
-    float q0;  // w (scalar part)
-    float q1;  // x (vector i)
-    float q2;  // y (vector j)
-    float q3;  // z (vector k)
-} Quaternion;
+#include "quaternion.h"
 
 /**
  * Madgwick filter state
@@ -79,16 +69,6 @@ void madgwick_update_imu(MadgwickFilter* filter,
                         float gx, float gy, float gz,
                         float ax, float ay, float az);
 
-/**
- * Convert quaternion to Euler angles (roll, pitch, yaw)
- *
- * @param q Pointer to quaternion
- * @param roll Output: roll angle in radians (rotation around X-axis)
- * @param pitch Output: pitch angle in radians (rotation around Y-axis)
- * @param yaw Output: yaw angle in radians (rotation around Z-axis)
- */
-void quaternion_to_euler(const Quaternion* q, float* roll, float* pitch, float* yaw);
-
 /**
  * Get roll angle in degrees
  */
@@ -0,0 +1,139 @@
+/**
+ * Magnetometer Calibration Implementation
+ */
+
+#include "mag_calibration.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Magic number to identify valid calibration data
+#define MAG_CAL_MAGIC   0x4D414743  // "MAGC"
+#define MAG_CAL_VERSION 2           // v1 (archive) had hard-iron offsets only
+
+// Second-to-last flash sector (the last one holds Bluetooth pairing data)
+#define MAG_CAL_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE)
+
+// Compile-time check to ensure calibration data fits in a flash page
+_Static_assert(sizeof(MagCalibration) <= FLASH_PAGE_SIZE,
+               "MagCalibration struct is too large for flash page");
+
+// ── Flash Storage ─────────────────────────────────────────────────────────────
+
+void mag_calibration_identity(MagCalibration* cal) {
+    memset(cal, 0, sizeof(*cal));
+    cal->scale[0] = cal->scale[1] = cal->scale[2] = 1.0f;
+}
+
+bool mag_calibration_load(MagCalibration* cal) {
+    const MagCalibration* flash_cal = (const MagCalibration*)(XIP_BASE + MAG_CAL_FLASH_OFFSET);
+
+    if (flash_cal->magic == MAG_CAL_MAGIC && flash_cal->version == MAG_CAL_VERSION) {
+        memcpy(cal, flash_cal, sizeof(MagCalibration));
+        printf("[MAG] Calibration loaded: offset=(%.1f, %.1f, %.1f) scale=(%.3f, %.3f, %.3f)\n",
+               cal->offset[0], cal->offset[1], cal->offset[2],
+               cal->scale[0], cal->scale[1], cal->scale[2]);
+        return true;
+    }
+
+    printf("[MAG] No valid calibration in flash (magic=0x%08lx)\n", (unsigned long)flash_cal->magic);
+    mag_calibration_identity(cal);
+    return false;
+}
+
+// Runs with the other core parked and interrupts disabled
+static void mag_calibration_flash_write(void* param) {
+    const uint8_t* page = (const uint8_t*)param;
+    flash_range_erase(MAG_CAL_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(MAG_CAL_FLASH_OFFSET, page, FLASH_PAGE_SIZE);
+}
+
+bool mag_calibration_save(const MagCalibration* cal) {
+    uint8_t page[FLASH_PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, cal, sizeof(MagCalibration));
+
+    int rc = flash_safe_execute(mag_calibration_flash_write, page, 100);
+    if (rc != PICO_OK) {
+        printf("[MAG] ERROR: Flash write failed (%d)\n", rc);
+        return false;
+    }
+
+    // Verify the write by reading back
+    const MagCalibration* flash_cal = (const MagCalibration*)(XIP_BASE + MAG_CAL_FLASH_OFFSET);
+    if (memcmp(flash_cal, cal, sizeof(MagCalibration)) != 0) {
+        printf("[MAG] ERROR: Flash verification failed!\n");
+        return false;
+    }
+
+    printf("[MAG] Calibration saved and verified in flash\n");
+    return true;
+}
+
+// ── Correction ────────────────────────────────────────────────────────────────
+
+void mag_calibration_apply(const MagCalibration* cal, float* mx, float* my, float* mz) {
+    *mx = (*mx - cal->offset[0]) * cal->scale[0];
+    *my = (*my - cal->offset[1]) * cal->scale[1];
+    *mz = (*mz - cal->offset[2]) * cal->scale[2];
+}
+
+// ── Envelope Collection ───────────────────────────────────────────────────────
+
+void mag_cal_collect_reset(MagCalCollector* col) {
+    for (int i = 0; i < 3; i++) {
+        col->min[i] = 1000.0f;
+        col->max[i] = -1000.0f;
+    }
+    col->samples = 0;
+}
+
+void mag_cal_collect_add(MagCalCollector* col, float mx, float my, float mz) {
+    float m[3] = {mx, my, mz};
+    for (int i = 0; i < 3; i++) {
+        if (!isfinite(m[i])) return;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (m[i] < col->min[i]) col->min[i] = m[i];
+        if (m[i] > col->max[i]) col->max[i] = m[i];
+    }
+    col->samples++;
+}
+
+bool mag_cal_collect_finish(const MagCalCollector* col, MagCalibration* cal) {
+    if (col->samples < MAG_CAL_MIN_SAMPLES) {
+        printf("[MAG] Calibration rejected: %lu samples (need %d)\n",
+               (unsigned long)col->samples, MAG_CAL_MIN_SAMPLES);
+        return false;
+    }
+
+    float radius[3];
+    for (int i = 0; i < 3; i++) {
+        float span = col->max[i] - col->min[i];
+        if (span < MAG_CAL_MIN_SPAN_UT) {
+            printf("[MAG] Calibration rejected: axis %d span %.1f uT\n", i, span);
+            return false;
+        }
+        radius[i] = span * 0.5f;
+    }
+
+    // Hard iron: envelope center. Soft iron: stretch each axis to the mean radius.
+    float mean_radius = (radius[0] + radius[1] + radius[2]) / 3.0f;
+
+    mag_calibration_identity(cal);
+    cal->magic = MAG_CAL_MAGIC;
+    cal->version = MAG_CAL_VERSION;
+    for (int i = 0; i < 3; i++) {
+        cal->offset[i] = (col->min[i] + col->max[i]) * 0.5f;
+        cal->scale[i] = mean_radius / radius[i];
+    }
+    cal->field_ut = mean_radius;
+
+    printf("[MAG] Calibration: offset=(%.1f, %.1f, %.1f) scale=(%.3f, %.3f, %.3f) field=%.1fuT\n",
+           cal->offset[0], cal->offset[1], cal->offset[2],
+           cal->scale[0], cal->scale[1], cal->scale[2], cal->field_ut);
+    return true;
+}
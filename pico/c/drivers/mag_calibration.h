@@ -0,0 +1,82 @@
+/**
+ * Magnetometer Calibration for ICM-20948 (AK09916)
+ *
+ * Hard-iron offsets plus a diagonal soft-iron scale, estimated from the
+ * min/max envelope seen while the device is rotated through all
+ * orientations. Stored in flash so it persists across reboots.
+ *
+ * Ported from the old joystick firmware (archive/old_joystick_system);
+ * sample collection is now driven by the AHRS core instead of a blocking
+ * UI loop, and soft-iron scaling was added.
+ */
+
+#ifndef MAG_CALIBRATION_H
+#define MAG_CALIBRATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Minimum samples and per-axis span before a calibration is accepted
+#define MAG_CAL_MIN_SAMPLES  300     // 3 s at 100 Hz
+#define MAG_CAL_MIN_SPAN_UT  30.0f   // Earth field is ~25-65 µT, so a full turn spans 50+
+
+// Magnetometer calibration data
+// Magic number must be first for easier verification
+// Packed attribute ensures stable layout across compiler versions
+typedef struct __attribute__((packed)) {
+    uint32_t magic;      // MAG_CAL_MAGIC when valid (must be first)
+    uint32_t version;    // Layout version
+    float offset[3];     // Hard-iron offset (µT), subtracted first
+    float scale[3];      // Soft-iron scale (unitless), applied after offset
+    float field_ut;      // Mean field strength after correction (µT)
+} MagCalibration;
+
+// Running min/max envelope while calibrating
+typedef struct {
+    float min[3];
+    float max[3];
+    uint32_t samples;
+} MagCalCollector;
+
+/**
+ * Load calibration from flash
+ * Returns true if a valid calibration was found (cal is then filled),
+ * false otherwise (cal is set to identity)
+ */
+bool mag_calibration_load(MagCalibration* cal);
+
+/**
+ * Save calibration to flash
+ * Safe to call while the AHRS core runs (uses flash_safe_execute, which
+ * briefly parks the other core).
+ * Returns true on success, false on failure
+ */
+bool mag_calibration_save(const MagCalibration* cal);
+
+/**
+ * Set calibration to identity (no offset, unit scale, invalid magic)
+ */
+void mag_calibration_identity(MagCalibration* cal);
+
+/**
+ * Apply calibration to a magnetometer sample (µT, in place)
+ */
+void mag_calibration_apply(const MagCalibration* cal, float* mx, float* my, float* mz);
+
+/**
+ * Reset the envelope collector
+ */
+void mag_cal_collect_reset(MagCalCollector* col);
+
+/**
+ * Add one magnetometer sample (µT) to the envelope
+ */
+void mag_cal_collect_add(MagCalCollector* col, float mx, float my, float mz);
+
+/**
+ * Compute calibration from the collected envelope
+ * Returns false if there are too few samples or an axis was not covered
+ */
+bool mag_cal_collect_finish(const MagCalCollector* col, MagCalibration* cal);
+
+#endif // MAG_CALIBRATION_H
@@ -0,0 +1,175 @@
+/**
+ * Mahony AHRS Filter Implementation
+ */
+
+#include "mahony_filter.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Largest gyro bias the integral term may absorb (rad/s, ~6 deg/s)
+#define MAHONY_INTEGRAL_LIMIT 0.1f
+
+static float inv_sqrt(float x) {
+    if (x <= 1e-20f || !isfinite(x)) {
+        return 0.0f;
+    }
+    return 1.0f / sqrtf(x);
+}
+
+/**
+ * Initialize Mahony filter
+ */
+void mahony_init(MahonyFilter* filter, float sample_freq, float kp, float ki) {
+    quaternion_identity(&filter->q);
+    filter->kp = kp;
+    filter->ki = ki;
+    filter->integral[0] = 0.0f;
+    filter->integral[1] = 0.0f;
+    filter->integral[2] = 0.0f;
+    filter->sample_freq = sample_freq;
+    filter->inv_sample_freq = 1.0f / sample_freq;
+}
+
+// PI feedback of the direction error e (sensor frame), then integrate the rate
+static void mahony_feedback_integrate(MahonyFilter* filter,
+                                      float gx, float gy, float gz,
+                                      float ex, float ey, float ez,
+                                      bool have_error) {
+    const float dt = filter->inv_sample_freq;
+
+    if (have_error) {
+        if (filter->ki > 0.0f) {
+            const float e[3] = {ex, ey, ez};
+            for (int i = 0; i < 3; i++) {
+                float v = filter->integral[i] + filter->ki * e[i] * dt;
+                if (v > MAHONY_INTEGRAL_LIMIT) v = MAHONY_INTEGRAL_LIMIT;
+                if (v < -MAHONY_INTEGRAL_LIMIT) v = -MAHONY_INTEGRAL_LIMIT;
+                filter->integral[i] = v;
+            }
+        }
+        gx += filter->kp * ex;
+        gy += filter->kp * ey;
+        gz += filter->kp * ez;
+    }
+    gx += filter->integral[0];
+    gy += filter->integral[1];
+    gz += filter->integral[2];
+
+    // Integrate rate of change of quaternion
+    gx *= 0.5f * dt;
+    gy *= 0.5f * dt;
+    gz *= 0.5f * dt;
+    float qa = filter->q.q0, qb = filter->q.q1, qc = filter->q.q2;
+    filter->q.q0 += -qb * gx - qc * gy - filter->q.q3 * gz;
+    filter->q.q1 += qa * gx + qc * gz - filter->q.q3 * gy;
+    filter->q.q2 += qa * gy - qb * gz + filter->q.q3 * gx;
+    filter->q.q3 += qa * gz + qb * gy - qc * gx;
+
+    quaternion_normalize(&filter->q);
+}
+
+/**
+ * Update filter with 9-DOF sensor data (accel + gyro + mag)
+ */
+void mahony_update(MahonyFilter* filter,
+                   float gx, float gy, float gz,
+                   float ax, float ay, float az,
+                   float mx, float my, float mz) {
+    // Use IMU algorithm if magnetometer measurement invalid
+    if ((mx == 0.0f) && (my == 0.0f) && (mz == 0.0f)) {
+        mahony_update_imu(filter, gx, gy, gz, ax, ay, az);
+        return;
+    }
+
+    float recipNorm = inv_sqrt(ax * ax + ay * ay + az * az);
+    float recipNormM = inv_sqrt(mx * mx + my * my + mz * mz);
+    if (recipNorm == 0.0f || recipNormM == 0.0f) {
+        mahony_feedback_integrate(filter, gx, gy, gz, 0.0f, 0.0f, 0.0f, false);
+        return;
+    }
+    ax *= recipNorm;
+    ay *= recipNorm;
+    az *= recipNorm;
+    mx *= recipNormM;
+    my *= recipNormM;
+    mz *= recipNormM;
+
+    const float q0 = filter->q.q0, q1 = filter->q.q1, q2 = filter->q.q2, q3 = filter->q.q3;
+    float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+    float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+    float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+    // Reference direction of Earth's magnetic field (horizontal part on X)
+    float hx = 2.0f * (mx * (0.5f - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+    float hy = 2.0f * (mx * (q1q2 + q0q3) + my * (0.5f - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+    float bx = sqrtf(hx * hx + hy * hy);
+    float bz = 2.0f * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5f - q1q1 - q2q2));
+
+    // Predicted gravity and field directions in the sensor frame
+    float vx = 2.0f * (q1q3 - q0q2);
+    float vy = 2.0f * (q0q1 + q2q3);
+    float vz = q0q0 - q1q1 - q2q2 + q3q3;
+    float wx = 2.0f * (bx * (0.5f - q2q2 - q3q3) + bz * (q1q3 - q0q2));
+    float wy = 2.0f * (bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3));
+    float wz = 2.0f * (bx * (q0q2 + q1q3) + bz * (0.5f - q1q1 - q2q2));
+
+    // Error is the sum of cross products between measured and predicted directions
+    float ex = (ay * vz - az * vy) + (my * wz - mz * wy);
+    float ey = (az * vx - ax * vz) + (mz * wx - mx * wz);
+    float ez = (ax * vy - ay * vx) + (mx * wy - my * wx);
+
+    mahony_feedback_integrate(filter, gx, gy, gz, ex, ey, ez, true);
+}
+
+/**
+ * Update filter with 6-DOF sensor data (accel + gyro, no mag)
+ */
+void mahony_update_imu(MahonyFilter* filter,
+                       float gx, float gy, float gz,
+                       float ax, float ay, float az) {
+    float recipNorm = inv_sqrt(ax * ax + ay * ay + az * az);
+    if (recipNorm == 0.0f) {
+        mahony_feedback_integrate(filter, gx, gy, gz, 0.0f, 0.0f, 0.0f, false);
+        return;
+    }
+    ax *= recipNorm;
+    ay *= recipNorm;
+    az *= recipNorm;
+
+    const float q0 = filter->q.q0, q1 = filter->q.q1, q2 = filter->q.q2, q3 = filter->q.q3;
+
+    // Predicted gravity direction in the sensor frame
+    float vx = 2.0f * (q1 * q3 - q0 * q2);
+    float vy = 2.0f * (q0 * q1 + q2 * q3);
+    float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+    float ex = ay * vz - az * vy;
+    float ey = az * vx - ax * vz;
+    float ez = ax * vy - ay * vx;
+
+    mahony_feedback_integrate(filter, gx, gy, gz, ex, ey, ez, true);
+}
+
+/**
+ * Helper functions to get angles in degrees
+ */
+float mahony_get_roll_deg(const MahonyFilter* filter) {
+    float roll, pitch, yaw;
+    quaternion_to_euler(&filter->q, &roll, &pitch, &yaw);
+    return roll * 180.0f / M_PI;
+}
+
+float mahony_get_pitch_deg(const MahonyFilter* filter) {
+    float roll, pitch, yaw;
+    quaternion_to_euler(&filter->q, &roll, &pitch, &yaw);
+    return pitch * 180.0f / M_PI;
+}
+
+float mahony_get_yaw_deg(const MahonyFilter* filter) {
+    float roll, pitch, yaw;
+    quaternion_to_euler(&filter->q, &roll, &pitch, &yaw);
+    return yaw * 180.0f / M_PI;
+}
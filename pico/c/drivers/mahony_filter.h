@@ -0,0 +1,75 @@
+/**
+ * Mahony AHRS Filter
+ *
+ * Nonlinear complementary filter on SO(3): the cross product between the
+ * measured and predicted gravity (and magnetic field) directions is fed
+ * back into the gyro rate through a PI controller. The integral term
+ * tracks residual gyro bias. Cheaper than Madgwick (no gradient step).
+ *
+ * Reference: R. Mahony, T. Hamel, J.-M. Pflimlin, "Nonlinear Complementary
+ * Filters on the Special Orthogonal Group," IEEE TAC 53(5), 2008.
+ */
+
+#ifndef MAHONY_FILTER_H
+#define MAHONY_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "quaternion.h"
+
+/**
+ * Mahony filter state
+ */
+typedef struct {
+    Quaternion q;           // Current orientation quaternion
+    float kp;               // Proportional gain (rad/s per unit error)
+    float ki;               // Integral gain (bias tracking), 0 disables
+    float integral[3];      // Integrated error (rad/s), subtracted bias estimate
+    float sample_freq;      // Sampling frequency (Hz)
+    float inv_sample_freq;  // 1 / sample_freq (cached for performance)
+} MahonyFilter;
+
+/**
+ * Initialize Mahony filter
+ *
+ * @param filter Pointer to filter structure
+ * @param sample_freq Sampling frequency in Hz (e.g., 200.0)
+ * @param kp Proportional gain (typical 0.5). Higher = faster convergence, more noise.
+ * @param ki Integral gain (typical 0.0-0.05). Non-zero estimates gyro bias.
+ */
+void mahony_init(MahonyFilter* filter, float sample_freq, float kp, float ki);
+
+/**
+ * Update filter with 9-DOF sensor data
+ * Gyroscope in rad/s, accelerometer in g, magnetometer in µT.
+ * An all-zero magnetometer sample falls back to the 6-DOF update.
+ */
+void mahony_update(MahonyFilter* filter,
+                   float gx, float gy, float gz,
+                   float ax, float ay, float az,
+                   float mx, float my, float mz);
+
+/**
+ * Update filter with 6-DOF sensor data (no magnetometer)
+ * Yaw will drift over time without magnetometer correction.
+ */
+void mahony_update_imu(MahonyFilter* filter,
+                       float gx, float gy, float gz,
+                       float ax, float ay, float az);
+
+/**
+ * Get roll angle in degrees
+ */
+float mahony_get_roll_deg(const MahonyFilter* filter);
+
+/**
+ * Get pitch angle in degrees
+ */
+float mahony_get_pitch_deg(const MahonyFilter* filter);
+
+/**
+ * Get yaw angle in degrees (heading)
+ */
+float mahony_get_yaw_deg(const MahonyFilter* filter);
+
+#endif // MAHONY_FILTER_H
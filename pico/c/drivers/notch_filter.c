@@ -0,0 +1,248 @@
+/**
+ * Biquad / Notch Filter Bank Implementation
+ */
+
+#include "notch_filter.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ANF pole radius: bandwidth of the tracker ~ (1 - rho) * fs / pi
+#define ANF_RHO     0.95f
+#define ANF_RHO2    (ANF_RHO * ANF_RHO)
+
+// Power estimator smoothing (per sample)
+#define POWER_ALPHA 0.01f
+
+// Highest usable notch frequency as a fraction of the sample rate
+#define NYQUIST_MARGIN 0.45f
+
+// ── Biquad Design (RBJ Audio EQ Cookbook) ─────────────────────────────────────
+
+static void biquad_set_coeffs(Biquad* bq, float b0, float b1, float b2,
+                              float a0, float a1, float a2) {
+    float inv = 1.0f / a0;
+    bq->b0 = b0 * inv;
+    bq->b1 = b1 * inv;
+    bq->b2 = b2 * inv;
+    bq->a1 = a1 * inv;
+    bq->a2 = a2 * inv;
+}
+
+static void biquad_set_passthrough(Biquad* bq) {
+    bq->b0 = 1.0f;
+    bq->b1 = bq->b2 = bq->a1 = bq->a2 = 0.0f;
+}
+
+void biquad_reset(Biquad* bq) {
+    bq->x1 = bq->x2 = bq->y1 = bq->y2 = 0.0f;
+}
+
+void biquad_set_notch(Biquad* bq, float sample_freq, float center_hz, float q) {
+    float w0 = 2.0f * (float)M_PI * center_hz / sample_freq;
+    float c = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    biquad_set_coeffs(bq, 1.0f, -2.0f * c, 1.0f, 1.0f + alpha, -2.0f * c, 1.0f - alpha);
+}
+
+void biquad_set_lowpass(Biquad* bq, float sample_freq, float cutoff_hz, float q) {
+    float w0 = 2.0f * (float)M_PI * cutoff_hz / sample_freq;
+    float c = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    biquad_set_coeffs(bq, (1.0f - c) * 0.5f, 1.0f - c, (1.0f - c) * 0.5f,
+                      1.0f + alpha, -2.0f * c, 1.0f - alpha);
+}
+
+void biquad_set_highpass(Biquad* bq, float sample_freq, float cutoff_hz, float q) {
+    float w0 = 2.0f * (float)M_PI * cutoff_hz / sample_freq;
+    float c = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    biquad_set_coeffs(bq, (1.0f + c) * 0.5f, -(1.0f + c), (1.0f + c) * 0.5f,
+                      1.0f + alpha, -2.0f * c, 1.0f - alpha);
+}
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+// Tracker coefficient a = -2cos(w0) for a frequency in Hz
+static float hz_to_a(float hz, float sample_freq) {
+    return -2.0f * cosf(2.0f * (float)M_PI * hz / sample_freq);
+}
+
+static float clampf(float v, float lo, float hi) {
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+// Re-tune the notch stages of one channel from cos(w0) without trig:
+// cos(k*w0) by Chebyshev recurrence, sin from sqrt(1 - cos^2)
+static void retune_notches(NotchFilterBank* bank, int ch, float a) {
+    float c1 = -0.5f * a;
+    float c_prev = 1.0f;
+    float c_k = c1;
+
+    for (int k = 0; k < bank->cfg.harmonics; k++) {
+        Biquad* bq = &bank->notch[ch][k];
+
+        if (a > bank->harmonic_a_max[k]) {
+            biquad_set_passthrough(bq);
+        } else {
+            float s2 = 1.0f - c_k * c_k;
+            float s = s2 > 0.0f ? sqrtf(s2) : 0.0f;
+            float alpha = s * bank->alpha_scale;
+            float inv = 1.0f / (1.0f + alpha);
+            bq->b0 = inv;
+            bq->b1 = -2.0f * c_k * inv;
+            bq->b2 = inv;
+            bq->a1 = bq->b1;
+            bq->a2 = (1.0f - alpha) * inv;
+        }
+
+        float c_next = 2.0f * c1 * c_k - c_prev;
+        c_prev = c_k;
+        c_k = c_next;
+    }
+}
+
+static void update_limits(NotchFilterBank* bank) {
+    NotchConfig* cfg = &bank->cfg;
+    float nyq = NYQUIST_MARGIN * cfg->sample_freq;
+
+    float max_hz = cfg->max_hz < nyq ? cfg->max_hz : nyq;
+    float min_hz = cfg->min_hz < max_hz ? cfg->min_hz : max_hz * 0.5f;
+
+    for (int k = 0; k < NOTCH_MAX_HARMONICS; k++) {
+        bank->harmonic_a_max[k] = hz_to_a(nyq / (float)(k + 1), cfg->sample_freq);
+    }
+
+    for (int ch = 0; ch < cfg->channels; ch++) {
+        VibrationTracker* t = &bank->tracker[ch];
+        t->a_lo = hz_to_a(min_hz, cfg->sample_freq);
+        t->a_hi = hz_to_a(max_hz, cfg->sample_freq);
+        biquad_set_highpass(&t->highpass, cfg->sample_freq, min_hz * 0.5f, 0.707f);
+
+        if (cfg->lowpass_hz > 0.0f && cfg->lowpass_hz < nyq) {
+            biquad_set_lowpass(&bank->lowpass[ch], cfg->sample_freq, cfg->lowpass_hz, 0.707f);
+        } else {
+            biquad_set_passthrough(&bank->lowpass[ch]);
+        }
+    }
+}
+
+// ── Public API ────────────────────────────────────────────────────────────────
+
+void notch_default_config(NotchConfig* cfg, uint8_t channels, float sample_freq) {
+    cfg->channels = channels;
+    cfg->harmonics = 2;
+    cfg->tracking = true;
+    cfg->sample_freq = sample_freq;
+    cfg->center_hz = 40.0f;
+    cfg->min_hz = 20.0f;
+    cfg->max_hz = NYQUIST_MARGIN * sample_freq;
+    cfg->q = 3.0f;
+    cfg->lowpass_hz = 0.0f;
+    cfg->tracker_rate = 0.01f;
+    cfg->min_level = 0.0f;
+}
+
+void notch_bank_init(NotchFilterBank* bank, const NotchConfig* cfg) {
+    memset(bank, 0, sizeof(*bank));
+    bank->cfg = *cfg;
+
+    if (bank->cfg.channels > NOTCH_MAX_CHANNELS) bank->cfg.channels = NOTCH_MAX_CHANNELS;
+    if (bank->cfg.harmonics < 1) bank->cfg.harmonics = 1;
+    if (bank->cfg.harmonics > NOTCH_MAX_HARMONICS) bank->cfg.harmonics = NOTCH_MAX_HARMONICS;
+    if (bank->cfg.q < 0.5f) bank->cfg.q = 0.5f;
+
+    bank->alpha_scale = 1.0f / (2.0f * bank->cfg.q);
+    update_limits(bank);
+
+    for (int ch = 0; ch < bank->cfg.channels; ch++) {
+        VibrationTracker* t = &bank->tracker[ch];
+        t->a = clampf(hz_to_a(bank->cfg.center_hz, bank->cfg.sample_freq), t->a_lo, t->a_hi);
+        retune_notches(bank, ch, t->a);
+    }
+}
+
+void notch_bank_set_sample_rate(NotchFilterBank* bank, float sample_freq) {
+    if (!(sample_freq > 0.0f)) return;
+
+    float old_freq = bank->cfg.sample_freq;
+    bank->cfg.sample_freq = sample_freq;
+    update_limits(bank);
+
+    for (int ch = 0; ch < bank->cfg.channels; ch++) {
+        VibrationTracker* t = &bank->tracker[ch];
+        float w0 = acosf(clampf(-0.5f * t->a, -1.0f, 1.0f));
+        float hz = w0 * old_freq / (2.0f * (float)M_PI);
+        t->a = clampf(hz_to_a(hz, sample_freq), t->a_lo, t->a_hi);
+        retune_notches(bank, ch, t->a);
+    }
+}
+
+void notch_bank_apply(NotchFilterBank* bank, float* samples) {
+    const NotchConfig* cfg = &bank->cfg;
+
+    for (int ch = 0; ch < cfg->channels; ch++) {
+        VibrationTracker* t = &bank->tracker[ch];
+        float in = samples[ch];
+
+        if (cfg->tracking) {
+            // Constrained adaptive notch: s = x / (1 + rho*a*z^-1 + rho^2*z^-2),
+            // e = s * (1 + a*z^-1 + z^-2); minimize e^2 w.r.t. a (NLMS)
+            float x = biquad_process(&t->highpass, in);
+            float s = x - ANF_RHO * t->a * t->s1 - ANF_RHO2 * t->s2;
+            float e = s + t->a * t->s1 + t->s2;
+
+            t->level += POWER_ALPHA * (x * x - t->level);
+            t->power += POWER_ALPHA * (t->s1 * t->s1 - t->power);
+
+            if (t->level > cfg->min_level) {
+                t->a -= cfg->tracker_rate * e * t->s1 / (t->power + 1e-9f);
+                t->a = clampf(t->a, t->a_lo, t->a_hi);
+            }
+
+            t->s2 = t->s1;
+            t->s1 = s;
+
+            if (!isfinite(t->a) || !isfinite(t->s1)) {
+                t->a = hz_to_a(cfg->center_hz, cfg->sample_freq);
+                t->s1 = t->s2 = t->power = t->level = 0.0f;
+                biquad_reset(&t->highpass);
+            }
+
+            retune_notches(bank, ch, t->a);
+        }
+
+        float y = in;
+        for (int k = 0; k < cfg->harmonics; k++) {
+            y = biquad_process(&bank->notch[ch][k], y);
+        }
+        samples[ch] = biquad_process(&bank->lowpass[ch], y);
+    }
+}
+
+float notch_bank_get_freq_hz(const NotchFilterBank* bank, int channel) {
+    if (channel < 0 || channel >= bank->cfg.channels) return 0.0f;
+
+    float c = clampf(-0.5f * bank->tracker[channel].a, -1.0f, 1.0f);
+    return acosf(c) * bank->cfg.sample_freq / (2.0f * (float)M_PI);
+}
+
+int notch_bank_dominant(const NotchFilterBank* bank, float* freq_hz) {
+    int best = -1;
+    float best_level = bank->cfg.min_level;
+
+    for (int ch = 0; ch < bank->cfg.channels; ch++) {
+        if (bank->tracker[ch].level > best_level) {
+            best_level = bank->tracker[ch].level;
+            best = ch;
+        }
+    }
+
+    if (freq_hz) *freq_hz = best >= 0 ? notch_bank_get_freq_hz(bank, best) : 0.0f;
+    return best;
+}
@@ -0,0 +1,158 @@
+/**
+ * Biquad / Notch Filter Bank with Vibration Frequency Tracking
+ *
+ * Removes narrow-band engine and propeller vibration from IMU channels
+ * before they reach the attitude filter. Each channel runs:
+ *
+ *   input -> [tracker] -> notch (fundamental) -> notch (harmonics) -> [low-pass] -> output
+ *
+ * The tracker is a constrained adaptive notch filter (Nehorai, 1985) that
+ * follows the dominant vibration frequency of the channel with a normalized
+ * LMS update. The notch stages are re-tuned from the tracker every sample
+ * using only sqrt/div (no trig), so the per-sample cost is fixed and
+ * identical on the Cortex-M33 and on the Raspberry Pi.
+ *
+ * Portable C, no platform headers - shared by the Pico firmware and the
+ * Raspberry Pi application.
+ */
+
+#ifndef NOTCH_FILTER_H
+#define NOTCH_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NOTCH_MAX_CHANNELS  6   // accel XYZ + gyro XYZ
+#define NOTCH_MAX_HARMONICS 3   // fundamental + 2 harmonics
+
+/**
+ * Direct Form I biquad section
+ * Coefficients are normalized (a0 = 1). DF-I keeps the state well-behaved
+ * when coefficients change between samples.
+ */
+typedef struct {
+    float b0, b1, b2;
+    float a1, a2;
+    float x1, x2;
+    float y1, y2;
+} Biquad;
+
+/**
+ * Adaptive frequency tracker state (one per channel)
+ */
+typedef struct {
+    Biquad highpass;        // Removes attitude motion below the tracking band
+    float a;                // -2*cos(w0), w0 = tracked normalized frequency
+    float a_lo, a_hi;       // Clamp range for a (from min_hz / max_hz)
+    float s1, s2;           // ANF internal states
+    float power;            // Running power of s1 (NLMS normalization)
+    float level;            // Running power of the band-limited input
+} VibrationTracker;
+
+/**
+ * Filter bank configuration
+ */
+typedef struct {
+    uint8_t channels;       // Number of channels (<= NOTCH_MAX_CHANNELS)
+    uint8_t harmonics;      // Notches per channel (1..NOTCH_MAX_HARMONICS)
+    bool tracking;          // true = follow vibration, false = fixed center_hz
+    float sample_freq;      // Sample rate (Hz)
+    float center_hz;        // Initial / fixed notch frequency (Hz)
+    float min_hz;           // Lowest frequency the tracker may follow (Hz)
+    float max_hz;           // Highest frequency the tracker may follow (Hz)
+    float q;                // Notch quality factor (higher = narrower)
+    float lowpass_hz;       // Optional post low-pass cutoff (0 = disabled)
+    float tracker_rate;     // NLMS step size (0.001 - 0.05 typical)
+    float min_level;        // In-band power below which trackers hold frequency
+} NotchConfig;
+
+/**
+ * Filter bank state
+ */
+typedef struct {
+    NotchConfig cfg;
+    VibrationTracker tracker[NOTCH_MAX_CHANNELS];
+    Biquad notch[NOTCH_MAX_CHANNELS][NOTCH_MAX_HARMONICS];
+    Biquad lowpass[NOTCH_MAX_CHANNELS];
+    float alpha_scale;      // 1 / (2Q), cached for per-sample re-tuning
+    float harmonic_a_max[NOTCH_MAX_HARMONICS];  // Tracker a above which harmonic k passes through
+} NotchFilterBank;
+
+/**
+ * Configure a biquad as an RBJ notch
+ *
+ * @param bq Biquad section
+ * @param sample_freq Sample rate (Hz)
+ * @param center_hz Notch center frequency (Hz)
+ * @param q Quality factor
+ */
+void biquad_set_notch(Biquad* bq, float sample_freq, float center_hz, float q);
+
+/**
+ * Configure a biquad as an RBJ low-pass
+ */
+void biquad_set_lowpass(Biquad* bq, float sample_freq, float cutoff_hz, float q);
+
+/**
+ * Configure a biquad as an RBJ high-pass
+ */
+void biquad_set_highpass(Biquad* bq, float sample_freq, float cutoff_hz, float q);
+
+/**
+ * Clear biquad history (coefficients are kept)
+ */
+void biquad_reset(Biquad* bq);
+
+/**
+ * Filter one sample
+ */
+static inline float biquad_process(Biquad* bq, float x) {
+    float y = bq->b0 * x + bq->b1 * bq->x1 + bq->b2 * bq->x2
+            - bq->a1 * bq->y1 - bq->a2 * bq->y2;
+    bq->x2 = bq->x1;
+    bq->x1 = x;
+    bq->y2 = bq->y1;
+    bq->y1 = y;
+    return y;
+}
+
+/**
+ * Fill a configuration with sensible defaults for the given sample rate
+ * (single tracked notch + first harmonic, 20 Hz up to 0.45 * sample_freq)
+ */
+void notch_default_config(NotchConfig* cfg, uint8_t channels, float sample_freq);
+
+/**
+ * Initialize filter bank
+ *
+ * @param bank Filter bank
+ * @param cfg Configuration (copied)
+ */
+void notch_bank_init(NotchFilterBank* bank, const NotchConfig* cfg);
+
+/**
+ * Change sample rate (e.g. after measuring the real loop rate).
+ * Tracked frequencies are preserved in Hz; filter history is kept.
+ */
+void notch_bank_set_sample_rate(NotchFilterBank* bank, float sample_freq);
+
+/**
+ * Filter one sample of every channel in place
+ *
+ * @param bank Filter bank
+ * @param samples Array of cfg.channels values
+ */
+void notch_bank_apply(NotchFilterBank* bank, float* samples);
+
+/**
+ * Get the frequency currently tracked on a channel (Hz)
+ */
+float notch_bank_get_freq_hz(const NotchFilterBank* bank, int channel);
+
+/**
+ * Get the channel with the strongest vibration and its frequency (Hz).
+ * Returns the channel index, or -1 if no channel exceeds min_level.
+ */
+int notch_bank_dominant(const NotchFilterBank* bank, float* freq_hz);
+
+#endif // NOTCH_FILTER_H
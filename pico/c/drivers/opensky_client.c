@@ -15,10 +15,6 @@
 #define RESP_BUF_SIZE 16384
 #define FETCH_TIMEOUT_MS 10000
 
-// Bounding box half-width in degrees (~26 km radius)
-#define BOX_LAT  0.23
-#define BOX_LON  0.30
-
 typedef enum {
     CS_DNS,
     CS_CONNECTING,
@@ -155,7 +151,10 @@ static bool json_arr_field(const char *arr, int idx, char *out, int out_size) {
     return false;
 }
 
-static int parse_opensky_response(const char *resp, TelemetryData *td) {
+// Fills td->traffic[] with the first MAX_TRAFFIC targets; every target goes
+// into tracks (when given). Returns the number stored in td.
+static int parse_opensky_response(const char *resp, TelemetryData *td,
+                                  TrackTable *tracks, uint32_t now_ms, int *total) {
     // Skip HTTP headers
     const char *body = strstr(resp, "\r\n\r\n");
     if (!body) return 0;
@@ -170,8 +169,9 @@ static int parse_opensky_response(const char *resp, TelemetryData *td) {
 
     int count = 0;
     const char *p = states;
+    *total = 0;
 
-    while (*p && count < MAX_TRAFFIC) {
+    while (*p && (count < MAX_TRAFFIC || tracks)) {
         // Find next state entry '['
         while (*p && *p != '[' && *p != ']') p++;
         if (!*p || *p == ']') break;
@@ -192,6 +192,10 @@ static int parse_opensky_response(const char *resp, TelemetryData *td) {
         TrafficData td_tmp = {0};
         char fld[32];
 
+        // Field 0: icao24 (hex transponder address)
+        if (json_arr_field(entry, 0, fld, sizeof(fld)))
+            td_tmp.icao24 = track_parse_icao24(fld);
+
         // Field 1: callsign
         if (!json_arr_field(entry, 1, fld, sizeof(fld))) { p = end + 1; continue; }
         // Trim trailing spaces
@@ -202,26 +206,34 @@ static int parse_opensky_response(const char *resp, TelemetryData *td) {
         // Field 5: longitude
         if (!json_arr_field(entry, 5, fld, sizeof(fld))) { p = end + 1; continue; }
         if (strcmp(fld, "null") == 0) { p = end + 1; continue; }
-        td_tmp.lon = atof(fld);
+        td_tmp.lon = geo_deg_to_udeg(atof(fld));
 
         // Field 6: latitude
         if (!json_arr_field(entry, 6, fld, sizeof(fld))) { p = end + 1; continue; }
         if (strcmp(fld, "null") == 0) { p = end + 1; continue; }
-        td_tmp.lat = atof(fld);
+        td_tmp.lat = geo_deg_to_udeg(atof(fld));
 
         // Field 7: baro_altitude (meters → feet)
         if (json_arr_field(entry, 7, fld, sizeof(fld)) && strcmp(fld, "null") != 0)
-            td_tmp.alt = atof(fld) * 3.28084;
+            td_tmp.alt = geo_ft_to_alt((float)atof(fld) * 3.28084f);
 
         // Field 9: velocity (m/s → knots)
         if (json_arr_field(entry, 9, fld, sizeof(fld)) && strcmp(fld, "null") != 0)
-            td_tmp.speed = atof(fld) * 1.944;
+            td_tmp.speed = geo_kt_to_speed((float)atof(fld) * 1.94384f);
 
         // Field 10: true_track (heading degrees)
         if (json_arr_field(entry, 10, fld, sizeof(fld)) && strcmp(fld, "null") != 0)
-            td_tmp.heading = atof(fld);
-
-        td->traffic[count++] = td_tmp;
+            td_tmp.heading = geo_deg_to_heading((float)atof(fld));
+
+        if (tracks && td_tmp.icao24) {
+            TrackState st = {
+                .lat = td_tmp.lat, .lon = td_tmp.lon, .alt = td_tmp.alt,
+                .speed_kt = td_tmp.speed, .heading = td_tmp.heading,
+            };
+            track_table_update(tracks, td_tmp.icao24, td_tmp.id, &st, now_ms);
+        }
+        if (count < MAX_TRAFFIC) td->traffic[count++] = td_tmp;
+        (*total)++;
         p = end + 1;
     }
 
@@ -230,10 +242,12 @@ static int parse_opensky_response(const char *resp, TelemetryData *td) {
 
 // ── Public API ────────────────────────────────────────────────────────────────
 
-bool opensky_fetch(double lat, double lon, TelemetryData *td) {
-    // Build bounding-box query
-    double lamin = lat - BOX_LAT, lamax = lat + BOX_LAT;
-    double lomin = lon - BOX_LON, lomax = lon + BOX_LON;
+bool opensky_fetch(const OpenSkyQuery *query, TelemetryData *td, TrackTable *tracks,
+                   uint32_t now_ms, OpenSkyResponse *response) {
+    memset(response, 0, sizeof(*response));
+    response->result = OPENSKY_FAILED;
+    response->remaining_credits = -1;
+    response->retry_after_s = -1;
 
     snprintf(g_ctx.req, sizeof(g_ctx.req),
         "GET /api/states/all?lamin=%.4f&lomin=%.4f&lamax=%.4f&lomax=%.4f HTTP/1.1\r\n"
@@ -241,7 +255,7 @@ bool opensky_fetch(double lat, double lon, TelemetryData *td) {
         "Connection: close\r\n"
         "User-Agent: PicoW-PilotAssistant/1.0\r\n"
         "\r\n",
-        lamin, lomin, lamax, lomax);
+        query->lamin, query->lomin, query->lamax, query->lomax);
 
     // Init context
     g_ctx.state    = CS_DNS;
@@ -329,16 +343,22 @@ bool opensky_fetch(double lat, double lon, TelemetryData *td) {
 
     printf("OpenSky: got %d bytes, parsing...\n", g_ctx.resp_len);
 
+    if (opensky_parse_headers(g_ctx.resp, response) != 200) {
+        printf("OpenSky: HTTP %d\n", response->http_status);
+        return false;
+    }
+
     // Set own position
-    td->own.lat = lat;
-    td->own.lon = lon;
-    td->own.alt = 0;
-    td->own.pitch = td->own.roll = td->own.yaw = 0;
+    memset(&td->own, 0, sizeof(td->own));
+    td->own.lat = geo_deg_to_udeg(query->lat);
+    td->own.lon = geo_deg_to_udeg(query->lon);
 
     // Parse traffic
-    td->traffic_count = (uint8_t)parse_opensky_response(g_ctx.resp, td);
+    int total;
+    td->traffic_count = (uint8_t)parse_opensky_response(g_ctx.resp, td, tracks, now_ms, &total);
     td->valid = (td->traffic_count > 0);
-    printf("OpenSky: found %d aircraft\n", td->traffic_count);
+    response->traffic_count = total;
+    printf("OpenSky: found %d aircraft, %d credits left\n", total, (int)response->remaining_credits);
 
     return true;
 }
@@ -3,17 +3,23 @@
 
 #include <stdbool.h>
 #include "../src/telemetry_parser.h"
+#include "track_table.h"
+#include "opensky_scheduler.h"
 
 // Default position to use when no GPS fix: Stockholm Arlanda Airport
 #define ARLANDA_LAT  59.6519
 #define ARLANDA_LON  17.9186
 #define ARLANDA_ALT  40.0    // meters AMSL
 
-// Fetch ADS-B traffic from OpenSky around (lat, lon) with ~26km radius.
-// Populates td->traffic[] and td->traffic_count.
-// Sets td->own to the provided position.
+// Fetch ADS-B traffic from OpenSky in the query box (from opensky_sched_poll).
+// Populates td->traffic[] and td->traffic_count (first MAX_TRAFFIC targets).
+// Every target with a valid icao24 also updates tracks (may be NULL), stamped now_ms.
+// Sets td->own to the query centre.
+// Fills response (HTTP status, rate-limit headers, aircraft count) for
+// opensky_sched_result().
 // Must be called from a context where wifi_poll() is being called regularly.
-// Returns true on success, false on network/parse error.
-bool opensky_fetch(double lat, double lon, TelemetryData *td);
+// Returns true on success, false on network/HTTP/parse error.
+bool opensky_fetch(const OpenSkyQuery *query, TelemetryData *td, TrackTable *tracks,
+                   uint32_t now_ms, OpenSkyResponse *response);
 
 #endif // OPENSKY_CLIENT_H
@@ -0,0 +1,257 @@
+/**
+ * OpenSky Polling Scheduler - Implementation
+ */
+
+#include "opensky_scheduler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define KM_PER_DEG_LAT 111.32f
+#define DAY_MS 86400000.0f
+#define MAX_RETRY_AFTER_S 86400     // Credits reset daily at the latest
+
+static bool time_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+static void refill(OpenSkyScheduler* sched, uint32_t now_ms) {
+    sched->tokens += (float)(now_ms - sched->refill_ms) * sched->refill_per_ms;
+    if (sched->tokens > sched->bucket_size) sched->tokens = sched->bucket_size;
+    sched->refill_ms = now_ms;
+}
+
+// OpenSky charges by the area of the box, in square degrees
+static int query_credits(double lat_span, double lon_span) {
+    double area = lat_span * lon_span;
+    if (area <= 25.0) return 1;
+    if (area <= 100.0) return 2;
+    if (area <= 400.0) return 3;
+    return 4;
+}
+
+static bool busy(const OpenSkyScheduler* sched) {
+    return sched->have_response && sched->last_count >= OPENSKY_SCHED_BUSY_TRAFFIC;
+}
+
+void opensky_sched_init(OpenSkyScheduler* sched, uint32_t daily_credits, uint32_t now_ms) {
+    memset(sched, 0, sizeof(*sched));
+    if (daily_credits < 4) daily_credits = 4;
+    sched->daily_credits = daily_credits;
+
+    // A full bucket at start plus the refill over a day is the daily budget
+    sched->bucket_size = daily_credits / 4.0f;
+    sched->tokens = sched->bucket_size;
+    sched->refill_per_ms = (daily_credits - sched->bucket_size) / DAY_MS;
+    sched->refill_ms = now_ms;
+
+    sched->radius_km = OPENSKY_SCHED_BASE_RADIUS_KM;
+    // As if the last request were longer ago than any interval: due now
+    sched->last_request_ms = now_ms - OPENSKY_SCHED_REUSE_MAX_MS;
+}
+
+void opensky_sched_set_fixed_interval(OpenSkyScheduler* sched, uint32_t interval_ms) {
+    sched->fixed_interval_ms = interval_ms;
+}
+
+uint32_t opensky_sched_interval_ms(const OpenSkyScheduler* sched, float ground_speed_kt) {
+    uint32_t interval;
+    if (sched->fixed_interval_ms) {
+        interval = sched->fixed_interval_ms;
+    } else if (ground_speed_kt <= OPENSKY_SCHED_GROUND_SPEED_KT) {
+        interval = OPENSKY_SCHED_GROUND_INTERVAL_MS;
+    } else if (ground_speed_kt >= OPENSKY_SCHED_FAST_SPEED_KT) {
+        interval = OPENSKY_SCHED_FAST_INTERVAL_MS;
+    } else {
+        float f = (ground_speed_kt - OPENSKY_SCHED_GROUND_SPEED_KT) /
+                  (OPENSKY_SCHED_FAST_SPEED_KT - OPENSKY_SCHED_GROUND_SPEED_KT);
+        interval = OPENSKY_SCHED_AIR_INTERVAL_MS -
+                   (uint32_t)(f * (OPENSKY_SCHED_AIR_INTERVAL_MS - OPENSKY_SCHED_FAST_INTERVAL_MS));
+    }
+
+    if (busy(sched)) {
+        interval /= 2;
+        if (interval < OPENSKY_SCHED_MIN_INTERVAL_MS) interval = OPENSKY_SCHED_MIN_INTERVAL_MS;
+    }
+    return interval;
+}
+
+bool opensky_sched_poll(OpenSkyScheduler* sched, uint32_t now_ms, double lat, double lon,
+                        float ground_speed_kt, OpenSkyQuery* query) {
+    refill(sched, now_ms);
+    uint32_t interval = opensky_sched_interval_ms(sched, ground_speed_kt);
+
+    if (sched->backing_off) {
+        // Retry when the backoff ends, not a whole interval later
+        if (time_before(now_ms, sched->backoff_until_ms)) return false;
+    } else {
+        uint32_t wait = interval;
+        uint32_t since = now_ms - sched->last_request_ms;
+        if (sched->have_response && !sched->fixed_interval_ms &&
+            opensky_distance_km(lat, lon, sched->last_lat, sched->last_lon) <
+                OPENSKY_SCHED_REUSE_MOVE * sched->last_radius_km) {
+            uint32_t stretched = interval * OPENSKY_SCHED_REUSE_STRETCH;
+            if (stretched > OPENSKY_SCHED_REUSE_MAX_MS) stretched = OPENSKY_SCHED_REUSE_MAX_MS;
+            if (stretched > wait) wait = stretched;
+            if (since >= interval && since < wait && !sched->reuse_counted) {
+                sched->reused++;
+                sched->reuse_counted = true;
+            }
+        }
+        if (since < wait) return false;
+    }
+
+    // Box: the density-adapted radius plus the distance flown until the next poll
+    float lookahead_km = ground_speed_kt * 1.852f * (interval / 3600000.0f);
+    float radius = sched->radius_km + lookahead_km;
+    if (radius < OPENSKY_SCHED_MIN_RADIUS_KM) radius = OPENSKY_SCHED_MIN_RADIUS_KM;
+    if (radius > OPENSKY_SCHED_MAX_RADIUS_KM) radius = OPENSKY_SCHED_MAX_RADIUS_KM;
+
+    float cos_lat = cosf((float)lat * (float)M_PI / 180.0f);
+    if (cos_lat < 0.1f) cos_lat = 0.1f;
+    double half_lat = radius / KM_PER_DEG_LAT;
+    double half_lon = radius / (KM_PER_DEG_LAT * cos_lat);
+    int credits = query_credits(2.0 * half_lat, 2.0 * half_lon);
+
+    // Outside busy airspace keep a quarter of the bucket in reserve
+    float reserve = busy(sched) ? 0.0f : sched->bucket_size / 4.0f;
+    if (sched->tokens < credits + reserve) {
+        if (!sched->waiting_budget) {
+            sched->budget_waits++;
+            sched->waiting_budget = true;
+        }
+        return false;
+    }
+
+    sched->tokens -= credits;
+    sched->credits_used += credits;
+    sched->requests++;
+    sched->last_request_ms = now_ms;
+    sched->reuse_counted = false;
+    sched->waiting_budget = false;
+
+    query->lat = lat;
+    query->lon = lon;
+    query->radius_km = radius;
+    query->lamin = lat - half_lat;
+    query->lamax = lat + half_lat;
+    query->lomin = lon - half_lon;
+    query->lomax = lon + half_lon;
+    query->credits = credits;
+    return true;
+}
+
+static void back_off(OpenSkyScheduler* sched, uint32_t now_ms, uint32_t first_ms, uint32_t max_ms) {
+    sched->backoff_ms = sched->backoff_ms ? sched->backoff_ms * 2 : first_ms;
+    if (sched->backoff_ms > max_ms) sched->backoff_ms = max_ms;
+    sched->backoff_until_ms = now_ms + sched->backoff_ms;
+    sched->backing_off = true;
+}
+
+void opensky_sched_result(OpenSkyScheduler* sched, uint32_t now_ms, const OpenSkyQuery* query,
+                          const OpenSkyResponse* response) {
+    switch (response->result) {
+    case OPENSKY_OK:
+        sched->backoff_ms = 0;
+        sched->backing_off = false;
+        sched->have_response = true;
+        sched->last_lat = query->lat;
+        sched->last_lon = query->lon;
+        sched->last_radius_km = query->radius_km;
+        sched->last_response_ms = now_ms;
+        sched->last_count = response->traffic_count;
+
+        if (response->traffic_count > OPENSKY_SCHED_DENSE_TRAFFIC) sched->radius_km *= 0.75f;
+        else if (response->traffic_count < OPENSKY_SCHED_SPARSE_TRAFFIC) sched->radius_km *= 1.25f;
+        if (sched->radius_km < OPENSKY_SCHED_MIN_RADIUS_KM) sched->radius_km = OPENSKY_SCHED_MIN_RADIUS_KM;
+        if (sched->radius_km > OPENSKY_SCHED_MAX_RADIUS_KM) sched->radius_km = OPENSKY_SCHED_MAX_RADIUS_KM;
+
+        // The server knows best what is left
+        if (response->remaining_credits >= 0 && response->remaining_credits < sched->tokens) {
+            sched->tokens = (float)response->remaining_credits;
+        }
+        break;
+
+    case OPENSKY_RATE_LIMITED:
+        sched->rate_limited++;
+        if (response->retry_after_s >= 0) {
+            // Credits are back when the server says; the next response's
+            // X-Rate-Limit-Remaining brings the bucket in line
+            uint32_t wait_s = (uint32_t)response->retry_after_s;
+            if (wait_s > MAX_RETRY_AFTER_S) wait_s = MAX_RETRY_AFTER_S;
+            sched->backoff_until_ms = now_ms + wait_s * 1000;
+            sched->backing_off = true;
+        } else {
+            sched->tokens = 0.0f;
+            back_off(sched, now_ms, OPENSKY_SCHED_LIMIT_BACKOFF_MS, OPENSKY_SCHED_LIMIT_BACKOFF_MAX_MS);
+        }
+        break;
+
+    case OPENSKY_FAILED:
+        sched->errors++;
+        // Never reached the server: nothing was charged
+        if (response->http_status == 0) {
+            sched->tokens += query->credits;
+            if (sched->tokens > sched->bucket_size) sched->tokens = sched->bucket_size;
+        }
+        back_off(sched, now_ms, OPENSKY_SCHED_ERROR_BACKOFF_MS, OPENSKY_SCHED_ERROR_BACKOFF_MAX_MS);
+        break;
+    }
+}
+
+// Case-insensitive "Name:" match at the start of a header line
+static const char* header_value(const char* line, const char* name) {
+    size_t i = 0;
+    for (; name[i]; i++) {
+        char c = line[i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != name[i]) return NULL;
+    }
+    if (line[i] != ':') return NULL;
+    const char* v = line + i + 1;
+    while (*v == ' ' || *v == '\t') v++;
+    return v;
+}
+
+int opensky_parse_headers(const char* head, OpenSkyResponse* response) {
+    response->http_status = 0;
+    response->remaining_credits = -1;
+    response->retry_after_s = -1;
+
+    const char* p = head;
+    while (*p) {
+        const char* eol = strchr(p, '\n');
+        const char* v;
+        if (eol == p || (eol == p + 1 && *p == '\r')) {
+            // End of a head; a proxy's or a "100 Continue" one is followed by another
+            p = eol + 1;
+            if (strncmp(p, "HTTP/", 5) != 0) break;
+            continue;
+        }
+        if (strncmp(p, "HTTP/", 5) == 0) {
+            const char* sp = strchr(p, ' ');
+            if (sp && (!eol || sp < eol)) response->http_status = atoi(sp + 1);
+        } else if ((v = header_value(p, "x-rate-limit-remaining")) != NULL) {
+            response->remaining_credits = atoi(v);
+        } else if ((v = header_value(p, "x-rate-limit-retry-after-seconds")) != NULL) {
+            response->retry_after_s = atoi(v);
+        }
+        if (!eol) break;
+        p = eol + 1;
+    }
+
+    if (response->http_status == 200) response->result = OPENSKY_OK;
+    else if (response->http_status == 429) response->result = OPENSKY_RATE_LIMITED;
+    else response->result = OPENSKY_FAILED;
+    return response->http_status;
+}
+
+float opensky_distance_km(double lat1, double lon1, double lat2, double lon2) {
+    const float d2r = (float)M_PI / 180.0f;
+    float dlat = (float)(lat2 - lat1) * d2r;
+    float dlon = (float)(lon2 - lon1) * d2r;
+    float a = sinf(dlat * 0.5f) * sinf(dlat * 0.5f) +
+              cosf((float)lat1 * d2r) * cosf((float)lat2 * d2r) *
+                  sinf(dlon * 0.5f) * sinf(dlon * 0.5f);
+    return 6371.0f * 2.0f * atan2f(sqrtf(a), sqrtf(1.0f - a));
+}
@@ -0,0 +1,169 @@
+/**
+ * OpenSky Polling Scheduler
+ *
+ * Decides when to query the OpenSky states API and how large a box to ask
+ * for, so traffic stays fresh in the air without running out of API
+ * credits (anonymous use: 400 per day, 1 per query up to 25 square degrees).
+ *
+ * - Cadence follows ground speed: slow on the ground, faster the faster
+ *   ownship goes, and twice as fast again in busy airspace.
+ * - The box covers the distance flown until the next poll on top of a
+ *   radius that shrinks when the last response was crowded and grows
+ *   when it was nearly empty.
+ * - Credits come from a token bucket refilled so no 24 h window spends
+ *   more than the daily budget; part of the bucket is held back for busy
+ *   airspace. The X-Rate-Limit-Remaining header caps the bucket.
+ * - Errors back off exponentially; HTTP 429 waits for the server's
+ *   X-Rate-Limit-Retry-After-Seconds (or backs off when it is missing).
+ * - While ownship has barely moved the last response is reused for
+ *   longer before asking again.
+ * - Without a position or speed source (a display at a fixed default
+ *   position) a fixed cadence replaces both of the above; only the
+ *   budget and backoff slow it down.
+ *
+ * The caller does the HTTP request: poll() says whether to fetch now and
+ * fills in the query box, result() reports how it went.
+ */
+
+#ifndef OPENSKY_SCHEDULER_H
+#define OPENSKY_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define OPENSKY_CREDITS_ANONYMOUS 400           // Per day
+#define OPENSKY_CREDITS_REGISTERED 4000
+
+// Cadence
+#define OPENSKY_SCHED_GROUND_INTERVAL_MS 300000 // At or below the ground speed
+#define OPENSKY_SCHED_AIR_INTERVAL_MS 30000     // Just above it
+#define OPENSKY_SCHED_FAST_INTERVAL_MS 15000    // At the fast speed and above
+#define OPENSKY_SCHED_MIN_INTERVAL_MS 10000     // Busy airspace floor
+#define OPENSKY_SCHED_GROUND_SPEED_KT 40.0f
+#define OPENSKY_SCHED_FAST_SPEED_KT 150.0f
+#define OPENSKY_SCHED_BUSY_TRAFFIC 20           // Aircraft in the last response
+
+// Box radius
+#define OPENSKY_SCHED_MIN_RADIUS_KM 10.0f
+#define OPENSKY_SCHED_BASE_RADIUS_KM 25.0f
+#define OPENSKY_SCHED_MAX_RADIUS_KM 60.0f
+#define OPENSKY_SCHED_DENSE_TRAFFIC 40          // Shrink the box above this
+#define OPENSKY_SCHED_SPARSE_TRAFFIC 3          // Grow it below this
+
+// Reuse while ownship stays within this fraction of the radius
+#define OPENSKY_SCHED_REUSE_MOVE 0.1f
+#define OPENSKY_SCHED_REUSE_STRETCH 4           // Interval multiplier
+#define OPENSKY_SCHED_REUSE_MAX_MS 600000
+
+// Backoff
+#define OPENSKY_SCHED_ERROR_BACKOFF_MS 5000     // Doubles per failure
+#define OPENSKY_SCHED_ERROR_BACKOFF_MAX_MS 300000
+#define OPENSKY_SCHED_LIMIT_BACKOFF_MS 60000    // 429 without Retry-After
+#define OPENSKY_SCHED_LIMIT_BACKOFF_MAX_MS 3600000
+
+typedef enum {
+    OPENSKY_OK,
+    OPENSKY_RATE_LIMITED,       // HTTP 429
+    OPENSKY_FAILED              // No response, other HTTP error or bad body
+} OpenSkyResult;
+
+typedef struct {
+    double lat;                 // Centre (ownship)
+    double lon;
+    float radius_km;
+    double lamin, lomin;        // Box to request
+    double lamax, lomax;
+    int credits;                // What the query costs
+} OpenSkyQuery;
+
+typedef struct {
+    OpenSkyResult result;
+    int http_status;            // 0 without a response
+    int32_t remaining_credits;  // X-Rate-Limit-Remaining, -1 if absent
+    int32_t retry_after_s;      // X-Rate-Limit-Retry-After-Seconds, -1 if absent
+    int traffic_count;          // Aircraft in the response
+} OpenSkyResponse;
+
+typedef struct {
+    // Budget
+    uint32_t daily_credits;
+    float bucket_size;
+    float tokens;
+    float refill_per_ms;
+    uint32_t refill_ms;
+
+    // Last response
+    bool have_response;
+    double last_lat;
+    double last_lon;
+    float last_radius_km;
+    uint32_t last_request_ms;
+    uint32_t last_response_ms;
+    int last_count;
+    float radius_km;            // Density-adapted part of the radius
+
+    // Backoff
+    uint32_t backoff_ms;
+    uint32_t backoff_until_ms;
+    bool backing_off;
+
+    uint32_t fixed_interval_ms; // 0: cadence follows ground speed
+
+    bool reuse_counted;
+    bool waiting_budget;
+
+    // Counters
+    uint32_t requests;
+    uint32_t credits_used;
+    uint32_t reused;            // Polls skipped because ownship barely moved
+    uint32_t budget_waits;      // Polls delayed for credits
+    uint32_t rate_limited;
+    uint32_t errors;
+} OpenSkyScheduler;
+
+/**
+ * Initialize with a daily credit budget (OPENSKY_CREDITS_*); the first
+ * poll fetches right away
+ */
+void opensky_sched_init(OpenSkyScheduler* sched, uint32_t daily_credits, uint32_t now_ms);
+
+/**
+ * Poll every interval_ms whatever the ground speed, with no reuse
+ * stretching: for callers whose position is a fixed default, where
+ * "not moving" says nothing about the traffic. 0 restores the speed-based
+ * cadence.
+ */
+void opensky_sched_set_fixed_interval(OpenSkyScheduler* sched, uint32_t interval_ms);
+
+/**
+ * Whether to fetch now, for ownship at (lat, lon) doing ground_speed_kt
+ * Returns true and fills query (and spends its credits) when a request is
+ * due; the caller must report the outcome with opensky_sched_result().
+ */
+bool opensky_sched_poll(OpenSkyScheduler* sched, uint32_t now_ms, double lat, double lon,
+                        float ground_speed_kt, OpenSkyQuery* query);
+
+/**
+ * Report the outcome of the request poll() asked for
+ */
+void opensky_sched_result(OpenSkyScheduler* sched, uint32_t now_ms, const OpenSkyQuery* query,
+                          const OpenSkyResponse* response);
+
+/**
+ * Poll interval for a ground speed, before budget and reuse adjustments
+ */
+uint32_t opensky_sched_interval_ms(const OpenSkyScheduler* sched, float ground_speed_kt);
+
+/**
+ * Fill response (status, rate-limit headers) from an HTTP response head
+ * (status line and headers; the body may follow). traffic_count is left
+ * alone. Returns the HTTP status, 0 if there is no status line.
+ */
+int opensky_parse_headers(const char* head, OpenSkyResponse* response);
+
+/**
+ * Great-circle distance in km
+ */
+float opensky_distance_km(double lat1, double lon1, double lat2, double lon2);
+
+#endif // OPENSKY_SCHEDULER_H
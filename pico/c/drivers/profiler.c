@@ -0,0 +1,198 @@
+/**
+ * Cycle-Counter Profiler - Implementation
+ */
+
+#include "profiler.h"
+#include "pico/stdlib.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+#include "hardware/clocks.h"
+#include <stdio.h>
+
+// Core debug / DWT registers (one set per Cortex-M33)
+#define DEMCR           (*(volatile uint32_t*)0xE000EDFCu)
+#define DEMCR_TRCENA    (1u << 24)
+#define DWT_CTRL        (*(volatile uint32_t*)0xE0001000u)
+#define DWT_CYCCNTENA   (1u << 0)
+
+// Per-core statistics. Only the owning core writes; seq is odd while an
+// update is in progress so readers on the other core can retry.
+typedef struct {
+    volatile uint32_t seq;
+    ProfStats stats;
+} ProfSlot;
+
+static ProfSlot slots[PROF_NUM_CORES][PROF_ZONE_COUNT];
+
+// Reset requests: each core compares against the generation it last cleared
+static volatile uint32_t reset_gen = 0;
+static uint32_t cleared_gen[PROF_NUM_CORES];
+static volatile uint64_t reset_time_us = 0;
+
+// Cost of one begin/end pair, measured at init
+static uint32_t overhead_cycles = 0;
+
+static const char* const zone_names[PROF_ZONE_COUNT] = {
+    [PROF_AHRS_LOOP]      = "ahrs_loop",
+    [PROF_SENSOR_READ]    = "sensor_read",
+    [PROF_FILTER_UPDATE]  = "filter_update",
+    [PROF_RENDER_HORIZON] = "render_horizon",
+    [PROF_RENDER_OVERLAY] = "render_overlay",
+    [PROF_LCD_FLUSH]      = "lcd_flush",
+    [PROF_WIFI_POLL]      = "wifi_poll",
+    [PROF_TOUCH_READ]     = "touch_read",
+    [PROF_SPRITE_BLIT]    = "sprite_blit",
+    [PROF_RADAR_PROJECT]  = "radar_project",
+};
+
+// ── Recording ─────────────────────────────────────────────────────────────────
+
+#if PROFILER_ENABLED
+
+static inline uint32_t hist_bin(uint32_t cycles) {
+    if (cycles == 0) return 0;
+    uint32_t bin = 32u - (uint32_t)__builtin_clz(cycles);
+    return bin < PROF_HIST_BINS ? bin : PROF_HIST_BINS - 1;
+}
+
+// Open-coded rather than memset so the reset path never touches flash
+static inline void stats_clear(ProfStats* s) {
+    s->count = 0;
+    s->min_cycles = UINT32_MAX;
+    s->max_cycles = 0;
+    s->total_cycles = 0;
+    for (int b = 0; b < PROF_HIST_BINS; b++) s->hist[b] = 0;
+}
+
+static inline void stats_add(ProfStats* s, uint32_t cycles) {
+    s->count++;
+    s->total_cycles += cycles;
+    if (cycles < s->min_cycles) s->min_cycles = cycles;
+    if (cycles > s->max_cycles) s->max_cycles = cycles;
+    s->hist[hist_bin(cycles)]++;
+}
+
+// Clear this core's slots if a reset was requested since the last sample
+static void __not_in_flash_func(apply_reset)(uint32_t core, uint32_t gen) {
+    for (int z = 0; z < PROF_ZONE_COUNT; z++) {
+        ProfSlot* slot = &slots[core][z];
+        slot->seq++;
+        __dmb();
+        stats_clear(&slot->stats);
+        __dmb();
+        slot->seq++;
+    }
+    cleared_gen[core] = gen;
+}
+
+void prof_init_core(void) {
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CYCCNTENA;
+
+    uint32_t core = get_core_num();
+    if (core == 0) {
+        reset_time_us = time_us_64();
+
+        // Time a batch of real pairs (best of a few runs), then discard them
+        uint32_t best = UINT32_MAX;
+        for (int run = 0; run < 4; run++) {
+            uint32_t t0 = prof_begin();
+            for (int i = 0; i < 16; i++) {
+                prof_end(PROF_AHRS_LOOP, prof_begin());
+            }
+            uint32_t per_pair = (PROF_DWT_CYCCNT - t0) / 16;
+            if (per_pair < best) best = per_pair;
+        }
+        overhead_cycles = best;
+    }
+    apply_reset(core, reset_gen);
+}
+
+// RAM-resident: stays usable while the other core programs flash
+void __not_in_flash_func(prof_end)(ProfZone zone, uint32_t start) {
+    uint32_t cycles = PROF_DWT_CYCCNT - start;
+    uint32_t core = get_core_num();
+
+    uint32_t gen = reset_gen;
+    if (cleared_gen[core] != gen) apply_reset(core, gen);
+
+    ProfSlot* slot = &slots[core][zone];
+    slot->seq++;
+    __dmb();
+    stats_add(&slot->stats, cycles);
+    __dmb();
+    slot->seq++;
+}
+
+#endif
+
+// ── Readout ───────────────────────────────────────────────────────────────────
+
+bool prof_snapshot(uint8_t core, ProfZone zone, ProfStats* out) {
+    if (core >= PROF_NUM_CORES || zone >= PROF_ZONE_COUNT || !out) return false;
+
+    const ProfSlot* slot = &slots[core][zone];
+    for (int attempt = 0; attempt < 8; attempt++) {
+        uint32_t seq = slot->seq;
+        if (seq & 1u) continue;
+        __dmb();
+        *out = slot->stats;
+        __dmb();
+        if (slot->seq == seq) {
+            // A reset the owning core has not applied yet reads as empty
+            if (cleared_gen[core] != reset_gen) return false;
+            return out->count > 0;
+        }
+    }
+    return false;   // Writer kept racing us; try again on the next refresh
+}
+
+uint64_t prof_elapsed_cycles(void) {
+    uint64_t us = time_us_64() - reset_time_us;
+    return us * (clock_get_hz(clk_sys) / 1000000u);
+}
+
+void prof_reset(void) {
+    reset_time_us = time_us_64();
+    __dmb();
+    reset_gen = reset_gen + 1;
+}
+
+const char* prof_zone_name(ProfZone zone) {
+    return zone < PROF_ZONE_COUNT ? zone_names[zone] : "?";
+}
+
+void prof_dump(void) {
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000u;
+    uint64_t elapsed = prof_elapsed_cycles();
+
+    printf("\n[PROF] %lu MHz, %.1f s since reset, %lu cycles per zone\n",
+           (unsigned long)mhz, (double)elapsed / (mhz * 1e6),
+           (unsigned long)overhead_cycles);
+    printf("[PROF] %-15s core %8s %9s %9s %9s %6s\n",
+           "zone", "count", "min_us", "avg_us", "max_us", "load%");
+
+    for (uint8_t core = 0; core < PROF_NUM_CORES; core++) {
+        for (int z = 0; z < PROF_ZONE_COUNT; z++) {
+            ProfStats s;
+            if (!prof_snapshot(core, (ProfZone)z, &s)) continue;
+
+            float avg = (float)s.total_cycles / s.count;
+            float load = elapsed ? 100.0f * (float)s.total_cycles / (float)elapsed : 0.0f;
+            printf("[PROF] %-15s %4u %8lu %9.2f %9.2f %9.2f %6.2f\n",
+                   zone_names[z], core, (unsigned long)s.count,
+                   (float)s.min_cycles / mhz, avg / mhz, (float)s.max_cycles / mhz, load);
+
+            // Histogram: upper bound of each non-empty bin in µs, then count
+            printf("[PROF]   hist");
+            for (int b = 0; b < PROF_HIST_BINS; b++) {
+                if (s.hist[b] == 0) continue;
+                float upper_us = (float)(1u << b) / mhz;
+                printf(" %s%.2f:%lu", b == PROF_HIST_BINS - 1 ? ">" : "<",
+                       b == PROF_HIST_BINS - 1 ? upper_us / 2.0f : upper_us,
+                       (unsigned long)s.hist[b]);
+            }
+            printf("\n");
+        }
+    }
+}
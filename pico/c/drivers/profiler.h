@@ -0,0 +1,113 @@
+/**
+ * Cycle-Counter Profiler
+ *
+ * Named timing zones measured with the Cortex-M33 DWT cycle counter, one
+ * set of statistics per core (min/avg/max plus a log2 histogram). Each
+ * core only ever writes its own statistics, and readers take consistent
+ * snapshots through a per-zone sequence counter, so there are no locks
+ * and neither core ever waits for the other.
+ *
+ * Usage:
+ *   uint32_t t = prof_begin();
+ *   ...work...
+ *   prof_end(PROF_SENSOR_READ, t);
+ *
+ * A begin/end pair costs a few dozen cycles (prof_dump() prints the
+ * measured figure), well under 1% of any instrumented loop, so it stays
+ * enabled. Build with PROFILER_ENABLED=0 to compile it out entirely.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#define PROF_NUM_CORES  2
+#define PROF_HIST_BINS  24      // Bin b counts durations in [2^(b-1), 2^b) cycles, last bin open-ended
+
+typedef enum {
+    PROF_AHRS_LOOP,         // One AHRS iteration, read to shared-data publish
+    PROF_SENSOR_READ,       // ICM-20948 burst read
+    PROF_FILTER_UPDATE,     // Notch banks + attitude estimator
+    PROF_RENDER_HORIZON,    // Sky/ground fill
+    PROF_RENDER_OVERLAY,    // Pitch ladder, bank arc, symbols, text
+    PROF_LCD_FLUSH,         // Framebuffer (or rectangle) to the panel
+    PROF_WIFI_POLL,         // cyw43_arch_poll + link supervision
+    PROF_TOUCH_READ,        // XPT2046 sample
+    PROF_SPRITE_BLIT,       // One rotated sprite (sprite.h)
+    PROF_RADAR_PROJECT,     // Projection math of one radar redraw (all targets and trails)
+    PROF_ZONE_COUNT
+} ProfZone;
+
+// Statistics for one zone on one core
+typedef struct {
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t hist[PROF_HIST_BINS];
+} ProfStats;
+
+#if PROFILER_ENABLED
+
+// DWT cycle counter (architectural address, private to each core)
+#define PROF_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004u)
+
+/**
+ * Enable the cycle counter on the calling core
+ * Call once from each core that records zones.
+ */
+void prof_init_core(void);
+
+/**
+ * Current cycle count (start of a zone)
+ */
+static inline uint32_t prof_begin(void) {
+    return PROF_DWT_CYCCNT;
+}
+
+/**
+ * Close a zone opened with prof_begin() on the calling core
+ */
+void prof_end(ProfZone zone, uint32_t start);
+
+#else
+
+static inline void prof_init_core(void) {}
+static inline uint32_t prof_begin(void) { return 0; }
+static inline void prof_end(ProfZone zone, uint32_t start) { (void)zone; (void)start; }
+
+#endif
+
+/**
+ * Consistent copy of one zone's statistics
+ * Returns: false if the zone has no samples on that core
+ */
+bool prof_snapshot(uint8_t core, ProfZone zone, ProfStats* out);
+
+/**
+ * Cycles elapsed since the last reset (for load percentages)
+ */
+uint64_t prof_elapsed_cycles(void);
+
+/**
+ * Clear all statistics (each core clears its own on its next sample)
+ */
+void prof_reset(void);
+
+/**
+ * Zone name for display
+ */
+const char* prof_zone_name(ProfZone zone);
+
+/**
+ * Print all zones with samples (min/avg/max µs, load, histogram) to stdout
+ */
+void prof_dump(void);
+
+#endif // PROFILER_H
@@ -0,0 +1,67 @@
+/**
+ * Quaternion Helpers Implementation
+ */
+
+#include "quaternion.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void quaternion_identity(Quaternion* q) {
+    q->q0 = 1.0f;
+    q->q1 = 0.0f;
+    q->q2 = 0.0f;
+    q->q3 = 0.0f;
+}
+
+void quaternion_normalize(Quaternion* q) {
+    float n_sq = q->q0 * q->q0 + q->q1 * q->q1 + q->q2 * q->q2 + q->q3 * q->q3;
+    if (n_sq <= 1e-20f || !isfinite(n_sq)) {
+        quaternion_identity(q);
+        return;
+    }
+    float recipNorm = 1.0f / sqrtf(n_sq);
+    q->q0 *= recipNorm;
+    q->q1 *= recipNorm;
+    q->q2 *= recipNorm;
+    q->q3 *= recipNorm;
+}
+
+void quaternion_to_euler(const Quaternion* q, float* roll, float* pitch, float* yaw) {
+    // Roll (X-axis rotation)
+    float sinr_cosp = 2.0f * (q->q0 * q->q1 + q->q2 * q->q3);
+    float cosr_cosp = 1.0f - 2.0f * (q->q1 * q->q1 + q->q2 * q->q2);
+    *roll = atan2f(sinr_cosp, cosr_cosp);
+
+    // Pitch (Y-axis rotation)
+    float sinp = 2.0f * (q->q0 * q->q2 - q->q3 * q->q1);
+    if (fabsf(sinp) >= 1.0f) {
+        *pitch = copysignf(M_PI / 2.0f, sinp);  // Use 90 degrees if out of range
+    } else {
+        *pitch = asinf(sinp);
+    }
+
+    // Yaw (Z-axis rotation)
+    float siny_cosp = 2.0f * (q->q0 * q->q3 + q->q1 * q->q2);
+    float cosy_cosp = 1.0f - 2.0f * (q->q2 * q->q2 + q->q3 * q->q3);
+    *yaw = atan2f(siny_cosp, cosy_cosp);
+}
+
+void quaternion_from_euler(Quaternion* q, float roll, float pitch, float yaw) {
+    float cr = cosf(roll / 2), sr = sinf(roll / 2);
+    float cp = cosf(pitch / 2), sp = sinf(pitch / 2);
+    float cy = cosf(yaw / 2), sy = sinf(yaw / 2);
+    q->q0 = cr * cp * cy + sr * sp * sy;
+    q->q1 = sr * cp * cy - cr * sp * sy;
+    q->q2 = cr * sp * cy + sr * cp * sy;
+    q->q3 = cr * cp * sy - sr * sp * cy;
+}
+
+void quaternion_up_vector(const Quaternion* q, float up[3]) {
+    // Third row of the sensor-to-earth rotation matrix
+    up[0] = 2.0f * (q->q1 * q->q3 - q->q0 * q->q2);
+    up[1] = 2.0f * (q->q0 * q->q1 + q->q2 * q->q3);
+    up[2] = 1.0f - 2.0f * (q->q1 * q->q1 + q->q2 * q->q2);
+}
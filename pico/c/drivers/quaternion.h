@@ -0,0 +1,55 @@
+/**
+ * Quaternion Helpers
+ *
+ * Orientation type shared by the attitude estimators (Madgwick, Mahony,
+ * ESKF). A quaternion rotates sensor-frame vectors into the earth frame
+ * (X north, Z up), so gravity reads +Z when the sensor is level.
+ */
+
+#ifndef QUATERNION_H
+#define QUATERNION_H
+
+/**
+ * Quaternion representation (w, x, y, z)
+ * Represents 3D rotation: q = w + xi + yj + zk
+ */
+typedef struct {
+    float q0;  // w (scalar part)
+    float q1;  // x (vector i)
+    float q2;  // y (vector j)
+    float q3;  // z (vector k)
+} Quaternion;
+
+/**
+ * Set quaternion to identity (sensor frame aligned with earth frame)
+ */
+void quaternion_identity(Quaternion* q);
+
+/**
+ * Normalize quaternion in place
+ * Falls back to identity if the norm is zero or not finite.
+ */
+void quaternion_normalize(Quaternion* q);
+
+/**
+ * Convert quaternion to Euler angles (roll, pitch, yaw)
+ *
+ * @param q Pointer to quaternion
+ * @param roll Output: roll angle in radians (rotation around X-axis)
+ * @param pitch Output: pitch angle in radians (rotation around Y-axis)
+ * @param yaw Output: yaw angle in radians (rotation around Z-axis)
+ */
+void quaternion_to_euler(const Quaternion* q, float* roll, float* pitch, float* yaw);
+
+/**
+ * Build quaternion from Euler angles in radians (inverse of quaternion_to_euler)
+ */
+void quaternion_from_euler(Quaternion* q, float roll, float pitch, float yaw);
+
+/**
+ * Earth "up" axis expressed in the sensor frame
+ * This is what an ideal accelerometer reads (in g) when not accelerating.
+ */
+void quaternion_up_vector(const Quaternion* q, float up[3]);
+
+#endif // QUATERNION_H
@@ -0,0 +1,131 @@
+/**
+ * Rotated Sprite Blitter - Implementation
+ */
+
+#include "sprite.h"
+#include "st7789_lcd.h"
+#include "profiler.h"
+#include "hardware/interp.h"
+#include <math.h>
+#include <string.h>
+
+#define UV_FRAC_BITS 16     // Texture coordinates are 16.16 fixed point
+
+// ── Textures ──────────────────────────────────────────────────────────────────
+
+void sprite_texture_from_mask(SpriteTexture* tex, uint8_t size_bits,
+                              const uint8_t* mask, uint16_t width, uint16_t height) {
+    if (size_bits > SPRITE_MAX_SIZE_BITS) size_bits = SPRITE_MAX_SIZE_BITS;
+    memset(tex, 0, sizeof(*tex));
+    tex->size_bits = size_bits;
+
+    // Bounding box of the opaque spans, so the symbol (not its padding) is
+    // centred on the rotation point
+    int16_t min_x = width, max_x = -1, min_y = height, max_y = -1;
+    const uint8_t* p = mask;
+    for (int16_t row = 0; row < (int16_t)height; row++) {
+        uint8_t spans = *p++;
+        for (uint8_t s = 0; s < spans; s++, p += 2) {
+            if (p[1] == 0) continue;
+            if (p[0] < min_x) min_x = p[0];
+            if (p[0] + p[1] - 1 > max_x) max_x = p[0] + p[1] - 1;
+            if (row < min_y) min_y = row;
+            if (row > max_y) max_y = row;
+        }
+    }
+    if (max_x < 0) return;  // Empty mask
+
+    int16_t size = 1 << size_bits;
+    int16_t ox = (size - (max_x - min_x + 1)) / 2 - min_x;
+    int16_t oy = (size - (max_y - min_y + 1)) / 2 - min_y;
+
+    p = mask;
+    for (int16_t row = 0; row < (int16_t)height; row++) {
+        uint8_t spans = *p++;
+        int16_t ty = row + oy;
+        for (uint8_t s = 0; s < spans; s++, p += 2) {
+            for (int16_t x = p[0]; x < p[0] + p[1]; x++) {
+                int16_t tx = x + ox;
+                if (tx >= 0 && tx < size && ty >= 0 && ty < size) {
+                    tex->texels[(ty << size_bits) | tx] = 1;
+                }
+            }
+        }
+    }
+}
+
+int16_t sprite_radius(const SpriteTexture* tex, float scale) {
+    return (int16_t)ceilf((float)(1 << tex->size_bits) * 0.5f * scale);
+}
+
+// ── Blitting ──────────────────────────────────────────────────────────────────
+
+// Lane 0 turns u into the column, lane 1 turns v into the row offset; the
+// FULL result adds both to the texture base, i.e. the texel address. Raw
+// adds step the 16.16 accumulators by du/dv on every pop.
+static void interp_setup(const SpriteTexture* tex) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_config_set_shift(&cfg, UV_FRAC_BITS);
+    interp_config_set_mask(&cfg, 0, tex->size_bits - 1);
+    interp_set_config(interp0, 0, &cfg);
+
+    cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_config_set_shift(&cfg, UV_FRAC_BITS - tex->size_bits);
+    interp_config_set_mask(&cfg, tex->size_bits, 2 * tex->size_bits - 1);
+    interp_set_config(interp0, 1, &cfg);
+
+    interp0->base[2] = (uintptr_t)tex->texels;
+}
+
+void sprite_draw_rotated(const SpriteTexture* tex, int16_t cx, int16_t cy,
+                         float heading_deg, float scale, uint16_t color) {
+    if (scale <= 0.0f) return;
+    uint32_t t0 = prof_begin();
+
+    uint16_t* fb = lcd_get_framebuffer();
+    float half = (float)(1 << tex->size_bits) * 0.5f;
+
+    // Destination -> texture is the inverse rotation (screen y points down,
+    // so a positive heading turns the symbol clockwise)
+    float a = heading_deg * (float)M_PI / 180.0f;
+    float c = cosf(a) / scale;
+    float s = sinf(a) / scale;
+
+    interp_setup(tex);
+    interp0->base[0] = (uint32_t)(int32_t)lroundf(c * (1 << UV_FRAC_BITS));
+    interp0->base[1] = (uint32_t)(int32_t)lroundf(-s * (1 << UV_FRAC_BITS));
+
+    // The sprite centre sits on the top-left corner of pixel (cx, cy) and
+    // pixels are sampled at their centres, so symmetric symbols stay
+    // symmetric. Only pixel centres strictly inside the inscribed circle are
+    // drawn: their texture coordinates stay inside the texture at any angle.
+    float r = half * scale - 0.01f;
+    int16_t y0 = cy + (int16_t)ceilf(-r - 0.5f);
+    int16_t y1 = cy + (int16_t)floorf(r - 0.5f);
+    for (int16_t y = y0; y <= y1; y++) {
+        if (y < 0 || y >= LCD_HEIGHT) continue;
+
+        float ry = (float)(y - cy) + 0.5f;
+        float hw = sqrtf(r * r - ry * ry);
+        int16_t x0 = cx + (int16_t)ceilf(-0.5f - hw);
+        int16_t x1 = cx + (int16_t)floorf(hw - 0.5f);
+        if (x0 < 0) x0 = 0;
+        if (x1 > LCD_WIDTH - 1) x1 = LCD_WIDTH - 1;
+        if (x0 > x1) continue;
+
+        float rx = (float)(x0 - cx) + 0.5f;
+        float u = half + rx * c + ry * s;
+        float v = half - rx * s + ry * c;
+        interp0->accum[0] = (uint32_t)(int32_t)(u * (1 << UV_FRAC_BITS));
+        interp0->accum[1] = (uint32_t)(int32_t)(v * (1 << UV_FRAC_BITS));
+
+        uint16_t* dst = &fb[y * LCD_WIDTH];
+        for (int16_t x = x0; x <= x1; x++) {
+            if (*(const uint8_t*)(uintptr_t)interp0->pop[2]) dst[x] = color;
+        }
+    }
+
+    prof_end(PROF_SPRITE_BLIT, t0);
+}
@@ -0,0 +1,53 @@
+/**
+ * Rotated Sprite Blitter
+ *
+ * Draws small one-color symbols (traffic aircraft, later a track-up radar
+ * rose) rotated and scaled into the LCD framebuffer. Texture coordinates
+ * are stepped by the RP2350 SIO interpolator 0 of the calling core: per
+ * destination pixel the interpolator adds du/dv to the accumulators and
+ * returns the texel address directly, so the inner loop is one load from
+ * the interpolator, one texel load and a store.
+ *
+ * Textures are 2^n x 2^n bytes (0 = transparent). Only destination pixels
+ * inside the texture's inscribed circle are drawn, so any rotation samples
+ * inside the texture and the interpolator never wraps. Keep the symbol
+ * inside that circle (a 24x24 icon fits a 32x32 texture unless it fills
+ * its corners).
+ *
+ * UI core only (it owns interp0 there).
+ */
+
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <stdint.h>
+
+#define SPRITE_MAX_SIZE_BITS    5   // Up to 32x32 texels
+
+typedef struct {
+    uint8_t size_bits;          // Texture is (1 << size_bits) square
+    uint8_t texels[1 << (2 * SPRITE_MAX_SIZE_BITS)];
+} SpriteTexture;
+
+/**
+ * Build a texture from an icon span mask (lcd_draw_icon_mask format). The
+ * opaque pixels' bounding box is centred in the (1 << size_bits) square, so
+ * the symbol rotates about its own centre rather than the icon's.
+ */
+void sprite_texture_from_mask(SpriteTexture* tex, uint8_t size_bits,
+                              const uint8_t* mask, uint16_t width, uint16_t height);
+
+/**
+ * Draw the texture centred at (cx, cy), rotated clockwise by heading_deg
+ * (0 = texture up) and scaled (1.0 = one texel per pixel), in one color.
+ * Clipped to the framebuffer.
+ */
+void sprite_draw_rotated(const SpriteTexture* tex, int16_t cx, int16_t cy,
+                         float heading_deg, float scale, uint16_t color);
+
+/**
+ * Radius in pixels of what sprite_draw_rotated() can touch at this scale
+ */
+int16_t sprite_radius(const SpriteTexture* tex, float scale);
+
+#endif // SPRITE_H
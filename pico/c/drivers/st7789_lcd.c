@@ -1,4 +1,5 @@
 #include "st7789_lcd.h"
+#include "profiler.h"
 #include "pico/stdlib.h"
 #include "hardware/spi.h"
 #include "hardware/gpio.h"
@@ -344,6 +345,7 @@ void lcd_draw_string_scaled(uint16_t x, uint16_t y, const char* str, uint16_t co
 
 // Flush entire framebuffer to LCD using DMA
 void lcd_flush(void) {
+    uint32_t prof_t = prof_begin();
     lcd_set_window(0, 0, LCD_WIDTH, LCD_HEIGHT);
 
     // Byte-swap for SPI (ST7789 expects big-endian, ARM is little-endian)
@@ -376,6 +378,7 @@ void lcd_flush(void) {
 
     // Swap back to native format
     swap_bytes_region((uint8_t*)framebuffer, LCD_WIDTH * LCD_HEIGHT);
+    prof_end(PROF_LCD_FLUSH, prof_t);
 }
 
 // Flush a rectangular region to LCD
@@ -384,6 +387,7 @@ void lcd_flush_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
     if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
     if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
 
+    uint32_t prof_t = prof_begin();
     lcd_set_window(x, y, x + w, y + h);
 
     gpio_put(LCD_DC_PIN, 1);
@@ -415,19 +419,16 @@ void lcd_flush_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
     }
 
     gpio_put(LCD_CS_PIN, 1);
+    prof_end(PROF_LCD_FLUSH, prof_t);
 }
 
-void lcd_display_splash(const uint8_t* image_data, size_t data_len) {
-    if (!image_data || data_len != (LCD_WIDTH * LCD_HEIGHT * 2)) {
+void lcd_display_splash(const uint8_t* rle_data, size_t data_len) {
+    if (!rle_data || data_len == 0) {
         return;
     }
 
-    // Copy splash to framebuffer (data is already big-endian, need to swap to native)
-    memcpy(framebuffer, image_data, data_len);
-    // Swap from big-endian (file format) to native little-endian
-    swap_bytes_region((uint8_t*)framebuffer, LCD_WIDTH * LCD_HEIGHT);
-
-    // Now flush normally (lcd_flush will swap to big-endian for SPI)
+    // Decode straight into the framebuffer, then flush normally
+    lcd_draw_rle_image(0, 0, LCD_WIDTH, LCD_HEIGHT, rle_data, data_len);
     lcd_flush();
 }
 
@@ -472,33 +473,97 @@ void lcd_draw_bitmap_transparent(uint16_t x, uint16_t y, uint16_t width, uint16_
     }
 }
 
+// RLE format (assets/Splash Converter/convert_compressed.py): a control
+// byte, then either one pixel repeated (bit 7 set) or literal pixels, each
+// (control & 0x7F) + 1 long. Runs may wrap across rows.
+void lcd_draw_rle_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                        const uint8_t* rle_data, size_t data_len) {
+    const uint8_t* p = rle_data;
+    const uint8_t* end = rle_data + data_len;
+    uint16_t col = 0, row = 0;
+
+    while (p < end && row < h) {
+        uint8_t ctrl = *p++;
+        uint16_t count = (ctrl & 0x7F) + 1;
+        bool repeat = (ctrl & 0x80) != 0;
+        if (p + (repeat ? 2 : 2 * count) > end) break;  // Truncated data
+
+        uint16_t color = repeat ? (uint16_t)(p[0] | (p[1] << 8)) : 0;
+        const uint8_t* literal = p;
+        p += repeat ? 2 : 2 * count;
+
+        while (count > 0 && row < h) {
+            uint16_t n = count < (uint16_t)(w - col) ? count : (uint16_t)(w - col);
+            uint16_t dy = y + row;
+            uint16_t x0 = x + col;
+
+            if (dy < LCD_HEIGHT && x0 < LCD_WIDTH) {
+                uint16_t visible = (x0 + n <= LCD_WIDTH) ? n : (uint16_t)(LCD_WIDTH - x0);
+                uint16_t* dst = &framebuffer[dy * LCD_WIDTH + x0];
+                if (repeat) {
+                    for (uint16_t i = 0; i < visible; i++) dst[i] = color;
+                } else {
+                    memcpy(dst, literal, visible * 2);  // Stored little-endian, as in RAM
+                }
+            }
+
+            if (!repeat) literal += 2 * n;
+            count -= n;
+            col += n;
+            if (col == w) {
+                col = 0;
+                row++;
+            }
+        }
+    }
+}
+
+// Icon mask format: per row, a span count followed by (x, length) pairs of
+// opaque pixels, so only drawn pixels cost anything
+void lcd_draw_icon_mask(uint16_t x, uint16_t y, uint16_t height,
+                        const uint8_t* mask, uint16_t color) {
+    for (uint16_t row = 0; row < height; row++) {
+        uint8_t spans = *mask++;
+        uint16_t dy = y + row;
+
+        for (uint8_t s = 0; s < spans; s++, mask += 2) {
+            uint16_t x0 = x + mask[0];
+            uint16_t x1 = x0 + mask[1];
+            if (dy >= LCD_HEIGHT || x0 >= LCD_WIDTH) continue;
+            if (x1 > LCD_WIDTH) x1 = LCD_WIDTH;
+
+            uint16_t* dst = &framebuffer[dy * LCD_WIDTH];
+            for (uint16_t px = x0; px < x1; px++) dst[px] = color;
+        }
+    }
+}
 
 void lcd_draw_plane_icon(uint16_t x, uint16_t y, uint16_t color) {
     #include "assets/img/plane_icon.h"
-    lcd_draw_bitmap_transparent(x, y, AIRCRAFT_ICON_WIDTH, AIRCRAFT_ICON_HEIGHT, aircraft_icon_data, color);
+    lcd_draw_icon_mask(x, y, AIRCRAFT_ICON_HEIGHT, aircraft_icon_mask, color);
 }
 
 void lcd_draw_settings_icon(uint16_t x, uint16_t y, uint16_t color) {
     #include "assets/img/setting_icon.h"
-    lcd_draw_bitmap_transparent(x, y, SETTINGS_ICON_WIDTH, SETTINGS_ICON_HEIGHT, settings_icon_data, color);
+    lcd_draw_icon_mask(x, y, SETTINGS_ICON_HEIGHT, settings_icon_mask, color);
 }
 
 void lcd_draw_wifi_icon(uint16_t x, uint16_t y, bool connected) {
     uint16_t color = connected ? COLOR_GREEN : COLOR_WHITE;
     #include "assets/img/wifi_icon.h"
-    lcd_draw_bitmap_transparent(x, y, WIFI_ICON_WIDTH, WIFI_ICON_HEIGHT, wifi_icon_data, color);
+    lcd_draw_icon_mask(x, y, WIFI_ICON_HEIGHT, wifi_icon_mask, color);
 }
 
 void lcd_draw_gps_icon(uint16_t x, uint16_t y, bool connected) {
     uint16_t color = connected ? COLOR_GREEN : COLOR_WHITE;
     #include "assets/img/gps_icon.h"
-    lcd_draw_bitmap_transparent(x, y, GPS_ICON_WIDTH, GPS_ICON_HEIGHT, gps_icon_data, color);
+    lcd_draw_icon_mask(x, y, GPS_ICON_HEIGHT, gps_icon_mask, color);
 }
 
 void lcd_draw_bluetooth_icon(uint16_t x, uint16_t y, bool connected) {
     uint16_t color = connected ? COLOR_GREEN : COLOR_WHITE;
     #include "assets/img/bluetooth_icon.h"
-    lcd_draw_bitmap_transparent(x, y, BLUETOOTH_ICON_WIDTH, BLUETOOTH_ICON_HEIGHT, bluetooth_icon_data, color);
+    lcd_draw_icon_mask(x, y, BLUETOOTH_ICON_HEIGHT, bluetooth_icon_mask, color);
 }
 
 void lcd_draw_battery_icon(uint16_t x, uint16_t y, uint8_t percentage) {
@@ -512,13 +577,13 @@ void lcd_draw_battery_icon(uint16_t x, uint16_t y, uint8_t percentage) {
         color = COLOR_RED;
     }
     #include "assets/img/battery_icon.h"
-    lcd_draw_bitmap_transparent(x, y, BATTERY_ICON_WIDTH, BATTERY_ICON_HEIGHT, battery_icon_data, color);
+    lcd_draw_icon_mask(x, y, BATTERY_ICON_HEIGHT, battery_icon_mask, color);
 }
 
 void lcd_draw_warning_icon(uint16_t x, uint16_t y, bool active) {
     uint16_t color = active ? COLOR_RED : COLOR_AMBER;
     #include "assets/img/warning_icon.h"
-    lcd_draw_bitmap_transparent(x, y, WARNING_ICON_WIDTH, WARNING_ICON_HEIGHT, warning_icon_data, color);
+    lcd_draw_icon_mask(x, y, WARNING_ICON_HEIGHT, warning_icon_mask, color);
 }
 
 void lcd_draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
@@ -62,8 +62,8 @@ void lcd_flush_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
 // Get pointer to framebuffer (320*240 uint16_t pixels)
 uint16_t* lcd_get_framebuffer(void);
 
-// Display a splash screen from RGB565 buffer
-void lcd_display_splash(const uint8_t* image_data, size_t data_len);
+// Display a full-screen RLE-compressed splash (see lcd_draw_rle_image)
+void lcd_display_splash(const uint8_t* rle_data, size_t data_len);
 
 // Draw status icons
 void lcd_draw_wifi_icon(uint16_t x, uint16_t y, bool connected);
@@ -76,6 +76,15 @@ void lcd_draw_warning_icon(uint16_t x, uint16_t y, bool active);
 void lcd_draw_bitmap_transparent(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
                                   const uint16_t* bitmap_data, uint16_t replace_color);
 
+// Decode an RLE-compressed RGB565 image straight into the framebuffer
+// (generated by assets/Splash Converter/convert_compressed.py)
+void lcd_draw_rle_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                        const uint8_t* rle_data, size_t data_len);
+
+// Fill the opaque spans of an icon mask with one color
+void lcd_draw_icon_mask(uint16_t x, uint16_t y, uint16_t height,
+                        const uint8_t* mask, uint16_t color);
+
 // Radar display functions
 void lcd_draw_circle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t color);
 void lcd_draw_pixel(uint16_t x, uint16_t y, uint16_t color);
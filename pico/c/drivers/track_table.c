@@ -0,0 +1,195 @@
+/**
+ * Traffic Track Table - Implementation
+ */
+
+#include "track_table.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define SLOT_MASK (TRACK_TABLE_SLOTS - 1)
+
+_Static_assert((TRACK_TABLE_CAPACITY & (TRACK_TABLE_CAPACITY - 1)) == 0,
+               "TRACK_TABLE_CAPACITY must be a power of two");
+_Static_assert(TRACK_TABLE_CAPACITY < TRACK_NONE, "track indices are 16-bit");
+_Static_assert(TRACK_TRAIL_LEN <= 255, "trail ring index is 8-bit");
+
+// Home slot; the multiply spreads addresses from the same block
+static uint32_t home_slot(uint32_t icao24) {
+    uint32_t h = icao24 * 0x9E3779B1u;
+    return (h ^ (h >> 16)) & SLOT_MASK;
+}
+
+// Slot holding icao24, or the empty slot where it would go
+static uint32_t probe(const TrackTable* table, uint32_t icao24, bool* found) {
+    uint32_t s = home_slot(icao24);
+    while (table->slots[s] != TRACK_NONE) {
+        if (table->tracks[table->slots[s]].icao24 == icao24) {
+            *found = true;
+            return s;
+        }
+        s = (s + 1) & SLOT_MASK;
+    }
+    *found = false;
+    return s;
+}
+
+// Close the gap at slot s so later probes never stop early (no tombstones)
+static void slot_delete(TrackTable* table, uint32_t s) {
+    uint32_t j = s;
+    while (true) {
+        j = (j + 1) & SLOT_MASK;
+        uint16_t idx = table->slots[j];
+        if (idx == TRACK_NONE) break;
+        uint32_t k = home_slot(table->tracks[idx].icao24);
+        // Movable if its home is not cyclically within (s, j]
+        bool stays = (s <= j) ? (s < k && k <= j) : (s < k || k <= j);
+        if (!stays) {
+            table->slots[s] = idx;
+            s = j;
+        }
+    }
+    table->slots[s] = TRACK_NONE;
+}
+
+static void list_unlink(TrackTable* table, uint16_t idx) {
+    Track* t = &table->tracks[idx];
+    if (t->newer != TRACK_NONE) table->tracks[t->newer].older = t->older;
+    else table->newest = t->older;
+    if (t->older != TRACK_NONE) table->tracks[t->older].newer = t->newer;
+    else table->oldest = t->newer;
+}
+
+static void list_push_newest(TrackTable* table, uint16_t idx) {
+    Track* t = &table->tracks[idx];
+    t->newer = TRACK_NONE;
+    t->older = table->newest;
+    if (table->newest != TRACK_NONE) table->tracks[table->newest].newer = idx;
+    table->newest = idx;
+    if (table->oldest == TRACK_NONE) table->oldest = idx;
+}
+
+void track_table_init(TrackTable* table) {
+    memset(table->tracks, 0, sizeof(table->tracks));
+    for (int i = 0; i < TRACK_TABLE_SLOTS; i++) table->slots[i] = TRACK_NONE;
+    for (int i = 0; i < TRACK_TABLE_CAPACITY; i++) {
+        table->tracks[i].older = (i + 1 < TRACK_TABLE_CAPACITY) ? (uint16_t)(i + 1) : TRACK_NONE;
+    }
+    table->free_head = 0;
+    table->newest = TRACK_NONE;
+    table->oldest = TRACK_NONE;
+    table->count = 0;
+    table->evictions = 0;
+}
+
+static void remove_at(TrackTable* table, uint32_t slot) {
+    uint16_t idx = table->slots[slot];
+    slot_delete(table, slot);
+    list_unlink(table, idx);
+
+    Track* t = &table->tracks[idx];
+    t->icao24 = 0;
+    t->older = table->free_head;
+    table->free_head = idx;
+    table->count--;
+}
+
+void track_table_remove(TrackTable* table, uint32_t icao24) {
+    if (icao24 == 0) return;
+    bool found;
+    uint32_t s = probe(table, icao24, &found);
+    if (found) remove_at(table, s);
+}
+
+Track* track_table_find(TrackTable* table, uint32_t icao24) {
+    if (icao24 == 0) return NULL;
+    bool found;
+    uint32_t s = probe(table, icao24, &found);
+    return found ? &table->tracks[table->slots[s]] : NULL;
+}
+
+Track* track_table_update(TrackTable* table, uint32_t icao24, const char* callsign,
+                          const TrackState* state, uint32_t now_ms) {
+    if (icao24 == 0) return NULL;
+
+    bool found;
+    uint32_t s = probe(table, icao24, &found);
+    Track* t;
+
+    if (found) {
+        uint16_t idx = table->slots[s];
+        t = &table->tracks[idx];
+        list_unlink(table, idx);
+        list_push_newest(table, idx);
+
+        // Previous position into the trail, unless the target is standing still
+        if (abs(state->lat - t->state.lat) >= TRACK_TRAIL_MIN_MOVE_UDEG ||
+            abs(state->lon - t->state.lon) >= TRACK_TRAIL_MIN_MOVE_UDEG) {
+            TrackPoint* p = &t->trail[t->trail_head];
+            p->lat = t->state.lat;
+            p->lon = t->state.lon;
+            p->time_ms = t->last_seen_ms;
+            t->trail_head = (uint8_t)((t->trail_head + 1) % TRACK_TRAIL_LEN);
+            if (t->trail_count < TRACK_TRAIL_LEN) t->trail_count++;
+        }
+    } else {
+        if (table->free_head == TRACK_NONE) {
+            // Full: evict the least recently updated target. Deleting moves
+            // slots around, so probe again for the insert position.
+            track_table_remove(table, table->tracks[table->oldest].icao24);
+            table->evictions++;
+            s = probe(table, icao24, &found);
+        }
+
+        uint16_t idx = table->free_head;
+        t = &table->tracks[idx];
+        table->free_head = t->older;
+        memset(t, 0, sizeof(*t));
+        t->icao24 = icao24;
+        t->first_seen_ms = now_ms;
+        table->slots[s] = idx;
+        list_push_newest(table, idx);
+        table->count++;
+    }
+
+    if (callsign && callsign[0]) {
+        strncpy(t->callsign, callsign, sizeof(t->callsign) - 1);
+        t->callsign[sizeof(t->callsign) - 1] = '\0';
+    }
+    t->state = *state;
+    t->last_seen_ms = now_ms;
+    return t;
+}
+
+int track_table_expire(TrackTable* table, uint32_t now_ms, uint32_t max_age_ms) {
+    int dropped = 0;
+    while (table->oldest != TRACK_NONE) {
+        const Track* t = &table->tracks[table->oldest];
+        if (now_ms - t->last_seen_ms <= max_age_ms) break;
+        track_table_remove(table, t->icao24);
+        dropped++;
+    }
+    return dropped;
+}
+
+const Track* track_table_first(const TrackTable* table) {
+    return table->newest != TRACK_NONE ? &table->tracks[table->newest] : NULL;
+}
+
+const Track* track_table_next(const TrackTable* table, const Track* track) {
+    return track->older != TRACK_NONE ? &table->tracks[track->older] : NULL;
+}
+
+uint32_t track_parse_icao24(const char* hex) {
+    uint32_t value = 0;
+    int digits = 0;
+    for (; *hex && digits < 7; hex++, digits++) {
+        char c = *hex;
+        uint32_t d;
+        if (c >= '0' && c <= '9') d = (uint32_t)(c - '0');
+        else if (c >= 'a' && c <= 'f') d = (uint32_t)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') d = (uint32_t)(c - 'A' + 10);
+        else return 0;
+        value = (value << 4) | d;
+    }
+    return (digits >= 1 && digits <= 6) ? value : 0;
+}
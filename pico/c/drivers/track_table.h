@@ -0,0 +1,132 @@
+/**
+ * Traffic Track Table
+ *
+ * Keeps every target seen by the traffic fetches, keyed by its ICAO 24-bit
+ * address, so identity and history survive from one fetch to the next.
+ * Each target holds its latest state and a short ring of past positions
+ * (the trail drawn behind it on the radar).
+ *
+ * Fixed capacity, no allocation: the lookup is an open-addressed hash
+ * (linear probing, backward-shift deletion, at most half full) of indices
+ * into the track array. Tracks are also on a least-recently-updated list;
+ * when the table is full the oldest target is evicted, and targets no
+ * longer reported are dropped after an age limit.
+ *
+ * Positions and state are packed fixed point (geo_fixed.h).
+ *
+ * Sized by TRACK_TABLE_CAPACITY and TRACK_TRAIL_LEN (~36 KB at 256 targets
+ * with 8-point trails, 140 bytes per target; see sizeof(TrackTable)).
+ *
+ * Not thread-safe: update and read from the same thread/core.
+ */
+
+#ifndef TRACK_TABLE_H
+#define TRACK_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "geo_fixed.h"
+
+#ifndef TRACK_TABLE_CAPACITY
+#define TRACK_TABLE_CAPACITY 256        // Targets; power of two
+#endif
+#ifndef TRACK_TRAIL_LEN
+#define TRACK_TRAIL_LEN 8               // Past positions per target
+#endif
+
+#define TRACK_TABLE_SLOTS (2 * TRACK_TABLE_CAPACITY)
+#define TRACK_NONE 0xFFFF
+#define TRACK_TRAIL_MIN_MOVE_UDEG 500 // ~50 m; smaller moves don't add a trail point
+
+typedef struct {
+    int32_t lat;                // Microdegrees
+    int32_t lon;
+    int16_t alt;                // Tens of feet
+    int16_t speed_kt;
+    uint16_t heading;           // Centidegrees true
+} TrackState;
+
+typedef struct {
+    int32_t lat;                // Microdegrees
+    int32_t lon;
+    uint32_t time_ms;
+} TrackPoint;
+
+typedef struct {
+    uint32_t icao24;            // 0 when the entry is free
+    char callsign[9];
+    uint8_t trail_head;         // Next ring slot to write
+    uint8_t trail_count;
+    TrackState state;
+    uint32_t first_seen_ms;
+    uint32_t last_seen_ms;
+    uint16_t newer;             // Update list links (track indices)
+    uint16_t older;
+    TrackPoint trail[TRACK_TRAIL_LEN];
+} Track;
+
+typedef struct {
+    Track tracks[TRACK_TABLE_CAPACITY];
+    uint16_t slots[TRACK_TABLE_SLOTS];  // Track index or TRACK_NONE
+    uint16_t newest;
+    uint16_t oldest;
+    uint16_t free_head;                 // Free tracks, chained through .older
+    uint16_t count;
+    uint32_t evictions;
+} TrackTable;
+
+/**
+ * Initialize empty
+ */
+void track_table_init(TrackTable* table);
+
+/**
+ * Record a report for icao24 (non-zero) at now_ms
+ * Creates the track if it is new, evicting the least recently updated one
+ * when the table is full. The previous position moves into the trail.
+ * callsign may be NULL or empty to keep the known one.
+ * Returns the track, or NULL for icao24 == 0.
+ */
+Track* track_table_update(TrackTable* table, uint32_t icao24, const char* callsign,
+                          const TrackState* state, uint32_t now_ms);
+
+/**
+ * Track for icao24, or NULL
+ */
+Track* track_table_find(TrackTable* table, uint32_t icao24);
+
+/**
+ * Drop one target
+ */
+void track_table_remove(TrackTable* table, uint32_t icao24);
+
+/**
+ * Drop targets not updated within max_age_ms of now_ms
+ * Returns how many were dropped.
+ */
+int track_table_expire(TrackTable* table, uint32_t now_ms, uint32_t max_age_ms);
+
+/**
+ * Iterate from the most to the least recently updated target:
+ *   for (const Track* t = track_table_first(table); t; t = track_table_next(table, t))
+ */
+const Track* track_table_first(const TrackTable* table);
+const Track* track_table_next(const TrackTable* table, const Track* track);
+
+/**
+ * Trail point `age` steps back (0 = the most recent past position), or NULL
+ * The current position is track->state, not part of the trail.
+ */
+static inline const TrackPoint* track_trail_point(const Track* track, int age) {
+    if (age < 0 || age >= track->trail_count) return 0;
+    int i = (int)track->trail_head - 1 - age;
+    if (i < 0) i += TRACK_TRAIL_LEN;
+    return &track->trail[i];
+}
+
+/**
+ * Parse a hex ICAO 24-bit address ("4ca7b3"); 0 if invalid
+ */
+uint32_t track_parse_icao24(const char* hex);
+
+#endif // TRACK_TABLE_H
@@ -1,4 +1,5 @@
 #include "wifi_manager.h"
+#include "profiler.h"
 #include "pico/stdlib.h"
 #include "pico/cyw43_arch.h"
 #include <stdio.h>
@@ -47,9 +48,8 @@ bool wifi_is_connected(void) {
     return cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) == CYW43_LINK_UP;
 }
 
-void wifi_poll(void) {
-    cyw43_arch_poll();
-
+// Link supervision, split out so wifi_poll() can time the whole call
+static void wifi_check_link(void) {
     if (!g_started) return;
 
     int s = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
@@ -71,3 +71,10 @@ void wifi_poll(void) {
         }
     }
 }
+
+void wifi_poll(void) {
+    uint32_t prof_t = prof_begin();
+    cyw43_arch_poll();
+    wifi_check_link();
+    prof_end(PROF_WIFI_POLL, prof_t);
+}
@@ -1,5 +1,6 @@
 #include "xpt2046_touch.h"
 #include "st7789_lcd.h"
+#include "profiler.h"
 #include "hardware/spi.h"
 #include "hardware/gpio.h"
 #include "pico/stdlib.h"
@@ -80,6 +81,7 @@ void touch_read_raw(uint16_t *x_raw, uint16_t *y_raw) {
 }
 
 bool touch_read(uint16_t *x, uint16_t *y) {
+    uint32_t prof_t = prof_begin();
     touch_spi_begin();
 
     uint16_t z1 = touch_read_channel(CMD_READ_Z1);
@@ -87,6 +89,7 @@ bool touch_read(uint16_t *x, uint16_t *y) {
     if (z1 < Z_THRESHOLD) {
         touch_spi_end();
         lift_count = 0;
+        prof_end(PROF_TOUCH_READ, prof_t);
         return false;
     }
     lift_count = 0;
@@ -96,6 +99,7 @@ bool touch_read(uint16_t *x, uint16_t *y) {
     sleep_us(10);
     uint16_t y_raw = sample_channel(CMD_READ_Y);
     touch_spi_end();
+    prof_end(PROF_TOUCH_READ, prof_t);
 
     // Affine transform — maps raw ADC to screen coords directly
     int32_t sx = (int32_t)(CAL_AX * x_raw + CAL_BX * y_raw + CAL_CX);
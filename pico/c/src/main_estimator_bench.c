@@ -0,0 +1,566 @@
+/**
+ * Attitude Estimator Benchmark
+ *
+ * Runs every estimator engine (Madgwick, Mahony, ESKF) over the same IMU
+ * datasets, in 6-DOF and 9-DOF mode, and reports the cost per update and
+ * the attitude error against the reference:
+ *   tilt     angle between true and estimated "up" (roll/pitch error)
+ *   heading  yaw error, 9-DOF mode only (6-DOF yaw is free to drift)
+ *
+ * The same source builds for both boards:
+ *   Pico 2W:       estimator_bench target, cost in CPU cycles (DWT cycle
+ *                  counter), report on USB serial
+ *   Host / RPi:    rpi/c/debug Makefile, cost in nanoseconds, and
+ *                  ./estimator_bench recording.csv replays a recording
+ *
+ * Built-in datasets are generated deterministically from analytic motion
+ * (identical samples on every board), with sensor noise, gyro bias and
+ * 100 Hz magnetometer updates:
+ *   level     parked, slightly tilted
+ *   coning    ±25° roll / ±15° pitch oscillation while slowly yawing
+ *   turns     coordinated 30° banked turns at 50 m/s (accel sees no
+ *             gravity tilt, the classic complementary-filter trap)
+ *
+ * Recording format (one header line, then one row per sample):
+ *   t_s,gx,gy,gz,ax,ay,az,mx,my,mz[,roll_deg,pitch_deg,yaw_deg]
+ * gyro in rad/s, accel in g, mag in µT (calibrated, sensor frame, 0 if
+ * none), optional reference attitude in the quaternion.h convention.
+ */
+
+#ifndef LIB_PICO_STDLIB
+#define _DEFAULT_SOURCE     // clock_gettime() and M_PI on the host
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "madgwick_filter.h"
+#include "mahony_filter.h"
+#include "eskf_filter.h"
+#include "attitude_estimator.h"
+
+#ifdef LIB_PICO_STDLIB
+#define BENCH_ON_TARGET 1
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#else
+#include <stdlib.h>
+#include <time.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define D2R (M_PI / 180.0)
+#define R2D (180.0 / M_PI)
+
+#define BENCH_RATE_HZ   500     // Built-in dataset sample rate
+#define BENCH_MAG_DIV   5       // Magnetometer updates at 100 Hz
+#define BENCH_CHUNK     256     // Samples generated, then timed, per batch
+
+// ── Timing ────────────────────────────────────────────────────────────────────
+
+#ifdef BENCH_ON_TARGET
+// Cortex-M33 DWT cycle counter
+#define DEMCR      (*(volatile uint32_t*)0xE000EDFCu)
+#define DWT_CTRL   (*(volatile uint32_t*)0xE0001000u)
+#define DWT_CYCCNT (*(volatile uint32_t*)0xE0001004u)
+
+typedef uint32_t bench_ticks_t;
+#define BENCH_UNIT "cycles"
+
+static void bench_timer_init(void) {
+    DEMCR |= (1u << 24);    // TRCENA
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1u;         // CYCCNTENA
+}
+
+static inline bench_ticks_t bench_now(void) {
+    return DWT_CYCCNT;
+}
+#else
+typedef uint64_t bench_ticks_t;
+#define BENCH_UNIT "ns"
+
+static void bench_timer_init(void) {
+}
+
+static inline bench_ticks_t bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+#endif
+
+// ── Samples ───────────────────────────────────────────────────────────────────
+
+typedef struct {
+    float dt;               // Time since previous sample (s)
+    float g[3];             // Gyro (rad/s)
+    float a[3];             // Accel (g)
+    float m[3];             // Mag (µT), held between magnetometer updates
+    bool has_ref;
+    Quaternion ref;         // Reference attitude
+} BenchSample;
+
+typedef struct {
+    const char* name;
+    float duration_s;
+} BenchDataset;
+
+static const BenchDataset datasets[] = {
+    {"level",  20.0f},
+    {"coning", 30.0f},
+    {"turns",  60.0f},
+};
+#define NUM_DATASETS (int)(sizeof(datasets) / sizeof(datasets[0]))
+
+// Deterministic gaussian noise (Box-Muller on a small LCG)
+static uint64_t rng_state;
+static double randn(void) {
+    rng_state = rng_state * 6364136223846793005ull + 1442695040888963407ull;
+    double u1 = ((rng_state >> 11) + 1.0) / 9007199254740993.0;
+    rng_state = rng_state * 6364136223846793005ull + 1442695040888963407ull;
+    double u2 = (rng_state >> 11) / 9007199254740992.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static Quaternion quat_mul(const Quaternion* a, const Quaternion* b) {
+    Quaternion r = {
+        a->q0 * b->q0 - a->q1 * b->q1 - a->q2 * b->q2 - a->q3 * b->q3,
+        a->q0 * b->q1 + a->q1 * b->q0 + a->q2 * b->q3 - a->q3 * b->q2,
+        a->q0 * b->q2 - a->q1 * b->q3 + a->q2 * b->q0 + a->q3 * b->q1,
+        a->q0 * b->q3 + a->q1 * b->q2 - a->q2 * b->q1 + a->q3 * b->q0
+    };
+    return r;
+}
+
+// Rotate an earth-frame vector into the sensor frame (R' v)
+static void earth_to_sensor(const Quaternion* q, const double v[3], float out[3]) {
+    Quaternion qc = {q->q0, -q->q1, -q->q2, -q->q3};
+    Quaternion p = {0.0f, (float)v[0], (float)v[1], (float)v[2]};
+    Quaternion t = quat_mul(&qc, &p);
+    Quaternion r = quat_mul(&t, q);
+    out[0] = r.q1;
+    out[1] = r.q2;
+    out[2] = r.q3;
+}
+
+// Synthetic dataset generator
+typedef struct {
+    int dataset;
+    long index;
+    long count;
+    double heading;         // Integrated yaw for the turns dataset (rad)
+    Quaternion q_prev;
+    float mag_hold[3];
+} BenchGen;
+
+#define TURN_SPEED_MPS  50.0
+#define GRAVITY         9.80665
+
+// Bank angle profile for the turns dataset: level, right turn, level, left turn
+static double turns_bank(double t) {
+    double cycle = fmod(t, 30.0);
+    double sign = fmod(t, 60.0) < 30.0 ? 1.0 : -1.0;
+    double bank = 30.0 * D2R;
+    if (cycle < 5.0) return 0.0;
+    if (cycle < 8.0) return sign * bank * (cycle - 5.0) / 3.0;
+    if (cycle < 23.0) return sign * bank;
+    if (cycle < 26.0) return sign * bank * (26.0 - cycle) / 3.0;
+    return 0.0;
+}
+
+// True Euler angles (rad) at time t; also specific force in the earth frame (g)
+static void gen_truth(BenchGen* gen, double t, double dt, double euler[3], double force[3]) {
+    force[0] = 0.0;
+    force[1] = 0.0;
+    force[2] = 1.0;
+
+    switch (gen->dataset) {
+    case 0:
+        euler[0] = 2.0 * D2R;
+        euler[1] = -3.0 * D2R;
+        euler[2] = 30.0 * D2R;
+        break;
+    case 1:
+        euler[0] = 25.0 * D2R * sin(2.0 * M_PI * 0.5 * t);
+        euler[1] = 15.0 * D2R * sin(2.0 * M_PI * 0.3 * t + 1.0);
+        euler[2] = 10.0 * D2R * t;
+        break;
+    default: {
+        // Coordinated turn: right wing down (positive roll) turns clockwise from above
+        double bank = turns_bank(t);
+        double yaw_rate = -GRAVITY * tan(bank) / TURN_SPEED_MPS;
+        gen->heading += yaw_rate * dt;
+        euler[0] = bank;
+        euler[1] = 2.0 * D2R;
+        euler[2] = gen->heading;
+        // Centripetal acceleration of the flight path, in g
+        force[0] = TURN_SPEED_MPS * yaw_rate * -sin(gen->heading) / GRAVITY;
+        force[1] = TURN_SPEED_MPS * yaw_rate * cos(gen->heading) / GRAVITY;
+        break;
+    }
+    }
+}
+
+static void gen_reset(BenchGen* gen, int dataset) {
+    memset(gen, 0, sizeof(*gen));
+    gen->dataset = dataset;
+    gen->count = (long)(datasets[dataset].duration_s * BENCH_RATE_HZ);
+    rng_state = 12345 + dataset;
+
+    double euler[3], force[3];
+    gen_truth(gen, 0.0, 0.0, euler, force);
+    quaternion_from_euler(&gen->q_prev, (float)euler[0], (float)euler[1], (float)euler[2]);
+}
+
+static const Quaternion* gen_initial(const BenchGen* gen) {
+    return &gen->q_prev;
+}
+
+static int gen_fill(BenchGen* gen, BenchSample* out, int max) {
+    const double dt = 1.0 / BENCH_RATE_HZ;
+    const double gyro_bias[3] = {0.2 * D2R, -0.15 * D2R, 0.1 * D2R};
+    const double earth_field[3] = {15.0, 0.0, -48.0};    // µT, northern Europe
+    int n = 0;
+
+    while (n < max && gen->index < gen->count) {
+        double t = (gen->index + 1) * dt;
+        double euler[3], force[3];
+        gen_truth(gen, t, dt, euler, force);
+
+        Quaternion q;
+        quaternion_from_euler(&q, (float)euler[0], (float)euler[1], (float)euler[2]);
+
+        // Average body rate over the interval: q_prev* ⊗ q = [cos, sin * axis]
+        Quaternion qc = {gen->q_prev.q0, -gen->q_prev.q1, -gen->q_prev.q2, -gen->q_prev.q3};
+        Quaternion d = quat_mul(&qc, &q);
+        if (d.q0 < 0.0f) {
+            d.q0 = -d.q0; d.q1 = -d.q1; d.q2 = -d.q2; d.q3 = -d.q3;
+        }
+
+        BenchSample* s = &out[n++];
+        s->dt = (float)dt;
+        s->g[0] = (float)(2.0 * d.q1 / dt + gyro_bias[0] + 0.1 * D2R * randn());
+        s->g[1] = (float)(2.0 * d.q2 / dt + gyro_bias[1] + 0.1 * D2R * randn());
+        s->g[2] = (float)(2.0 * d.q3 / dt + gyro_bias[2] + 0.1 * D2R * randn());
+
+        earth_to_sensor(&q, force, s->a);
+        double vib = gen->dataset == 2 ? 0.02 * sin(2.0 * M_PI * 60.0 * t) : 0.0;
+        s->a[0] += (float)(0.01 * randn());
+        s->a[1] += (float)(0.01 * randn());
+        s->a[2] += (float)(0.01 * randn() + vib);
+
+        if (gen->index % BENCH_MAG_DIV == 0) {
+            earth_to_sensor(&q, earth_field, gen->mag_hold);
+            for (int i = 0; i < 3; i++) gen->mag_hold[i] += (float)(0.3 * randn());
+        }
+        memcpy(s->m, gen->mag_hold, sizeof(s->m));
+
+        s->has_ref = true;
+        s->ref = q;
+        gen->q_prev = q;
+        gen->index++;
+    }
+    return n;
+}
+
+// ── Engines ───────────────────────────────────────────────────────────────────
+
+enum { ENGINE_MADGWICK, ENGINE_MAHONY, ENGINE_ESKF, NUM_ENGINES };
+static const char* const engine_names[NUM_ENGINES] = {"Madgwick", "Mahony", "ESKF"};
+
+typedef union {
+    MadgwickFilter madgwick;
+    MahonyFilter mahony;
+    EskfFilter eskf;
+} EngineState;
+
+static void engine_init(int engine, EngineState* st, const Quaternion* q0) {
+    switch (engine) {
+    case ENGINE_MADGWICK:
+        madgwick_init(&st->madgwick, BENCH_RATE_HZ, ESTIMATOR_MADGWICK_BETA);
+        st->madgwick.q = *q0;
+        break;
+    case ENGINE_MAHONY:
+        mahony_init(&st->mahony, BENCH_RATE_HZ, ESTIMATOR_MAHONY_KP, ESTIMATOR_MAHONY_KI);
+        st->mahony.q = *q0;
+        break;
+    default:
+        eskf_init(&st->eskf, BENCH_RATE_HZ);
+        st->eskf.q = *q0;
+        break;
+    }
+}
+
+// Same per-sample work as the AHRS loop: set dt, update, copy the quaternion out
+#define RUN_ENGINE(f, update_marg, update_imu)                                          \
+    for (int i = 0; i < n; i++) {                                                       \
+        const BenchSample* s = &in[i];                                                  \
+        (f)->sample_freq = 1.0f / s->dt;                                                \
+        (f)->inv_sample_freq = s->dt;                                                   \
+        if (marg) {                                                                     \
+            update_marg((f), s->g[0], s->g[1], s->g[2], s->a[0], s->a[1], s->a[2],      \
+                        s->m[0], s->m[1], s->m[2]);                                     \
+        } else {                                                                        \
+            update_imu((f), s->g[0], s->g[1], s->g[2], s->a[0], s->a[1], s->a[2]);      \
+        }                                                                               \
+        out[i] = (f)->q;                                                                \
+    }
+
+static bench_ticks_t engine_run(int engine, EngineState* st, bool marg,
+                                const BenchSample* in, Quaternion* out, int n) {
+    bench_ticks_t t0 = bench_now();
+    switch (engine) {
+    case ENGINE_MADGWICK:
+        RUN_ENGINE(&st->madgwick, madgwick_update, madgwick_update_imu);
+        break;
+    case ENGINE_MAHONY:
+        RUN_ENGINE(&st->mahony, mahony_update, mahony_update_imu);
+        break;
+    default:
+        RUN_ENGINE(&st->eskf, eskf_update, eskf_update_imu);
+        break;
+    }
+    return (bench_ticks_t)(bench_now() - t0);
+}
+
+// ── Scoring ───────────────────────────────────────────────────────────────────
+
+typedef struct {
+    double ticks;
+    long updates;
+    double tilt_sq, tilt_max;
+    double hdg_sq, hdg_max;
+    long scored;
+} BenchResult;
+
+static double wrap_deg(double a) {
+    while (a > 180.0) a -= 360.0;
+    while (a < -180.0) a += 360.0;
+    return a;
+}
+
+static void score(BenchResult* res, const Quaternion* est, const Quaternion* ref) {
+    float ue[3], ur[3];
+    quaternion_up_vector(est, ue);
+    quaternion_up_vector(ref, ur);
+    double dot = ue[0] * ur[0] + ue[1] * ur[1] + ue[2] * ur[2];
+    if (dot > 1.0) dot = 1.0;
+    double tilt = acos(dot) * R2D;
+
+    float r, p, ye, yr;
+    quaternion_to_euler(est, &r, &p, &ye);
+    quaternion_to_euler(ref, &r, &p, &yr);
+    double hdg = fabs(wrap_deg((ye - yr) * R2D));
+
+    res->tilt_sq += tilt * tilt;
+    if (tilt > res->tilt_max) res->tilt_max = tilt;
+    res->hdg_sq += hdg * hdg;
+    if (hdg > res->hdg_max) res->hdg_max = hdg;
+    res->scored++;
+}
+
+static void print_header(void) {
+    printf("%-8s %-5s %-9s %10s %9s %9s %9s %9s\n",
+           "dataset", "mode", "engine", BENCH_UNIT "/upd", "tilt_rms", "tilt_max", "hdg_rms", "hdg_max");
+}
+
+static void print_result(const char* dataset, bool marg, int engine, const BenchResult* res) {
+    printf("%-8s %-5s %-9s %10.1f", dataset, marg ? "MARG" : "IMU", engine_names[engine],
+           res->updates ? res->ticks / res->updates : 0.0);
+    if (res->scored) {
+        printf(" %9.3f %9.3f", sqrt(res->tilt_sq / res->scored), res->tilt_max);
+        if (marg) {
+            printf(" %9.3f %9.3f\n", sqrt(res->hdg_sq / res->scored), res->hdg_max);
+        } else {
+            printf(" %9s %9s\n", "-", "-");
+        }
+    } else {
+        printf(" %9s %9s %9s %9s\n", "-", "-", "-", "-");
+    }
+}
+
+static BenchSample chunk[BENCH_CHUNK];
+static Quaternion estimates[BENCH_CHUNK];
+
+static void run_builtin(void) {
+    print_header();
+    for (int d = 0; d < NUM_DATASETS; d++) {
+        for (int mode = 0; mode < 2; mode++) {
+            bool marg = mode == 1;
+            for (int e = 0; e < NUM_ENGINES; e++) {
+                BenchGen gen;
+                EngineState st;
+                BenchResult res = {0};
+
+                gen_reset(&gen, d);
+                engine_init(e, &st, gen_initial(&gen));
+
+                int n;
+                while ((n = gen_fill(&gen, chunk, BENCH_CHUNK)) > 0) {
+                    res.ticks += engine_run(e, &st, marg, chunk, estimates, n);
+                    res.updates += n;
+                    for (int i = 0; i < n; i++) score(&res, &estimates[i], &chunk[i].ref);
+                }
+                print_result(datasets[d].name, marg, e, &res);
+            }
+        }
+    }
+}
+
+// ── Recorded datasets (host only) ─────────────────────────────────────────────
+
+#ifndef BENCH_ON_TARGET
+
+typedef struct {
+    BenchSample* samples;
+    long count;
+    bool has_mag;
+} Recording;
+
+static bool load_recording(const char* path, Recording* rec) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    char line[512];
+    long cap = 4096;
+    double last_t = NAN;
+    memset(rec, 0, sizeof(*rec));
+    rec->samples = malloc(cap * sizeof(BenchSample));
+    if (!rec->samples || !fgets(line, sizeof(line), f)) {
+        fclose(f);
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), f)) {
+        double v[13];
+        int cols = sscanf(line, "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf",
+                          &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6],
+                          &v[7], &v[8], &v[9], &v[10], &v[11], &v[12]);
+        if (cols < 10) continue;
+
+        if (rec->count == cap) {
+            cap *= 2;
+            BenchSample* grown = realloc(rec->samples, cap * sizeof(BenchSample));
+            if (!grown) break;
+            rec->samples = grown;
+        }
+
+        BenchSample* s = &rec->samples[rec->count++];
+        s->dt = isnan(last_t) ? 1.0f / BENCH_RATE_HZ : (float)(v[0] - last_t);
+        if (!(s->dt > 0.0f)) s->dt = 1.0f / BENCH_RATE_HZ;
+        last_t = v[0];
+        for (int i = 0; i < 3; i++) {
+            s->g[i] = (float)v[1 + i];
+            s->a[i] = (float)v[4 + i];
+            s->m[i] = (float)v[7 + i];
+        }
+        if (s->m[0] != 0.0f || s->m[1] != 0.0f || s->m[2] != 0.0f) rec->has_mag = true;
+
+        s->has_ref = cols >= 13;
+        if (s->has_ref) {
+            quaternion_from_euler(&s->ref, (float)(v[10] * D2R), (float)(v[11] * D2R),
+                                  (float)(v[12] * D2R));
+        }
+    }
+    fclose(f);
+    return rec->count > 0;
+}
+
+static int run_recording(const char* path) {
+    Recording rec;
+    if (!load_recording(path, &rec)) {
+        fprintf(stderr, "%s: no samples\n", path);
+        free(rec.samples);
+        return 1;
+    }
+
+    // Seed from the reference if present, else from the first accelerometer sample
+    Quaternion q0;
+    const BenchSample* first = &rec.samples[0];
+    if (first->has_ref) {
+        q0 = first->ref;
+    } else {
+        float r = atan2f(first->a[1], first->a[2]);
+        float p = atan2f(-first->a[0], sqrtf(first->a[1] * first->a[1] + first->a[2] * first->a[2]));
+        quaternion_from_euler(&q0, r, p, 0.0f);
+    }
+
+    printf("Recording %s: %ld samples%s%s\n", path, rec.count,
+           rec.has_mag ? ", magnetometer" : "", first->has_ref ? ", reference attitude" : "");
+    print_header();
+
+    Quaternion* est = malloc(rec.count * sizeof(Quaternion));
+    if (!est) {
+        free(rec.samples);
+        return 1;
+    }
+
+    for (int mode = 0; mode < (rec.has_mag ? 2 : 1); mode++) {
+        bool marg = mode == 1;
+        for (int e = 0; e < NUM_ENGINES; e++) {
+            EngineState st;
+            BenchResult res = {0};
+            engine_init(e, &st, &q0);
+
+            for (long off = 0; off < rec.count; off += BENCH_CHUNK) {
+                int n = rec.count - off < BENCH_CHUNK ? (int)(rec.count - off) : BENCH_CHUNK;
+                res.ticks += engine_run(e, &st, marg, &rec.samples[off], &est[off], n);
+                res.updates += n;
+            }
+            for (long i = 0; i < rec.count; i++) {
+                if (rec.samples[i].has_ref) score(&res, &est[i], &rec.samples[i].ref);
+            }
+            print_result("recorded", marg, e, &res);
+        }
+    }
+
+    free(est);
+    free(rec.samples);
+    return 0;
+}
+
+#endif
+
+// ── Main ──────────────────────────────────────────────────────────────────────
+
+#ifdef BENCH_ON_TARGET
+
+int main(void) {
+    stdio_init_all();
+    while (!stdio_usb_connected()) sleep_ms(100);
+    sleep_ms(500);
+
+    bench_timer_init();
+
+    while (true) {
+        printf("\n=== Attitude Estimator Benchmark (Pico 2W, %lu MHz, %d Hz datasets) ===\n",
+               (unsigned long)(clock_get_hz(clk_sys) / 1000000), BENCH_RATE_HZ);
+        printf("Application build uses: %s\n", ATTITUDE_ESTIMATOR_NAME);
+        run_builtin();
+        printf("Press any key to run again\n");
+        getchar();
+    }
+}
+
+#else
+
+int main(int argc, char* argv[]) {
+    bench_timer_init();
+    if (argc > 1) {
+        return run_recording(argv[1]);
+    }
+    printf("=== Attitude Estimator Benchmark (host, %d Hz datasets) ===\n", BENCH_RATE_HZ);
+    run_builtin();
+    return 0;
+}
+
+#endif
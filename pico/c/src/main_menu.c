@@ -11,6 +11,7 @@
 #include "hardware/gpio.h"
 #include "st7789_lcd.h"
 #include "img/splash_data.h"
+#include "img/plane_icon.h"
 #include "menu.h"
 #include "xpt2046_touch.h"
 #include "telemetry_parser.h"
@@ -20,11 +21,20 @@
 #include "opensky_client.h"
 #include "bluetooth_manager.h"
 #include "ahrs_core.h"
+#include "profiler.h"
+#include "usb_commands.h"
+#include "imu_stream.h"
+#include "flight_log.h"
+#include "boot_timeline.h"
+#include "sprite.h"
+#include "latency_hist.h"
+#include "track_table.h"
 
 #define LED_PIN 25
 
-// Traffic data populated by OpenSky fetches
+// Latest OpenSky fetch (own position) and every target seen, with trails
 static TelemetryData latest_telemetry;
+static TrackTable radar_tracks;
 
 // Navigation flag: set by action_radar to signal "ribbon pressed → return to menu"
 static bool g_radar_exit_to_menu = false;
@@ -50,6 +60,142 @@ void draw_status_icons(void) {
     draw_ribbon_internal();
 }
 
+// ── Background services ───────────────────────────────────────────────────────
+
+#define LOG_ATTITUDE_INTERVAL_MS  200     // 5 Hz
+#define LOG_DIAG_INTERVAL_MS      5000
+
+// Sample the AHRS output into the flight log at fixed rates
+static void flight_log_sample(void) {
+    static uint32_t last_attitude_ms = 0;
+    static uint32_t last_diag_ms = 0;
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+
+    if (now - last_attitude_ms < LOG_ATTITUDE_INTERVAL_MS) return;
+    last_attitude_ms = now;
+
+    AHRSAttitude att;
+    if (!ahrs_core_get_attitude(&att)) return;
+
+    uint8_t flags = 0;
+    if (att.heading_valid) flags |= FLIGHT_LOG_FLAG_HEADING_VALID;
+    if (att.stationary) flags |= FLIGHT_LOG_FLAG_STATIONARY;
+    flight_log_attitude(att.roll, att.pitch, att.yaw, flags);
+
+    if (now - last_diag_ms >= LOG_DIAG_INTERVAL_MS) {
+        last_diag_ms = now;
+        FlightLogDiag diag = {
+            .loop_rate_dhz = (uint16_t)(att.loop_rate_hz * 10.0f + 0.5f),
+            .jitter_us = (uint16_t)fminf(att.timing_jitter_ms * 1000.0f, 65535.0f),
+            .gyro_bias_mdps = {
+                (int16_t)lroundf(att.gyro_bias_x * 1000.0f),
+                (int16_t)lroundf(att.gyro_bias_y * 1000.0f),
+                (int16_t)lroundf(att.gyro_bias_z * 1000.0f),
+            },
+            .wifi_up = wifi_is_connected(),
+            .bt_connected = bt_is_connected(),
+        };
+        flight_log_diag(&diag);
+    }
+}
+
+// Print the boot timeline once the first attitude is out, and turn the
+// LED off to show the AHRS is ready
+static void boot_report_poll(void) {
+    static bool reported = false;
+    if (reported || boot_attitude_us() == 0) return;
+    reported = true;
+    gpio_put(LED_PIN, 0);
+    boot_timeline_print();
+}
+
+// Called from every UI loop: keeps WiFi alive, answers USB console commands,
+// drains the binary IMU stream and appends to the flight log
+static void service_poll(void) {
+    wifi_poll();
+    usb_commands_poll();
+    imu_stream_service();
+    flight_log_sample();
+    flight_log_poll();
+    boot_report_poll();
+}
+
+// "stream on" starts binary packets immediately (no reply, the capture tool
+// is already reading); "stream off" stops them and reports the totals
+static void cmd_stream(const char* args) {
+    uint32_t sent, dropped;
+
+    if (strcmp(args, "on") == 0) {
+        imu_stream_enable(true);
+        return;
+    }
+    if (strcmp(args, "off") == 0) {
+        imu_stream_enable(false);
+        imu_stream_service();
+    }
+
+    imu_stream_get_stats(&sent, &dropped);
+    printf("[USB] Stream %s: %lu packets sent, %lu dropped\n",
+           imu_stream_enabled() ? "on" : "off",
+           (unsigned long)sent, (unsigned long)dropped);
+}
+
+// "log" prints the ring status, "log dump" the records as CSV (oldest first),
+// "log erase" clears the whole region
+static void cmd_log(const char* args) {
+    if (strcmp(args, "dump") == 0) {
+        flight_log_flush();
+        flight_log_dump();
+        return;
+    }
+    if (strcmp(args, "erase") == 0) {
+        flight_log_erase();
+    }
+
+    FlightLogStatus st;
+    flight_log_get_status(&st);
+    printf("[LOG] Session %u: %lu/%lu pages valid, seq %lu-%lu\n",
+           st.session, (unsigned long)st.pages_valid, (unsigned long)st.pages_total,
+           (unsigned long)st.oldest_seq, (unsigned long)st.newest_seq);
+}
+
+static void cmd_boot(const char* args) {
+    boot_timeline_print();
+}
+
+// ── Sensor-to-panel latency ───────────────────────────────────────────────────
+
+// AHRS sample timestamp to the end of the lcd_flush() that showed it
+#define LATENCY_BIN_US  1000
+static LatencyHist ahrs_latency;
+static bool latency_overlay = false;
+
+static void latency_print(void) {
+    LatencySummary s;
+    latency_hist_summary(&ahrs_latency, &s);
+    printf("[LAT] %lu frames: p50 %.1f p95 %.1f p99 %.1f ms (min %.1f mean %.1f max %.1f)\n",
+           (unsigned long)s.count, s.p50_us / 1000.0f, s.p95_us / 1000.0f, s.p99_us / 1000.0f,
+           s.min_us / 1000.0f, s.mean_us / 1000.0f, s.max_us / 1000.0f);
+}
+
+// "latency" prints the histogram percentiles, "latency reset" starts over,
+// "latency overlay" toggles the readout on the AHRS screen
+static void cmd_latency(const char* args) {
+    if (strcmp(args, "reset") == 0) {
+        latency_hist_reset(&ahrs_latency);
+    } else if (strcmp(args, "overlay") == 0) {
+        latency_overlay = !latency_overlay;
+    }
+    latency_print();
+}
+
+static const UsbCommand usb_app_commands[] = {
+    {"boot", "Boot timeline and time to first attitude", cmd_boot},
+    {"stream", "Binary IMU stream (stream on|off)", cmd_stream},
+    {"log", "Flight log (log [dump|erase])", cmd_log},
+    {"latency", "Sensor-to-panel latency (latency [reset|overlay])", cmd_latency},
+};
+
 // ── Bluetooth pairing ─────────────────────────────────────────────────────────
 
 #define BT_LIST_Y_START 75
@@ -320,14 +466,41 @@ void action_bluetooth(void) {
 #define RDR_PX   213
 #define RDR_PANEL_BG  0x2104
 #define KM_TO_PX  3.23f
-
-#define OPENSKY_INTERVAL_MS  15000
-
-static int16_t  prev_ac_x[MAX_TRAFFIC];
-static int16_t  prev_ac_y[MAX_TRAFFIC];
-static uint8_t  prev_ac_ti[MAX_TRAFFIC];
+#define RDR_SYM_SCALE  0.75f // Traffic symbol: 24px icon -> ~15px on screen
+#define RDR_SYM_R      12    // sprite_radius() at RDR_SYM_SCALE
+#define RDR_LABEL_W    (7 * 6)
+#define RDR_MAX_BLIPS  48
+#define RDR_TRAIL_COLOR 0x8410   // Grey
+
+static int16_t  prev_ac_x[RDR_MAX_BLIPS];
+static int16_t  prev_ac_y[RDR_MAX_BLIPS];
+static uint32_t prev_ac_icao[RDR_MAX_BLIPS];
 static uint8_t  prev_ac_count = 0;
-static int      radar_selected = -1;
+static uint32_t radar_selected = 0;   // icao24, 0 = none; kept across fetches
+static bool     radar_tracks_ready = false;
+static OpenSkyScheduler radar_sched;  // Fetch cadence and credit budget
+static SpriteTexture aircraft_sprite;
+static GeoProjection radar_proj;      // Own position to screen pixels, per redraw
+
+// Blip index of the selected target, -1 if it is not on the radar
+static int radar_selected_blip(void) {
+    for (int i = 0; i < prev_ac_count; i++)
+        if (prev_ac_icao[i] == radar_selected) return i;
+    return -1;
+}
+
+// Screen position of a target relative to own position (north up),
+// through radar_proj; far-off points are clamped, still off the scope
+static void radar_project(int32_t lat, int32_t lon, int16_t *sx, int16_t *sy) {
+    int32_t east, north;
+    geo_project(&radar_proj, lat, lon, &east, &north);
+    if (east > 10000) east = 10000;
+    if (east < -10000) east = -10000;
+    if (north > 10000) north = 10000;
+    if (north < -10000) north = -10000;
+    *sx = (int16_t)(RDR_CX + east);
+    *sy = (int16_t)(RDR_CY - north);
+}
 
 static void radar_draw_static(void) {
     lcd_clear(COLOR_BLACK);
@@ -368,52 +541,48 @@ static void radar_draw_panel(void) {
     // Clear info area (above nav buttons)
     lcd_fill_rect(RDR_PX + 1, 29, 319 - RDR_PX, RDR_BTN_Y - 29, bg);
 
-    if (radar_selected < 0 || radar_selected >= latest_telemetry.traffic_count) {
+    const Track *t = track_table_find(&radar_tracks, radar_selected);
+    if (!t) {
         char buf[16];
-        snprintf(buf, sizeof(buf), "TFC: %d", latest_telemetry.traffic_count);
+        snprintf(buf, sizeof(buf), "TFC: %d", prev_ac_count);
         lcd_draw_string(px,  50, buf,     COLOR_CYAN,  bg);
         lcd_draw_string(px,  90, "Tap",   COLOR_WHITE, bg);
         lcd_draw_string(px, 103, "a blip",COLOR_WHITE, bg);
         lcd_draw_string(px, 120, "or use", COLOR_WHITE, bg);
         lcd_draw_string(px, 133, "arrows", COLOR_WHITE, bg);
     } else {
-        TrafficData *t = &latest_telemetry.traffic[radar_selected];
-
         // Callsign — big, yellow
-        lcd_draw_string_scaled(px, 34, t->id, COLOR_YELLOW, bg, 2);
+        lcd_draw_string_scaled(px, 34, t->callsign, COLOR_YELLOW, bg, 2);
 
-        // Counter: which / total
+        // Counter: which / total on the radar
         char idx_buf[12];
         snprintf(idx_buf, sizeof(idx_buf), "%d/%d",
-                 radar_selected + 1, latest_telemetry.traffic_count);
+                 radar_selected_blip() + 1, prev_ac_count);
         lcd_draw_string(px, 58, idx_buf, COLOR_WHITE, bg);
 
         // Distance
-        const double R = 6371.0;
-        double lat1r = latest_telemetry.own.lat * M_PI / 180.0;
-        double lon1r = latest_telemetry.own.lon * M_PI / 180.0;
-        double lat2r = t->lat * M_PI / 180.0;
-        double lon2r = t->lon * M_PI / 180.0;
-        double dx_km = (lon2r - lon1r) * cos((lat1r + lat2r) / 2.0) * R;
-        double dy_km = (lat2r - lat1r) * R;
-        double dist  = sqrt(dx_km * dx_km + dy_km * dy_km);
+        GeoProjection metres;
+        geo_projection_init(&metres, latest_telemetry.own.lat, latest_telemetry.own.lon, 1000.0f);
+        int32_t east, north;
+        geo_project(&metres, t->state.lat, t->state.lon, &east, &north);
+        float dist = sqrtf((float)east * east + (float)north * north) / 1000.0f;
 
         char buf[20];
 
         lcd_draw_string(px,  80, "HDG", COLOR_CYAN,  bg);
-        snprintf(buf, sizeof(buf), "%.0f deg", t->heading);
+        snprintf(buf, sizeof(buf), "%d deg", (t->state.heading + 50) / 100 % 360);
         lcd_draw_string(px,  92, buf,   COLOR_WHITE, bg);
 
         lcd_draw_string(px, 110, "ALT", COLOR_CYAN,  bg);
-        snprintf(buf, sizeof(buf), "%d ft", (int)t->alt);
+        snprintf(buf, sizeof(buf), "%d ft", (int)geo_alt_to_ft(t->state.alt));
         lcd_draw_string(px, 122, buf,   COLOR_WHITE, bg);
 
         lcd_draw_string(px, 140, "SPD", COLOR_CYAN,  bg);
-        snprintf(buf, sizeof(buf), "%d kt", (int)t->speed);
+        snprintf(buf, sizeof(buf), "%d kt", (int)t->state.speed_kt);
         lcd_draw_string(px, 152, buf,   COLOR_WHITE, bg);
 
         lcd_draw_string(px, 170, "DST", COLOR_CYAN,  bg);
-        snprintf(buf, sizeof(buf), "%.1f km", dist);
+        snprintf(buf, sizeof(buf), "%.1f km", (double)dist);
         lcd_draw_string(px, 182, buf,   COLOR_WHITE, bg);
     }
 
@@ -429,77 +598,119 @@ static void radar_panel_fetching(void) {
 }
 
 static void radar_update_blips(void) {
-    for (int i = 0; i < prev_ac_count; i++)
-        lcd_fill_rect(prev_ac_x[i] - 2, prev_ac_y[i] - 2, 4 + 7*6 + 2, 13, COLOR_BLACK);
-
+    // Trails cross the whole scope, so redraw it rather than erase blips
+    lcd_fill_rect(0, 29, RDR_PX, LCD_HEIGHT - 29, COLOR_BLACK);
     lcd_draw_circle(RDR_CX, RDR_CY, RDR_R1, COLOR_WHITE);
     lcd_draw_circle(RDR_CX, RDR_CY, RDR_R2, COLOR_WHITE);
     lcd_draw_circle(RDR_CX, RDR_CY, RDR_R3, COLOR_WHITE);
+    lcd_fill_rect(RDR_CX - 1, RDR_CY - RDR_R3 - 6, 3, 6, COLOR_WHITE);
+
+    // Projection cycles are summed across the redraw into PROF_RADAR_PROJECT
+    uint32_t math_t = prof_begin();
+    geo_projection_init(&radar_proj, latest_telemetry.own.lat, latest_telemetry.own.lon, KM_TO_PX);
+    uint32_t math_cycles = prof_begin() - math_t;
+
+    // Trails first so symbols and labels stay on top
+    for (const Track *t = track_table_first(&radar_tracks); t; t = track_table_next(&radar_tracks, t)) {
+        int16_t x0, y0;
+        math_t = prof_begin();
+        radar_project(t->state.lat, t->state.lon, &x0, &y0);
+        math_cycles += prof_begin() - math_t;
+        for (int age = 0; age < t->trail_count; age++) {
+            const TrackPoint *p = track_trail_point(t, age);
+            int16_t x1, y1;
+            math_t = prof_begin();
+            radar_project(p->lat, p->lon, &x1, &y1);
+            math_cycles += prof_begin() - math_t;
+            if (x0 >= 0 && x0 < RDR_PX && x1 >= 0 && x1 < RDR_PX &&
+                y0 >= 29 && y0 < LCD_HEIGHT && y1 >= 29 && y1 < LCD_HEIGHT)
+                lcd_draw_line(x0, y0, x1, y1, RDR_TRAIL_COLOR);
+            x0 = x1;
+            y0 = y1;
+        }
+    }
     lcd_fill_rect(RDR_CX - 2, RDR_CY - 2, 5, 5, COLOR_YELLOW);
 
     prev_ac_count = 0;
-    for (int i = 0; i < latest_telemetry.traffic_count && i < MAX_TRAFFIC; i++) {
-        TrafficData *t = &latest_telemetry.traffic[i];
-        const double R = 6371.0;
-        double lat1r = latest_telemetry.own.lat * M_PI / 180.0;
-        double lon1r = latest_telemetry.own.lon * M_PI / 180.0;
-        double lat2r = t->lat * M_PI / 180.0;
-        double lon2r = t->lon * M_PI / 180.0;
-        double dx_km = (lon2r - lon1r) * cos((lat1r + lat2r) / 2.0) * R;
-        double dy_km = (lat2r - lat1r) * R;
-
-        int16_t sx = RDR_CX + (int16_t)(dx_km * KM_TO_PX);
-        int16_t sy = RDR_CY - (int16_t)(dy_km * KM_TO_PX);
-        if (sx < 4 || sx > RDR_PX - 4 || sy < 29 || sy > LCD_HEIGHT - 4) continue;
-
-        bool sel = (i == radar_selected);
+    for (const Track *t = track_table_first(&radar_tracks);
+         t && prev_ac_count < RDR_MAX_BLIPS; t = track_table_next(&radar_tracks, t)) {
+        int16_t sx, sy;
+        math_t = prof_begin();
+        radar_project(t->state.lat, t->state.lon, &sx, &sy);
+        math_cycles += prof_begin() - math_t;
+        if (sx < RDR_SYM_R || sx > RDR_PX - RDR_SYM_R ||
+            sy < 28 + RDR_SYM_R || sy > LCD_HEIGHT - RDR_SYM_R) continue;
+
+        bool sel = (t->icao24 == radar_selected);
         uint16_t color = sel ? COLOR_YELLOW : COLOR_RED;
-        lcd_fill_rect(sx - 2, sy - 2, 5, 5, color);
-        lcd_draw_string(sx + 4, sy - 4, t->id, color, COLOR_BLACK);
-
-        prev_ac_x[prev_ac_count]  = sx;
-        prev_ac_y[prev_ac_count]  = sy;
-        prev_ac_ti[prev_ac_count] = (uint8_t)i;
+        // North-up radar: rotate by true track (a track-up view would
+        // subtract own track here)
+        sprite_draw_rotated(&aircraft_sprite, sx, sy, geo_heading_to_deg(t->state.heading),
+                            RDR_SYM_SCALE, color);
+        lcd_draw_string(sx + RDR_SYM_R + 2, sy - 4, t->callsign, color, COLOR_BLACK);
+
+        prev_ac_x[prev_ac_count]    = sx;
+        prev_ac_y[prev_ac_count]    = sy;
+        prev_ac_icao[prev_ac_count] = t->icao24;
         prev_ac_count++;
     }
+    prof_end(PROF_RADAR_PROJECT, prof_begin() - math_cycles);
 
     char buf[20];
-    snprintf(buf, sizeof(buf), "TFC %d", latest_telemetry.traffic_count);
+    snprintf(buf, sizeof(buf), "TFC %d", prev_ac_count);
     lcd_fill_rect(0, 226, 80, 10, COLOR_BLACK);
     lcd_draw_string(2, 226, buf, COLOR_WHITE, COLOR_BLACK);
 }
 
 void action_radar(void) {
+    if (aircraft_sprite.size_bits == 0) {
+        sprite_texture_from_mask(&aircraft_sprite, 5, aircraft_icon_mask,
+                                 AIRCRAFT_ICON_WIDTH, AIRCRAFT_ICON_HEIGHT);
+    }
+    if (!radar_tracks_ready) {
+        track_table_init(&radar_tracks);
+        opensky_sched_init(&radar_sched, OPENSKY_CREDITS_ANONYMOUS,
+                           to_ms_since_boot(get_absolute_time()));
+        // The position is a fixed default, so speed and movement say nothing:
+        // refresh at the airborne cadence and let the credit budget throttle
+        opensky_sched_set_fixed_interval(&radar_sched, OPENSKY_SCHED_AIR_INTERVAL_MS);
+        memset(&latest_telemetry, 0, sizeof(latest_telemetry));
+        radar_tracks_ready = true;
+    }
     prev_ac_count  = 0;
-    radar_selected = -1;
-    memset(&latest_telemetry, 0, sizeof(latest_telemetry));
+    radar_selected = 0;
 
     radar_draw_static();
+    // Show the last response right away; the scheduler fetches when one is due
+    if (radar_sched.have_response) radar_update_blips();
     radar_draw_panel();
     lcd_flush();
 
     bool was_touched = false;
-    uint32_t last_opensky_fetch = 0;  // force immediate fetch on entry
 
     while (true) {
-        wifi_poll();
+        service_poll();
 
         if (wifi_is_connected()) {
             uint32_t now = to_ms_since_boot(get_absolute_time());
-            if (now - last_opensky_fetch >= OPENSKY_INTERVAL_MS) {
-                last_opensky_fetch = now;
-
-                double fetch_lat = ARLANDA_LAT;
-                double fetch_lon = ARLANDA_LON;
-
+            OpenSkyQuery query;
+            // No GPS driver yet: stationary at the default position
+            if (opensky_sched_poll(&radar_sched, now, ARLANDA_LAT, ARLANDA_LON, 0.0f, &query)) {
                 radar_panel_fetching();
 
+                // Tracks are stamped with the poll time, so targets missing
+                // from this response and the one before are the older ones
+                uint32_t max_age_ms = now - radar_sched.last_response_ms;
                 TelemetryData sky = {0};
-                if (opensky_fetch(fetch_lat, fetch_lon, &sky)) {
-                    latest_telemetry.traffic_count = sky.traffic_count;
-                    memcpy(latest_telemetry.traffic, sky.traffic,
-                           sky.traffic_count * sizeof(TrafficData));
+                OpenSkyResponse response;
+                bool ok = opensky_fetch(&query, &sky, &radar_tracks, now, &response);
+                opensky_sched_result(&radar_sched, now, &query, &response);
+                if (ok) {
+                    track_table_expire(&radar_tracks, now, max_age_ms);
                     latest_telemetry.own = sky.own;
+                    for (int i = 0; i < sky.traffic_count; i++) {
+                        flight_log_traffic(&sky.traffic[i]);
+                    }
                 }
 
                 radar_update_blips();
@@ -518,17 +729,19 @@ void action_radar(void) {
                 g_radar_exit_to_menu = false;
                 break;  // Tap radar area → back to AHRS
             } else if (tx > RDR_PX) {
-                int n = latest_telemetry.traffic_count;
+                int n = prev_ac_count;
                 if (ty >= RDR_BTN_Y && n > 0) {
-                    // Nav buttons: prev / next
+                    // Nav buttons: prev / next blip
+                    int i = radar_selected_blip();
                     if (tx < RDR_BTN_MID) {
-                        radar_selected = (radar_selected <= 0) ? n - 1 : radar_selected - 1;
+                        i = (i <= 0) ? n - 1 : i - 1;
                     } else {
-                        radar_selected = (radar_selected >= n - 1) ? 0 : radar_selected + 1;
+                        i = (i >= n - 1) ? 0 : i + 1;
                     }
+                    radar_selected = prev_ac_icao[i];
                 } else {
                     // Tap info area → deselect
-                    radar_selected = -1;
+                    radar_selected = 0;
                 }
                 radar_draw_panel();
                 lcd_flush_rect(RDR_PX, 0, 320 - RDR_PX, LCD_HEIGHT);
@@ -541,7 +754,7 @@ void action_radar(void) {
                     int d2 = ddx * ddx + ddy * ddy;
                     if (d2 < best_d2) { best_d2 = d2; best = i; }
                 }
-                radar_selected = (best >= 0) ? prev_ac_ti[best] : -1;
+                radar_selected = (best >= 0) ? prev_ac_icao[best] : 0;
                 radar_draw_panel();
                 lcd_flush_rect(RDR_PX, 0, 320 - RDR_PX, LCD_HEIGHT);
             }
@@ -637,6 +850,93 @@ static void draw_bank_arc(float roll_deg) {
     lcd_fill_rect(x - 2, y - 2, 5, 5, COLOR_RED);
 }
 
+// ── Magnetometer calibration ──────────────────────────────────────────────────
+
+#define MAGCAL_BTN_Y  190
+#define MAGCAL_BTN_H  40
+
+static void mag_cal_draw_static(void) {
+    lcd_clear(COLOR_BLACK);
+    lcd_draw_string_scaled(10, 10, "MAG CALIBRATION", COLOR_WHITE, COLOR_BLACK, 2);
+    lcd_draw_string(10, 40, "Rotate the unit slowly through", COLOR_YELLOW, COLOR_BLACK);
+    lcd_draw_string(10, 52, "every orientation (figure-8).", COLOR_YELLOW, COLOR_BLACK);
+
+    lcd_fill_round_rect(10, MAGCAL_BTN_Y, 140, MAGCAL_BTN_H, 6, COLOR_RED);
+    lcd_draw_string_scaled(38, MAGCAL_BTN_Y + 12, "CANCEL", COLOR_WHITE, COLOR_RED, 2);
+    lcd_fill_round_rect(170, MAGCAL_BTN_Y, 140, MAGCAL_BTN_H, 6, COLOR_GREEN);
+    lcd_draw_string_scaled(210, MAGCAL_BTN_Y + 12, "DONE", COLOR_BLACK, COLOR_GREEN, 2);
+}
+
+static void mag_cal_draw_progress(const MagCalCollector* col) {
+    char buf[48];
+    static const char axis[3] = {'X', 'Y', 'Z'};
+
+    lcd_fill_rect(0, 75, LCD_WIDTH, 105, COLOR_BLACK);
+    snprintf(buf, sizeof(buf), "Samples: %lu", (unsigned long)col->samples);
+    lcd_draw_string_scaled(10, 75, buf,
+                           col->samples >= MAG_CAL_MIN_SAMPLES ? COLOR_GREEN : COLOR_WHITE,
+                           COLOR_BLACK, 2);
+
+    for (int i = 0; i < 3; i++) {
+        float span = col->samples ? col->max[i] - col->min[i] : 0.0f;
+        snprintf(buf, sizeof(buf), "%c: %+6.1f .. %+6.1f uT", axis[i],
+                 col->samples ? col->min[i] : 0.0f, col->samples ? col->max[i] : 0.0f);
+        lcd_draw_string(10, 110 + i * 16, buf,
+                        span >= MAG_CAL_MIN_SPAN_UT ? COLOR_GREEN : COLOR_WHITE, COLOR_BLACK);
+    }
+}
+
+static void action_mag_calibration(void) {
+    ahrs_core_mag_cal_start();
+    mag_cal_draw_static();
+    lcd_flush();
+
+    bool was_touched = true;  // Ignore the tap that opened this screen
+    uint8_t disp_ctr = 0;
+
+    while (true) {
+        uint16_t tx, ty;
+        bool touched = touch_read(&tx, &ty);
+
+        if (touched && !was_touched && ty >= MAGCAL_BTN_Y && ty < MAGCAL_BTN_Y + MAGCAL_BTN_H) {
+            if (tx < 160) {
+                ahrs_core_mag_cal_cancel();
+                return;
+            }
+
+            if (ahrs_core_mag_cal_finish()) {
+                lcd_fill_rect(0, 75, LCD_WIDTH, 105, COLOR_BLACK);
+                lcd_draw_string_scaled(40, 110, "SAVED", COLOR_GREEN, COLOR_BLACK, 3);
+                lcd_flush();
+                sleep_ms(1500);
+                return;
+            }
+
+            lcd_fill_rect(0, 165, LCD_WIDTH, 20, COLOR_BLACK);
+            lcd_draw_string(10, 168, "Not enough coverage - keep rotating", COLOR_RED, COLOR_BLACK);
+            lcd_flush();
+        }
+        was_touched = touched;
+
+        service_poll();
+
+        // Refresh progress at 5 Hz
+        if (++disp_ctr >= 10) {
+            disp_ctr = 0;
+            MagCalCollector col;
+            if (!ahrs_core_mag_cal_progress(&col)) return;
+            mag_cal_draw_progress(&col);
+            lcd_flush();
+        }
+
+        sleep_ms(20);
+    }
+}
+
+// Longest wait for the first attitude after boot (sensor init + calibration
+// take well under a second) before the page reports a fault
+#define AHRS_INIT_TIMEOUT_MS      5000
+
 void action_test_gyro(void) {
     // ========== DUAL-CORE AHRS MODE ==========
     // Core 0: Dedicated AHRS (runs continuously in background, started at boot)
@@ -647,10 +947,30 @@ void action_test_gyro(void) {
     uint8_t disp_ctr = 0;
     bool was_touched = false;
     const int16_t center_x = 160, center_y = 120;
+    uint32_t entered_ms = to_ms_since_boot(get_absolute_time());
+    bool init_shown = false;
 
     while (true) {
         // Get attitude from Core 0
         if (!ahrs_core_get_attitude(&attitude)) {
+            uint32_t waited_ms = to_ms_since_boot(get_absolute_time()) - entered_ms;
+            if (!attitude.init_failed && boot_attitude_us() == 0 && !attitude.calibrated &&
+                waited_ms < AHRS_INIT_TIMEOUT_MS) {
+                // Still calibrating after boot: wait rather than report a fault
+                if (!init_shown) {
+                    lcd_clear(COLOR_BLACK);
+                    lcd_draw_string_scaled(70, 100, "AHRS INIT", COLOR_WHITE, COLOR_BLACK, 2);
+                    lcd_flush();
+                    init_shown = true;
+                }
+                uint16_t tx, ty;
+                bool touched = touch_read(&tx, &ty);
+                if (touched && !was_touched && ty < 28) break;  // Ribbon → back to menu
+                was_touched = touched;
+                service_poll();
+                sleep_ms(50);
+                continue;
+            }
             // AHRS not healthy
             lcd_clear(COLOR_BLACK);
             lcd_draw_string_scaled(50, 100, "CORE 0 ERROR", COLOR_RED, COLOR_BLACK, 2);
@@ -665,6 +985,10 @@ void action_test_gyro(void) {
         if (touched && !was_touched) {
             if (ty < 28) {
                 break;  // Ribbon → back to menu
+            } else if (ty >= 215 && tx >= 110 && tx < 210) {
+                // Heading readout → magnetometer calibration
+                action_mag_calibration();
+                disp_ctr = 0;
             } else {
                 // Any screen touch → go to radar
                 g_radar_exit_to_menu = false;
@@ -676,8 +1000,8 @@ void action_test_gyro(void) {
         }
         was_touched = touched;
 
-        // Keep WiFi alive while in AHRS
-        wifi_poll();
+        // Keep WiFi and the USB console alive while in AHRS
+        service_poll();
 
         // Render at 10 Hz (every 10th iteration, ~100ms)
         if (++disp_ctr < 10) {
@@ -690,7 +1014,11 @@ void action_test_gyro(void) {
         float roll_rad = attitude.roll * D2R;
         float pitch_px = -attitude.pitch * PX_PER_DEG;
 
+        uint32_t prof_t = prof_begin();
         draw_horizon_bg(roll_rad, pitch_px);
+        prof_end(PROF_RENDER_HORIZON, prof_t);
+
+        prof_t = prof_begin();
         draw_pitch_ladder(roll_rad, attitude.pitch);
         draw_bank_arc(attitude.roll);
 
@@ -716,20 +1044,127 @@ void action_test_gyro(void) {
         lcd_fill_rect(0, 227, 90, 10, COLOR_BLACK);
         lcd_draw_string(4, 227, buf, COLOR_WHITE, COLOR_BLACK);
 
+        // Bottom center: Magnetic heading (tap to calibrate)
+        if (attitude.heading_valid) {
+            snprintf(buf, sizeof(buf), "HDG %03d", (int)(attitude.yaw + 0.5f) % 360);
+        } else {
+            snprintf(buf, sizeof(buf), "HDG ---");
+        }
+        lcd_fill_rect(130, 227, 60, 10, COLOR_BLACK);
+        lcd_draw_string(134, 227, buf, attitude.heading_valid ? COLOR_WHITE : COLOR_YELLOW, COLOR_BLACK);
+
         // Bottom right: Calibration indicator only
         if (attitude.stationary) {
             lcd_draw_string(280, 227, "CAL", COLOR_GREEN, COLOR_BLACK);
         } else {
             lcd_fill_rect(280, 227, 40, 10, COLOR_BLACK);
         }
+        if (latency_overlay && ahrs_latency.count > 0) {
+            LatencySummary lat;
+            latency_hist_summary(&ahrs_latency, &lat);
+            snprintf(buf, sizeof(buf), "LAT %lu/%lu/%lu ms",
+                     (unsigned long)(lat.p50_us / 1000), (unsigned long)(lat.p95_us / 1000),
+                     (unsigned long)(lat.p99_us / 1000));
+            lcd_draw_string(4, 4, buf, COLOR_WHITE, COLOR_BLACK);
+        }
+        prof_end(PROF_RENDER_OVERLAY, prof_t);
 
         lcd_flush();
+        latency_hist_add(&ahrs_latency, (uint32_t)(time_us_64() - attitude.timestamp_us));
     }
 
+    if (ahrs_latency.count > 0) latency_print();
+
     // AHRS continues running on Core 0 in background
     // Just return to menu (no shutdown - instant restart when re-entering AHRS)
 }
 
+// ── Diagnostics (profiler zones) ──────────────────────────────────────────────
+
+#define DIAG_ROW_Y      52
+#define DIAG_ROW_H      12
+#define DIAG_BTN_Y      200
+#define DIAG_BTN_H      32
+
+// Hardware core 1 runs the AHRS loop (called "Core 0" elsewhere), core 0 the UI
+static const char* const diag_core_label[PROF_NUM_CORES] = {"UI", "AHRS"};
+
+static void diag_draw_static(void) {
+    lcd_clear(COLOR_BLACK);
+    lcd_draw_string_scaled(10, 6, "DIAGNOSTICS", COLOR_WHITE, COLOR_BLACK, 2);
+    lcd_draw_string(10, 36, "ZONE            CORE     AVG us    MAX us  LOAD%",
+                    COLOR_YELLOW, COLOR_BLACK);
+
+    lcd_fill_round_rect(10, DIAG_BTN_Y, 140, DIAG_BTN_H, 6, COLOR_RED);
+    lcd_draw_string_scaled(44, DIAG_BTN_Y + 9, "RESET", COLOR_WHITE, COLOR_RED, 2);
+    lcd_fill_round_rect(170, DIAG_BTN_Y, 140, DIAG_BTN_H, 6, 0x041F);
+    lcd_draw_string_scaled(210, DIAG_BTN_Y + 9, "BACK", COLOR_WHITE, 0x041F, 2);
+}
+
+static void diag_draw_zones(void) {
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000u;
+    uint64_t elapsed = prof_elapsed_cycles();
+    char buf[64];
+    int row = 0;
+
+    lcd_fill_rect(0, DIAG_ROW_Y, LCD_WIDTH, DIAG_BTN_Y - DIAG_ROW_Y - 4, COLOR_BLACK);
+
+    for (uint8_t core = 0; core < PROF_NUM_CORES; core++) {
+        for (int z = 0; z < PROF_ZONE_COUNT; z++) {
+            ProfStats s;
+            if (!prof_snapshot(core, (ProfZone)z, &s)) continue;
+
+            float avg_us = (float)s.total_cycles / s.count / mhz;
+            float max_us = (float)s.max_cycles / mhz;
+            float load = elapsed ? 100.0f * (float)s.total_cycles / (float)elapsed : 0.0f;
+            snprintf(buf, sizeof(buf), "%-15s %-5s %9.1f %9.1f %6.1f",
+                     prof_zone_name((ProfZone)z), diag_core_label[core], avg_us, max_us, load);
+            lcd_draw_string(10, DIAG_ROW_Y + row * DIAG_ROW_H, buf,
+                            load >= 50.0f ? COLOR_RED : COLOR_WHITE, COLOR_BLACK);
+            row++;
+        }
+    }
+
+    if (row == 0) {
+        lcd_draw_string(10, DIAG_ROW_Y, "No samples yet", COLOR_WHITE, COLOR_BLACK);
+    }
+}
+
+// Opened by tapping the ribbon on the main menu; "prof" on USB prints the same data
+static void action_diagnostics(void) {
+    diag_draw_static();
+    diag_draw_zones();
+    lcd_flush();
+
+    bool was_touched = true;  // Ignore the tap that opened this screen
+    uint32_t last_refresh_ms = to_ms_since_boot(get_absolute_time());
+
+    while (true) {
+        uint16_t tx, ty;
+        bool touched = touch_read(&tx, &ty);
+        if (touched && !was_touched) {
+            if (ty >= DIAG_BTN_Y && ty < DIAG_BTN_Y + DIAG_BTN_H && tx < 160) {
+                prof_reset();
+            } else {
+                return;
+            }
+        }
+        was_touched = touched;
+
+        service_poll();
+
+        // Refresh at 2 Hz
+        uint32_t now = to_ms_since_boot(get_absolute_time());
+        if (now - last_refresh_ms >= 500) {
+            last_refresh_ms = now;
+            diag_draw_zones();
+            lcd_flush_rect(0, DIAG_ROW_Y, LCD_WIDTH, DIAG_BTN_Y - DIAG_ROW_Y);
+        }
+
+        sleep_ms(20);
+    }
+}
+
 // ── Menu definition ───────────────────────────────────────────────────────────
 
 #define ICON_COLOR_FLY   0x041F   // Blue
@@ -748,34 +1183,44 @@ int main(void) {
     set_sys_clock_khz(200000, true);
     gpio_init(LED_PIN);
     gpio_set_dir(LED_PIN, GPIO_OUT);
-    gpio_put(LED_PIN, 1);
+    gpio_put(LED_PIN, 1);   // On until the first valid attitude
 
+    // Staged boot: the AHRS core goes first so sensor init and calibration
+    // overlap everything else. Nothing here waits for the USB console;
+    // the timeline is kept and printed later (or with the "boot" command).
+    boot_timeline_init();
     stdio_init_all();
-    sleep_ms(1000);
+    prof_init_core();
+    latency_hist_init(&ahrs_latency, LATENCY_BIN_US);
+    usb_commands_init(usb_app_commands, sizeof(usb_app_commands) / sizeof(usb_app_commands[0]));
+    boot_mark("stdio");
 
     printf("=== Pico 2W PilotAssistant ===\n");
 
-    lcd_init();
-    lcd_display_splash(splash_320x240_bin, splash_320x240_bin_len);
+    // Start AHRS on Core 0 (runs continuously in background)
+    ahrs_core_start();
+    boot_mark("ahrs launched");
 
-    for (int i = 0; i < 3; i++) {
-        gpio_put(LED_PIN, 1); sleep_ms(100);
-        gpio_put(LED_PIN, 0); sleep_ms(100);
-    }
+    lcd_init();
+    lcd_display_splash(splash_rle, SPLASH_LEN);
+    boot_mark("splash");
 
-    // Connect to WiFi while splash is shown
+    // WiFi chip firmware load; association then runs asynchronously from wifi_poll
     wifi_connect();
+    boot_mark("wifi started");
 
-    // Initialize Bluetooth
     bt_init();
+    boot_mark("bluetooth");
 
-    // Start AHRS on Core 0 (runs continuously in background)
-    printf("Starting AHRS on Core 0...\n");
-    ahrs_core_start();
+    // Flash writes prefer a running AHRS loop but fall back to a lockout
+    // while it is still calibrating (see ahrs_core_flash_op)
+    flight_log_init();
+    boot_mark("flight log");
 
     touch_init();
 
     icon_menu_draw(menu_items, ICON_COUNT);
+    boot_mark("menu");
 
     bool was_touched = false;
 
@@ -784,6 +1229,14 @@ int main(void) {
         uint16_t tx, ty;
         bool touched = touch_read(&tx, &ty);
         if (touched && !was_touched) {
+            if (ty < 28) {
+                // Ribbon → profiler diagnostics
+                action_diagnostics();
+                was_touched = true;
+                icon_menu_draw(menu_items, ICON_COUNT);
+                continue;
+            }
+
             int idx = icon_menu_hit_test(tx, ty);
             if (idx >= 0) {
                 icon_menu_flash(idx);
@@ -796,7 +1249,7 @@ int main(void) {
         }
         was_touched = touched;
 
-        wifi_poll();
+        service_poll();
         bt_poll();
 
         // Refresh WiFi/BT icons in ribbon if state changed
@@ -1,80 +1,384 @@
 #include "telemetry_parser.h"
-#include <stdio.h>
+#include "track_table.h"
 #include <string.h>
-#include <stdlib.h>
 
-// Simple JSON parser for telemetry data
-// This is a lightweight parser specific to our telemetry format
-// Format: {"own":{"lat":37.775,"lon":-122.419,"alt":5000,"pitch":1.2,"roll":3.4,"yaw":45.6},"traffic":[{"id":"T1","lat":37.78,"lon":-122.42,"alt":5200}]}
+// Single-pass JSON parser for telemetry data
+// Walks the message once with a cursor, dispatching on keys as they come,
+// so sections and fields may appear in any order and unknown ones (of any
+// shape) are skipped. No allocation, no recursion, no floating point:
+// numbers are read straight into the fixed-point units of TelemetryData.
+// Format: {"own":{"lat":37.775,"lon":-122.419,"alt":5000,"pitch":1.2,"roll":3.4,"yaw":45.6},
+//          "traffic":[{"id":"T1","icao24":"4ca7b3","lat":37.78,"lon":-122.42,"alt":5200,"heading":90,"speed":120}],
+//          "status":{"wifi":true,"gps":true,"bluetooth":false},"warnings":{"bank":false,"pitch":false}}
 
-static char* find_key(const char* json, const char* key) {
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-    return strstr(json, search);
+#define KEY_SIZE 16             // Longer keys are unknown anyway
+#define MANTISSA_DIGITS 18      // Digits kept from a number; the rest only scale it
+
+typedef struct {
+    const char* p;
+    bool error;                 // Malformed input; stops every read
+} JsonCursor;
+
+static void skip_ws(JsonCursor* c) {
+    while (*c->p == ' ' || *c->p == '\t' || *c->p == '\n' || *c->p == '\r') c->p++;
+}
+
+// Consume ch (after whitespace) or flag an error
+static bool expect(JsonCursor* c, char ch) {
+    skip_ws(c);
+    if (*c->p != ch) {
+        c->error = true;
+        return false;
+    }
+    c->p++;
+    return true;
 }
 
-static double extract_double(const char* json, const char* key) {
-    char* pos = find_key(json, key);
-    if (!pos) return 0.0;
+static int hex_digit(char ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
 
-    pos = strchr(pos, ':');
-    if (!pos) return 0.0;
+// String at the cursor into out (truncated, NUL-terminated; out may be NULL)
+// Escapes are decoded; \u escapes outside ASCII become '?'.
+static bool read_string(JsonCursor* c, char* out, size_t size) {
+    size_t n = 0;
+    if (!expect(c, '"')) return false;
 
-    return atof(pos + 1);
+    while (*c->p != '"') {
+        char ch = *c->p++;
+        if (ch == '\0') {
+            c->p--;
+            c->error = true;
+            return false;
+        }
+        if (ch == '\\') {
+            char e = *c->p++;
+            switch (e) {
+            case '"': case '\\': case '/': ch = e; break;
+            case 'b': ch = '\b'; break;
+            case 'f': ch = '\f'; break;
+            case 'n': ch = '\n'; break;
+            case 'r': ch = '\r'; break;
+            case 't': ch = '\t'; break;
+            case 'u': {
+                int code = 0;
+                for (int i = 0; i < 4; i++) {
+                    int d = hex_digit(*c->p);
+                    if (d < 0) {
+                        c->error = true;
+                        return false;
+                    }
+                    code = code * 16 + d;
+                    c->p++;
+                }
+                ch = (code >= 0x20 && code < 0x7F) ? (char)code : '?';
+                break;
+            }
+            default:
+                if (e == '\0') c->p--;
+                c->error = true;
+                return false;
+            }
+        }
+        if (out && n + 1 < size) out[n++] = ch;
+    }
+    c->p++;
+    if (out && size) out[n] = '\0';
+    return true;
 }
 
-static void extract_string(const char* json, const char* key, char* output, size_t max_len) {
-    char* pos = find_key(json, key);
-    if (!pos) {
-        output[0] = '\0';
-        return;
+// Number at the cursor times 10^decimals, rounded half away from zero,
+// saturated at about ±2^62; decimals may be negative (tens of feet: -1)
+static bool read_scaled(JsonCursor* c, int decimals, int64_t* out) {
+    const char* p = c->p;
+    bool negative = false;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exp10 = 0;
+
+    if (*p == '-') {
+        negative = true;
+        p++;
+    }
+    if (*p < '0' || *p > '9') {
+        c->error = true;
+        return false;
+    }
+    while (*p >= '0' && *p <= '9') {
+        if (digits < MANTISSA_DIGITS) {
+            if (mantissa || *p != '0') {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                digits++;
+            }
+        } else {
+            exp10++;
+        }
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p < '0' || *p > '9') {
+            c->error = true;
+            return false;
+        }
+        while (*p >= '0' && *p <= '9') {
+            if (digits < MANTISSA_DIGITS) {
+                if (mantissa || *p != '0') digits++;
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                exp10--;
+            }
+            p++;
+        }
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        bool exp_negative = false;
+        if (*p == '+' || *p == '-') exp_negative = (*p++ == '-');
+        if (*p < '0' || *p > '9') {
+            c->error = true;
+            return false;
+        }
+        int e = 0;
+        while (*p >= '0' && *p <= '9') {
+            if (e < 1000) e = e * 10 + (*p - '0');
+            p++;
+        }
+        exp10 += exp_negative ? -e : e;
     }
+    c->p = p;
 
-    pos = strchr(pos, '"');
-    if (!pos) {
-        output[0] = '\0';
-        return;
+    // Scale, keeping the last digit shifted out for rounding
+    const uint64_t limit = (uint64_t)1 << 62;
+    int shift = exp10 + decimals;
+    for (; shift > 0 && mantissa; shift--) {
+        if (mantissa > limit / 10) {
+            mantissa = limit;
+            break;
+        }
+        mantissa *= 10;
+    }
+    uint64_t last = 0;
+    for (; shift < 0 && mantissa; shift++) {
+        last = mantissa % 10;
+        mantissa /= 10;
     }
-    pos++; // Skip opening quote
+    if (shift < 0) last = 0;    // Ran out of digits: far below one unit
+    if (last >= 5) mantissa++;
 
-    pos = strchr(pos, '"');
-    if (!pos) {
-        output[0] = '\0';
-        return;
+    *out = negative ? -(int64_t)mantissa : (int64_t)mantissa;
+    return true;
+}
+
+// Skip one value of any shape; nesting is counted, not recursed into
+static void skip_value(JsonCursor* c) {
+    int depth = 0;
+    do {
+        skip_ws(c);
+        char ch = *c->p;
+        if (ch == '"') {
+            read_string(c, NULL, 0);
+        } else if (ch == '{' || ch == '[') {
+            depth++;
+            c->p++;
+        } else if ((ch == '}' || ch == ']') && depth > 0) {
+            depth--;
+            c->p++;
+        } else if (ch == ',' || ch == ':') {
+            if (depth == 0) {
+                c->error = true;
+                return;
+            }
+            c->p++;
+        } else if (ch == '-' || (ch >= '0' && ch <= '9')) {
+            int64_t unused;
+            read_scaled(c, 0, &unused);
+        } else if (strncmp(c->p, "true", 4) == 0) {
+            c->p += 4;
+        } else if (strncmp(c->p, "false", 5) == 0) {
+            c->p += 5;
+        } else if (strncmp(c->p, "null", 4) == 0) {
+            c->p += 4;
+        } else {
+            c->error = true;
+        }
+    } while (depth > 0 && !c->error);
+}
+
+// Numeric field: anything else (null, a string, ...) is skipped and leaves
+// the field as it was
+static bool read_number(JsonCursor* c, int decimals, int64_t* out) {
+    skip_ws(c);
+    if (*c->p == '-' || (*c->p >= '0' && *c->p <= '9')) return read_scaled(c, decimals, out);
+    skip_value(c);
+    return false;
+}
+
+static bool read_bool(JsonCursor* c) {
+    skip_ws(c);
+    if (strncmp(c->p, "true", 4) == 0) {
+        c->p += 4;
+        return true;
     }
-    pos++; // Skip second quote
+    skip_value(c);
+    return false;
+}
 
-    pos = strchr(pos, '"');
-    if (!pos) {
-        output[0] = '\0';
-        return;
+// Object members: call with *first = true after the '{' has been read;
+// returns true with the next key (cursor at its value), false at the
+// closing '}' or on an error
+static bool next_member(JsonCursor* c, bool* first, char* key) {
+    if (c->error) return false;
+    skip_ws(c);
+    if (*c->p == '}') {
+        c->p++;
+        return false;
     }
-    pos++; // Now at start of value
+    if (!*first && !expect(c, ',')) return false;
+    *first = false;
+    return read_string(c, key, KEY_SIZE) && expect(c, ':');
+}
 
-    size_t i = 0;
-    while (i < max_len - 1 && *pos != '"' && *pos != '\0') {
-        output[i++] = *pos++;
+// Array elements, as next_member
+static bool next_element(JsonCursor* c, bool* first) {
+    if (c->error) return false;
+    skip_ws(c);
+    if (*c->p == ']') {
+        c->p++;
+        return false;
     }
-    output[i] = '\0';
+    if (!*first && !expect(c, ',')) return false;
+    *first = false;
+    skip_ws(c);
+    return !c->error;
 }
 
-static bool extract_bool(const char* json, const char* key) {
-    char* pos = find_key(json, key);
-    if (!pos) return false;
+// Value at the cursor is an object (consumed) or skipped
+static bool begin_object(JsonCursor* c) {
+    skip_ws(c);
+    if (*c->p == '{') {
+        c->p++;
+        return true;
+    }
+    skip_value(c);
+    return false;
+}
 
-    pos = strchr(pos, ':');
-    if (!pos) return false;
+static int32_t clamp32(int64_t v, int32_t lo, int32_t hi) {
+    return v < lo ? lo : v > hi ? hi : (int32_t)v;
+}
 
-    // Skip whitespace
-    pos++;
-    while (*pos == ' ' || *pos == '\t') pos++;
+static uint16_t wrap_heading(int64_t cd) {
+    int64_t h = cd % 36000;
+    return (uint16_t)(h < 0 ? h + 36000 : h);
+}
 
-    // Check for "true"
-    if (strncmp(pos, "true", 4) == 0) {
-        return true;
+// Position, altitude, speed and heading members shared by own and traffic
+static bool read_common(JsonCursor* c, const char* key, int32_t* lat, int32_t* lon, int16_t* alt) {
+    int64_t v;
+    if (strcmp(key, "lat") == 0) {
+        if (read_number(c, 6, &v)) *lat = clamp32(v, -90 * GEO_UDEG_PER_DEG, 90 * GEO_UDEG_PER_DEG);
+    } else if (strcmp(key, "lon") == 0) {
+        if (read_number(c, 6, &v)) *lon = clamp32(v, -GEO_UDEG_HALF_TURN, GEO_UDEG_HALF_TURN);
+    } else if (strcmp(key, "alt") == 0) {
+        if (read_number(c, -1, &v)) *alt = (int16_t)clamp32(v, INT16_MIN, INT16_MAX);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static void parse_own(JsonCursor* c, OwnShipData* own) {
+    char key[KEY_SIZE];
+    bool first = true;
+    int64_t v;
+
+    if (!begin_object(c)) return;
+    while (next_member(c, &first, key)) {
+        if (read_common(c, key, &own->lat, &own->lon, &own->alt)) continue;
+        if (strcmp(key, "pitch") == 0) {
+            if (read_number(c, 2, &v)) own->pitch = (int16_t)clamp32(v, INT16_MIN, INT16_MAX);
+        } else if (strcmp(key, "roll") == 0) {
+            if (read_number(c, 2, &v)) own->roll = (int16_t)clamp32(v, INT16_MIN, INT16_MAX);
+        } else if (strcmp(key, "yaw") == 0) {
+            if (read_number(c, 2, &v)) own->yaw = wrap_heading(v);
+        } else {
+            skip_value(c);
+        }
+    }
+}
+
+static void parse_traffic_entry(JsonCursor* c, TrafficData* t) {
+    char key[KEY_SIZE];
+    bool first = true;
+    int64_t v;
+
+    while (next_member(c, &first, key)) {
+        if (read_common(c, key, &t->lat, &t->lon, &t->alt)) continue;
+        if (strcmp(key, "id") == 0) {
+            skip_ws(c);
+            if (*c->p == '"') read_string(c, t->id, sizeof(t->id));
+            else skip_value(c);
+        } else if (strcmp(key, "icao24") == 0) {
+            char icao[8];
+            skip_ws(c);
+            if (*c->p == '"' && read_string(c, icao, sizeof(icao))) t->icao24 = track_parse_icao24(icao);
+            else skip_value(c);
+        } else if (strcmp(key, "heading") == 0) {
+            if (read_number(c, 2, &v)) t->heading = wrap_heading(v);
+        } else if (strcmp(key, "speed") == 0) {
+            if (read_number(c, 0, &v)) t->speed = (int16_t)clamp32(v, INT16_MIN, INT16_MAX);
+        } else {
+            skip_value(c);
+        }
     }
+}
 
-    return false;
+static void parse_traffic(JsonCursor* c, TelemetryData* telemetry) {
+    bool first = true;
+
+    skip_ws(c);
+    if (*c->p != '[') {
+        skip_value(c);
+        return;
+    }
+    c->p++;
+    // Entries past MAX_TRAFFIC and non-objects are skipped
+    while (next_element(c, &first)) {
+        if (*c->p == '{' && telemetry->traffic_count < MAX_TRAFFIC) {
+            c->p++;
+            parse_traffic_entry(c, &telemetry->traffic[telemetry->traffic_count++]);
+        } else {
+            skip_value(c);
+        }
+    }
+}
+
+static void parse_status(JsonCursor* c, ConnectivityStatus* status) {
+    char key[KEY_SIZE];
+    bool first = true;
+
+    if (!begin_object(c)) return;
+    while (next_member(c, &first, key)) {
+        if (strcmp(key, "wifi") == 0) status->wifi = read_bool(c);
+        else if (strcmp(key, "gps") == 0) status->gps = read_bool(c);
+        else if (strcmp(key, "bluetooth") == 0) status->bluetooth = read_bool(c);
+        else skip_value(c);
+    }
+}
+
+static void parse_warnings(JsonCursor* c, WarningStatus* warnings) {
+    char key[KEY_SIZE];
+    bool first = true;
+
+    if (!begin_object(c)) return;
+    while (next_member(c, &first, key)) {
+        if (strcmp(key, "bank") == 0) warnings->bank_warning = read_bool(c);
+        else if (strcmp(key, "pitch") == 0) warnings->pitch_warning = read_bool(c);
+        else skip_value(c);
+    }
 }
 
 bool parse_telemetry(const char* json_str, TelemetryData* telemetry) {
@@ -82,84 +386,34 @@ bool parse_telemetry(const char* json_str, TelemetryData* telemetry) {
         return false;
     }
 
+    // Missing fields, sections and status flags stay zero/false
     memset(telemetry, 0, sizeof(TelemetryData));
 
-    // Find "own" section
-    char* own_section = strstr(json_str, "\"own\"");
-    if (!own_section) {
-        telemetry->valid = false;
+    JsonCursor c = { .p = json_str, .error = false };
+    char key[KEY_SIZE];
+    bool first = true;
+    bool have_own = false;
+
+    if (!expect(&c, '{')) {
         return false;
     }
-
-    // Parse own aircraft data
-    telemetry->own.lat = extract_double(own_section, "lat");
-    telemetry->own.lon = extract_double(own_section, "lon");
-    telemetry->own.alt = extract_double(own_section, "alt");
-    telemetry->own.pitch = extract_double(own_section, "pitch");
-    telemetry->own.roll = extract_double(own_section, "roll");
-    telemetry->own.yaw = extract_double(own_section, "yaw");
-
-    // Find "traffic" array
-    char* traffic_section = strstr(json_str, "\"traffic\"");
-    if (traffic_section) {
-        char* traffic_start = strchr(traffic_section, '[');
-        if (traffic_start) {
-            char* current = traffic_start + 1;
-            telemetry->traffic_count = 0;
-
-            // Parse each traffic object
-            while (telemetry->traffic_count < MAX_TRAFFIC) {
-                char* obj_start = strchr(current, '{');
-                if (!obj_start) break;
-
-                char* obj_end = strchr(obj_start, '}');
-                if (!obj_end) break;
-
-                // Extract traffic data
-                TrafficData* t = &telemetry->traffic[telemetry->traffic_count];
-                extract_string(obj_start, "id", t->id, sizeof(t->id));
-                t->lat = extract_double(obj_start, "lat");
-                t->lon = extract_double(obj_start, "lon");
-                t->alt = extract_double(obj_start, "alt");
-
-                telemetry->traffic_count++;
-                current = obj_end + 1;
-
-                // Check if we've reached the end of the array
-                char* next_comma = strchr(current, ',');
-                char* array_end = strchr(current, ']');
-                if (!array_end || (next_comma && next_comma > array_end)) {
-                    break;
-                }
-                current = next_comma ? next_comma + 1 : array_end;
-            }
+    while (next_member(&c, &first, key)) {
+        if (strcmp(key, "own") == 0) {
+            parse_own(&c, &telemetry->own);
+            have_own = true;
+        } else if (strcmp(key, "traffic") == 0) {
+            parse_traffic(&c, telemetry);
+        } else if (strcmp(key, "status") == 0) {
+            parse_status(&c, &telemetry->status);
+        } else if (strcmp(key, "warnings") == 0) {
+            parse_warnings(&c, &telemetry->warnings);
+        } else {
+            skip_value(&c);
         }
     }
 
-    // Find "status" section
-    char* status_section = strstr(json_str, "\"status\"");
-    if (status_section) {
-        telemetry->status.wifi = extract_bool(status_section, "wifi");
-        telemetry->status.gps = extract_bool(status_section, "gps");
-        telemetry->status.bluetooth = extract_bool(status_section, "bluetooth");
-    } else {
-        // Default to disconnected if status not present
-        telemetry->status.wifi = false;
-        telemetry->status.gps = false;
-        telemetry->status.bluetooth = false;
-    }
-
-    // Find "warnings" section
-    char* warnings_section = strstr(json_str, "\"warnings\"");
-    if (warnings_section) {
-        telemetry->warnings.bank_warning = extract_bool(warnings_section, "bank");
-        telemetry->warnings.pitch_warning = extract_bool(warnings_section, "pitch");
-    } else {
-        // Default to no warnings if section not present
-        telemetry->warnings.bank_warning = false;
-        telemetry->warnings.pitch_warning = false;
-    }
-
-    telemetry->valid = true;
-    return true;
+    // Whatever follows the closing brace (a newline, the next message) is
+    // not ours; a message cut short or garbled inside is rejected
+    telemetry->valid = have_own && !c.error;
+    return telemetry->valid;
 }
@@ -3,27 +3,31 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "geo_fixed.h"
 
 #define MAX_TRAFFIC 10
 
-// Structure for own aircraft data
+// Positions and state are packed fixed point; convert with geo_fixed.h
+
+// Structure for own aircraft data (16 bytes)
 typedef struct {
-    double lat;
-    double lon;
-    double alt;
-    double pitch;
-    double roll;
-    double yaw;
+    int32_t lat;      // microdegrees
+    int32_t lon;      // microdegrees
+    int16_t alt;      // tens of feet
+    int16_t pitch;    // centidegrees
+    int16_t roll;     // centidegrees
+    uint16_t yaw;     // centidegrees, 0..35999
 } OwnShipData;
 
-// Structure for traffic aircraft
+// Structure for traffic aircraft (28 bytes)
 typedef struct {
     char id[8];
-    double lat;
-    double lon;
-    double alt;      // feet
-    double heading;  // degrees (true track)
-    double speed;    // knots
+    uint32_t icao24;  // ICAO 24-bit address, 0 if unknown
+    int32_t lat;      // microdegrees
+    int32_t lon;      // microdegrees
+    int16_t alt;      // tens of feet
+    int16_t speed;    // knots
+    uint16_t heading; // centidegrees (true track), 0..35999
 } TrafficData;
 
 // Structure for connectivity status
@@ -50,6 +54,9 @@ typedef struct {
 } TelemetryData;
 
 // Function to parse JSON telemetry string
+// Sections and fields may come in any order; unknown ones are skipped and
+// missing ones left zero. Returns telemetry->valid: false without an "own"
+// section or when the message is malformed or cut short.
 bool parse_telemetry(const char* json_str, TelemetryData* telemetry);
 
 #endif // TELEMETRY_PARSER_H
@@ -0,0 +1,150 @@
+#include "usb_commands.h"
+#include "profiler.h"
+#include "latency_hist.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LINE_MAX_LEN 64
+#define LINK_BIN_US 500             // Telemetry latency histogram, 128 ms range
+
+static char line_buf[LINE_MAX_LEN];
+static int  line_len = 0;
+static bool line_overflow = false;
+static uint64_t line_time_us = 0;   // When the current line's terminator arrived
+
+// Pi -> Pico telemetry latency, from the send time the Pi stamps on it
+static LatencyHist link_latency;
+
+static const UsbCommand* app_table = NULL;
+static int app_count = 0;
+
+// ── Built-in commands ─────────────────────────────────────────────────────────
+
+static void cmd_help(const char* args);
+
+static void cmd_prof(const char* args) {
+    if (strcmp(args, "reset") == 0) {
+        prof_reset();
+        printf("[USB] Profiler statistics cleared\n");
+    } else {
+        prof_dump();
+    }
+}
+
+// Clock sync ping from the Pi: "sync <seq> <t1>" answered with
+// "SYNC:<seq>,<t1>,<t2>,<t3>", t2 = line received, t3 = reply sent (Pico us)
+static void cmd_sync(const char* args) {
+    unsigned long seq;
+    unsigned long long t1;
+    if (sscanf(args, "%lu %llu", &seq, &t1) != 2) {
+        printf("[USB] usage: sync <seq> <t1>\n");
+        return;
+    }
+    printf("SYNC:%lu,%llu,%llu,%llu\n", seq, t1,
+           (unsigned long long)line_time_us, (unsigned long long)time_us_64());
+}
+
+// "link" prints the telemetry latency, "link reset" starts over
+static void cmd_link(const char* args) {
+    if (strcmp(args, "reset") == 0) {
+        latency_hist_reset(&link_latency);
+    }
+    LatencySummary s;
+    latency_hist_summary(&link_latency, &s);
+    printf("[LINK] %lu telemetry lines: p50 %.1f p95 %.1f ms (min %.1f mean %.1f max %.1f)\n",
+           (unsigned long)s.count, s.p50_us / 1000.0f, s.p95_us / 1000.0f,
+           s.min_us / 1000.0f, s.mean_us / 1000.0f, s.max_us / 1000.0f);
+}
+
+static const UsbCommand builtin_commands[] = {
+    {"help", "List commands",                           cmd_help},
+    {"prof", "Profiler zones (prof reset: clear stats)", cmd_prof},
+    {"sync", "Clock sync ping (sent by the Pi)",        cmd_sync},
+    {"link", "Pi telemetry latency (link reset: clear)", cmd_link},
+};
+
+#define BUILTIN_COUNT ((int)(sizeof(builtin_commands) / sizeof(builtin_commands[0])))
+
+static void cmd_help(const char* args) {
+    (void)args;
+    for (int i = 0; i < BUILTIN_COUNT; i++) {
+        printf("  %-8s %s\n", builtin_commands[i].name, builtin_commands[i].help);
+    }
+    for (int i = 0; i < app_count; i++) {
+        printf("  %-8s %s\n", app_table[i].name, app_table[i].help);
+    }
+}
+
+// ── Dispatch ──────────────────────────────────────────────────────────────────
+
+static const UsbCommand* find_command(const char* name) {
+    for (int i = 0; i < BUILTIN_COUNT; i++) {
+        if (strcmp(builtin_commands[i].name, name) == 0) return &builtin_commands[i];
+    }
+    for (int i = 0; i < app_count; i++) {
+        if (strcmp(app_table[i].name, name) == 0) return &app_table[i];
+    }
+    return NULL;
+}
+
+// Telemetry JSON from the Pi shares the link. Its first member is the send
+// time on this clock, {"t":<us>,... (0 until the Pi's clock mapping locks);
+// the rest of the line is not needed here, and nothing is replied.
+static void run_telemetry(const char* line) {
+    unsigned long long t;
+    if (sscanf(line, "{\"t\":%llu", &t) != 1 || t == 0 || t > line_time_us) return;
+    latency_hist_add(&link_latency, (uint32_t)(line_time_us - t));
+}
+
+static void run_line(char* line) {
+    // Split "name args..." at the first space
+    while (*line == ' ') line++;
+    if (*line == '\0') return;
+
+    char* args = strchr(line, ' ');
+    if (args) {
+        *args++ = '\0';
+        while (*args == ' ') args++;
+    } else {
+        args = line + strlen(line);
+    }
+
+    const UsbCommand* cmd = find_command(line);
+    if (cmd) {
+        cmd->handler(args);
+    } else {
+        printf("[USB] Unknown command '%s' (try help)\n", line);
+    }
+}
+
+void usb_commands_init(const UsbCommand* app_commands, int count) {
+    app_table = app_commands;
+    app_count = app_commands ? count : 0;
+    line_len = 0;
+    line_overflow = false;
+    latency_hist_init(&link_latency, LINK_BIN_US);
+}
+
+void usb_commands_poll(void) {
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (c == '\r' || c == '\n') {
+            line_time_us = time_us_64();
+            line_buf[line_len] = '\0';
+            if (line_buf[0] == '{') {
+                run_telemetry(line_buf);    // Only its start is kept
+            } else if (line_overflow) {
+                printf("[USB] Line too long (max %d chars)\n", LINE_MAX_LEN - 1);
+            } else if (line_len > 0) {
+                run_line(line_buf);
+            }
+            line_len = 0;
+            line_overflow = false;
+        } else if (line_len < LINE_MAX_LEN - 1) {
+            line_buf[line_len++] = (char)c;
+        } else {
+            line_overflow = true;
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef USB_COMMANDS_H
+#define USB_COMMANDS_H
+
+#include <stdbool.h>
+
+// Line-oriented commands typed into the USB serial console (any terminal;
+// the baud rate is ignored by USB CDC). Type "help" for the list. Lines
+// starting with '{' are the Pi's telemetry JSON: never answered, only their
+// send time is read for the "link" latency report.
+
+typedef void (*UsbCommandHandler)(const char* args);
+
+typedef struct {
+    const char*       name;     // First word of the line
+    const char*       help;     // One-line description for "help"
+    UsbCommandHandler handler;  // Receives the rest of the line ("" if none)
+} UsbCommand;
+
+// Register the built-in commands (profiler, clock sync) plus an application table
+void usb_commands_init(const UsbCommand* app_commands, int count);
+
+// Drain pending console input without blocking; runs complete lines
+void usb_commands_poll(void);
+
+#endif // USB_COMMANDS_H
@@ -0,0 +1,319 @@
+/*
+ * IMU Stream Capture
+ * Records the Pico's binary IMU stream (pico/c/drivers/imu_stream.h) from
+ * its USB serial port to a capture file, and converts captures to the CSV
+ * recording format replayed by estimator_bench.
+ *
+ * Usage:
+ *   ./imu_capture [-d /dev/ttyACM0] flight.pimu    record until Ctrl-C
+ *   ./imu_capture -x flight.pimu flight.csv        export for estimator_bench
+ *
+ * Recording sends "stream on" to the Pico, keeps only packets whose CRC
+ * checks (console text that slips in between is skipped) and sends
+ * "stream off" on exit. File format: documentation/IMU_STREAM.md.
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/time.h>
+#include "imu_stream.h"
+
+#define FILE_MAGIC       "PIMU"
+#define FILE_HEADER_SIZE 16
+#define DEFAULT_DEVICE   "/dev/ttyACM0"
+
+static volatile sig_atomic_t stop_requested = 0;
+
+typedef struct {
+    uint8_t buf[4096];
+    size_t len;
+    uint32_t next_seq;
+    bool have_seq;
+    unsigned long packets, samples, lost, crc_errors, skipped;
+} Parser;
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), as in the firmware
+static uint16_t crc16(const uint8_t *p, size_t n) {
+    uint16_t crc = 0xFFFF;
+    while (n--) {
+        crc ^= (uint16_t)(*p++ << 8);
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static bool payload_len_ok(uint8_t type, uint8_t len) {
+    return (type == IMU_STREAM_TYPE_INFO && len == sizeof(ImuStreamInfo)) ||
+           (type == IMU_STREAM_TYPE_SAMPLE && len == sizeof(ImuStreamSample));
+}
+
+/*
+ * Pull the next valid packet out of the parser buffer.
+ * Returns the packet length (packet starts at p->buf), or 0 if more bytes
+ * are needed. Garbage before a packet is discarded.
+ */
+static size_t parser_next(Parser *p) {
+    const size_t hdr_len = sizeof(ImuStreamHeader);
+
+    while (p->len >= hdr_len) {
+        ImuStreamHeader hdr;
+        memcpy(&hdr, p->buf, hdr_len);
+
+        if (hdr.sync[0] == IMU_STREAM_SYNC0 && hdr.sync[1] == IMU_STREAM_SYNC1 &&
+            payload_len_ok(hdr.type, hdr.len)) {
+            size_t total = hdr_len + hdr.len + IMU_STREAM_CRC_LEN;
+            if (p->len < total) return 0;
+
+            uint16_t crc = (uint16_t)(p->buf[total - 2] | (p->buf[total - 1] << 8));
+            if (crc16(p->buf + 2, total - 2 - IMU_STREAM_CRC_LEN) == crc) {
+                if (p->have_seq && hdr.seq != p->next_seq) {
+                    // seq restarts at 0 when streaming is re-enabled
+                    if (hdr.seq > p->next_seq) p->lost += hdr.seq - p->next_seq;
+                }
+                p->next_seq = hdr.seq + 1;
+                p->have_seq = true;
+                p->packets++;
+                if (hdr.type == IMU_STREAM_TYPE_SAMPLE) p->samples++;
+                return total;
+            }
+            p->crc_errors++;
+        }
+
+        // Not a packet here: resync one byte further on
+        memmove(p->buf, p->buf + 1, --p->len);
+        p->skipped++;
+    }
+    return 0;
+}
+
+static void parser_consume(Parser *p, size_t n) {
+    memmove(p->buf, p->buf + n, p->len - n);
+    p->len -= n;
+}
+
+static void parser_report(const Parser *p) {
+    fprintf(stderr, "%lu packets (%lu samples), %lu lost, %lu CRC errors, %lu bytes skipped\n",
+            p->packets, p->samples, p->lost, p->crc_errors, p->skipped);
+}
+
+// ── Recording ─────────────────────────────────────────────────────────────────
+
+static void on_signal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static int open_serial(const char *device) {
+    int fd = open(device, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        perror(device);
+        return -1;
+    }
+
+    struct termios tty;
+    if (tcgetattr(fd, &tty) != 0) {
+        perror("tcgetattr");
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tty);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 2;    // 200 ms read timeout so Ctrl-C is noticed
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        perror("tcsetattr");
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+static void send_command(int fd, const char *cmd) {
+    if (write(fd, cmd, strlen(cmd)) < 0) perror("write");
+}
+
+static int record(const char *device, const char *path) {
+    int fd = open_serial(device);
+    if (fd < 0) return 1;
+
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        perror(path);
+        close(fd);
+        return 1;
+    }
+
+    // File header: magic, stream version, header size, host start time (µs)
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint8_t header[FILE_HEADER_SIZE] = {0};
+    uint16_t version = IMU_STREAM_VERSION, header_size = FILE_HEADER_SIZE;
+    uint64_t start_us = (uint64_t)tv.tv_sec * 1000000u + (uint64_t)tv.tv_usec;
+    memcpy(header, FILE_MAGIC, 4);
+    memcpy(header + 4, &version, 2);
+    memcpy(header + 6, &header_size, 2);
+    memcpy(header + 8, &start_us, 8);
+    fwrite(header, 1, sizeof(header), out);
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    send_command(fd, "\nstream on\n");
+    fprintf(stderr, "Recording %s to %s, Ctrl-C to stop\n", device, path);
+
+    Parser p = {0};
+    unsigned long last_report = 0;
+    while (!stop_requested) {
+        ssize_t n = read(fd, p.buf + p.len, sizeof(p.buf) - p.len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("read");
+            break;
+        }
+        p.len += (size_t)n;
+
+        size_t pkt;
+        while ((pkt = parser_next(&p)) > 0) {
+            fwrite(p.buf, 1, pkt, out);
+            parser_consume(&p, pkt);
+        }
+
+        if (p.samples - last_report >= 5000) {
+            last_report = p.samples;
+            parser_report(&p);
+        }
+    }
+
+    send_command(fd, "\nstream off\n");
+    close(fd);
+    fclose(out);
+    parser_report(&p);
+    return 0;
+}
+
+// ── Export ────────────────────────────────────────────────────────────────────
+
+static int export_csv(const char *in_path, const char *out_path) {
+    FILE *in = fopen(in_path, "rb");
+    if (!in) {
+        perror(in_path);
+        return 1;
+    }
+
+    uint8_t header[FILE_HEADER_SIZE];
+    uint16_t version = 0;
+    if (fread(header, 1, sizeof(header), in) != sizeof(header) ||
+        memcmp(header, FILE_MAGIC, 4) != 0) {
+        fprintf(stderr, "%s: not an IMU capture\n", in_path);
+        fclose(in);
+        return 1;
+    }
+    memcpy(&version, header + 4, 2);
+    if (version != IMU_STREAM_VERSION) {
+        fprintf(stderr, "%s: stream version %u, expected %u\n", in_path, version, IMU_STREAM_VERSION);
+        fclose(in);
+        return 1;
+    }
+
+    FILE *out = fopen(out_path, "w");
+    if (!out) {
+        perror(out_path);
+        fclose(in);
+        return 1;
+    }
+    fprintf(out, "t_s,gx,gy,gz,ax,ay,az,mx,my,mz,roll_deg,pitch_deg,yaw_deg\n");
+
+    const double d2r = M_PI / 180.0;
+    ImuStreamInfo info;
+    bool have_info = false;
+    uint64_t t0 = 0;
+    bool have_t0 = false;
+    unsigned long skipped_before_info = 0;
+
+    Parser p = {0};
+    size_t n;
+    while ((n = fread(p.buf + p.len, 1, sizeof(p.buf) - p.len, in)) > 0 || p.len > 0) {
+        p.len += n;
+        size_t pkt;
+        bool progress = false;
+        while ((pkt = parser_next(&p)) > 0) {
+            progress = true;
+            ImuStreamHeader hdr;
+            memcpy(&hdr, p.buf, sizeof(hdr));
+            const uint8_t *payload = p.buf + sizeof(hdr);
+
+            if (hdr.type == IMU_STREAM_TYPE_INFO) {
+                memcpy(&info, payload, sizeof(info));
+                have_info = true;
+            } else if (!have_info) {
+                skipped_before_info++;
+            } else {
+                ImuStreamSample s;
+                memcpy(&s, payload, sizeof(s));
+                if (!have_t0) {
+                    t0 = s.t_us;
+                    have_t0 = true;
+                }
+
+                // Same conversions as the AHRS core (notch filters not applied)
+                double g[3], a[3], m[3] = {0, 0, 0};
+                for (int i = 0; i < 3; i++) {
+                    g[i] = (s.gyro[i] / info.gyro_lsb_per_dps - s.gyro_bias[i]) * d2r;
+                    a[i] = s.accel[i] / info.accel_lsb_per_g - info.accel_bias[i];
+                }
+                if ((s.flags & IMU_STREAM_FLAG_MAG_FRESH) && info.mag_field_ut > 0.0f) {
+                    double body[3] = {s.mag[0], -s.mag[1], -s.mag[2]};
+                    for (int i = 0; i < 3; i++) {
+                        m[i] = (body[i] * info.mag_ut_per_lsb - info.mag_offset[i]) * info.mag_scale[i];
+                    }
+                }
+
+                // Display angles back to the quaternion.h convention
+                double yaw = 180.0 - s.heading;
+                if (yaw > 180.0) yaw -= 360.0;
+
+                fprintf(out, "%.6f,%.6f,%.6f,%.6f,%.5f,%.5f,%.5f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                        (s.t_us - t0) * 1e-6, g[0], g[1], g[2], a[0], a[1], a[2],
+                        m[0], m[1], m[2], -s.roll, -s.pitch, yaw);
+            }
+            parser_consume(&p, pkt);
+        }
+        if (n == 0 && !progress) break;     // Trailing partial packet
+    }
+
+    fclose(in);
+    fclose(out);
+    parser_report(&p);
+    if (skipped_before_info) {
+        fprintf(stderr, "%lu samples before the first INFO packet were skipped\n", skipped_before_info);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 4 && strcmp(argv[1], "-x") == 0) {
+        return export_csv(argv[2], argv[3]);
+    }
+    if (argc == 4 && strcmp(argv[1], "-d") == 0) {
+        return record(argv[2], argv[3]);
+    }
+    if (argc == 2 && argv[1][0] != '-') {
+        return record(DEFAULT_DEVICE, argv[1]);
+    }
+
+    fprintf(stderr, "Usage: %s [-d device] capture.pimu\n"
+                    "       %s -x capture.pimu recording.csv\n", argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,80 @@
+/*
+ * LCD Backend Benchmark
+ * Draws full HUD-sized frames and displays them through the spidev or the
+ * DRM backend of st7789_rpi.c, reporting CPU time and wall time per frame.
+ * CPU time is what the render loop loses to the display; with DRM the
+ * transfer runs in the kernel and only shows up as a lower frame rate cap.
+ *
+ * The panel is bound to one driver at a time (spidev, or panel-mipi-dbi
+ * with the overlay loaded), so run it once per configuration:
+ *   ./lcd_backend_bench spidev [frames]
+ *   ./lcd_backend_bench drm [frames]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "../include/st7789_rpi.h"
+
+static double clock_ms(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Something HUD-like that changes every frame
+static void draw_frame(int n) {
+    lcd_fb_clear(COLOR_BLACK);
+    int horizon = LCD_HEIGHT / 2 + (n % 60) - 30;
+    for (int i = -2; i <= 2; i++) {
+        lcd_fb_draw_line(0, horizon + i * 20 + n % 7, LCD_WIDTH - 1, horizon - i * 20, COLOR_CYAN);
+    }
+    lcd_fb_fill_rect(0, 0, 15, LCD_HEIGHT, COLOR_BLACK);
+    lcd_fb_fill_rect(LCD_WIDTH - 15, 0, 15, LCD_HEIGHT, COLOR_BLACK);
+    lcd_fb_fill_rect(LCD_WIDTH / 2 - 2, LCD_HEIGHT / 2 - 2, 5, 5, COLOR_YELLOW);
+    char text[32];
+    snprintf(text, sizeof(text), "FRAME %d", n);
+    lcd_fb_draw_string(20, LCD_HEIGHT - 20, text, COLOR_WHITE, COLOR_BLACK);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || (strcmp(argv[1], "spidev") != 0 && strcmp(argv[1], "drm") != 0)) {
+        fprintf(stderr, "Usage: %s spidev|drm [frames]\n", argv[0]);
+        return 1;
+    }
+    LcdBackend which = strcmp(argv[1], "drm") == 0 ? LCD_BACKEND_DRM : LCD_BACKEND_SPIDEV;
+    int frames = argc > 2 ? atoi(argv[2]) : 300;
+
+    if (lcd_init_backend(which) < 0) {
+        fprintf(stderr, "%s backend not available\n", argv[1]);
+        return 1;
+    }
+
+    // Drawing alone, to separate it from the display cost
+    double cpu0 = clock_ms(CLOCK_PROCESS_CPUTIME_ID);
+    for (int n = 0; n < frames; n++) {
+        draw_frame(n);
+    }
+    double draw_ms = (clock_ms(CLOCK_PROCESS_CPUTIME_ID) - cpu0) / frames;
+
+    double wall0 = clock_ms(CLOCK_MONOTONIC);
+    cpu0 = clock_ms(CLOCK_PROCESS_CPUTIME_ID);
+    for (int n = 0; n < frames; n++) {
+        draw_frame(n);
+        lcd_display_framebuffer();
+    }
+    double cpu_ms = (clock_ms(CLOCK_PROCESS_CPUTIME_ID) - cpu0) / frames;
+    double wall_ms = (clock_ms(CLOCK_MONOTONIC) - wall0) / frames;
+
+    lcd_clear(COLOR_BLACK);
+    lcd_cleanup();
+
+    printf("%s: %d frames\n", argv[1], frames);
+    printf("  draw only        %6.2f ms CPU/frame\n", draw_ms);
+    printf("  draw + display   %6.2f ms CPU/frame (display %.2f ms)\n", cpu_ms, cpu_ms - draw_ms);
+    printf("  wall             %6.2f ms/frame (%.1f fps)\n", wall_ms, 1000.0 / wall_ms);
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Logger Overhead Benchmark
+ * Measures what a log call costs the calling thread with src/logger.c,
+ * next to printf + fflush, with the output going to /dev/null and to a
+ * slow pipe (a reader that stalls like a busy journald).
+ *
+ * Usage:
+ *   ./log_bench
+ *
+ * Also checks that deferred formatting matches printf for the conversions
+ * the app uses. Exit status is 0 if it does.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include "../include/logger.h"
+
+#define BURST 200                   // Calls between pauses (fits one ring)
+#define BURSTS 200
+#define PAUSE_US 20000
+
+typedef struct {
+    uint32_t ns[BURST * BURSTS];
+    int n;
+} Samples;
+
+static Samples samples;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, uint32_t timer_ns) {
+    qsort(samples.ns, samples.n, sizeof(samples.ns[0]), compare_u32);
+    double sum = 0.0;
+    for (int i = 0; i < samples.n; i++) {
+        sum += samples.ns[i] > timer_ns ? samples.ns[i] - timer_ns : 0;
+    }
+#define PCT(p) (samples.ns[(int)((samples.n - 1) * (p))] > timer_ns ? samples.ns[(int)((samples.n - 1) * (p))] - timer_ns : 0)
+    fprintf(stderr, "%-28s mean %7.0f ns  p50 %7u ns  p99 %8u ns  max %9u ns\n",
+            name, sum / samples.n, PCT(0.50), PCT(0.99), PCT(1.0));
+#undef PCT
+    samples.n = 0;
+}
+
+// Slow consumer on the read end of a pipe: 4 KiB every 10 ms (~400 kB/s)
+static volatile bool reader_stop = false;
+static void *slow_reader(void *arg) {
+    int fd = *(int *)arg;
+    char buf[4096];
+    while (!reader_stop) {
+        if (read(fd, buf, sizeof(buf)) <= 0) break;
+        usleep(10000);
+    }
+    return NULL;
+}
+
+#define MEASURE(stmt) do {                                              \
+    for (int b = 0; b < BURSTS; b++) {                                  \
+        for (int i = 0; i < BURST; i++) {                               \
+            uint64_t t0 = now_ns();                                     \
+            stmt;                                                       \
+            samples.ns[samples.n++] = (uint32_t)(now_ns() - t0);        \
+        }                                                               \
+        usleep(PAUSE_US);                                               \
+    }                                                                   \
+} while (0)
+
+static bool check_format(void) {
+    char path[] = "/tmp/log_bench_XXXXXX";
+    int fd = mkstemp(path);
+    int saved = dup(STDOUT_FILENO);
+    fflush(stdout);
+    dup2(fd, STDOUT_FILENO);
+
+    // No drain thread yet: formatted synchronously through the same code
+    const char *name = "N123AB";
+    unsigned long ul = 42;
+    LOGI("a %d b %5.2f c %-8s| d %lu e %x f %.0f%% g %c", -3, 3.14159f, name, ul, 255u, 99.6, 'z');
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    char line[512] = "";
+    FILE *f = fopen(path, "r");
+    if (!f || !fgets(line, sizeof(line), f)) line[0] = '\0';
+    if (f) fclose(f);
+    close(fd);
+    unlink(path);
+
+    char want[256];
+    snprintf(want, sizeof(want), "a %d b %5.2f c %-8s| d %lu e %x f %.0f%% g %c\n",
+             -3, 3.14159f, name, ul, 255u, 99.6, 'z');
+    const char *got = strstr(line, "a -3");
+    bool ok = got && strcmp(got, want) == 0;
+    fprintf(stderr, "Format check: %s", ok ? "PASS\n" : "FAIL\n");
+    if (!ok) fprintf(stderr, "  want: %s  got:  %s", want, got ? got : line);
+    return ok;
+}
+
+int main(void) {
+    bool ok = check_format();
+
+    // Timer cost, subtracted from every sample
+    MEASURE((void)0);
+    qsort(samples.ns, samples.n, sizeof(samples.ns[0]), compare_u32);
+    uint32_t timer_ns = samples.ns[samples.n / 2];
+    samples.n = 0;
+    fprintf(stderr, "clock_gettime pair: %u ns (subtracted)\n\n", timer_ns);
+
+    int null_fd = open("/dev/null", O_WRONLY);
+    int saved = dup(STDOUT_FILENO);
+    double att = 12.5, roll = -3.25;
+    const char *state = "ACTIVE";
+
+    // 1. stdout to /dev/null
+    dup2(null_fd, STDOUT_FILENO);
+    MEASURE(printf("Telemetry sent: pitch %.1f roll %.1f bank %s seq %d\n", att, roll, state, i); fflush(stdout));
+    report("printf+fflush, /dev/null", timer_ns);
+
+    log_init(LOG_SINK_STDOUT, "log_bench");
+    MEASURE(LOGI("Telemetry sent: pitch %.1f roll %.1f bank %s seq %d", att, roll, state, i));
+    report("LOGI, /dev/null", timer_ns);
+    MEASURE(LOGI_RATE(10, "Telemetry sent: pitch %.1f roll %.1f bank %s seq %d", att, roll, state, i));
+    report("LOGI_RATE(10), mostly cut", timer_ns);
+    MEASURE(LOGD("Telemetry JSON: %s", state));
+    report("LOGD (compiled out)", timer_ns);
+    log_shutdown();
+
+    // 2. stdout to a pipe with a slow reader
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) return 1;
+    pthread_t reader;
+    pthread_create(&reader, NULL, slow_reader, &pipe_fds[0]);
+    dup2(pipe_fds[1], STDOUT_FILENO);
+
+    MEASURE(printf("Telemetry sent: pitch %.1f roll %.1f bank %s seq %d\n", att, roll, state, i); fflush(stdout));
+    report("printf+fflush, slow pipe", timer_ns);
+
+    log_init(LOG_SINK_STDOUT, "log_bench");
+    MEASURE(LOGI("Telemetry sent: pitch %.1f roll %.1f bank %s seq %d", att, roll, state, i));
+    report("LOGI, slow pipe", timer_ns);
+    log_shutdown();
+
+    LogStats stats;
+    log_get_stats(&stats);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    reader_stop = true;
+    close(pipe_fds[1]);
+    pthread_join(reader, NULL);
+
+    fprintf(stderr, "\nLogger: %llu records written, %llu dropped, %llu rate limited\n",
+            (unsigned long long)stats.records, (unsigned long long)stats.dropped,
+            (unsigned long long)stats.suppressed);
+    return ok ? 0 : 1;
+}
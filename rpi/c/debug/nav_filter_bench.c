@@ -0,0 +1,235 @@
+/*
+ * Navigation Filter Benchmark
+ * Measures cost and accuracy of the GPS/inertial filter (src/nav_filter.c)
+ *
+ * Usage:
+ *   ./nav_filter_bench                 synthetic flight with known truth
+ *   ./nav_filter_bench recording.csv   replay a PILOT_NAV_LOG recording
+ *
+ * Synthetic mode reports RMS error against truth for the filter and for
+ * the raw (held) GPS values the tapes used before. Replay mode has no
+ * truth, so it reports the RMS of the filter's prediction just before
+ * each GPS fix against that fix, next to the same metric for holding the
+ * previous fix.
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../include/nav_filter.h"
+
+#define SENSOR_RATE_HZ 200
+#define GPS_RATE_HZ    5
+
+typedef struct {
+    double sum_sq;
+    long n;
+} RmsAcc;
+
+static void rms_add(RmsAcc *acc, double err) {
+    acc->sum_sq += err * err;
+    acc->n++;
+}
+
+static double rms(const RmsAcc *acc) {
+    return acc->n ? sqrt(acc->sum_sq / acc->n) : 0.0;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Deterministic gaussian noise (Box-Muller on a small LCG)
+static unsigned long rng_state = 12345;
+static double randn(void) {
+    rng_state = rng_state * 6364136223846793005UL + 1442695040888963407UL;
+    double u1 = ((rng_state >> 11) + 1.0) / 9007199254740993.0;
+    rng_state = rng_state * 6364136223846793005UL + 1442695040888963407UL;
+    double u2 = (rng_state >> 11) / 9007199254740992.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/*
+ * Synthetic profile: taxi, takeoff roll, climb, level-off, descent.
+ * Returns true vertical/forward acceleration (m/s^2) at time t.
+ */
+static void profile_accel(double t, double *a_up, double *a_fwd) {
+    *a_up = 0.0;
+    *a_fwd = 0.0;
+    if (t > 10.0 && t < 30.0) *a_fwd = 1.5;                  // takeoff roll
+    if (t > 30.0 && t < 32.0) *a_up = 2.0;                   // rotate
+    if (t > 60.0 && t < 62.0) *a_up = -2.0;                  // level off
+    if (t > 90.0 && t < 93.0) *a_up = -1.0;                  // start descent
+    if (t > 120.0 && t < 123.0) *a_up = 1.0;                 // flare
+    *a_up += 0.3 * sin(2.0 * M_PI * 0.2 * t);                // turbulence
+}
+
+static int run_synthetic(void) {
+    const double dt = 1.0 / SENSOR_RATE_HZ;
+    const int gps_div = SENSOR_RATE_HZ / GPS_RATE_HZ;
+    const double duration = 150.0;
+
+    NavFilter nav;
+    nav_filter_init(&nav);
+
+    double alt = 30.0, vs = 0.0, speed = 2.0;
+    double gps_alt = alt, gps_speed = speed;
+    const double bias_up = 0.15, bias_fwd = -0.1;   // m/s^2, uncorrected sensor bias
+
+    RmsAcc e_alt = {0}, e_vs = {0}, e_spd = {0};
+    RmsAcc g_alt = {0}, g_spd = {0};
+    double t_predict = 0.0, t_update = 0.0;
+    long n_predict = 0, n_update = 0;
+
+    int steps = (int)(duration / dt);
+    for (int i = 0; i < steps; i++) {
+        double t = i * dt;
+        double a_up, a_fwd;
+        profile_accel(t, &a_up, &a_fwd);
+
+        // Truth
+        alt += vs * dt + 0.5 * a_up * dt * dt;
+        vs += a_up * dt;
+        speed += a_fwd * dt;
+
+        // Level attitude, noisy accelerometer with bias and vibration residue
+        float accel_g[3] = {
+            (float)((a_fwd + bias_fwd + 0.3 * randn()) / NAV_GRAVITY),
+            (float)(0.3 * randn() / NAV_GRAVITY),
+            (float)(1.0 + (a_up + bias_up + 0.3 * randn()) / NAV_GRAVITY)
+        };
+        float up[3] = {0.0f, 0.0f, 1.0f};
+
+        double t0 = now_ns();
+        nav_filter_predict(&nav, accel_g, up, (float)dt);
+        t_predict += now_ns() - t0;
+        n_predict++;
+
+        if (i % gps_div == 0) {
+            gps_alt = alt + 3.0 * randn();
+            gps_speed = fabs(speed + 0.3 * randn());
+            t0 = now_ns();
+            nav_filter_update_altitude(&nav, (float)gps_alt);
+            nav_filter_update_speed(&nav, (float)gps_speed);
+            t_update += now_ns() - t0;
+            n_update++;
+        }
+
+        // Score after convergence
+        if (t > 5.0) {
+            rms_add(&e_alt, nav.alt_m - alt);
+            rms_add(&e_vs, nav.vs_mps - vs);
+            rms_add(&e_spd, nav.speed_mps - speed);
+            rms_add(&g_alt, gps_alt - alt);
+            rms_add(&g_spd, gps_speed - speed);
+        }
+    }
+
+    printf("Synthetic flight: %.0f s, %d Hz IMU, %d Hz GPS\n", duration, SENSOR_RATE_HZ, GPS_RATE_HZ);
+    printf("  Cost:   predict %.0f ns, GPS update %.0f ns\n",
+           t_predict / n_predict, t_update / n_update);
+    printf("  RMS error        filter    held GPS\n");
+    printf("    altitude (m)   %6.2f    %6.2f\n", rms(&e_alt), rms(&g_alt));
+    printf("    speed (m/s)    %6.2f    %6.2f\n", rms(&e_spd), rms(&g_spd));
+    printf("    VSI (m/s)      %6.2f       -\n", rms(&e_vs));
+    return 0;
+}
+
+// Parse one CSV field; returns false if empty
+static bool next_field(char **cursor, double *out) {
+    char *p = *cursor;
+    if (!p) return false;
+    char *comma = strchr(p, ',');
+    if (comma) {
+        *comma = '\0';
+        *cursor = comma + 1;
+    } else {
+        *cursor = NULL;
+    }
+    if (*p == '\0' || *p == '\n') return false;
+    *out = atof(p);
+    return true;
+}
+
+static int run_replay(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+
+    NavFilter nav;
+    nav_filter_init(&nav);
+
+    char line[256];
+    double last_t = -1.0;
+    double held_alt = NAN, held_speed = NAN;
+    RmsAcc e_alt = {0}, e_spd = {0}, h_alt = {0}, h_spd = {0};
+    double t_predict = 0.0;
+    long n_predict = 0, rows = 0;
+
+    // Skip header
+    if (!fgets(line, sizeof(line), f)) {
+        fclose(f);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), f)) {
+        char *cur = line;
+        double v[9];
+        bool has[9];
+        for (int i = 0; i < 9; i++) has[i] = next_field(&cur, &v[i]);
+        if (!has[0]) continue;
+        rows++;
+
+        if (has[1] && has[2] && has[3] && has[4] && has[5] && has[6]) {
+            float accel_g[3] = {(float)v[1], (float)v[2], (float)v[3]};
+            float up[3] = {(float)v[4], (float)v[5], (float)v[6]};
+            float dt = last_t >= 0.0 ? (float)(v[0] - last_t) : 0.0f;
+            last_t = v[0];
+
+            double t0 = now_ns();
+            nav_filter_predict(&nav, accel_g, up, dt);
+            t_predict += now_ns() - t0;
+            n_predict++;
+        }
+
+        if (has[7]) {
+            if (nav.alt_valid) {
+                rms_add(&e_alt, nav.alt_m - v[7]);
+                rms_add(&h_alt, held_alt - v[7]);
+            }
+            nav_filter_update_altitude(&nav, (float)v[7]);
+            held_alt = v[7];
+        }
+        if (has[8]) {
+            if (nav.speed_valid) {
+                rms_add(&e_spd, nav.speed_mps - v[8]);
+                rms_add(&h_spd, held_speed - v[8]);
+            }
+            nav_filter_update_speed(&nav, (float)v[8]);
+            held_speed = v[8];
+        }
+    }
+    fclose(f);
+
+    printf("Replay %s: %ld rows, %ld IMU samples\n", path, rows, n_predict);
+    if (n_predict) printf("  Cost:   predict %.0f ns\n", t_predict / n_predict);
+    printf("  RMS error vs next GPS fix   filter    held GPS\n");
+    printf("    altitude (m)              %6.2f    %6.2f\n", rms(&e_alt), rms(&h_alt));
+    printf("    speed (m/s)               %6.2f    %6.2f\n", rms(&e_spd), rms(&h_spd));
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        return run_replay(argv[1]);
+    }
+    return run_synthetic();
+}
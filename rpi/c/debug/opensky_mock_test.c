@@ -0,0 +1,309 @@
+/*
+ * OpenSky Scheduler Test against a Mock Server
+ * Runs the traffic refresh of the Pi app (opensky_scheduler + opensky_http
+ * + track_table) through a simulated day, with a local HTTP server standing
+ * in for OpenSky. Time is simulated in 1 s steps; every request the
+ * scheduler asks for is a real curl request to the mock.
+ *
+ * The mock charges credits like OpenSky (daily budget, X-Rate-Limit-
+ * Remaining, 429 with X-Rate-Limit-Retry-After-Seconds once spent), serves
+ * a traffic density that follows the flight phase, fails with 503 for a
+ * ten minutes and rate-limits once on its own.
+ *
+ * Day: parked at the airport, taxi, departure through busy airspace,
+ * sparse cruise, busy approach, parked again.
+ *
+ * Usage:
+ *   ./opensky_mock_test [daily credits]
+ *
+ * Prints requests and mean interval per phase. Exit status is 0 if the
+ * budget held, no request came during a backoff, ownship reused responses
+ * while parked, the box shrank in dense traffic and departed targets were
+ * dropped from the track table. A second, scheduler-only day checks the
+ * fixed cadence of the Pico radar (default position, no speed): the
+ * first half hour refreshes at that cadence and the day stays in budget.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "../include/opensky_http.h"
+
+#define SIM_START_MS 1000u
+#define DAY_S 86400
+#define OUTAGE_START_S (7 * 3600)           // 503 from the mock
+#define OUTAGE_END_S (7 * 3600 + 600)
+#define LIMIT_AT_S (12 * 3600)              // First request after this gets a 429
+#define LIMIT_RETRY_S 900
+#define ESSA_LAT 59.6519
+#define ESSA_LON 17.9186
+
+typedef struct {
+    const char *name;
+    int end_s;
+    float speed_kt;
+    int density;                            // Aircraft the mock serves
+} Phase;
+
+static const Phase phases[] = {
+    { "parked",    6 * 3600,        0.0f,   25 },
+    { "taxi",      6 * 3600 + 600,  15.0f,  25 },
+    { "departure", 6 * 3600 + 1500, 160.0f, 45 },
+    { "cruise",    8 * 3600,        250.0f, 2 },
+    { "approach",  8 * 3600 + 1200, 140.0f, 35 },
+    { "parked",    DAY_S,           0.0f,   25 },
+};
+#define PHASES (int)(sizeof(phases) / sizeof(phases[0]))
+
+// Mock server state, shared with the server thread
+static struct {
+    pthread_mutex_t lock;
+    uint32_t sim_s;
+    int density;
+    int credits_left;
+    bool limit_sent;
+    uint32_t limit_until_s;
+    int requests;
+    int charged;
+    int exhausted;                          // 429s for a spent budget
+    int early;                              // Requests during a Retry-After
+    float min_lat_span;                     // Smallest box seen, degrees
+} mock = { .lock = PTHREAD_MUTEX_INITIALIZER, .min_lat_span = 1e9f };
+
+static int server_fd = -1;
+
+static void send_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n <= 0) return;
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+// Aircraft spread over the inner part of the box, stable addresses
+static int states_body(char *out, size_t size, double lamin, double lamax,
+                       double lomin, double lomax, int count, uint32_t sim_s) {
+    int used = snprintf(out, size, "{\"time\":%u,\"states\":[", sim_s);
+    for (int i = 0; i < count && used < (int)size - 256; i++) {
+        double fy = 0.2 + 0.6 * ((i * 37) % 100) / 100.0;
+        double fx = 0.2 + 0.6 * ((i * 61) % 100) / 100.0;
+        used += snprintf(out + used, size - used,
+                         "%s[\"%06x\",\"MOCK%03d \",\"Sweden\",%u,%u,%.5f,%.5f,%.1f,false,%.1f,%.1f,0.0,null,%.1f,\"1200\",false,0]",
+                         i ? "," : "", 0x4a0000 + i, i, sim_s, sim_s,
+                         lomin + fx * (lomax - lomin), lamin + fy * (lamax - lamin),
+                         1000.0 + 100 * i, 120.0 + i, (double)((i * 45 + sim_s / 10) % 360), 1000.0 + 100 * i);
+    }
+    used += snprintf(out + used, size - used, "]}");
+    return used;
+}
+
+static void handle(int fd) {
+    char req[2048];
+    ssize_t n = read(fd, req, sizeof(req) - 1);
+    if (n <= 0) return;
+    req[n] = '\0';
+
+    double lamin = 0, lamax = 0, lomin = 0, lomax = 0;
+    const char *q = strstr(req, "/states/all?");
+    if (!q || sscanf(q, "/states/all?lamin=%lf&lamax=%lf&lomin=%lf&lomax=%lf",
+                     &lamin, &lamax, &lomin, &lomax) != 4) {
+        const char *bad = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        send_all(fd, bad, strlen(bad));
+        return;
+    }
+
+    static char body[65536];
+    char head[512];
+    int body_len = 0;
+
+    pthread_mutex_lock(&mock.lock);
+    uint32_t now_s = mock.sim_s;
+    mock.requests++;
+    if ((float)(lamax - lamin) < mock.min_lat_span) mock.min_lat_span = (float)(lamax - lamin);
+
+    if (mock.limit_until_s && now_s < mock.limit_until_s) {
+        mock.early++;
+    }
+    if (now_s >= OUTAGE_START_S && now_s < OUTAGE_END_S) {
+        snprintf(head, sizeof(head), "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    } else if (!mock.limit_sent && now_s >= LIMIT_AT_S) {
+        mock.limit_sent = true;
+        mock.limit_until_s = now_s + LIMIT_RETRY_S;
+        snprintf(head, sizeof(head),
+                 "HTTP/1.1 429 Too Many Requests\r\nX-Rate-Limit-Retry-After-Seconds: %d\r\n"
+                 "Content-Length: 0\r\nConnection: close\r\n\r\n", LIMIT_RETRY_S);
+    } else if (mock.credits_left <= 0) {
+        mock.exhausted++;
+        snprintf(head, sizeof(head),
+                 "HTTP/1.1 429 Too Many Requests\r\nX-Rate-Limit-Retry-After-Seconds: %u\r\n"
+                 "Content-Length: 0\r\nConnection: close\r\n\r\n", DAY_S - now_s % DAY_S);
+    } else {
+        // One credit: the test boxes stay under 25 square degrees
+        mock.credits_left--;
+        mock.charged++;
+        body_len = states_body(body, sizeof(body), lamin, lamax, lomin, lomax, mock.density, now_s);
+        snprintf(head, sizeof(head),
+                 "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nx-rate-limit-remaining: %d\r\n"
+                 "Content-Length: %d\r\nConnection: close\r\n\r\n", mock.credits_left, body_len);
+    }
+    pthread_mutex_unlock(&mock.lock);
+
+    send_all(fd, head, strlen(head));
+    send_all(fd, body, (size_t)body_len);
+}
+
+static void *server_thread(void *arg) {
+    (void)arg;
+    while (true) {
+        int fd = accept(server_fd, NULL, NULL);
+        if (fd < 0) break;
+        handle(fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+static int start_server(void) {
+    server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t len = sizeof(addr);
+    if (server_fd < 0 || bind(server_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(server_fd, 8) < 0 || getsockname(server_fd, (struct sockaddr *)&addr, &len) < 0) {
+        perror("mock server");
+        return -1;
+    }
+    pthread_t thread;
+    pthread_create(&thread, NULL, server_thread, NULL);
+    pthread_detach(thread);
+    return ntohs(addr.sin_port);
+}
+
+static TrackTable tracks;
+
+// Pico radar: fixed position, fixed cadence, every request answered
+static int check_fixed_cadence(uint32_t daily) {
+    OpenSkyScheduler sched;
+    opensky_sched_init(&sched, daily, SIM_START_MS);
+    opensky_sched_set_fixed_interval(&sched, OPENSKY_SCHED_AIR_INTERVAL_MS);
+
+    int first_half_hour = 0;
+    uint32_t credits = 0;
+    for (int t = 0; t < DAY_S; t++) {
+        uint32_t now = SIM_START_MS + (uint32_t)t * 1000u;
+        OpenSkyQuery query;
+        if (!opensky_sched_poll(&sched, now, ESSA_LAT, ESSA_LON, 0.0f, &query)) continue;
+        OpenSkyResponse response = { OPENSKY_OK, 200, -1, -1, 5 };
+        opensky_sched_result(&sched, now, &query, &response);
+        credits += query.credits;
+        if (t < 1800) first_half_hour++;
+    }
+
+    int expected = 1800 * 1000 / OPENSKY_SCHED_AIR_INTERVAL_MS;
+    printf("  fixed cadence: %d requests in the first 30 min, %u credits over the day\n",
+           first_half_hour, credits);
+    int failures = 0;
+    if (first_half_hour < expected) { printf("FAIL: fixed cadence not kept\n"); failures++; }
+    if (credits > daily) { printf("FAIL: fixed cadence over budget\n"); failures++; }
+    if (sched.reused) { printf("FAIL: reuse stretched the fixed cadence\n"); failures++; }
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    uint32_t daily = argc > 1 ? (uint32_t)atoi(argv[1]) : OPENSKY_CREDITS_ANONYMOUS;
+    mock.credits_left = (int)daily;
+
+    int port = start_server();
+    if (port < 0) return 1;
+    char url[64];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d/api", port);
+
+    OpenSkyScheduler sched;
+    opensky_sched_init(&sched, daily, SIM_START_MS);
+    track_table_init(&tracks);
+
+    int phase_requests[PHASES] = {0};
+    int failures = 0;
+    uint32_t last_error_ms = 0, last_error_gap = 0;
+    double lat = ESSA_LAT, lon = ESSA_LON;
+    int phase = 0;
+
+    for (int t = 0; t < DAY_S; t++) {
+        while (t >= phases[phase].end_s) phase++;
+        uint32_t now = SIM_START_MS + (uint32_t)t * 1000u;
+        float speed = phases[phase].speed_kt;
+        lat += speed * 1.852 / 111.32 / 3600.0;   // Northbound
+
+        pthread_mutex_lock(&mock.lock);
+        mock.sim_s = (uint32_t)t;
+        mock.density = phases[phase].density;
+        pthread_mutex_unlock(&mock.lock);
+
+        OpenSkyQuery query;
+        if (!opensky_sched_poll(&sched, now, lat, lon, speed, &query)) continue;
+
+        // As the app does: drop targets missing from two responses in a row
+        uint32_t max_age_ms = now - sched.last_response_ms;
+        OpenSkyResponse response;
+        opensky_http_fetch(url, &query, &tracks, now, &response);
+        opensky_sched_result(&sched, now, &query, &response);
+        if (response.result == OPENSKY_OK) track_table_expire(&tracks, now, max_age_ms);
+        phase_requests[phase]++;
+
+        // Error retries must back off, each gap at least as long as the last
+        if (response.result == OPENSKY_FAILED) {
+            uint32_t gap = last_error_ms ? now - last_error_ms : 0;
+            if (last_error_ms && (gap < OPENSKY_SCHED_ERROR_BACKOFF_MS || gap < last_error_gap)) {
+                printf("FAIL: error retry after %u ms\n", gap);
+                failures++;
+            }
+            last_error_gap = gap;
+            last_error_ms = now;
+        } else if (response.result == OPENSKY_OK && response.traffic_count != phases[phase].density) {
+            printf("FAIL: %d aircraft parsed at %d s, mock sent %d\n",
+                   response.traffic_count, t, phases[phase].density);
+            failures++;
+        }
+    }
+
+    printf("OpenSky scheduler vs mock, %u credits/day\n", daily);
+    printf("  %-10s %8s %14s\n", "phase", "requests", "mean interval");
+    int start = 0;
+    for (int i = 0; i < PHASES; i++) {
+        int secs = phases[i].end_s - start;
+        if (phase_requests[i]) {
+            printf("  %-10s %8d %12.0f s\n", phases[i].name, phase_requests[i], (double)secs / phase_requests[i]);
+        } else {
+            printf("  %-10s %8d %14s\n", phases[i].name, 0, "-");
+        }
+        start = phases[i].end_s;
+    }
+    printf("  credits charged %d of %u, reused %u, budget waits %u, errors %u, rate limited %u\n",
+           mock.charged, daily, sched.reused, sched.budget_waits, sched.errors, sched.rate_limited);
+    printf("  smallest box %.2f deg latitude, %u tracks at the end\n", mock.min_lat_span, tracks.count);
+
+    if (mock.exhausted) { printf("FAIL: %d requests after the budget ran out\n", mock.exhausted); failures++; }
+    if (mock.early) { printf("FAIL: %d requests before Retry-After\n", mock.early); failures++; }
+    if (sched.rate_limited != 1) { printf("FAIL: expected the one forced 429\n"); failures++; }
+    if (sched.errors == 0) { printf("FAIL: the outage went unnoticed\n"); failures++; }
+    if (sched.reused == 0) { printf("FAIL: no response reused while parked\n"); failures++; }
+    if (tracks.count != phases[PHASES - 1].density) { printf("FAIL: stale tracks kept\n"); failures++; }
+    if (mock.min_lat_span >= 2.0f * OPENSKY_SCHED_BASE_RADIUS_KM / 111.32f) {
+        printf("FAIL: the box never shrank in dense traffic\n");
+        failures++;
+    }
+
+    failures += check_fixed_cadence(daily);
+
+    printf("%s\n", failures ? "FAIL" : "PASS");
+    close(server_fd);
+    return failures ? 1 : 0;
+}
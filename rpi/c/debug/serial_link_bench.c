@@ -0,0 +1,293 @@
+/*
+ * Serial Link Test and Benchmark
+ * Drives src/serial_link.c through a pseudo-terminal standing in for the
+ * Pico's ttyACM0, no hardware needed.
+ *
+ * Usage:
+ *   ./serial_link_bench [megabytes]     default 32
+ *
+ * 1. Correctness: numbered lines of varying length written in random-size
+ *    chunks (with \r\n and \n endings, blank lines and one overlong line)
+ *    must arrive complete, in order, and the overlong one dropped.
+ * 2. Throughput: the same line stream through serial_link and through the
+ *    old byte-at-a-time serial_read_line(), in MB/s and lines/s.
+ * 3. Reconnect: the pty is closed (unplug) and a new one put behind the
+ *    same path (replug); reports how long detection and reconnect take.
+ *    ptys send no uevents, so this exercises the fallback poll.
+ *
+ * Exit status is 0 only if every check passes.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include "../include/serial_comm.h"
+#include "../include/serial_link.h"
+
+#define LINE_PAYLOAD 48             // Throughput lines are ~64 bytes, like CMD/BTN traffic
+#define CHECK_LINES 200000
+
+typedef struct {
+    int master;
+    uint32_t lines;                 // Number of lines to send
+    bool check;                     // Correctness stream (random chunks, odd lines)
+} Writer;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Open a pty and point `link_path` at its slave; returns the master fd
+static int pty_open(const char *link_path) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("posix_openpt");
+        exit(1);
+    }
+    unlink(link_path);
+    if (symlink(ptsname(master), link_path) != 0) {
+        perror("symlink");
+        exit(1);
+    }
+    return master;
+}
+
+static bool write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+// "SEQ:<n>,<payload>" where the payload length and letter derive from n
+static int format_line(char *out, uint32_t seq, bool vary) {
+    int payload = vary ? (int)(seq * 7919u % 200) : LINE_PAYLOAD;
+    int len = sprintf(out, "SEQ:%08u,", seq);
+    memset(out + len, 'a' + seq % 26, payload);
+    return len + payload;
+}
+
+static bool check_line(const char *line, size_t len, uint32_t expect, bool vary) {
+    char want[320];
+    int want_len = format_line(want, expect, vary);
+    return len == (size_t)want_len && memcmp(line, want, len) == 0;
+}
+
+static void *writer_main(void *arg) {
+    Writer *w = arg;
+    char block[65536];
+    size_t fill = 0;
+    uint32_t seq = 0;
+    unsigned rng = 12345;
+
+    if (w->check) {
+        // Overlong line first: must be dropped without losing SEQ 0
+        size_t n = SERIAL_LINK_MAX_LINE + 100;
+        char *junk = malloc(n + 1);
+        memset(junk, 'x', n);
+        junk[n] = '\n';
+        write_all(w->master, junk, n + 1);
+        free(junk);
+    }
+
+    while (seq < w->lines) {
+        fill = 0;
+        while (fill < sizeof(block) - 512 && seq < w->lines) {
+            fill += format_line(block + fill, seq, w->check);
+            if (w->check && seq % 3 == 0) {
+                memcpy(block + fill, "\r\n", 2);
+                fill += 2;
+            } else {
+                block[fill++] = '\n';
+            }
+            if (w->check && seq % 11 == 0) {
+                block[fill++] = '\n';   // Blank line
+            }
+            seq++;
+        }
+
+        if (w->check) {
+            // Random chunks so lines straddle reads and the ring wrap
+            for (size_t off = 0; off < fill;) {
+                rng = rng * 1103515245u + 12345u;
+                size_t chunk = 1 + (rng >> 16) % 700;
+                if (chunk > fill - off) chunk = fill - off;
+                if (!write_all(w->master, block + off, chunk)) return NULL;
+                off += chunk;
+            }
+        } else if (!write_all(w->master, block, fill)) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+static bool test_correctness(SerialLink *link, int master) {
+    Writer w = { master, CHECK_LINES, true };
+    uint32_t total = CHECK_LINES;
+    uint64_t dropped_before = link->stats.dropped_bytes;
+    pthread_t thread;
+    pthread_create(&thread, NULL, writer_main, &w);
+
+    uint32_t expect = 0;
+    bool ok = true;
+    double deadline = now_s() + 30.0;
+    while (expect < total && ok && now_s() < deadline) {
+        serial_link_wait(link, 100);
+        const char *l;
+        size_t len;
+        while ((l = serial_link_next_line(link, &len)) != NULL) {
+            if (!check_line(l, len, expect, true)) {
+                printf("  line %u mismatch: \"%.40s\"\n", expect, l);
+                ok = false;
+                break;
+            }
+            expect++;
+        }
+    }
+    pthread_join(thread, NULL);
+
+    uint64_t dropped = link->stats.dropped_bytes - dropped_before;
+    bool dropped_ok = dropped == SERIAL_LINK_MAX_LINE + 100;
+    printf("Correctness: %u/%u lines in order, overlong line dropped (%llu bytes): %s\n",
+           expect, total, (unsigned long long)dropped,
+           ok && expect == total && dropped_ok ? "PASS" : "FAIL");
+    return ok && expect == total && dropped_ok;
+}
+
+static double bench_link(SerialLink *link, int master, uint32_t count) {
+    Writer w = { master, count, false };
+    uint64_t reads_before = link->stats.reads;
+    uint64_t lines = 0, got = 0;
+    pthread_t thread;
+
+    double t0 = now_s();
+    pthread_create(&thread, NULL, writer_main, &w);
+    while (lines < count && serial_link_connected(link)) {
+        serial_link_wait(link, 100);
+        const char *l;
+        size_t len;
+        while ((l = serial_link_next_line(link, &len)) != NULL) {
+            got += len + 1;
+            lines++;
+        }
+    }
+    double dt = now_s() - t0;
+    pthread_join(thread, NULL);
+
+    uint64_t reads = link->stats.reads - reads_before;
+    printf("serial_link:      %7.1f MB/s  %9.0f lines/s  %6.0f bytes/read()\n",
+           got / dt / 1e6, lines / dt, reads ? (double)got / reads : 0.0);
+    return got / dt;
+}
+
+static double bench_legacy(int master, const char *path, uint32_t count) {
+    int fd = serial_open_port(path);
+    if (fd < 0) {
+        return 0.0;
+    }
+    Writer w = { master, count, false };
+    char line[SERIAL_READ_BUFFER_SIZE];
+    uint64_t lines = 0, got = 0;
+    pthread_t thread;
+
+    double t0 = now_s();
+    pthread_create(&thread, NULL, writer_main, &w);
+    while (lines < count) {
+        int n = serial_read_line(fd, line, sizeof(line), 100);
+        if (n < 0) break;
+        if (n > 0) {
+            got += n + 1;
+            lines++;
+        }
+    }
+    double dt = now_s() - t0;
+    pthread_join(thread, NULL);
+    serial_close(fd);
+
+    printf("serial_read_line: %7.1f MB/s  %9.0f lines/s  %6.0f bytes/read()\n",
+           got / dt / 1e6, lines / dt, 1.0);
+    return got / dt;
+}
+
+static bool test_reconnect(SerialLink *link, int *master, const char *path) {
+    double t0 = now_s();
+    close(*master);
+    while (serial_link_connected(link) && now_s() - t0 < 5.0) {
+        serial_link_wait(link, 100);
+    }
+    double lost = now_s() - t0;
+
+    *master = pty_open(path);
+    double t1 = now_s();
+    while (!serial_link_connected(link) && now_s() - t1 < 5.0) {
+        serial_link_wait(link, 1000);
+    }
+    double back = now_s() - t1;
+
+    bool ok = !serial_link_connected(link) ? false : lost < 0.5 &&
+              back < SERIAL_LINK_RETRY_MS / 1000.0 + 0.5;
+    printf("Reconnect: unplug seen after %.1f ms, replug picked up after %.0f ms: %s\n",
+           lost * 1e3, back * 1e3, ok ? "PASS" : "FAIL");
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    uint64_t bytes = (argc > 1 ? strtoull(argv[1], NULL, 10) : 32) * 1000000ULL;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/serial_link_bench.%d", (int)getpid());
+    const char *paths[] = { path };
+
+    int master = pty_open(path);
+    SerialLink link;
+    if (serial_link_init(&link, paths, 1) != 0 || !serial_link_connected(&link)) {
+        fprintf(stderr, "serial_link_init failed on %s\n", path);
+        unlink(path);
+        return 1;
+    }
+
+    bool ok = test_correctness(&link, master);
+
+    int line_len = LINE_PAYLOAD + 14;
+    uint32_t count = bytes / line_len;
+    printf("\nThroughput, %.0f MB of %d-byte lines through a pty:\n", bytes / 1e6, line_len);
+    double fast = bench_link(&link, master, count);
+
+    int legacy_master = pty_open(path);
+    double slow = bench_legacy(legacy_master, path, count / 8);
+    close(legacy_master);
+    if (slow > 0.0) {
+        printf("speedup %.1fx\n\n", fast / slow);
+    }
+
+    // The legacy run re-pointed the path; put it back on the link's pty
+    unlink(path);
+    symlink(ptsname(master), path);
+    ok = test_reconnect(&link, &master, path) && ok;
+
+    printf("Link stats: %llu bytes, %llu reads, %llu lines, %llu dropped, %u connects\n",
+           (unsigned long long)link.stats.bytes, (unsigned long long)link.stats.reads,
+           (unsigned long long)link.stats.lines, (unsigned long long)link.stats.dropped_bytes,
+           link.stats.connects);
+
+    serial_link_close(&link);
+    close(master);
+    unlink(path);
+    return ok ? 0 : 1;
+}
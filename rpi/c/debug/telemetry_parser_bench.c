@@ -0,0 +1,486 @@
+/*
+ * Telemetry Parser Benchmark and Fuzzer
+ * Exercises the Pico's single-pass parse_telemetry (pico/c/src/
+ * telemetry_parser.c) on the host:
+ *
+ *   - correctness: random messages with sections and fields in random
+ *     order, unknown fields of every shape mixed in, must parse back to
+ *     exactly the values they were printed from
+ *   - corpus: every file in telemetry_corpus/ must parse (ok_*) or be
+ *     rejected (bad_*)
+ *   - timing: per message and per byte, next to the strstr/atof parser it
+ *     replaced, for a full message and for one padded with unknown fields
+ *   - fuzzing: mutated corpus files (flips, inserted punctuation, cuts,
+ *     splices) must never read past the message or break the invariants of
+ *     TelemetryData; build with `make telemetry_parser_fuzz` to run this
+ *     under AddressSanitizer/UBSan
+ *
+ * Usage:
+ *   ./telemetry_parser_bench [corpus_dir] [fuzz_iterations]
+ *
+ * Exit status is 0 if all checks pass.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dirent.h>
+#include <time.h>
+#include "telemetry_parser.h"
+
+#define MSG_SIZE 8192
+#define MAX_CORPUS 64
+#define TIMING_RUNS 20000
+
+static long failures;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// ── The parser before the single-pass one (timing reference) ─────────────────
+
+typedef struct {
+    double lat, lon, alt, pitch, roll, yaw;
+    struct { char id[8]; char icao[8]; double lat, lon, alt; } traffic[MAX_TRAFFIC];
+    int traffic_count;
+    bool wifi, gps, bluetooth, bank, pitch_warning;
+} LegacyTelemetry;
+
+static char *legacy_find_key(const char *json, const char *key) {
+    char search[64];
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    return strstr(json, search);
+}
+
+static double legacy_double(const char *json, const char *key) {
+    char *pos = legacy_find_key(json, key);
+    if (!pos) return 0.0;
+    pos = strchr(pos, ':');
+    return pos ? atof(pos + 1) : 0.0;
+}
+
+static void legacy_string(const char *json, const char *key, char *out, size_t max_len) {
+    char *pos = legacy_find_key(json, key);
+    out[0] = '\0';
+    for (int q = 0; q < 3 && pos; q++) {
+        pos = strchr(pos, '"');
+        if (pos) pos++;
+    }
+    if (!pos) return;
+    size_t i = 0;
+    while (i < max_len - 1 && *pos != '"' && *pos != '\0') out[i++] = *pos++;
+    out[i] = '\0';
+}
+
+static bool legacy_bool(const char *json, const char *key) {
+    char *pos = legacy_find_key(json, key);
+    if (!pos || !(pos = strchr(pos, ':'))) return false;
+    pos++;
+    while (*pos == ' ' || *pos == '\t') pos++;
+    return strncmp(pos, "true", 4) == 0;
+}
+
+static bool legacy_parse(const char *json, LegacyTelemetry *t) {
+    memset(t, 0, sizeof(*t));
+    char *own = strstr(json, "\"own\"");
+    if (!own) return false;
+    t->lat = legacy_double(own, "lat");
+    t->lon = legacy_double(own, "lon");
+    t->alt = legacy_double(own, "alt");
+    t->pitch = legacy_double(own, "pitch");
+    t->roll = legacy_double(own, "roll");
+    t->yaw = legacy_double(own, "yaw");
+
+    char *traffic = strstr(json, "\"traffic\"");
+    char *cur = traffic ? strchr(traffic, '[') : NULL;
+    if (cur) {
+        cur++;
+        while (t->traffic_count < MAX_TRAFFIC) {
+            char *obj = strchr(cur, '{');
+            if (!obj) break;
+            char *end = strchr(obj, '}');
+            if (!end) break;
+            legacy_string(obj, "id", t->traffic[t->traffic_count].id, 8);
+            legacy_string(obj, "icao24", t->traffic[t->traffic_count].icao, 8);
+            t->traffic[t->traffic_count].lat = legacy_double(obj, "lat");
+            t->traffic[t->traffic_count].lon = legacy_double(obj, "lon");
+            t->traffic[t->traffic_count].alt = legacy_double(obj, "alt");
+            t->traffic_count++;
+            cur = end + 1;
+            char *comma = strchr(cur, ',');
+            char *array_end = strchr(cur, ']');
+            if (!array_end || (comma && comma > array_end)) break;
+            cur = comma ? comma + 1 : array_end;
+        }
+    }
+
+    char *status = strstr(json, "\"status\"");
+    if (status) {
+        t->wifi = legacy_bool(status, "wifi");
+        t->gps = legacy_bool(status, "gps");
+        t->bluetooth = legacy_bool(status, "bluetooth");
+    }
+    char *warnings = strstr(json, "\"warnings\"");
+    if (warnings) {
+        t->bank = legacy_bool(warnings, "bank");
+        t->pitch_warning = legacy_bool(warnings, "pitch");
+    }
+    return true;
+}
+
+// ── Generated messages ───────────────────────────────────────────────────────
+
+typedef struct {
+    char text[400];
+} Field;
+
+static void shuffle(Field *f, int n) {
+    for (int i = n - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        Field tmp = f[i];
+        f[i] = f[j];
+        f[j] = tmp;
+    }
+}
+
+static const char *const noise_values[] = {
+    "null", "true", "false", "-0.5e-3", "12345678901234567890123",
+    "\"str,with:}punct]\"", "\"esc\\\"aped\\u0041\"", "[]", "{}",
+    "[1,[2,[3,{\"a\":[{}]}]]]", "{\"lat\":1,\"own\":{\"lat\":2},\"traffic\":[{}]}",
+};
+
+// An unknown member, sometimes with a known key name one level down
+static void noise_field(Field *f) {
+    snprintf(f->text, sizeof(f->text), "\"x%d\":%s", rand() % 1000,
+             noise_values[rand() % (sizeof(noise_values) / sizeof(noise_values[0]))]);
+}
+
+// Join fields into an object, with random whitespace
+static size_t emit_object(char *out, size_t size, Field *f, int n) {
+    static const char *const ws[] = { "", "", " ", "\n", "\t ", "\r\n" };
+    size_t len = (size_t)snprintf(out, size, "{%s", ws[rand() % 6]);
+    for (int i = 0; i < n && len < size; i++) {
+        len += (size_t)snprintf(out + len, size - len, "%s%s%s", i ? "," : "", ws[rand() % 6], f[i].text);
+    }
+    if (len < size) len += (size_t)snprintf(out + len, size - len, "%s}", ws[rand() % 6]);
+    return len;
+}
+
+static int32_t rand_range(int32_t lo, int32_t hi) {
+    return lo + (int32_t)(((uint32_t)rand() << 8 ^ (uint32_t)rand()) % (uint32_t)(hi - lo + 1));
+}
+
+static void print_udeg(char *out, size_t size, int32_t v) {
+    snprintf(out, size, "%s%d.%06d", v < 0 ? "-" : "", abs(v) / 1000000, abs(v) % 1000000);
+}
+
+static void print_centi(char *out, size_t size, int32_t v) {
+    snprintf(out, size, "%s%d.%02d", v < 0 ? "-" : "", abs(v) / 100, abs(v) % 100);
+}
+
+// Random message and the TelemetryData it must parse to
+static void generate(char *msg, size_t size, TelemetryData *expect, bool noise) {
+    memset(expect, 0, sizeof(*expect));
+    Field own[12], top[12], item[16];
+    char num[32], obj[1600];
+    int n;
+
+    expect->own.lat = rand_range(-90000000, 90000000);
+    expect->own.lon = rand_range(-180000000, 180000000);
+    expect->own.alt = (int16_t)rand_range(-100, 4500);
+    expect->own.pitch = (int16_t)rand_range(-9000, 9000);
+    expect->own.roll = (int16_t)rand_range(-18000, 18000);
+    expect->own.yaw = (uint16_t)rand_range(0, 35999);
+    n = 0;
+    print_udeg(num, sizeof(num), expect->own.lat);
+    snprintf(own[n++].text, sizeof(own[0].text), "\"lat\":%s", num);
+    print_udeg(num, sizeof(num), expect->own.lon);
+    snprintf(own[n++].text, sizeof(own[0].text), "\"lon\":%s", num);
+    snprintf(own[n++].text, sizeof(own[0].text), "\"alt\":%d", expect->own.alt * 10);
+    print_centi(num, sizeof(num), expect->own.pitch);
+    snprintf(own[n++].text, sizeof(own[0].text), "\"pitch\":%s", num);
+    print_centi(num, sizeof(num), expect->own.roll);
+    snprintf(own[n++].text, sizeof(own[0].text), "\"roll\":%s", num);
+    print_centi(num, sizeof(num), expect->own.yaw);
+    snprintf(own[n++].text, sizeof(own[0].text), "\"yaw\":%s", num);
+    if (noise) for (int k = rand() % 3; k > 0; k--) noise_field(&own[n++]);
+    shuffle(own, n);
+    emit_object(obj, sizeof(obj), own, n);
+
+    int t = 0;
+    if ((size_t)snprintf(top[t++].text, sizeof(top[0].text), "\"own\":%s", obj) >= sizeof(top[0].text)) failures++;
+
+    // Traffic: built straight into its own buffer (too long for a Field)
+    char traffic[6000];
+    int count = rand() % (MAX_TRAFFIC + 3);
+    size_t len = (size_t)snprintf(traffic, sizeof(traffic), "\"traffic\":[");
+    for (int i = 0; i < count; i++) {
+        TrafficData e = {0};
+        snprintf(e.id, sizeof(e.id), "T%d", rand() % 100000);
+        e.icao24 = (uint32_t)rand_range(1, 0xFFFFFF);
+        e.lat = rand_range(-90000000, 90000000);
+        e.lon = rand_range(-180000000, 180000000);
+        e.alt = (int16_t)rand_range(0, 4500);
+        e.heading = (uint16_t)rand_range(0, 35999);
+        e.speed = (int16_t)rand_range(0, 600);
+        if (i < MAX_TRAFFIC) {
+            expect->traffic[i] = e;
+            expect->traffic_count++;
+        }
+        n = 0;
+        snprintf(item[n++].text, sizeof(item[0].text), "\"id\":\"%s\"", e.id);
+        snprintf(item[n++].text, sizeof(item[0].text), "\"icao24\":\"%06x\"", (unsigned)e.icao24);
+        print_udeg(num, sizeof(num), e.lat);
+        snprintf(item[n++].text, sizeof(item[0].text), "\"lat\":%s", num);
+        print_udeg(num, sizeof(num), e.lon);
+        snprintf(item[n++].text, sizeof(item[0].text), "\"lon\":%s", num);
+        snprintf(item[n++].text, sizeof(item[0].text), "\"alt\":%d", e.alt * 10);
+        print_centi(num, sizeof(num), e.heading);
+        snprintf(item[n++].text, sizeof(item[0].text), "\"heading\":%s", num);
+        snprintf(item[n++].text, sizeof(item[0].text), "\"speed\":%d", e.speed);
+        if (noise) for (int k = rand() % 3; k > 0; k--) noise_field(&item[n++]);
+        shuffle(item, n);
+        emit_object(obj, sizeof(obj), item, n);
+        len += (size_t)snprintf(traffic + len, sizeof(traffic) - len, "%s%s", i ? "," : "", obj);
+    }
+    snprintf(traffic + len, sizeof(traffic) - len, "]");
+
+    expect->status.wifi = rand() % 2;
+    expect->status.gps = rand() % 2;
+    expect->status.bluetooth = rand() % 2;
+    snprintf(top[t++].text, sizeof(top[0].text), "\"status\":{\"gps\":%s,\"bluetooth\":%s,\"wifi\":%s}",
+             expect->status.gps ? "true" : "false", expect->status.bluetooth ? "true" : "false",
+             expect->status.wifi ? "true" : "false");
+    expect->warnings.bank_warning = rand() % 2;
+    expect->warnings.pitch_warning = rand() % 2;
+    snprintf(top[t++].text, sizeof(top[0].text), "\"warnings\":{\"pitch\":%s,\"bank\":%s}",
+             expect->warnings.pitch_warning ? "true" : "false", expect->warnings.bank_warning ? "true" : "false");
+    if (noise) for (int k = rand() % 3; k > 0; k--) noise_field(&top[t++]);
+    snprintf(top[t++].text, sizeof(top[0].text), "@");   // Where the traffic goes
+    shuffle(top, t);
+
+    // Top level, with the traffic array spliced in at the marker
+    len = emit_object(msg, size, top, t);
+    char *marker = strchr(msg, '@');
+    size_t tlen = strlen(traffic);
+    if (marker && len + tlen < size) {
+        memmove(marker + tlen, marker + 1, strlen(marker + 1) + 1);
+        memcpy(marker, traffic, tlen);
+    } else {
+        failures++;
+    }
+    expect->valid = true;
+}
+
+static bool same(const TelemetryData *a, const TelemetryData *b) {
+    if (memcmp(&a->own, &b->own, sizeof(a->own)) != 0 || a->traffic_count != b->traffic_count ||
+        a->valid != b->valid || a->status.wifi != b->status.wifi || a->status.gps != b->status.gps ||
+        a->status.bluetooth != b->status.bluetooth ||
+        a->warnings.bank_warning != b->warnings.bank_warning ||
+        a->warnings.pitch_warning != b->warnings.pitch_warning) return false;
+    for (int i = 0; i < a->traffic_count; i++) {
+        const TrafficData *x = &a->traffic[i], *y = &b->traffic[i];
+        if (strcmp(x->id, y->id) != 0 || x->icao24 != y->icao24 || x->lat != y->lat ||
+            x->lon != y->lon || x->alt != y->alt || x->heading != y->heading || x->speed != y->speed)
+            return false;
+    }
+    return true;
+}
+
+// ── Corpus and fuzzing ───────────────────────────────────────────────────────
+
+typedef struct {
+    char name[64];
+    char *data;
+    size_t len;
+} Seed;
+
+static Seed corpus[MAX_CORPUS];
+static int corpus_count;
+
+static int load_corpus(const char *dir) {
+    DIR *d = opendir(dir);
+    if (!d) return -1;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL && corpus_count < MAX_CORPUS) {
+        if (e->d_name[0] == '.') continue;
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+        FILE *f = fopen(path, "rb");
+        if (!f) continue;
+        Seed *s = &corpus[corpus_count];
+        s->data = malloc(MSG_SIZE);
+        s->len = fread(s->data, 1, MSG_SIZE - 1, f);
+        s->data[s->len] = '\0';
+        fclose(f);
+        snprintf(s->name, sizeof(s->name), "%.63s", e->d_name);
+        corpus_count++;
+    }
+    closedir(d);
+    return corpus_count;
+}
+
+// Parse a copy sized exactly to the message, so any read past its NUL is an
+// out-of-bounds read under AddressSanitizer, and check the result
+static void parse_checked(const char *msg, size_t len, TelemetryData *out) {
+    char *copy = malloc(len + 1);
+    memcpy(copy, msg, len);
+    copy[len] = '\0';
+    bool ok = parse_telemetry(copy, out);
+    free(copy);
+
+    bool bad = ok != out->valid || out->traffic_count > MAX_TRAFFIC || out->own.yaw >= 36000 ||
+               out->own.lat < -90000000 || out->own.lat > 90000000 ||
+               out->own.lon < -180000000 || out->own.lon > 180000000;
+    for (int i = 0; i < out->traffic_count && i < MAX_TRAFFIC; i++) {
+        const TrafficData *t = &out->traffic[i];
+        if (memchr(t->id, '\0', sizeof(t->id)) == NULL || t->heading >= 36000 || t->icao24 > 0xFFFFFF ||
+            t->lat < -90000000 || t->lat > 90000000 || t->lon < -180000000 || t->lon > 180000000)
+            bad = true;
+    }
+    if (bad) failures++;
+}
+
+static size_t mutate(char *buf, size_t len, size_t size) {
+    static const char punct[] = "{}[]\":,\\-+.eE0 9tfn\n";
+    int edits = 1 + rand() % 4;
+    for (int k = 0; k < edits; k++) {
+        size_t pos = len ? (size_t)rand() % len : 0;
+        switch (rand() % 6) {
+        case 0:     // Flip a bit
+            if (len) buf[pos] ^= (char)(1 << (rand() % 8));
+            break;
+        case 1:     // Replace with punctuation
+            if (len) buf[pos] = punct[rand() % (sizeof(punct) - 1)];
+            break;
+        case 2:     // Insert punctuation
+            if (len + 1 < size) {
+                memmove(buf + pos + 1, buf + pos, len - pos);
+                buf[pos] = punct[rand() % (sizeof(punct) - 1)];
+                len++;
+            }
+            break;
+        case 3:     // Delete a run
+            if (len) {
+                size_t n = 1 + (size_t)rand() % 8;
+                if (pos + n > len) n = len - pos;
+                memmove(buf + pos, buf + pos + n, len - pos - n);
+                len -= n;
+            }
+            break;
+        case 4:     // Cut short
+            len = pos;
+            break;
+        default: {  // Splice in part of another seed
+            const Seed *s = &corpus[rand() % corpus_count];
+            if (s->len == 0) break;
+            size_t from = (size_t)rand() % s->len;
+            size_t n = 1 + (size_t)rand() % (s->len - from);
+            if (pos + n >= size) n = size - 1 - pos;
+            memcpy(buf + pos, s->data + from, n);
+            if (pos + n > len) len = pos + n;
+            break;
+        }
+        }
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+int main(int argc, char **argv) {
+    const char *corpus_dir = argc > 1 ? argv[1] : "telemetry_corpus";
+    long fuzz_iterations = argc > 2 ? atol(argv[2]) : 200000;
+    static char msg[MSG_SIZE];
+    TelemetryData expect, got;
+
+    srand(1);
+
+    // Round trips in any order, with and without unknown fields
+    int round_trips = 0, round_trip_failures = 0;
+    for (int i = 0; i < 20000; i++) {
+        generate(msg, sizeof(msg), &expect, i % 2);
+        parse_checked(msg, strlen(msg), &got);
+        if (!same(&expect, &got)) {
+            if (round_trip_failures++ == 0) printf("  mismatch: %s\n", msg);
+        }
+        round_trips++;
+    }
+    failures += round_trip_failures;
+
+    // Corpus verdicts
+    if (load_corpus(corpus_dir) <= 0) {
+        printf("No corpus in %s\n", corpus_dir);
+        return 1;
+    }
+    int corpus_failures = 0;
+    for (int i = 0; i < corpus_count; i++) {
+        parse_checked(corpus[i].data, corpus[i].len, &got);
+        bool want = strncmp(corpus[i].name, "ok_", 3) == 0;
+        if (got.valid != want) {
+            printf("  corpus %s: %s\n", corpus[i].name, got.valid ? "accepted" : "rejected");
+            corpus_failures++;
+        }
+    }
+    failures += corpus_failures;
+
+    // Timing: a full message, then the same padded with unknown fields
+    generate(msg, sizeof(msg), &expect, false);
+    while (strlen(msg) > 2048 || expect.traffic_count < MAX_TRAFFIC) generate(msg, sizeof(msg), &expect, false);
+    static char padded[MSG_SIZE];
+    size_t plen = (size_t)snprintf(padded, sizeof(padded), "{");
+    for (int i = 0; i < 40; i++)
+        plen += (size_t)snprintf(padded + plen, sizeof(padded) - plen, "\"pad%d\":[%d,\"%s\"],", i, i, "0123456789abcdef");
+    snprintf(padded + plen, sizeof(padded) - plen, "%s", msg + 1);
+
+    const char *timed[2] = { msg, padded };
+    const char *label[2] = { "full", "padded" };
+    printf("Telemetry parser: %d round trips, %d corpus files, %ld fuzz runs\n",
+           round_trips, corpus_count, fuzz_iterations);
+    printf("  %-8s %6s %12s %12s %10s\n", "message", "bytes", "strstr ns", "1-pass ns", "ns/byte");
+    for (int m = 0; m < 2; m++) {
+        LegacyTelemetry legacy;
+        volatile int sink = 0;
+        uint64_t t0 = now_ns();
+        for (int r = 0; r < TIMING_RUNS; r++) {
+            legacy_parse(timed[m], &legacy);
+            sink += legacy.traffic_count;
+        }
+        uint64_t legacy_ns = now_ns() - t0;
+        t0 = now_ns();
+        for (int r = 0; r < TIMING_RUNS; r++) {
+            parse_telemetry(timed[m], &got);
+            sink += got.traffic_count;
+        }
+        uint64_t single_ns = now_ns() - t0;
+        size_t bytes = strlen(timed[m]);
+        printf("  %-8s %6zu %12.0f %12.0f %10.2f\n", label[m], bytes,
+               (double)legacy_ns / TIMING_RUNS, (double)single_ns / TIMING_RUNS,
+               (double)single_ns / TIMING_RUNS / bytes);
+        if (got.traffic_count != MAX_TRAFFIC || !same(&expect, &got)) failures++;
+    }
+
+    // Fuzz
+    long accepted = 0;
+    long before = failures;
+    static char buf[MSG_SIZE];
+    for (long i = 0; i < fuzz_iterations; i++) {
+        const Seed *s = &corpus[rand() % corpus_count];
+        memcpy(buf, s->data, s->len + 1);
+        size_t len = mutate(buf, s->len, sizeof(buf));
+        parse_checked(buf, len, &got);
+        if (got.valid) accepted++;
+    }
+    printf("  round trips      %d mismatches\n", round_trip_failures);
+    printf("  corpus           %d wrong verdicts\n", corpus_failures);
+    printf("  fuzz             %ld still valid, %ld invariant failures\n", accepted, failures - before);
+    printf("%s (%ld check failures)\n", failures ? "FAIL" : "PASS", failures);
+
+    for (int i = 0; i < corpus_count; i++) free(corpus[i].data);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Track Table Benchmark
+ * Feeds the shared track table (pico/c/drivers/track_table.c) with a busy
+ * simulated airspace: more aircraft than the table holds, each fetch
+ * reporting a random part of them, some leaving and new ones arriving.
+ * Reports the cost per update and per full trail walk, and checks after
+ * every fetch that each reported target is found with its latest state,
+ * that trails run back in time, and that the update list is ordered.
+ *
+ * Usage:
+ *   ./track_table_bench [aircraft] [fetches]
+ *
+ * Exit status is 0 if all checks pass.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "track_table.h"
+
+#define FETCH_INTERVAL_MS 10000
+#define MAX_AGE_MS 60000
+#define REPORT_PERCENT 70           // Share of aircraft in each fetch
+
+typedef struct {
+    uint32_t icao24;
+    TrackState state;
+} Aircraft;
+
+static TrackTable table;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t new_icao(void) {
+    return 0x400000u + (uint32_t)(rand() % 0x3FFFFF);
+}
+
+int main(int argc, char **argv) {
+    int aircraft_count = argc > 1 ? atoi(argv[1]) : 300;
+    int fetches = argc > 2 ? atoi(argv[2]) : 2000;
+    if (aircraft_count < 1) aircraft_count = 1;
+
+    Aircraft *aircraft = calloc(aircraft_count, sizeof(*aircraft));
+    bool *reported = calloc(aircraft_count, sizeof(*reported));
+    if (!aircraft || !reported) return 1;
+
+    srand(1);
+    for (int i = 0; i < aircraft_count; i++) {
+        aircraft[i].icao24 = new_icao();
+        aircraft[i].state.lat = 59400000 + (rand() % 5000) * 100;
+        aircraft[i].state.lon = 17600000 + (rand() % 6000) * 100;
+    }
+
+    track_table_init(&table);
+    uint64_t update_ns = 0, walk_ns = 0;
+    long updates = 0, walked_points = 0, failures = 0;
+
+    for (int f = 0; f < fetches; f++) {
+        uint32_t now = (uint32_t)(f + 1) * FETCH_INTERVAL_MS;
+
+        // Move everyone; a few leave the area and are replaced
+        for (int i = 0; i < aircraft_count; i++) {
+            aircraft[i].state.lat += ((rand() % 21) - 10) * 100;
+            aircraft[i].state.lon += ((rand() % 21) - 10) * 100;
+            aircraft[i].state.heading = (uint16_t)(rand() % 36000);
+            if (rand() % 100 == 0) aircraft[i].icao24 = new_icao();
+        }
+
+        uint64_t t0 = now_ns();
+        for (int i = 0; i < aircraft_count; i++) {
+            reported[i] = rand() % 100 < REPORT_PERCENT;
+            if (!reported[i]) continue;
+            track_table_update(&table, aircraft[i].icao24, "TEST", &aircraft[i].state, now);
+            updates++;
+        }
+        track_table_expire(&table, now, MAX_AGE_MS);
+        update_ns += now_ns() - t0;
+
+        // What a radar redraw reads: every target and its whole trail
+        t0 = now_ns();
+        int64_t sum = 0;
+        for (const Track *t = track_table_first(&table); t; t = track_table_next(&table, t)) {
+            sum += t->state.lat;
+            for (int age = 0; age < t->trail_count; age++) {
+                sum += track_trail_point(t, age)->lat;
+                walked_points++;
+            }
+        }
+        walk_ns += now_ns() - t0;
+        if (sum < 0) printf(" ");
+
+        // Checks
+        if (table.count > TRACK_TABLE_CAPACITY) failures++;
+        uint32_t newer = UINT32_MAX;
+        int listed = 0;
+        for (const Track *t = track_table_first(&table); t; t = track_table_next(&table, t)) {
+            if (t->last_seen_ms > newer) failures++;
+            newer = t->last_seen_ms;
+            uint32_t later = t->last_seen_ms;
+            for (int age = 0; age < t->trail_count; age++) {
+                const TrackPoint *p = track_trail_point(t, age);
+                if (p->time_ms >= later) failures++;
+                later = p->time_ms;
+            }
+            listed++;
+        }
+        if (listed != table.count) failures++;
+        // The newest targets survive eviction; with more reports per fetch
+        // than the table holds, only the last CAPACITY of them are checked
+        int reported_count = 0;
+        for (int i = aircraft_count - 1; i >= 0; i--) {
+            if (!reported[i] || ++reported_count > TRACK_TABLE_CAPACITY) continue;
+            const Track *t = track_table_find(&table, aircraft[i].icao24);
+            if (!t || t->last_seen_ms != now || t->state.lat != aircraft[i].state.lat) failures++;
+        }
+    }
+
+    printf("Track table: %d aircraft, %d fetches, capacity %d, trail %d\n",
+           aircraft_count, fetches, TRACK_TABLE_CAPACITY, TRACK_TRAIL_LEN);
+    printf("  memory           %zu bytes (%zu per track)\n", sizeof(TrackTable), sizeof(Track));
+    printf("  update           %.1f ns/report (incl. expiry)\n", (double)update_ns / updates);
+    printf("  radar walk       %.1f us/redraw (%.1f trail points per target)\n",
+           walk_ns / 1e3 / fetches, (double)walked_points / fetches / (table.count ? table.count : 1));
+    printf("  tracked          %d at the end, %u evictions\n", table.count, table.evictions);
+    printf("%s (%ld check failures)\n", failures ? "FAIL" : "PASS", failures);
+
+    free(aircraft);
+    free(reported);
+    return failures ? 1 : 0;
+}
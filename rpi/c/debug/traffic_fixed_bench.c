@@ -0,0 +1,233 @@
+/*
+ * Fixed-Point Traffic Benchmark
+ * Compares the packed traffic/telemetry layout (pico/c/drivers/geo_fixed.h)
+ * with the double/float one it replaced: bytes per target, and the radar's
+ * projection math per redraw (every target plus its trail) done the old way
+ * (double, great-circle terms per point) and through GeoProjection. Checks
+ * that both put every on-scope point within a pixel of each other and that
+ * the conversions round-trip.
+ *
+ * Host timings only show the ratio on this CPU, which has hardware double;
+ * on the Pico the radar records the real figure in the radar_project
+ * profiler zone (diagnostics screen).
+ *
+ * Usage:
+ *   ./traffic_fixed_bench [targets] [redraws]
+ *
+ * Exit status is 0 if all checks pass.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "geo_fixed.h"
+#include "telemetry_parser.h"
+#include "track_table.h"
+
+// Radar geometry as in pico/c/src/main_menu.c
+#define RDR_CX 106
+#define RDR_CY 133
+#define RDR_PX 213
+#define RDR_TOP 29
+#define LCD_HEIGHT 240
+#define KM_TO_PX 3.23f
+
+// Layouts before the fixed-point change
+typedef struct {
+    double lat, lon, alt, pitch, roll, yaw;
+} OwnShipDouble;
+
+typedef struct {
+    char id[8];
+    uint32_t icao24;
+    double lat, lon, alt, heading, speed;
+} TrafficDouble;
+
+typedef struct {
+    OwnShipDouble own;
+    TrafficDouble traffic[MAX_TRAFFIC];
+    uint8_t traffic_count;
+    ConnectivityStatus status;
+    WarningStatus warnings;
+    bool valid;
+} TelemetryDouble;
+
+typedef struct {
+    float lat, lon, alt_ft, heading, speed_kt;
+} TrackStateFloat;
+
+typedef struct {
+    float lat, lon;
+    uint32_t time_ms;
+} TrackPointFloat;
+
+typedef struct {
+    uint32_t icao24;
+    char callsign[9];
+    uint8_t trail_head, trail_count;
+    TrackStateFloat state;
+    uint32_t first_seen_ms, last_seen_ms;
+    uint16_t newer, older;
+    TrackPointFloat trail[TRACK_TRAIL_LEN];
+} TrackFloat;
+
+typedef struct {
+    TrackFloat tracks[TRACK_TABLE_CAPACITY];
+    uint16_t slots[TRACK_TABLE_SLOTS];
+    uint16_t newest, oldest, free_head, count;
+    uint32_t evictions;
+} TrackTableFloat;
+
+typedef struct {
+    double lat, lon;            // Degrees, for the old projection
+    int32_t lat_udeg, lon_udeg;
+} Point;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// The radar's projection before the change
+static void project_double(double own_lat, double own_lon, float lat, float lon, int16_t *sx, int16_t *sy) {
+    const double R = 6371.0;
+    double lat1r = own_lat * M_PI / 180.0;
+    double lon1r = own_lon * M_PI / 180.0;
+    double lat2r = lat * M_PI / 180.0;
+    double lon2r = lon * M_PI / 180.0;
+    double dx_km = (lon2r - lon1r) * cos((lat1r + lat2r) / 2.0) * R;
+    double dy_km = (lat2r - lat1r) * R;
+
+    *sx = RDR_CX + (int16_t)(dx_km * KM_TO_PX);
+    *sy = RDR_CY - (int16_t)(dy_km * KM_TO_PX);
+}
+
+static void project_fixed(const GeoProjection *proj, int32_t lat, int32_t lon, int16_t *sx, int16_t *sy) {
+    int32_t east, north;
+    geo_project(proj, lat, lon, &east, &north);
+    *sx = (int16_t)(RDR_CX + east);
+    *sy = (int16_t)(RDR_CY - north);
+}
+
+static int on_scope(int16_t x, int16_t y) {
+    return x >= 0 && x < RDR_PX && y >= RDR_TOP && y < LCD_HEIGHT;
+}
+
+static long check_conversions(void) {
+    long failures = 0;
+    for (int i = 0; i < 100000; i++) {
+        double deg = (rand() / (double)RAND_MAX) * 360.0 - 180.0;
+        if (fabs(geo_udeg_to_deg(geo_deg_to_udeg(deg)) - deg) > 0.5e-6 + 1e-12) failures++;
+    }
+    if (geo_deg_to_heading(-0.004f) != 0 || geo_deg_to_heading(359.996f) != 0 ||
+        geo_deg_to_heading(-90.0f) != 27000 || geo_deg_to_heading(725.5f) != 550) failures++;
+    if (geo_alt_to_ft(geo_ft_to_alt(41000.0f)) != 41000 || geo_ft_to_alt(1e6f) != 32767 ||
+        geo_ft_to_alt(-1e6f) != -32768) failures++;
+    if (geo_kt_to_speed(480.4f) != 480 || geo_kt_to_speed(1e6f) != 32767) failures++;
+
+    // Offsets across the antimeridian stay short
+    GeoProjection proj;
+    geo_projection_init(&proj, 0, geo_deg_to_udeg(179.9), 1000.0f);
+    int32_t east, north;
+    geo_project(&proj, 0, geo_deg_to_udeg(-179.9), &east, &north);
+    if (labs(east - 22239) > 2 || north != 0) failures++;
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    int targets = argc > 1 ? atoi(argv[1]) : TRACK_TABLE_CAPACITY;
+    int redraws = argc > 2 ? atoi(argv[2]) : 2000;
+    if (targets < 1) targets = 1;
+    if (redraws < 1) redraws = 1;
+    int per_target = 1 + TRACK_TRAIL_LEN;
+    int points = targets * per_target;
+
+    // Own ship near Arlanda, targets within ~40 km with 8-point trails
+    srand(1);
+    double own_lat = 59.651944, own_lon = 17.918611;
+    Point *pt = calloc(points, sizeof(*pt));
+    if (!pt) return 1;
+    for (int t = 0; t < targets; t++) {
+        double lat = own_lat + (rand() % 7000 - 3500) * 1e-4;
+        double lon = own_lon + (rand() % 14000 - 7000) * 1e-4;
+        for (int k = 0; k < per_target; k++) {
+            // The old track table stored floats, the new one microdegrees
+            Point *p = &pt[t * per_target + k];
+            p->lat = (float)(lat - k * 0.004);
+            p->lon = (float)(lon - k * 0.004);
+            p->lat_udeg = geo_deg_to_udeg(lat - k * 0.004);
+            p->lon_udeg = geo_deg_to_udeg(lon - k * 0.004);
+        }
+    }
+
+    long failures = check_conversions();
+
+    // Agreement on everything the scope shows
+    int32_t own_lat_udeg = geo_deg_to_udeg(own_lat), own_lon_udeg = geo_deg_to_udeg(own_lon);
+    GeoProjection proj;
+    geo_projection_init(&proj, own_lat_udeg, own_lon_udeg, KM_TO_PX);
+    int max_err = 0, shown = 0;
+    for (int i = 0; i < points; i++) {
+        int16_t x0, y0, x1, y1;
+        project_double(own_lat, own_lon, (float)pt[i].lat, (float)pt[i].lon, &x0, &y0);
+        project_fixed(&proj, pt[i].lat_udeg, pt[i].lon_udeg, &x1, &y1);
+        if (!on_scope(x0, y0)) continue;
+        shown++;
+        int err = abs(x1 - x0) > abs(y1 - y0) ? abs(x1 - x0) : abs(y1 - y0);
+        if (err > max_err) max_err = err;
+    }
+    if (max_err > 1) failures++;
+
+    // Projection math of one redraw, as the radar does it
+    volatile int32_t sink = 0;
+    uint64_t t0 = now_ns();
+    for (int r = 0; r < redraws; r++) {
+        int32_t acc = 0;
+        for (int i = 0; i < points; i++) {
+            int16_t x, y;
+            project_double(own_lat, own_lon, (float)pt[i].lat, (float)pt[i].lon, &x, &y);
+            acc += x + y;
+        }
+        sink += acc;
+    }
+    uint64_t double_ns = now_ns() - t0;
+
+    t0 = now_ns();
+    for (int r = 0; r < redraws; r++) {
+        GeoProjection p;
+        geo_projection_init(&p, own_lat_udeg, own_lon_udeg, KM_TO_PX);
+        int32_t acc = 0;
+        for (int i = 0; i < points; i++) {
+            int16_t x, y;
+            project_fixed(&p, pt[i].lat_udeg, pt[i].lon_udeg, &x, &y);
+            acc += x + y;
+        }
+        sink += acc;
+    }
+    uint64_t fixed_ns = now_ns() - t0;
+
+    printf("Fixed-point traffic: %d targets, %d points per target, %d redraws\n",
+           targets, per_target, redraws);
+    printf("  bytes per target      before  after\n");
+    printf("    TrafficData         %6zu %6zu\n", sizeof(TrafficDouble), sizeof(TrafficData));
+    printf("    OwnShipData         %6zu %6zu\n", sizeof(OwnShipDouble), sizeof(OwnShipData));
+    printf("    TelemetryData       %6zu %6zu  (%d traffic)\n",
+           sizeof(TelemetryDouble), sizeof(TelemetryData), MAX_TRAFFIC);
+    printf("    TrackState          %6zu %6zu\n", sizeof(TrackStateFloat), sizeof(TrackState));
+    printf("    Track (with trail)  %6zu %6zu\n", sizeof(TrackFloat), sizeof(Track));
+    printf("    TrackTable          %6zu %6zu\n", sizeof(TrackTableFloat), sizeof(TrackTable));
+    printf("  projection per redraw (host)\n");
+    printf("    double              %8.2f us (%.1f ns/point)\n",
+           double_ns / 1e3 / redraws, (double)double_ns / redraws / points);
+    printf("    fixed               %8.2f us (%.1f ns/point)\n",
+           fixed_ns / 1e3 / redraws, (double)fixed_ns / redraws / points);
+    printf("  agreement             max %d px over %d on-scope points\n", max_err, shown);
+    printf("%s (%ld check failures)\n", failures ? "FAIL" : "PASS", failures);
+
+    free(pt);
+    return failures ? 1 : 0;
+}
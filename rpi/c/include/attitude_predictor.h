@@ -0,0 +1,51 @@
+/**
+ * Display-Time Attitude Prediction
+ *
+ * The HUD shows the attitude at the moment the frame reaches the panel,
+ * not at the moment of the last sensor sample. The predictor keeps the
+ * latest estimator quaternion with its timestamp and a lightly smoothed
+ * body rate, and integrates that rate forward to any requested time.
+ *
+ * Extrapolation is capped (max_horizon_s) so a stalled sensor freezes the
+ * display instead of spinning it.
+ */
+
+#ifndef ATTITUDE_PREDICTOR_H
+#define ATTITUDE_PREDICTOR_H
+
+#include <stdbool.h>
+#include "quaternion.h"
+
+typedef struct {
+    Quaternion q;           // Latest estimator attitude
+    float rate[3];          // Smoothed body rate (rad/s)
+    unsigned long t_us;     // Monotonic time of q
+    bool valid;
+
+    // Tuning
+    float rate_tau_s;       // Rate smoothing time constant (0 = raw gyro)
+    float max_horizon_s;    // Longest extrapolation
+} AttitudePredictor;
+
+/**
+ * Initialize with default tuning (also used to drop state after a reset)
+ */
+void attitude_predictor_init(AttitudePredictor *pred);
+
+/**
+ * Add an estimator output
+ *
+ * t_us:        monotonic time of the sample
+ * q:           estimator orientation after this sample
+ * gx, gy, gz:  bias-corrected body rate (rad/s) used for the update
+ */
+void attitude_predictor_update(AttitudePredictor *pred, unsigned long t_us,
+                               const Quaternion *q, float gx, float gy, float gz);
+
+/**
+ * Orientation expected at t_us
+ * Returns false until the first update.
+ */
+bool attitude_predictor_predict(const AttitudePredictor *pred, unsigned long t_us, Quaternion *out);
+
+#endif // ATTITUDE_PREDICTOR_H
@@ -0,0 +1,105 @@
+/**
+ * Pico/Pi Clock Synchronisation
+ *
+ * NTP-style exchange over the serial link: the Pi sends "sync <seq> <t1>"
+ * (t1 = Pi CLOCK_MONOTONIC us), the Pico answers
+ * "SYNC:<seq>,<t1>,<t2>,<t3>" with its to_us_since_boot receive and reply
+ * times, and the Pi stamps t4 when the reply arrives. Each exchange gives
+ *   offset = ((t2 - t1) + (t3 - t4)) / 2     (Pico minus Pi)
+ *   rtt    = (t4 - t1) - (t3 - t2)
+ *
+ * The faster half of the last CLOCK_SYNC_WINDOW exchanges (by round trip)
+ * is fitted with a line, offset(t) = offset_us + skew * (t - ref_pi_us),
+ * so the mapping tracks crystal drift between pings. Queueing delay only
+ * ever adds to the round trip, which is why the slow exchanges are left out.
+ *
+ * One-way latency per direction follows from the mapping. Like any
+ * two-way method it assumes the fastest exchanges were symmetric, so a
+ * constant path asymmetry shifts latency between the two directions.
+ */
+
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "latency_hist.h"
+
+#define CLOCK_SYNC_WINDOW 32        // Exchanges kept for the fit
+#define CLOCK_SYNC_PENDING 8        // Requests awaiting a reply
+#define CLOCK_SYNC_MIN_LOCK 4       // Exchanges before the mapping is used
+#define CLOCK_SYNC_MIN_SPAN_US 5000000  // Shorter windows fit offset only
+#define CLOCK_SYNC_MAX_SKEW 500e-6  // Crystals are far better; clamps bad fits
+#define CLOCK_SYNC_HIST_BIN_US 100
+
+typedef struct {
+    uint64_t t_pi_us;       // Midpoint of t1 and t4
+    double offset_us;
+    int64_t rtt_us;
+} ClockSyncSample;
+
+typedef struct {
+    uint32_t next_seq;
+    uint32_t pending_seq[CLOCK_SYNC_PENDING];
+    uint64_t pending_t1[CLOCK_SYNC_PENDING];
+
+    ClockSyncSample samples[CLOCK_SYNC_WINDOW];
+    int sample_count;
+    int sample_next;
+
+    // Mapping: pico_us = pi_us + offset_us + skew * (pi_us - ref_pi_us)
+    bool locked;
+    uint64_t ref_pi_us;
+    double offset_us;
+    double skew;
+    int64_t rtt_min_us;     // Over the window
+
+    // One-way latency, Pico->Pi (up) and Pi->Pico (down)
+    LatencyHist up;
+    LatencyHist down;
+    double jitter_up_us;    // RFC 3550 interarrival jitter
+    double jitter_down_us;
+    double last_up_us;
+    double last_down_us;
+
+    uint32_t requests;
+    uint32_t replies;
+} ClockSync;
+
+/**
+ * Forget everything (also on reconnect: a replugged Pico has rebooted)
+ */
+void clock_sync_init(ClockSync *sync);
+
+/**
+ * Pi timestamp for t1/t4 (CLOCK_MONOTONIC, us)
+ */
+uint64_t clock_sync_now_us(void);
+
+/**
+ * Format the next "sync" request into buf, stamped now
+ * Returns its length (send it all), or 0 if buf is too small.
+ */
+int clock_sync_request(ClockSync *sync, char *buf, size_t size);
+
+/**
+ * Feed a received line; t4_us is when it arrived (clock_sync_now_us)
+ * Returns true if it was a SYNC reply (consumed), false for anything else.
+ */
+bool clock_sync_handle_reply(ClockSync *sync, const char *line, uint64_t t4_us);
+
+/**
+ * Convert between the clocks (valid once sync->locked)
+ */
+uint64_t clock_sync_pi_to_pico(const ClockSync *sync, uint64_t pi_us);
+uint64_t clock_sync_pico_to_pi(const ClockSync *sync, uint64_t pico_us);
+
+/**
+ * Print offset, skew, round trip and one-way latency/jitter
+ * reset clears the latency histograms afterwards.
+ */
+void clock_sync_print(ClockSync *sync, FILE *out, bool reset);
+
+#endif // CLOCK_SYNC_H
@@ -20,6 +20,8 @@ typedef struct {
     int satellites;         // Number of satellites
     float latitude;         // Latitude in decimal degrees
     float longitude;        // Longitude in decimal degrees
+    unsigned altitude_updates; // Incremented on every parsed altitude
+    unsigned speed_updates;    // Incremented on every parsed speed
 } GPSData;
 
 /**
@@ -0,0 +1,53 @@
+/**
+ * Pre-converted Image Cache
+ *
+ * Decoding a PNG and converting it to RGB565 takes long enough on the Pi
+ * to hold up startup, so it is done once: the converted pixels are stored
+ * under IMAGE_CACHE_DIR in a file named after a hash of the source bytes
+ * and the conversion settings, and later loads just mmap that file. An
+ * edited image hashes differently and is converted again.
+ *
+ * Pixels are kept in wire order (big-endian RGB565, what the ST7789
+ * expects on SPI), so lcd_draw_image_wire() sends the mapping as is and
+ * lcd_fb_draw_image_wire() only swaps bytes while copying into the
+ * framebuffer.
+ */
+
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define IMAGE_CACHE_DIR "/var/cache/pilot_assistant"   // Or $PILOT_IMAGE_CACHE
+#define IMAGE_CACHE_FALLBACK_DIR "/tmp/pilot_assistant"
+#define IMAGE_CACHE_VERSION 1
+
+typedef enum {
+    IMAGE_CONVERT_COLOR,            // Plain RGB888 -> RGB565
+    IMAGE_CONVERT_CYAN              // Grayscale in HUD cyan (splash)
+} ImageConvert;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    const uint8_t *pixels;          // width * height big-endian RGB565
+    void *base;                     // Mapping (or heap copy if uncached)
+    size_t size;
+    int mapped;
+} CachedImage;
+
+/**
+ * Load an image, converting it only if no cached copy matches
+ * Images larger than max_w x max_h are scaled down to fit.
+ * Returns 0 on success, -1 on error.
+ */
+int image_cache_load(CachedImage *img, const char *source_path,
+                     uint16_t max_w, uint16_t max_h, ImageConvert mode);
+
+/**
+ * Unmap or free an image loaded by image_cache_load()
+ */
+void image_cache_release(CachedImage *img);
+
+#endif // IMAGE_CACHE_H
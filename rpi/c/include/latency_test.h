@@ -0,0 +1,70 @@
+/**
+ * Synthetic Step Latency Test
+ *
+ * Replaces the IMU with a synthetic level sensor that rolls in steps
+ * (0 -> step_deg -> 0 ...) at a fixed period. Each step is one sample with
+ * the gyro rate that covers it and the matching accelerometer vector, so
+ * it goes through the notch banks, the estimator, the predictor, rendering
+ * and the flush like real motion.
+ *
+ * After every flushed frame the caller measures the roll actually drawn
+ * (from the framebuffer) and passes it to latency_test_frame(). The step
+ * counts as displayed on the first frame closer to the new roll than the
+ * old one; the latency is from the step's sample time to the end of that
+ * frame's flush. With a p95 limit set, the run ends with a pass/fail
+ * result so regressions show up without anyone watching the screen.
+ */
+
+#ifndef LATENCY_TEST_H
+#define LATENCY_TEST_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "latency_hist.h"
+
+typedef struct {
+    // Configuration
+    int steps;                  // Steps to measure before finishing
+    float step_deg;             // Roll step size
+    unsigned long period_us;    // Time between steps
+    float p95_limit_ms;         // Fail above this (0 = report only)
+
+    // Synthetic sensor
+    float roll_deg;
+    unsigned long last_sample_us;
+    unsigned long next_step_us;
+
+    // Step waiting to show up on screen
+    bool pending;
+    unsigned long step_us;
+    float from_deg;
+    float to_deg;
+
+    int steps_done;
+    int steps_missed;           // Not seen within one period
+    LatencyHist hist;
+} LatencyTest;
+
+/**
+ * Configure the test
+ */
+void latency_test_init(LatencyTest *test, int steps, float step_deg,
+                       unsigned long period_us, float p95_limit_ms);
+
+/**
+ * One synthetic IMU sample at now_us (accelerometer in g, gyro in deg/s)
+ */
+void latency_test_sample(LatencyTest *test, unsigned long now_us, float accel_g[3], float gyro_dps[3]);
+
+/**
+ * Report the roll drawn in a frame whose flush ended at flushed_us
+ * Returns true once all steps are measured.
+ */
+bool latency_test_frame(LatencyTest *test, float drawn_roll_deg, unsigned long flushed_us);
+
+/**
+ * Print the result; returns false if the p95 limit was exceeded
+ */
+bool latency_test_report(const LatencyTest *test, FILE *out);
+
+#endif // LATENCY_TEST_H
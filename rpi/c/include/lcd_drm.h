@@ -0,0 +1,57 @@
+/**
+ * Kernel DRM Output for the LCD
+ *
+ * Alternative to driving the ST7789 over spidev: with the panel bound to
+ * a kernel DRM driver (panel-mipi-dbi or another tiny DRM/fbtft-style
+ * driver, e.g. dtoverlay=mipi-dbi-spi with rotation so the mode is
+ * 320x240), frames are drawn into mmapped dumb buffers and page-flipped;
+ * the kernel does the SPI transfer (DMA) on its own, off the render loop.
+ *
+ * Three buffers: one on screen, one queued for the next page flip and
+ * one being drawn, so drawing never touches a buffer the kernel may still
+ * be scanning out or sending over SPI (flips are nonblocking). Only
+ * raw KMS ioctls are used; libdrm-dev is needed at build time for the
+ * uapi headers alone (CMake defines LCD_DRM_ENABLED when it finds them,
+ * otherwise lcd_drm_open() always fails). st7789_rpi.c picks this backend
+ * at runtime (PILOT_LCD_BACKEND=drm); nothing else should need to call it.
+ */
+
+#ifndef LCD_DRM_H
+#define LCD_DRM_H
+
+#include <stdint.h>
+
+#define LCD_DRM_MAX_CARDS 8             // /dev/dri/card0..7 are probed
+#define LCD_DRM_BUFFERS 3
+#define LCD_DRM_FLIP_TIMEOUT_MS 100
+
+/**
+ * Open a DRM device with a connected width x height output and set it up
+ * card: device path, or NULL to probe for the first matching card.
+ * Returns 0 on success, -1 if there is no usable device.
+ */
+int lcd_drm_open(const char *card, uint16_t width, uint16_t height);
+
+void lcd_drm_close(void);
+
+/**
+ * Buffers, width * height RGB565 in native byte order (the kernel swaps
+ * for the panel). Front is the last one flipped to; back is free to draw
+ * and changes after every flip.
+ */
+uint16_t *lcd_drm_front(void);
+uint16_t *lcd_drm_back(void);
+
+/**
+ * Show the back buffer: waits for the previous flip to finish, queues this
+ * one and returns; the new back buffer is the one that flip took off screen
+ */
+void lcd_drm_flip(void);
+
+/**
+ * Send the rectangle [x0, x1) x [y0, y1) of the front buffer to the panel
+ * after drawing into it directly
+ */
+void lcd_drm_dirty(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+#endif // LCD_DRM_H
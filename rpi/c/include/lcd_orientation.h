@@ -0,0 +1,70 @@
+/**
+ * ST7789 Display Orientation
+ *
+ * Rotation and mirroring are done by the panel controller itself: the
+ * MADCTL register decides in which order incoming pixels fill the panel
+ * RAM (row/column exchange, column and row address order). Changing it
+ * costs one command, and every frame after that is drawn and sent exactly
+ * as before, which is what a HUD reflected in a combiner glass needs.
+ *
+ * Rotations are clockwise, relative to the board's normal landscape
+ * mounting; mirroring applies to the rotated picture. The ST7789 RAM is
+ * 240x320, so portrait uses it whole and needs no address offset.
+ */
+
+#ifndef LCD_ORIENTATION_H
+#define LCD_ORIENTATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MADCTL_MY 0x80              // Row address order
+#define MADCTL_MX 0x40              // Column address order
+#define MADCTL_MV 0x20              // Row/column exchange
+#define MADCTL_ML 0x10              // Vertical refresh order
+#define MADCTL_BGR 0x08
+
+typedef enum {
+    LCD_ROTATE_0,
+    LCD_ROTATE_90,
+    LCD_ROTATE_180,
+    LCD_ROTATE_270
+} LcdRotation;
+
+#define LCD_MIRROR_NONE 0x00
+#define LCD_MIRROR_X 0x01           // Left-right (combiner reflection)
+#define LCD_MIRROR_Y 0x02           // Top-bottom
+
+static inline bool lcd_orientation_is_portrait(LcdRotation rotation) {
+    return rotation == LCD_ROTATE_90 || rotation == LCD_ROTATE_270;
+}
+
+/**
+ * MADCTL for a rotation/mirror relative to a landscape base setting (one
+ * with MADCTL_MV, i.e. the value the driver uses at init). Bits other than
+ * MY/MX/MV are kept.
+ */
+static inline uint8_t lcd_orientation_madctl(uint8_t base, LcdRotation rotation, uint8_t mirror) {
+    bool mv = true;
+    bool mx = (base & MADCTL_MX) != 0;
+    bool my = (base & MADCTL_MY) != 0;
+
+    // Logical x runs along panel rows while MV is set, along columns otherwise
+    switch (rotation) {
+    case LCD_ROTATE_90:  mv = false; my = !my; break;
+    case LCD_ROTATE_180: mx = !mx; my = !my; break;
+    case LCD_ROTATE_270: mv = false; mx = !mx; break;
+    default: break;
+    }
+    if (mirror & LCD_MIRROR_X) {
+        if (mv) my = !my; else mx = !mx;
+    }
+    if (mirror & LCD_MIRROR_Y) {
+        if (mv) mx = !mx; else my = !my;
+    }
+
+    return (uint8_t)((base & ~(MADCTL_MY | MADCTL_MX | MADCTL_MV)) |
+                     (my ? MADCTL_MY : 0) | (mx ? MADCTL_MX : 0) | (mv ? MADCTL_MV : 0));
+}
+
+#endif // LCD_ORIENTATION_H
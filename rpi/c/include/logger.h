@@ -0,0 +1,167 @@
+/**
+ * Asynchronous Logger
+ *
+ * LOGI("GPS fix, %d satellites", n) stores a binary record (timestamp,
+ * call site, raw argument values) in the calling thread's ring buffer and
+ * returns; nothing is formatted or written on the caller's thread. A
+ * background thread merges the per-thread rings in time order, formats
+ * the records and writes them to stdout or to syslog (journald).
+ *
+ * Logging never blocks and takes no lock: each ring has one producer (its
+ * thread) and one consumer (the drain thread). A full ring drops the
+ * record and counts it.
+ *
+ * Levels below LOG_LEVEL_MIN compile away, arguments included. The
+ * *_RATE variants let a call site through at most n times per second;
+ * the next record that gets through reports how many were suppressed.
+ *
+ * Arguments are captured by type: signed/unsigned integers, floating
+ * point, strings (copied, truncated to LOG_MAX_STRING) and pointers, at
+ * most LOG_MAX_ARGS per call. The format uses the usual printf
+ * conversions, one per argument (no '*' widths); length modifiers are
+ * ignored since the captured type is known.
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+
+// Compile-time floor (CMake LOG_LEVEL); calls below it generate no code
+#ifndef LOG_LEVEL_MIN
+#define LOG_LEVEL_MIN LOG_LEVEL_INFO
+#endif
+
+#define LOG_RING_SIZE 65536         // Bytes per thread, power of two
+#define LOG_MAX_THREADS 16
+#define LOG_MAX_ARGS 8
+#define LOG_MAX_STRING 256          // Including the terminator
+#define LOG_DRAIN_INTERVAL_MS 5
+
+typedef enum {
+    LOG_SINK_STDOUT,                // "[   12.345678] I file.c:123 message"
+    LOG_SINK_SYSLOG                 // syslog(3) with the level as priority
+} LogSink;
+
+typedef enum {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STR,
+    LOG_ARG_PTR
+} LogArgType;
+
+typedef struct {
+    uint32_t type;                  // LogArgType
+    uint32_t len;                   // LOG_ARG_STR: bytes copied, terminator included
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        const char *s;
+        const void *p;
+    } v;
+} LogArg;
+
+// One per call site (static), holds the format and the rate limiter
+typedef struct {
+    const char *fmt;
+    const char *file;
+    int line;
+    int level;
+    uint32_t rate;                  // Records per second, 0 = unlimited
+    atomic_uint_least64_t window;   // Second the count belongs to
+    atomic_uint count;
+    atomic_uint suppressed;
+} LogSite;
+
+typedef struct {
+    uint64_t records;               // Written to the sink
+    uint64_t dropped;               // Ring full
+    uint64_t suppressed;            // Rate limited
+} LogStats;
+
+/**
+ * Start the drain thread; ident names the program in syslog
+ * Until then (and after log_shutdown) records are formatted and written
+ * synchronously. Returns 0 on success, -1 if the thread could not start.
+ */
+int log_init(LogSink sink, const char *ident);
+
+/**
+ * Write out everything still buffered and stop the drain thread
+ */
+void log_shutdown(void);
+
+/**
+ * Runtime floor on top of LOG_LEVEL_MIN (e.g. from an environment variable)
+ */
+void log_set_level(int level);
+
+void log_get_stats(LogStats *stats);
+
+// Used by the macros below
+void log_write(LogSite *site, int nargs, const LogArg *args);
+
+static inline LogArg log_arg_int(long long v) { LogArg a = { LOG_ARG_INT, 0, { .i = v } }; return a; }
+static inline LogArg log_arg_uint(unsigned long long v) { LogArg a = { LOG_ARG_UINT, 0, { .u = v } }; return a; }
+static inline LogArg log_arg_double(double v) { LogArg a = { LOG_ARG_DOUBLE, 0, { .d = v } }; return a; }
+static inline LogArg log_arg_str(const char *v) { LogArg a = { LOG_ARG_STR, 0, { .s = v } }; return a; }
+static inline LogArg log_arg_ptr(const void *v) { LogArg a = { LOG_ARG_PTR, 0, { .p = v } }; return a; }
+
+#define LOG_ARG(x) _Generic((x),                                          \
+    _Bool: log_arg_uint, char: log_arg_int, signed char: log_arg_int,     \
+    short: log_arg_int, int: log_arg_int, long: log_arg_int,              \
+    long long: log_arg_int, unsigned char: log_arg_uint,                  \
+    unsigned short: log_arg_uint, unsigned int: log_arg_uint,             \
+    unsigned long: log_arg_uint, unsigned long long: log_arg_uint,        \
+    float: log_arg_double, double: log_arg_double,                        \
+    char *: log_arg_str, const char *: log_arg_str,                       \
+    default: log_arg_ptr)(x)
+
+// Argument count after the format (0..8) and capture of each argument
+#define LOG_NARGS(...) LOG_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(fmt, a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+#define LOG_FMT(...) LOG_FMT_(__VA_ARGS__, 0)
+#define LOG_FMT_(fmt, ...) fmt
+#define LOG_CAPTURE(...) LOG_CAPTURE_N(LOG_NARGS(__VA_ARGS__), __VA_ARGS__)
+#define LOG_CAPTURE_N(n, ...) LOG_CAPTURE_N_(n, __VA_ARGS__)
+#define LOG_CAPTURE_N_(n, ...) LOG_CAPTURE_##n(__VA_ARGS__)
+#define LOG_CAPTURE_0(f)
+#define LOG_CAPTURE_1(f, a) LOG_ARG(a),
+#define LOG_CAPTURE_2(f, a, ...) LOG_ARG(a), LOG_CAPTURE_1(f, __VA_ARGS__)
+#define LOG_CAPTURE_3(f, a, ...) LOG_ARG(a), LOG_CAPTURE_2(f, __VA_ARGS__)
+#define LOG_CAPTURE_4(f, a, ...) LOG_ARG(a), LOG_CAPTURE_3(f, __VA_ARGS__)
+#define LOG_CAPTURE_5(f, a, ...) LOG_ARG(a), LOG_CAPTURE_4(f, __VA_ARGS__)
+#define LOG_CAPTURE_6(f, a, ...) LOG_ARG(a), LOG_CAPTURE_5(f, __VA_ARGS__)
+#define LOG_CAPTURE_7(f, a, ...) LOG_ARG(a), LOG_CAPTURE_6(f, __VA_ARGS__)
+#define LOG_CAPTURE_8(f, a, ...) LOG_ARG(a), LOG_CAPTURE_7(f, __VA_ARGS__)
+
+#define LOG_AT(lvl, per_second, ...) do {                                 \
+    if ((lvl) >= LOG_LEVEL_MIN) {                                         \
+        static LogSite log_site_ = {                                      \
+            .fmt = LOG_FMT(__VA_ARGS__), .file = __FILE__,                \
+            .line = __LINE__, .level = (lvl), .rate = (per_second)        \
+        };                                                                \
+        const LogArg log_args_[] = { LOG_CAPTURE(__VA_ARGS__) { 0 } };    \
+        log_write(&log_site_, LOG_NARGS(__VA_ARGS__), log_args_);         \
+    }                                                                     \
+} while (0)
+
+#define LOGD(...) LOG_AT(LOG_LEVEL_DEBUG, 0, __VA_ARGS__)
+#define LOGI(...) LOG_AT(LOG_LEVEL_INFO, 0, __VA_ARGS__)
+#define LOGW(...) LOG_AT(LOG_LEVEL_WARN, 0, __VA_ARGS__)
+#define LOGE(...) LOG_AT(LOG_LEVEL_ERROR, 0, __VA_ARGS__)
+
+#define LOGD_RATE(n, ...) LOG_AT(LOG_LEVEL_DEBUG, (n), __VA_ARGS__)
+#define LOGI_RATE(n, ...) LOG_AT(LOG_LEVEL_INFO, (n), __VA_ARGS__)
+#define LOGW_RATE(n, ...) LOG_AT(LOG_LEVEL_WARN, (n), __VA_ARGS__)
+
+#endif // LOGGER_H
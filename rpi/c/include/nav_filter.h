@@ -0,0 +1,85 @@
+/**
+ * GPS / Inertial Navigation Filter
+ *
+ * Two small Kalman filters that fuse low-rate GPS fixes with accelerometer
+ * data rotated into the local level frame by the current attitude:
+ *
+ *   vertical:     x = [altitude, vertical speed, accel bias]   meas: GPS altitude
+ *   along-track:  x = [ground speed, accel bias]               meas: GPS speed
+ *
+ * Prediction runs at the sensor rate, so speed, altitude and vertical speed
+ * are available at display rate without the 1-5 Hz GPS steps.
+ *
+ * Recorded data format (CSV, one row per sensor sample, used by
+ * debug/nav_filter_bench.c and written by pilot_assistant when the
+ * PILOT_NAV_LOG environment variable names an output file):
+ *
+ *   t_s,ax_g,ay_g,az_g,ux,uy,uz,gps_alt_m,gps_speed_mps
+ *
+ *   t_s            monotonic time in seconds
+ *   ax_g..az_g     accelerometer, body frame, g
+ *   ux..uz         unit "up" vector in the body frame (from attitude)
+ *   gps_alt_m      fresh GPS altitude in this sample, or empty
+ *   gps_speed_mps  fresh GPS ground speed in this sample, or empty
+ */
+
+#ifndef NAV_FILTER_H
+#define NAV_FILTER_H
+
+#include <stdbool.h>
+
+#define NAV_GRAVITY 9.80665f
+
+typedef struct {
+    // Vertical channel
+    float alt_m;
+    float vs_mps;
+    float bias_up;
+    float Pv[3][3];
+
+    // Along-track channel
+    float speed_mps;
+    float bias_fwd;
+    float Ps[2][2];
+
+    bool alt_valid;
+    bool speed_valid;
+
+    // Tuning
+    float accel_noise;      // Accelerometer white noise (m/s^2)
+    float bias_walk;        // Accel bias random walk (m/s^2 per sqrt(s))
+    float alt_noise;        // GPS altitude noise (m)
+    float speed_noise;      // GPS speed noise (m/s)
+} NavFilter;
+
+/**
+ * Initialize filter with default tuning
+ */
+void nav_filter_init(NavFilter *nav);
+
+/**
+ * Drop the estimates (GPS lost): both channels stop predicting and start
+ * again from the next GPS altitude/speed. Tuning is kept.
+ */
+void nav_filter_reset(NavFilter *nav);
+
+/**
+ * Propagate with one accelerometer sample
+ *
+ * accel_g: body-frame specific force in g
+ * up:      unit vector pointing up, expressed in the body frame
+ * dt:      seconds since the previous call
+ */
+void nav_filter_predict(NavFilter *nav, const float accel_g[3], const float up[3], float dt);
+
+/**
+ * Correct with a new GPS altitude (meters)
+ */
+void nav_filter_update_altitude(NavFilter *nav, float alt_m);
+
+/**
+ * Correct with a new GPS ground speed (m/s)
+ */
+void nav_filter_update_speed(NavFilter *nav, float speed_mps);
+
+#endif // NAV_FILTER_H
@@ -0,0 +1,34 @@
+/**
+ * OpenSky States over HTTP
+ *
+ * Runs one states/all query through curl and feeds the aircraft into the
+ * track table. When to query and which box to ask for is up to the
+ * scheduler (opensky_scheduler.h); this only fetches, parses the status
+ * line and rate-limit headers, and reports back in an OpenSkyResponse.
+ *
+ * The API root is a parameter so a local mock server can stand in for
+ * OpenSky (PILOT_OPENSKY_URL, debug/opensky_mock_test.c).
+ */
+
+#ifndef OPENSKY_HTTP_H
+#define OPENSKY_HTTP_H
+
+#include <stdint.h>
+#include "opensky_scheduler.h"
+#include "track_table.h"
+
+#define OPENSKY_API_URL "https://opensky-network.org/api"
+#define OPENSKY_HTTP_TIMEOUT_S 5
+#define OPENSKY_HTTP_RESPONSE_SIZE 65536    // Head and body; the rest is dropped
+
+/**
+ * Fetch the aircraft in query's box and update tracks (at now_ms) with
+ * those within query->radius_km of its centre
+ * base_url: API root, OPENSKY_API_URL or a mock server.
+ * Fills response; its traffic_count is the return value.
+ * Returns the number of aircraft, -1 unless response->result is OPENSKY_OK.
+ */
+int opensky_http_fetch(const char *base_url, const OpenSkyQuery *query, TrackTable *tracks,
+                       uint32_t now_ms, OpenSkyResponse *response);
+
+#endif // OPENSKY_HTTP_H
@@ -0,0 +1,71 @@
+/**
+ * Banded Render Pool
+ *
+ * Splits each frame into horizontal bands rendered in parallel by a pool
+ * of persistent worker threads. Workers take bands top to bottom, so the
+ * caller can flush band 0 to the panel while the lower bands are still
+ * being drawn; bands are always flushed in order.
+ *
+ * The render callback draws the whole scene, but the framebuffer
+ * primitives only touch rows inside the band (lcd_fb_set_clip_rows() is
+ * set per thread before each call). It must only read state the caller
+ * does not modify until render_pool_frame() returns.
+ *
+ * Per-band render times and the frame/flush totals are accumulated so
+ * scaling from one to four threads can be compared (PILOT_RENDER_THREADS).
+ */
+
+#ifndef RENDER_POOL_H
+#define RENDER_POOL_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define RENDER_BANDS 8              // 30 rows each at 240 lines
+#define RENDER_MAX_THREADS 4
+
+// Draw the scene for rows [y0, y1)
+typedef void (*RenderBandFn)(void *arg, uint16_t y0, uint16_t y1);
+
+// Send rows [y0, y1) of the framebuffer to the panel
+typedef void (*RenderFlushFn)(uint16_t y0, uint16_t y1);
+
+typedef struct {
+    unsigned long frames;
+    double band_last_us[RENDER_BANDS];
+    double band_max_us[RENDER_BANDS];
+    double band_total_us[RENDER_BANDS];
+    double flush_total_us;          // Time spent in the flush callback
+    double frame_total_us;          // Wall time of render_pool_frame()
+    double frame_max_us;
+} RenderPoolStats;
+
+/**
+ * Start the worker threads
+ * threads <= 0 picks the online core count (capped at RENDER_MAX_THREADS).
+ * Returns the number of workers; 0 means bands render on the calling thread.
+ */
+int render_pool_init(int threads);
+
+/**
+ * Render one frame band by band and flush each band in order
+ * Blocks until every band is rendered and flushed.
+ */
+void render_pool_frame(RenderBandFn render, void *arg, RenderFlushFn flush);
+
+/**
+ * Copy the accumulated timing
+ */
+void render_pool_get_stats(RenderPoolStats *stats);
+
+/**
+ * Print average/max time per band and per frame, then reset the counters
+ */
+void render_pool_print_stats(FILE *out);
+
+/**
+ * Stop and join the worker threads
+ */
+void render_pool_shutdown(void);
+
+#endif // RENDER_POOL_H
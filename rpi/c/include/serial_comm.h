@@ -23,6 +23,12 @@
  */
 int serial_init(void);
 
+/**
+ * Open and configure one specific port (raw 8N1, non-blocking)
+ * Returns file descriptor on success, -1 if it is absent or cannot be configured
+ */
+int serial_open_port(const char* port_path);
+
 /**
  * Close serial connection
  */
@@ -42,6 +48,7 @@ int serial_reconnect(void);
 
 /**
  * Read a line from serial port (blocks until newline or timeout)
+ * Unbuffered, one read() per byte; serial_link.h is the buffered alternative.
  * Returns number of bytes read (excluding newline), or -1 on error
  * Buffer will be null-terminated
  */
@@ -0,0 +1,108 @@
+/**
+ * Buffered Serial Link to the Pico
+ *
+ * Shared by pilot_assistant and pico_receiver. Incoming bytes land in a
+ * ring buffer with large read()s; the ring is mapped twice back to back,
+ * so any span of buffered bytes is contiguous in memory and lines/frames
+ * are handed out in place, without copying.
+ *
+ * The link reconnects by itself. Device add/remove events come from a
+ * kernel uevent (udev netlink) socket, so a replugged Pico is reopened
+ * as soon as its tty appears; where netlink is unavailable (containers,
+ * ptys) the candidate paths are simply retried every SERIAL_LINK_RETRY_MS.
+ */
+
+#ifndef SERIAL_LINK_H
+#define SERIAL_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SERIAL_LINK_RING_SIZE 16384     // Multiple of the page size
+#define SERIAL_LINK_MAX_LINE 4096       // Longer lines are dropped
+#define SERIAL_LINK_MAX_PATHS 4
+#define SERIAL_LINK_RETRY_MS 2000       // Fallback poll without hotplug events
+#define SERIAL_LINK_HOTPLUG_RETRY_MS 50 // Node may lag the add event slightly
+#define SERIAL_LINK_HOTPLUG_TRIES 20
+
+// serial_link_service()/serial_link_wait() result bits
+#define SERIAL_LINK_EV_DATA         0x01
+#define SERIAL_LINK_EV_CONNECTED    0x02
+#define SERIAL_LINK_EV_DISCONNECTED 0x04
+
+typedef struct {
+    uint64_t bytes;
+    uint64_t reads;             // read() calls that returned data
+    uint64_t lines;
+    uint64_t dropped_bytes;     // Overlong lines and ring overflow
+    uint32_t connects;
+    uint32_t disconnects;
+    uint32_t hotplug_events;    // Add/remove uevents for a candidate path
+} SerialLinkStats;
+
+typedef struct {
+    int fd;                     // -1 while disconnected
+    int hotplug_fd;             // Netlink uevent socket, -1 if unavailable
+    char *ring;                 // SERIAL_LINK_RING_SIZE bytes, mapped twice
+    size_t head;                // Free-running write count
+    size_t tail;                // Free-running read count
+    bool discarding;            // Skipping the rest of an overlong line
+    const char *paths[SERIAL_LINK_MAX_PATHS];
+    int path_count;
+    const char *device;         // Path currently open
+    uint64_t retry_at_us;       // Next reconnect attempt
+    int hotplug_tries;          // Fast retries left after an add event
+    SerialLinkStats stats;
+} SerialLink;
+
+/**
+ * Set up the ring and hotplug socket and try to open the first available path
+ * paths/count may be NULL/0 for SERIAL_PORT_PRIMARY and SERIAL_PORT_FALLBACK;
+ * the strings must outlive the link.
+ * Returns 0 (connected or not, see serial_link_connected), -1 on failure.
+ */
+int serial_link_init(SerialLink *link, const char *const *paths, int count);
+
+/**
+ * Close the device and release the ring and hotplug socket
+ */
+void serial_link_close(SerialLink *link);
+
+static inline bool serial_link_connected(const SerialLink *link) {
+    return link->fd >= 0;
+}
+
+/**
+ * Handle hotplug events, reconnect when due and drain the tty into the ring
+ * Never blocks. Returns SERIAL_LINK_EV_* bits.
+ */
+int serial_link_service(SerialLink *link);
+
+/**
+ * Wait up to timeout_ms for data or a connection change, then service the link
+ * Returns SERIAL_LINK_EV_* bits (0 on timeout).
+ */
+int serial_link_wait(SerialLink *link, int timeout_ms);
+
+/**
+ * Next complete line in the ring, NUL-terminated in place (\r and \n stripped,
+ * empty lines skipped). Valid until the next service/wait call.
+ * Returns NULL when no complete line is buffered.
+ */
+const char *serial_link_next_line(SerialLink *link, size_t *len);
+
+/**
+ * Contiguous view of every buffered byte, for binary frames
+ * Release what was used with serial_link_consume().
+ */
+const uint8_t *serial_link_peek(const SerialLink *link, size_t *len);
+void serial_link_consume(SerialLink *link, size_t n);
+
+/**
+ * Write all of data (waits briefly if the tty is full)
+ * Returns len, or -1 if the link is down or the write failed.
+ */
+int serial_link_write(SerialLink *link, const char *data, size_t len);
+
+#endif // SERIAL_LINK_H
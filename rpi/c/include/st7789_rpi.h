@@ -8,8 +8,10 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "lcd_orientation.h"
 
-// Display dimensions (landscape mode)
+// Display dimensions (landscape mode); after lcd_set_orientation() the
+// current size is lcd_width() x lcd_height()
 #define LCD_WIDTH  320
 #define LCD_HEIGHT 240
 
@@ -23,11 +25,41 @@
 #define COLOR_CYAN    0x07FF
 #define COLOR_MAGENTA 0xF81F
 
+// Output path: spidev + GPIO from user space, or a kernel DRM driver
+typedef enum {
+    LCD_BACKEND_SPIDEV,
+    LCD_BACKEND_DRM
+} LcdBackend;
+
 /**
  * Initialize the LCD
+ * Uses spidev unless PILOT_LCD_BACKEND=drm (PILOT_DRM_CARD picks the
+ * device, otherwise the cards are probed); falls back to spidev if no DRM
+ * device with a 320x240 output is found.
  */
 int lcd_init(void);
 
+/**
+ * Initialize the LCD with the given backend, no fallback
+ */
+int lcd_init_backend(LcdBackend backend);
+
+LcdBackend lcd_get_backend(void);
+
+/**
+ * Rotate and/or mirror the output in the panel controller (MADCTL), at no
+ * cost per frame. Portrait swaps lcd_width() and lcd_height(); redraw
+ * everything afterwards. Returns -1 if the backend cannot (DRM: set the
+ * rotation in the overlay instead).
+ */
+int lcd_set_orientation(LcdRotation rotation, uint8_t mirror);
+
+/**
+ * Current display size in pixels
+ */
+uint16_t lcd_width(void);
+uint16_t lcd_height(void);
+
 /**
  * Clean up and close LCD
  */
@@ -79,17 +111,32 @@ void lcd_draw_string_scaled(uint16_t x, uint16_t y, const char* str, uint16_t co
 void lcd_draw_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t* image_data);
 
 /**
- * Load and display a PNG image from file
+ * Draw an image already in wire order (big-endian RGB565, see image_cache.h)
+ * The pixels go to SPI without conversion.
+ */
+void lcd_draw_image_wire(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* pixels);
+
+/**
+ * Load and display a PNG image from file, centered
+ * Converted once through the image cache, later calls only map the result.
  * Returns 0 on success, -1 on error
  */
 int lcd_display_png(const char* filename);
 
 /**
  * Get pointer to the framebuffer
- * Allows drawing to offscreen buffer for double buffering
+ * Allows drawing to offscreen buffer for double buffering. With the DRM
+ * backend this is the back buffer and rotates through three buffers with
+ * each displayed frame, so every frame has to be drawn in full.
  */
 uint16_t* lcd_get_framebuffer(void);
 
+/**
+ * The frame last sent to the display (same as lcd_get_framebuffer() with
+ * spidev, the front buffer with DRM)
+ */
+const uint16_t* lcd_get_displayed_framebuffer(void);
+
 /**
  * Display the current framebuffer to the screen
  * Call this after drawing to framebuffer to show changes
@@ -97,7 +144,21 @@ uint16_t* lcd_get_framebuffer(void);
 void lcd_display_framebuffer(void);
 
 /**
- * Clear the framebuffer with a color (doesn't update display)
+ * Display only rows [y0, y1) of the framebuffer
+ * With DRM the rows wait until the bottom row is flushed, then the whole
+ * frame is page-flipped and the call returns without waiting for the
+ * transfer.
+ */
+void lcd_display_framebuffer_rows(uint16_t y0, uint16_t y1);
+
+/**
+ * Restrict the lcd_fb_* functions to rows [y0, y1) on the calling thread
+ * (default: the whole screen). Lets several threads draw disjoint bands.
+ */
+void lcd_fb_set_clip_rows(uint16_t y0, uint16_t y1);
+
+/**
+ * Clear the framebuffer (clip rows) with a color (doesn't update display)
  */
 void lcd_fb_clear(uint16_t color);
 
@@ -121,4 +182,9 @@ void lcd_fb_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16
  */
 void lcd_fb_draw_string(uint16_t x, uint16_t y, const char* str, uint16_t color, uint16_t bg_color);
 
+/**
+ * Copy a wire-order image (e.g. a cached icon) into the framebuffer (clip rows)
+ */
+void lcd_fb_draw_image_wire(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* pixels);
+
 #endif // ST7789_RPI_H
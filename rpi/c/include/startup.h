@@ -0,0 +1,66 @@
+/**
+ * Startup Tasks and Timeline
+ *
+ * Device bring-up (IMU, serial link to the Pico, GPS, WiFi check) runs on
+ * worker threads so slow devices do not hold up the display. Each task
+ * returns an int result (usually a file descriptor or -1) that the main
+ * thread picks up once startup_task_done() reports it finished. Anything
+ * else a task writes must only be read after startup_task_wait().
+ *
+ * Every task start/finish and every startup_mark() lands in a timeline
+ * (ms since startup_timeline_init) printed by startup_timeline_print().
+ */
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+typedef int (*StartupFn)(void *arg);
+
+typedef struct {
+    const char *name;
+    StartupFn fn;
+    void *arg;
+    pthread_t thread;
+    bool started;
+    atomic_bool done;
+    bool joined;
+    int result;
+} StartupTask;
+
+/**
+ * Start the clock (call first in main)
+ */
+void startup_timeline_init(void);
+
+/**
+ * Record a named stage (any thread; name must outlive the timeline)
+ */
+void startup_mark(const char *stage);
+
+/**
+ * Run fn(arg) on a worker thread
+ * Falls back to running it inline if the thread cannot be created.
+ */
+void startup_task_start(StartupTask *task, const char *name, StartupFn fn, void *arg);
+
+/**
+ * True once the task has finished (non-blocking)
+ */
+bool startup_task_done(StartupTask *task);
+
+/**
+ * Wait for the task and return its result
+ */
+int startup_task_wait(StartupTask *task);
+
+/**
+ * Print all stages in time order
+ */
+void startup_timeline_print(FILE *out);
+
+#endif // STARTUP_H
@@ -0,0 +1,78 @@
+/**
+ * Event Tracing (Chrome / Perfetto trace export)
+ *
+ * TRACE_BEGIN/TRACE_END bracket a span, TRACE_COUNTER records a value and
+ * TRACE_INSTANT a point in time. Each thread writes fixed-size events
+ * (CLOCK_MONOTONIC timestamp, static name, value) into its own ring with
+ * no lock and no system call beyond the clock read. Rings overwrite their
+ * oldest events, so the last TRACE_RING_EVENTS per thread are always
+ * there, like a flight recorder.
+ *
+ * A writer thread turns them into Chrome trace JSON (array form, which
+ * chrome://tracing and ui.perfetto.dev both open):
+ *   - snapshot: trace_request_dump() (safe in a signal handler) writes
+ *     everything still in the rings to TRACE_DUMP_DIR/pilot_trace_<n>.json
+ *   - stream: with a path given to trace_init(), new events are appended
+ *     every TRACE_STREAM_MS; events overwritten before they were written
+ *     out are counted as lost
+ *
+ * Names must be string literals (the pointer is stored). Until trace_init()
+ * the macros cost one predictable branch; -DTRACE_DISABLE removes them.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TRACE_RING_EVENTS 16384     // Per thread, power of two
+#define TRACE_MAX_THREADS 32
+#define TRACE_STREAM_MS 100
+#define TRACE_DUMP_DIR "/tmp"
+
+extern volatile bool trace_active;
+
+/**
+ * Start recording and the writer thread
+ * stream_path: append events to this file continuously, or NULL for
+ * snapshots only. Returns 0 on success, -1 on failure.
+ */
+int trace_init(const char *stream_path);
+
+/**
+ * Stop recording, flush the stream (closing the JSON array) and join the writer
+ */
+void trace_shutdown(void);
+
+/**
+ * Ask the writer thread for a snapshot of all rings (async-signal-safe)
+ */
+void trace_request_dump(void);
+
+/**
+ * Write a snapshot of all rings to path now; returns events written or -1
+ */
+int trace_dump(const char *path);
+
+/**
+ * Label the calling thread in the trace viewer (name must outlive the trace)
+ */
+void trace_thread_name(const char *name);
+
+// Used by the macros below; phase is 'B', 'E', 'C' or 'i'
+void trace_event(char phase, const char *name, double value);
+
+#ifdef TRACE_DISABLE
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#define TRACE_INSTANT(name) ((void)0)
+#else
+#define TRACE_BEGIN(name) do { if (trace_active) trace_event('B', (name), 0.0); } while (0)
+#define TRACE_END(name) do { if (trace_active) trace_event('E', (name), 0.0); } while (0)
+#define TRACE_COUNTER(name, value) do { if (trace_active) trace_event('C', (name), (value)); } while (0)
+#define TRACE_INSTANT(name) do { if (trace_active) trace_event('i', (name), 0.0); } while (0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,68 @@
+/**
+ * Display-Time Attitude Prediction Implementation
+ */
+
+#include <math.h>
+#include <string.h>
+#include "../include/attitude_predictor.h"
+
+/**
+ * Initialize with default tuning
+ */
+void attitude_predictor_init(AttitudePredictor *pred) {
+    memset(pred, 0, sizeof(*pred));
+    quaternion_identity(&pred->q);
+    pred->rate_tau_s = 0.015f;      // 3 samples at 200 Hz: trims gyro noise, little lag
+    pred->max_horizon_s = 0.05f;
+}
+
+void attitude_predictor_update(AttitudePredictor *pred, unsigned long t_us,
+                               const Quaternion *q, float gx, float gy, float gz) {
+    float g[3] = {gx, gy, gz};
+
+    if (!pred->valid) {
+        memcpy(pred->rate, g, sizeof(g));
+    } else {
+        float dt = (t_us - pred->t_us) / 1000000.0f;
+        float alpha = (pred->rate_tau_s > 0.0f && dt > 0.0f) ? dt / (pred->rate_tau_s + dt) : 1.0f;
+        for (int i = 0; i < 3; i++) {
+            pred->rate[i] += alpha * (g[i] - pred->rate[i]);
+        }
+    }
+
+    pred->q = *q;
+    pred->t_us = t_us;
+    pred->valid = true;
+}
+
+bool attitude_predictor_predict(const AttitudePredictor *pred, unsigned long t_us, Quaternion *out) {
+    if (!pred->valid) {
+        return false;
+    }
+
+    // Signed: a frame can start just before the next sample lands
+    float dt = (float)(long)(t_us - pred->t_us) / 1000000.0f;
+    if (dt <= 0.0f) {
+        *out = pred->q;
+        return true;
+    }
+    if (dt > pred->max_horizon_s) {
+        dt = pred->max_horizon_s;
+    }
+
+    // Constant body rate: q(t + dt) = q(t) * exp(0.5 * w * dt)
+    float wx = pred->rate[0], wy = pred->rate[1], wz = pred->rate[2];
+    float w = sqrtf(wx * wx + wy * wy + wz * wz);
+    float half = 0.5f * w * dt;
+    float c = cosf(half);
+    float s = (w > 1e-6f) ? sinf(half) / w : 0.5f * dt;
+    float dx = wx * s, dy = wy * s, dz = wz * s;
+
+    const Quaternion *q = &pred->q;
+    out->q0 = q->q0 * c - q->q1 * dx - q->q2 * dy - q->q3 * dz;
+    out->q1 = q->q0 * dx + q->q1 * c + q->q2 * dz - q->q3 * dy;
+    out->q2 = q->q0 * dy - q->q1 * dz + q->q2 * c + q->q3 * dx;
+    out->q3 = q->q0 * dz + q->q1 * dy - q->q2 * dx + q->q3 * c;
+    quaternion_normalize(out);
+    return true;
+}
@@ -0,0 +1,175 @@
+/**
+ * Pico/Pi Clock Synchronisation Implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "../include/clock_sync.h"
+
+void clock_sync_init(ClockSync *sync) {
+    memset(sync, 0, sizeof(*sync));
+    latency_hist_init(&sync->up, CLOCK_SYNC_HIST_BIN_US);
+    latency_hist_init(&sync->down, CLOCK_SYNC_HIST_BIN_US);
+}
+
+uint64_t clock_sync_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+int clock_sync_request(ClockSync *sync, char *buf, size_t size) {
+    uint32_t seq = sync->next_seq++;
+    uint64_t t1 = clock_sync_now_us();
+
+    int len = snprintf(buf, size, "sync %u %llu\n", seq, (unsigned long long)t1);
+    if (len < 0 || (size_t)len >= size) {
+        return 0;
+    }
+    sync->pending_seq[seq % CLOCK_SYNC_PENDING] = seq;
+    sync->pending_t1[seq % CLOCK_SYNC_PENDING] = t1;
+    sync->requests++;
+    return len;
+}
+
+static double offset_at(const ClockSync *sync, uint64_t pi_us) {
+    return sync->offset_us + sync->skew * (double)((int64_t)(pi_us - sync->ref_pi_us));
+}
+
+uint64_t clock_sync_pi_to_pico(const ClockSync *sync, uint64_t pi_us) {
+    return (uint64_t)((int64_t)pi_us + llround(offset_at(sync, pi_us)));
+}
+
+uint64_t clock_sync_pico_to_pi(const ClockSync *sync, uint64_t pico_us) {
+    // offset() barely changes over the offset itself, one step is enough
+    uint64_t guess = (uint64_t)((int64_t)pico_us - llround(sync->offset_us));
+    return (uint64_t)((int64_t)pico_us - llround(offset_at(sync, guess)));
+}
+
+static int compare_rtt(const void *a, const void *b) {
+    const ClockSyncSample *x = a, *y = b;
+    return (x->rtt_us > y->rtt_us) - (x->rtt_us < y->rtt_us);
+}
+
+// Least-squares line through the faster half of the window
+static void refit(ClockSync *sync) {
+    ClockSyncSample sorted[CLOCK_SYNC_WINDOW];
+    int n = sync->sample_count;
+    memcpy(sorted, sync->samples, n * sizeof(sorted[0]));
+    qsort(sorted, n, sizeof(sorted[0]), compare_rtt);
+    sync->rtt_min_us = sorted[0].rtt_us;
+
+    int used = (n + 1) / 2;
+    uint64_t t_min = sorted[0].t_pi_us, t_max = sorted[0].t_pi_us;
+    for (int i = 1; i < used; i++) {
+        if (sorted[i].t_pi_us < t_min) t_min = sorted[i].t_pi_us;
+        if (sorted[i].t_pi_us > t_max) t_max = sorted[i].t_pi_us;
+    }
+
+    // Times relative to the oldest sample keep the sums well inside a double
+    double mean_t = 0.0, mean_o = 0.0;
+    for (int i = 0; i < used; i++) {
+        mean_t += (double)(sorted[i].t_pi_us - t_min);
+        mean_o += sorted[i].offset_us;
+    }
+    mean_t /= used;
+    mean_o /= used;
+
+    double skew = 0.0;
+    if (t_max - t_min >= CLOCK_SYNC_MIN_SPAN_US) {
+        double stt = 0.0, sto = 0.0;
+        for (int i = 0; i < used; i++) {
+            double dt = (double)(sorted[i].t_pi_us - t_min) - mean_t;
+            stt += dt * dt;
+            sto += dt * (sorted[i].offset_us - mean_o);
+        }
+        skew = sto / stt;
+        if (skew > CLOCK_SYNC_MAX_SKEW) skew = CLOCK_SYNC_MAX_SKEW;
+        if (skew < -CLOCK_SYNC_MAX_SKEW) skew = -CLOCK_SYNC_MAX_SKEW;
+    }
+
+    sync->ref_pi_us = t_min + (uint64_t)llround(mean_t);
+    sync->offset_us = mean_o;
+    sync->skew = skew;
+    sync->locked = n >= CLOCK_SYNC_MIN_LOCK;
+}
+
+static void record_one_way(LatencyHist *hist, double *jitter, double *last,
+                           double latency_us, bool first) {
+    latency_hist_add(hist, latency_us > 0.0 ? (uint32_t)latency_us : 0);
+    if (!first) {
+        *jitter += (fabs(latency_us - *last) - *jitter) / 16.0;
+    }
+    *last = latency_us;
+}
+
+bool clock_sync_handle_reply(ClockSync *sync, const char *line, uint64_t t4_us) {
+    unsigned long seq;
+    unsigned long long t1, t2, t3;
+    if (strncmp(line, "SYNC:", 5) != 0) {
+        return false;
+    }
+    if (sscanf(line + 5, "%lu,%llu,%llu,%llu", &seq, &t1, &t2, &t3) != 4) {
+        return true;
+    }
+
+    // Only answers to our own recent requests (stale or echoed lines are ignored)
+    int slot = seq % CLOCK_SYNC_PENDING;
+    if (sync->pending_seq[slot] != seq || sync->pending_t1[slot] != t1 || t1 == 0) {
+        return true;
+    }
+    sync->pending_t1[slot] = 0;
+
+    int64_t rtt = (int64_t)(t4_us - t1) - (int64_t)(t3 - t2);
+    if (rtt < 0 || t4_us < t1) {
+        return true;
+    }
+
+    ClockSyncSample *s = &sync->samples[sync->sample_next];
+    s->t_pi_us = t1 + (t4_us - t1) / 2;
+    s->offset_us = ((double)((int64_t)(t2 - t1)) + (double)((int64_t)(t3 - t4_us))) / 2.0;
+    s->rtt_us = rtt;
+    sync->sample_next = (sync->sample_next + 1) % CLOCK_SYNC_WINDOW;
+    if (sync->sample_count < CLOCK_SYNC_WINDOW) {
+        sync->sample_count++;
+    }
+
+    bool first = sync->replies == 0 || !sync->locked;
+    sync->replies++;
+    refit(sync);
+
+    if (sync->locked) {
+        double up = (double)((int64_t)(t4_us - clock_sync_pico_to_pi(sync, t3)));
+        double down = (double)((int64_t)(t2 - clock_sync_pi_to_pico(sync, t1)));
+        record_one_way(&sync->up, &sync->jitter_up_us, &sync->last_up_us, up, first);
+        record_one_way(&sync->down, &sync->jitter_down_us, &sync->last_down_us, down, first);
+    }
+    return true;
+}
+
+void clock_sync_print(ClockSync *sync, FILE *out, bool reset) {
+    if (!sync->locked) {
+        fprintf(out, "Clock sync: not locked (%u/%u replies)\n", sync->replies, sync->requests);
+        return;
+    }
+
+    LatencySummary up, down;
+    latency_hist_summary(&sync->up, &up);
+    latency_hist_summary(&sync->down, &down);
+    fprintf(out, "Clock sync: Pico = Pi %+.3f s, skew %+.1f ppm, rtt min %.2f ms (%u/%u replies)\n",
+            sync->offset_us / 1e6, sync->skew * 1e6, sync->rtt_min_us / 1000.0,
+            sync->replies, sync->requests);
+    fprintf(out, "  Pico->Pi  p50 %.2f ms  p95 %.2f ms  max %.2f ms  jitter %.2f ms\n",
+            up.p50_us / 1000.0, up.p95_us / 1000.0, up.max_us / 1000.0,
+            sync->jitter_up_us / 1000.0);
+    fprintf(out, "  Pi->Pico  p50 %.2f ms  p95 %.2f ms  max %.2f ms  jitter %.2f ms\n",
+            down.p50_us / 1000.0, down.p95_us / 1000.0, down.max_us / 1000.0,
+            sync->jitter_down_us / 1000.0);
+    if (reset) {
+        latency_hist_reset(&sync->up);
+        latency_hist_reset(&sync->down);
+    }
+}
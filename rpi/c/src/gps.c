@@ -10,83 +10,49 @@
 #include <fcntl.h>
 #include <termios.h>
 #include <errno.h>
-#include <sys/stat.h>
+#include <gpiod.h>
 #include "../include/gps.h"
 
-#define GPIO_BASE_PATH "/sys/class/gpio"
+#define GPIO_CHIP "gpiochip0"
+
+// GPS enable line (held while the module is in use)
+static struct gpiod_chip *gpio_chip = NULL;
+static struct gpiod_line *en_line = NULL;
 
 // Helper function prototypes
-static int gpio_export(int pin);
-static int gpio_set_direction(int pin, const char *direction);
-static int gpio_set_value(int pin, int value);
+static int gps_power(bool on);
 static int parse_nmea_sentence(const char *sentence, GPSData *gps_data);
 static bool parse_nmea_coordinate(const char *coord, const char *hemisphere, float *out_deg);
 
 /**
- * Export GPIO pin
+ * Drive the GPS enable pin through libgpiod
  */
-static int gpio_export(int pin) {
-    char path[64];
-    snprintf(path, sizeof(path), "%s/gpio%d", GPIO_BASE_PATH, pin);
-
-    struct stat st;
-    if (stat(path, &st) == 0) {
-        return 0; // Already exported
+static int gps_power(bool on) {
+    if (!en_line) {
+        gpio_chip = gpiod_chip_open_by_name(GPIO_CHIP);
+        if (!gpio_chip) return -1;
+
+        en_line = gpiod_chip_get_line(gpio_chip, GPS_EN_PIN);
+        if (!en_line || gpiod_line_request_output(en_line, "gps-en", on ? 1 : 0) < 0) {
+            gpiod_chip_close(gpio_chip);
+            gpio_chip = NULL;
+            en_line = NULL;
+            return -1;
+        }
+        return 0;
     }
-
-    int fd = open(GPIO_BASE_PATH "/export", O_WRONLY);
-    if (fd < 0) return -1;
-
-    char buf[8];
-    int len = snprintf(buf, sizeof(buf), "%d", pin);
-    write(fd, buf, len);
-    close(fd);
-    usleep(100000);
-    return 0;
-}
-
-/**
- * Set GPIO direction
- */
-static int gpio_set_direction(int pin, const char *direction) {
-    char path[64];
-    snprintf(path, sizeof(path), "%s/gpio%d/direction", GPIO_BASE_PATH, pin);
-
-    int fd = open(path, O_WRONLY);
-    if (fd < 0) return -1;
-
-    write(fd, direction, strlen(direction));
-    close(fd);
-    return 0;
-}
-
-/**
- * Set GPIO value
- */
-static int gpio_set_value(int pin, int value) {
-    char path[64];
-    snprintf(path, sizeof(path), "%s/gpio%d/value", GPIO_BASE_PATH, pin);
-
-    int fd = open(path, O_WRONLY);
-    if (fd < 0) return -1;
-
-    char buf[2] = {value ? '1' : '0', '\0'};
-    write(fd, buf, 1);
-    close(fd);
-    return 0;
+    return gpiod_line_set_value(en_line, on ? 1 : 0);
 }
 
 /**
  * Initialize GPS module
  */
 int gps_init(void) {
-    // Enable GPS module via GPIO
-    gpio_export(GPS_EN_PIN);
-    gpio_set_direction(GPS_EN_PIN, "out");
-    gpio_set_value(GPS_EN_PIN, 1);
-
-    // Wait for GPS to boot
-    sleep(2);
+    // Enable GPS module via GPIO. No need to wait for it to boot: the port
+    // is read non-blocking and sentences simply start arriving.
+    if (gps_power(true) < 0) {
+        fprintf(stderr, "GPS: failed to drive enable pin %d\n", GPS_EN_PIN);
+    }
 
     // Open serial port
     int fd = open(GPS_PORT, O_RDWR | O_NOCTTY);
@@ -177,6 +143,7 @@ static int parse_nmea_sentence(const char *sentence, GPSData *gps_data) {
             // Field 9: Altitude in meters
             if (strlen(tokens[9]) > 0) {
                 gps_data->altitude_meters = atof(tokens[9]);
+                gps_data->altitude_updates++;
             }
 
             // Fields 2-5: Latitude and longitude
@@ -210,6 +177,7 @@ static int parse_nmea_sentence(const char *sentence, GPSData *gps_data) {
             // Field 7: Speed in knots
             if (strlen(tokens[7]) > 0) {
                 gps_data->speed_knots = atof(tokens[7]);
+                gps_data->speed_updates++;
             }
         }
 
@@ -256,5 +224,13 @@ void gps_cleanup(int fd) {
     if (fd >= 0) {
         close(fd);
     }
-    gpio_set_value(GPS_EN_PIN, 0);
+    if (en_line) {
+        gpiod_line_set_value(en_line, 0);
+        gpiod_line_release(en_line);
+        en_line = NULL;
+    }
+    if (gpio_chip) {
+        gpiod_chip_close(gpio_chip);
+        gpio_chip = NULL;
+    }
 }
@@ -0,0 +1,241 @@
+/**
+ * Pre-converted Image Cache Implementation
+ */
+
+#define _GNU_SOURCE
+#define STB_IMAGE_IMPLEMENTATION
+#include "../include/stb_image.h"
+#include "../include/image_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// On-disk layout: this header, then width * height wire-order pixels
+typedef struct {
+    char magic[4];                  // "R565"
+    uint32_t version;
+    uint64_t key;
+    uint16_t width;
+    uint16_t height;
+    uint32_t reserved;
+} CacheHeader;
+
+#define CACHE_MAGIC "R565"
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// FNV-1a, 64-bit
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t len) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    uint8_t *data = NULL;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        long size = ftell(f);
+        rewind(f);
+        if (size > 0) {
+            data = malloc(size);
+            if (data && fread(data, 1, size, f) != (size_t)size) {
+                free(data);
+                data = NULL;
+            }
+            *len = size;
+        }
+    }
+    fclose(f);
+    return data;
+}
+
+// First usable cache directory, created if missing
+static const char *cache_dir(void) {
+    const char *dirs[] = { getenv("PILOT_IMAGE_CACHE"), IMAGE_CACHE_DIR, IMAGE_CACHE_FALLBACK_DIR };
+    for (size_t i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++) {
+        if (!dirs[i]) continue;
+        if ((mkdir(dirs[i], 0755) == 0 || errno == EEXIST) && access(dirs[i], W_OK) == 0) {
+            return dirs[i];
+        }
+    }
+    return NULL;
+}
+
+// Map a cache file if it holds the image for this key
+static int map_cached(CachedImage *img, const char *path, uint64_t key) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(CacheHeader)) {
+        close(fd);
+        return -1;
+    }
+    // Prefault: the pages are about to be streamed to SPI anyway
+    void *base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+
+    const CacheHeader *hdr = base;
+    if (memcmp(hdr->magic, CACHE_MAGIC, 4) != 0 || hdr->version != IMAGE_CACHE_VERSION ||
+        hdr->key != key ||
+        (size_t)st.st_size != sizeof(CacheHeader) + (size_t)hdr->width * hdr->height * 2) {
+        munmap(base, st.st_size);
+        return -1;
+    }
+
+    img->width = hdr->width;
+    img->height = hdr->height;
+    img->pixels = (const uint8_t *)base + sizeof(CacheHeader);
+    img->base = base;
+    img->size = st.st_size;
+    img->mapped = 1;
+    return 0;
+}
+
+/**
+ * Decode and convert into a header + pixels block (heap)
+ * Scaling is nearest-neighbour, down only, as lcd_display_png always did.
+ */
+static uint8_t *convert(const uint8_t *src, size_t src_len, uint16_t max_w, uint16_t max_h,
+                        ImageConvert mode, uint64_t key, size_t *size) {
+    int width, height, channels;
+    unsigned char *rgb = stbi_load_from_memory(src, (int)src_len, &width, &height, &channels, 3);
+    if (!rgb) return NULL;
+
+    uint16_t w = width > max_w ? max_w : width;
+    uint16_t h = height > max_h ? max_h : height;
+    *size = sizeof(CacheHeader) + (size_t)w * h * 2;
+    uint8_t *block = malloc(*size);
+    if (!block) {
+        stbi_image_free(rgb);
+        return NULL;
+    }
+
+    CacheHeader *hdr = (CacheHeader *)block;
+    memset(hdr, 0, sizeof(*hdr));
+    memcpy(hdr->magic, CACHE_MAGIC, 4);
+    hdr->version = IMAGE_CACHE_VERSION;
+    hdr->key = key;
+    hdr->width = w;
+    hdr->height = h;
+
+    uint8_t *out = block + sizeof(CacheHeader);
+    for (int dy = 0; dy < h; dy++) {
+        const unsigned char *row = rgb + (size_t)((dy * height) / h) * width * 3;
+        for (int dx = 0; dx < w; dx++) {
+            const unsigned char *px = row + ((dx * width) / w) * 3;
+            uint8_t r = px[0], g = px[1], b = px[2];
+            if (mode == IMAGE_CONVERT_CYAN) {
+                uint8_t gray = (r * 30 + g * 59 + b * 11) / 100;
+                r = 0;
+                g = gray;
+                b = gray;
+            }
+            uint16_t pixel = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+            *out++ = pixel >> 8;
+            *out++ = pixel & 0xFF;
+        }
+    }
+
+    stbi_image_free(rgb);
+    return block;
+}
+
+// Write through a temporary file so a crash never leaves a torn entry
+static int store(const char *path, const uint8_t *block, size_t size) {
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", path, (int)getpid());
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = write(fd, block + done, size - done);
+        if (n <= 0) break;
+        done += n;
+    }
+    if (close(fd) != 0 || done != size || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+int image_cache_load(CachedImage *img, const char *source_path,
+                     uint16_t max_w, uint16_t max_h, ImageConvert mode) {
+    memset(img, 0, sizeof(*img));
+
+    size_t src_len = 0;
+    uint8_t *src = read_file(source_path, &src_len);
+    if (!src) {
+        fprintf(stderr, "Failed to read image: %s\n", source_path);
+        return -1;
+    }
+
+    // Key: source bytes plus everything that changes the converted pixels
+    uint32_t params[4] = { IMAGE_CACHE_VERSION, max_w, max_h, (uint32_t)mode };
+    uint64_t key = hash_bytes(0xcbf29ce484222325ULL, src, src_len);
+    key = hash_bytes(key, params, sizeof(params));
+
+    char path[512] = "";
+    const char *dir = cache_dir();
+    if (dir) {
+        snprintf(path, sizeof(path), "%s/%016llx.565", dir, (unsigned long long)key);
+        if (map_cached(img, path, key) == 0) {
+            free(src);
+            return 0;
+        }
+    }
+
+    double t0 = now_ms();
+    size_t size;
+    uint8_t *block = convert(src, src_len, max_w, max_h, mode, key, &size);
+    free(src);
+    if (!block) {
+        fprintf(stderr, "Failed to decode image: %s\n", source_path);
+        return -1;
+    }
+    printf("Image cache: converted %s in %.1f ms\n", source_path, now_ms() - t0);
+
+    if (dir && store(path, block, size) == 0 && map_cached(img, path, key) == 0) {
+        free(block);
+        return 0;
+    }
+
+    // No cache directory: use the converted copy this once
+    const CacheHeader *hdr = (const CacheHeader *)block;
+    img->width = hdr->width;
+    img->height = hdr->height;
+    img->pixels = block + sizeof(CacheHeader);
+    img->base = block;
+    img->size = size;
+    img->mapped = 0;
+    return 0;
+}
+
+void image_cache_release(CachedImage *img) {
+    if (!img->base) return;
+    if (img->mapped) {
+        munmap(img->base, img->size);
+    } else {
+        free(img->base);
+    }
+    memset(img, 0, sizeof(*img));
+}
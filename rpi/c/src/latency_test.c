@@ -0,0 +1,89 @@
+/**
+ * Synthetic Step Latency Test Implementation
+ */
+
+#include <math.h>
+#include <string.h>
+#include "../include/latency_test.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define DEG2RAD ((float)M_PI / 180.0f)
+#define LATENCY_BIN_US 250
+
+void latency_test_init(LatencyTest *test, int steps, float step_deg,
+                       unsigned long period_us, float p95_limit_ms) {
+    memset(test, 0, sizeof(*test));
+    test->steps = steps;
+    test->step_deg = step_deg;
+    test->period_us = period_us;
+    test->p95_limit_ms = p95_limit_ms;
+    latency_hist_init(&test->hist, LATENCY_BIN_US);
+}
+
+void latency_test_sample(LatencyTest *test, unsigned long now_us, float accel_g[3], float gyro_dps[3]) {
+    if (test->next_step_us == 0) {
+        // First sample: settle level for one period
+        test->next_step_us = now_us + test->period_us;
+        test->last_sample_us = now_us;
+    }
+
+    gyro_dps[0] = gyro_dps[1] = gyro_dps[2] = 0.0f;
+
+    // A step is due and the previous one was seen (or given up on)
+    if ((long)(now_us - test->next_step_us) >= 0 && test->steps_done < test->steps) {
+        if (test->pending) {
+            test->steps_missed++;
+            test->steps_done++;
+        }
+
+        float dt = (now_us - test->last_sample_us) / 1000000.0f;
+        float target = (test->roll_deg == 0.0f) ? test->step_deg : 0.0f;
+        if (dt > 0.0f) {
+            gyro_dps[0] = (target - test->roll_deg) / dt;
+        }
+
+        test->pending = true;
+        test->step_us = now_us;
+        test->from_deg = test->roll_deg;
+        test->to_deg = target;
+        test->roll_deg = target;
+        test->next_step_us = now_us + test->period_us;
+    }
+
+    // Gravity for the current roll (roll = atan2(ay, az), see quaternion.h)
+    accel_g[0] = 0.0f;
+    accel_g[1] = sinf(test->roll_deg * DEG2RAD);
+    accel_g[2] = cosf(test->roll_deg * DEG2RAD);
+    test->last_sample_us = now_us;
+}
+
+bool latency_test_frame(LatencyTest *test, float drawn_roll_deg, unsigned long flushed_us) {
+    if (test->pending &&
+        fabsf(drawn_roll_deg - test->to_deg) < fabsf(drawn_roll_deg - test->from_deg)) {
+        latency_hist_add(&test->hist, (uint32_t)(flushed_us - test->step_us));
+        test->pending = false;
+        test->steps_done++;
+    }
+    return test->steps_done >= test->steps;
+}
+
+bool latency_test_report(const LatencyTest *test, FILE *out) {
+    LatencySummary s;
+    latency_hist_summary(&test->hist, &s);
+
+    fprintf(out, "=== Latency test: %d steps of %.0f deg, %d not seen ===\n",
+            test->steps_done, test->step_deg, test->steps_missed);
+    fprintf(out, "step to panel: p50 %.1f ms  p95 %.1f ms  p99 %.1f ms  (min %.1f, max %.1f)\n",
+            s.p50_us / 1000.0f, s.p95_us / 1000.0f, s.p99_us / 1000.0f,
+            s.min_us / 1000.0f, s.max_us / 1000.0f);
+
+    bool pass = s.count > 0 && test->steps_missed == 0 &&
+                (test->p95_limit_ms <= 0.0f || s.p95_us / 1000.0f <= test->p95_limit_ms);
+    if (test->p95_limit_ms > 0.0f) {
+        fprintf(out, "p95 limit %.1f ms: %s\n", test->p95_limit_ms, pass ? "PASS" : "FAIL");
+    }
+    return pass;
+}
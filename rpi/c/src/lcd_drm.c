@@ -0,0 +1,346 @@
+/**
+ * Kernel DRM Output Implementation
+ */
+
+#define _GNU_SOURCE
+#include "../include/lcd_drm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#if LCD_DRM_ENABLED
+
+#include <drm.h>
+#include <drm_mode.h>
+#include <drm_fourcc.h>
+
+typedef struct {
+    uint32_t handle;
+    uint32_t fb_id;
+    uint16_t *pixels;
+    size_t size;
+} DumbBuffer;
+
+static int drm_fd = -1;
+static uint32_t crtc_id = 0;
+static uint32_t connector_id = 0;
+static struct drm_mode_modeinfo mode;
+static DumbBuffer buffers[LCD_DRM_BUFFERS];
+static int front = 0;                   // Last one flipped to (shown once the flip completes)
+static int draw = 1;                    // Neither shown nor queued
+static bool flip_pending = false;
+static bool can_flip = true;
+
+static int drm_ioctl(int fd, unsigned long request, void *arg) {
+    int ret;
+    do {
+        ret = ioctl(fd, request, arg);
+    } while (ret == -1 && (errno == EINTR || errno == EAGAIN));
+    return ret;
+}
+
+// Connected connector with a width x height mode, and a CRTC to drive it
+static int find_output(int fd, uint16_t width, uint16_t height) {
+    uint32_t crtcs[16], connectors[16];
+    struct drm_mode_card_res res;
+    memset(&res, 0, sizeof(res));
+    res.crtc_id_ptr = (uintptr_t)crtcs;
+    res.connector_id_ptr = (uintptr_t)connectors;
+    res.count_crtcs = 16;
+    res.count_connectors = 16;
+    if (drm_ioctl(fd, DRM_IOCTL_MODE_GETRESOURCES, &res) < 0) return -1;
+    uint32_t crtc_count = res.count_crtcs < 16 ? res.count_crtcs : 16;
+    uint32_t connector_count = res.count_connectors < 16 ? res.count_connectors : 16;
+
+    for (uint32_t c = 0; c < connector_count; c++) {
+        // First call for the counts, second for the lists
+        struct drm_mode_get_connector conn;
+        memset(&conn, 0, sizeof(conn));
+        conn.connector_id = connectors[c];
+        if (drm_ioctl(fd, DRM_IOCTL_MODE_GETCONNECTOR, &conn) < 0) continue;
+        if (conn.connection != DRM_MODE_CONNECTED || conn.count_modes == 0) continue;
+
+        uint32_t mode_count = conn.count_modes, encoder_count = conn.count_encoders;
+        struct drm_mode_modeinfo *modes = calloc(mode_count, sizeof(*modes));
+        uint32_t *encoders = calloc(encoder_count ? encoder_count : 1, sizeof(*encoders));
+        memset(&conn, 0, sizeof(conn));
+        conn.connector_id = connectors[c];
+        conn.modes_ptr = (uintptr_t)modes;
+        conn.count_modes = mode_count;
+        conn.encoders_ptr = (uintptr_t)encoders;
+        conn.count_encoders = encoder_count;
+
+        bool found = false;
+        if (modes && encoders && drm_ioctl(fd, DRM_IOCTL_MODE_GETCONNECTOR, &conn) == 0 &&
+            conn.count_modes <= mode_count && conn.count_encoders <= encoder_count) {
+            for (uint32_t m = 0; m < conn.count_modes && !found; m++) {
+                if (modes[m].hdisplay == width && modes[m].vdisplay == height) {
+                    mode = modes[m];
+                    found = true;
+                }
+            }
+            if (!found && conn.count_modes > 0) {
+                fprintf(stderr, "DRM connector %u is %ux%u, not %ux%u (check the overlay rotation)\n",
+                        connectors[c], modes[0].hdisplay, modes[0].vdisplay, width, height);
+            }
+        }
+
+        // The CRTC already driving it, else the first one the encoders allow
+        uint32_t crtc = 0;
+        for (uint32_t e = 0; found && crtc == 0 && e < conn.count_encoders; e++) {
+            struct drm_mode_get_encoder enc;
+            memset(&enc, 0, sizeof(enc));
+            enc.encoder_id = encoders[e];
+            if (drm_ioctl(fd, DRM_IOCTL_MODE_GETENCODER, &enc) < 0) continue;
+            if (enc.encoder_id == conn.encoder_id && enc.crtc_id) {
+                crtc = enc.crtc_id;
+            }
+            for (uint32_t i = 0; crtc == 0 && i < crtc_count; i++) {
+                if (enc.possible_crtcs & (1u << i)) crtc = crtcs[i];
+            }
+        }
+        free(modes);
+        free(encoders);
+
+        if (found && crtc) {
+            connector_id = connectors[c];
+            crtc_id = crtc;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int create_buffer(int fd, DumbBuffer *buf, uint16_t width, uint16_t height) {
+    struct drm_mode_create_dumb create;
+    memset(&create, 0, sizeof(create));
+    create.width = width;
+    create.height = height;
+    create.bpp = 16;
+    if (drm_ioctl(fd, DRM_IOCTL_MODE_CREATE_DUMB, &create) < 0) return -1;
+    buf->handle = create.handle;
+    buf->size = create.size;
+
+    // The drawing code assumes rows of exactly width pixels
+    if (create.pitch != (uint32_t)width * 2) {
+        fprintf(stderr, "DRM dumb buffer pitch %u, need %u\n", create.pitch, width * 2);
+        return -1;
+    }
+
+    struct drm_mode_fb_cmd2 fb;
+    memset(&fb, 0, sizeof(fb));
+    fb.width = width;
+    fb.height = height;
+    fb.pixel_format = DRM_FORMAT_RGB565;
+    fb.handles[0] = create.handle;
+    fb.pitches[0] = create.pitch;
+    if (drm_ioctl(fd, DRM_IOCTL_MODE_ADDFB2, &fb) < 0) return -1;
+    buf->fb_id = fb.fb_id;
+
+    struct drm_mode_map_dumb map;
+    memset(&map, 0, sizeof(map));
+    map.handle = create.handle;
+    if (drm_ioctl(fd, DRM_IOCTL_MODE_MAP_DUMB, &map) < 0) return -1;
+    void *pixels = mmap(NULL, buf->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, map.offset);
+    if (pixels == MAP_FAILED) return -1;
+    buf->pixels = pixels;
+    memset(buf->pixels, 0, buf->size);
+    return 0;
+}
+
+static void destroy_buffer(int fd, DumbBuffer *buf) {
+    if (buf->pixels) munmap(buf->pixels, buf->size);
+    if (buf->fb_id) drm_ioctl(fd, DRM_IOCTL_MODE_RMFB, &buf->fb_id);
+    if (buf->handle) {
+        struct drm_mode_destroy_dumb destroy = { .handle = buf->handle };
+        drm_ioctl(fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+    }
+    memset(buf, 0, sizeof(*buf));
+}
+
+static int open_card(const char *path, uint16_t width, uint16_t height) {
+    int fd = open(path, O_RDWR | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct drm_get_cap cap = { .capability = DRM_CAP_DUMB_BUFFER };
+    if (drm_ioctl(fd, DRM_IOCTL_GET_CAP, &cap) < 0 || !cap.value ||
+        find_output(fd, width, height) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int lcd_drm_open(const char *card, uint16_t width, uint16_t height) {
+    if (card) {
+        drm_fd = open_card(card, width, height);
+    } else {
+        for (int i = 0; i < LCD_DRM_MAX_CARDS && drm_fd < 0; i++) {
+            char path[32];
+            snprintf(path, sizeof(path), "/dev/dri/card%d", i);
+            drm_fd = open_card(path, width, height);
+        }
+    }
+    if (drm_fd < 0) {
+        fprintf(stderr, "No DRM device with a %ux%u output\n", width, height);
+        return -1;
+    }
+
+    for (int i = 0; i < LCD_DRM_BUFFERS; i++) {
+        if (create_buffer(drm_fd, &buffers[i], width, height) < 0) {
+            perror("DRM dumb buffer");
+            lcd_drm_close();
+            return -1;
+        }
+    }
+
+    front = 0;
+    draw = 1;
+    struct drm_mode_crtc crtc;
+    memset(&crtc, 0, sizeof(crtc));
+    crtc.crtc_id = crtc_id;
+    crtc.fb_id = buffers[front].fb_id;
+    crtc.set_connectors_ptr = (uintptr_t)&connector_id;
+    crtc.count_connectors = 1;
+    crtc.mode = mode;
+    crtc.mode_valid = 1;
+    if (drm_ioctl(drm_fd, DRM_IOCTL_MODE_SETCRTC, &crtc) < 0) {
+        perror("DRM set CRTC (is another program the DRM master?)");
+        lcd_drm_close();
+        return -1;
+    }
+
+    flip_pending = false;
+    can_flip = true;
+    printf("DRM display: %ux%u \"%s\", CRTC %u, connector %u\n",
+           mode.hdisplay, mode.vdisplay, mode.name, crtc_id, connector_id);
+    return 0;
+}
+
+// Drain the page flip completion event
+static void wait_flip(void) {
+    while (flip_pending) {
+        struct pollfd pfd = { .fd = drm_fd, .events = POLLIN };
+        if (poll(&pfd, 1, LCD_DRM_FLIP_TIMEOUT_MS) <= 0) {
+            flip_pending = false;   // Lost event; carry on rather than hang
+            break;
+        }
+
+        char events[256];
+        ssize_t len = read(drm_fd, events, sizeof(events));
+        ssize_t off = 0;
+        while (len > 0 && off + (ssize_t)sizeof(struct drm_event) <= len) {
+            const struct drm_event *ev = (const struct drm_event *)(events + off);
+            if (ev->type == DRM_EVENT_FLIP_COMPLETE) flip_pending = false;
+            if (ev->length == 0) break;
+            off += ev->length;
+        }
+    }
+}
+
+void lcd_drm_flip(void) {
+    if (drm_fd < 0) return;
+    // Once the previous flip is done the buffer it replaced is off screen
+    // and no longer read by the driver, so it can be drawn next
+    wait_flip();
+
+    int back = draw;
+    draw = (draw + 1) % LCD_DRM_BUFFERS;
+    if (can_flip) {
+        struct drm_mode_crtc_page_flip flip;
+        memset(&flip, 0, sizeof(flip));
+        flip.crtc_id = crtc_id;
+        flip.fb_id = buffers[back].fb_id;
+        flip.flags = DRM_MODE_PAGE_FLIP_EVENT;
+        if (drm_ioctl(drm_fd, DRM_IOCTL_MODE_PAGE_FLIP, &flip) == 0) {
+            flip_pending = true;
+            front = back;
+            return;
+        }
+        fprintf(stderr, "DRM page flip failed (%s), using mode sets\n", strerror(errno));
+        can_flip = false;
+    }
+
+    // Blocking fallback for drivers without page flip
+    struct drm_mode_crtc crtc;
+    memset(&crtc, 0, sizeof(crtc));
+    crtc.crtc_id = crtc_id;
+    crtc.fb_id = buffers[back].fb_id;
+    crtc.set_connectors_ptr = (uintptr_t)&connector_id;
+    crtc.count_connectors = 1;
+    crtc.mode = mode;
+    crtc.mode_valid = 1;
+    drm_ioctl(drm_fd, DRM_IOCTL_MODE_SETCRTC, &crtc);
+    front = back;
+}
+
+void lcd_drm_dirty(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    if (drm_fd < 0 || x0 >= x1 || y0 >= y1) return;
+    wait_flip();
+    struct drm_clip_rect clip = { x0, y0, x1, y1 };
+    struct drm_mode_fb_dirty_cmd dirty;
+    memset(&dirty, 0, sizeof(dirty));
+    dirty.fb_id = buffers[front].fb_id;
+    dirty.num_clips = 1;
+    dirty.clips_ptr = (uintptr_t)&clip;
+    // ENOSYS: the driver scans out continuously and needs no damage
+    drm_ioctl(drm_fd, DRM_IOCTL_MODE_DIRTYFB, &dirty);
+}
+
+uint16_t *lcd_drm_front(void) {
+    return buffers[front].pixels;
+}
+
+uint16_t *lcd_drm_back(void) {
+    return buffers[draw].pixels;
+}
+
+void lcd_drm_close(void) {
+    if (drm_fd < 0) return;
+    wait_flip();
+    for (int i = 0; i < LCD_DRM_BUFFERS; i++) {
+        destroy_buffer(drm_fd, &buffers[i]);
+    }
+    close(drm_fd);
+    drm_fd = -1;
+}
+
+#else // !LCD_DRM_ENABLED
+
+int lcd_drm_open(const char *card, uint16_t width, uint16_t height) {
+    (void)card;
+    (void)width;
+    (void)height;
+    fprintf(stderr, "DRM backend not built in (no libdrm headers at build time)\n");
+    return -1;
+}
+
+void lcd_drm_close(void) {
+}
+
+uint16_t *lcd_drm_front(void) {
+    return NULL;
+}
+
+uint16_t *lcd_drm_back(void) {
+    return NULL;
+}
+
+void lcd_drm_flip(void) {
+}
+
+void lcd_drm_dirty(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    (void)x0;
+    (void)y0;
+    (void)x1;
+    (void)y1;
+}
+
+#endif // LCD_DRM_ENABLED
@@ -0,0 +1,415 @@
+/**
+ * Asynchronous Logger Implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <syslog.h>
+#include "../include/logger.h"
+
+#define RING_MASK (LOG_RING_SIZE - 1)
+#define PAD_LEVEL 0xFF              // Filler up to the end of the ring
+#define MESSAGE_MAX 1024
+
+// Fixed part of a record; LogArgs and copied strings follow
+typedef struct {
+    uint32_t size;                  // Whole record, multiple of 8
+    uint8_t level;                  // PAD_LEVEL: skip to the ring start
+    uint8_t nargs;
+    uint16_t reserved;
+    uint64_t t_ns;
+    const LogSite *site;
+    uint32_t suppressed;
+    uint32_t reserved2;
+} LogRecord;
+
+typedef struct {
+    _Alignas(64) atomic_size_t head;    // Written by the owning thread
+    _Alignas(64) atomic_size_t tail;    // Written by the drain thread
+    atomic_bool in_use;                 // Owner alive (or not yet drained)
+    atomic_uint_least64_t dropped;
+    atomic_uint_least64_t suppressed;
+    _Alignas(8) char buf[LOG_RING_SIZE];
+} LogRing;
+
+static LogRing *rings[LOG_MAX_THREADS];
+static atomic_int ring_count = 0;
+static pthread_mutex_t register_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t ring_key;
+static _Thread_local LogRing *my_ring = NULL;
+
+static pthread_mutex_t sync_lock = PTHREAD_MUTEX_INITIALIZER;   // Synchronous path
+static pthread_t drain_thread;
+static atomic_bool draining = false;
+static atomic_bool stop_drain = false;
+static LogSink log_sink = LOG_SINK_STDOUT;
+static atomic_int runtime_level = LOG_LEVEL_DEBUG;
+static uint64_t start_ns = 0;
+static atomic_uint_least64_t records_written = 0;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// ── Formatting (drain thread) ─────────────────────────────────────────────────
+
+// printf one conversion with the captured value, whatever length modifier
+// the format had; mismatched types are converted rather than misread
+static int format_arg(char *out, size_t size, const char *spec, size_t spec_len,
+                      char conv, const LogArg *arg, const char *str) {
+    char f[32];
+    if (spec_len > sizeof(f) - 4) spec_len = sizeof(f) - 4;
+    memcpy(f, spec, spec_len);
+
+    switch (conv) {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c': {
+        long long v = arg->type == LOG_ARG_DOUBLE ? (long long)arg->v.d :
+                      arg->type == LOG_ARG_UINT ? (long long)arg->v.u : arg->v.i;
+        if (conv == 'c') {
+            f[spec_len] = 'c';
+            f[spec_len + 1] = '\0';
+            return snprintf(out, size, f, (int)v);
+        }
+        f[spec_len] = 'l';
+        f[spec_len + 1] = 'l';
+        f[spec_len + 2] = conv;
+        f[spec_len + 3] = '\0';
+        return snprintf(out, size, f, v);
+    }
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+        double v = arg->type == LOG_ARG_DOUBLE ? arg->v.d :
+                   arg->type == LOG_ARG_UINT ? (double)arg->v.u : (double)arg->v.i;
+        f[spec_len] = conv;
+        f[spec_len + 1] = '\0';
+        return snprintf(out, size, f, v);
+    }
+    case 's':
+        f[spec_len] = 's';
+        f[spec_len + 1] = '\0';
+        return snprintf(out, size, f, arg->type == LOG_ARG_STR ? str : "?");
+    case 'p':
+        return snprintf(out, size, "%p", arg->v.p);
+    default:
+        return snprintf(out, size, "%%%c", conv);
+    }
+}
+
+static int format_message(char *out, size_t size, const LogRecord *rec) {
+    const LogArg *args = (const LogArg *)(rec + 1);
+    const char *fmt = rec->site->fmt;
+    size_t pos = 0;
+    int next = 0;
+
+    while (*fmt && pos + 1 < size) {
+        if (*fmt != '%') {
+            out[pos++] = *fmt++;
+            continue;
+        }
+        if (fmt[1] == '%') {
+            out[pos++] = '%';
+            fmt += 2;
+            continue;
+        }
+
+        // Flags, width and precision are kept; length modifiers dropped
+        const char *spec = fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt)) fmt++;
+        size_t spec_len = fmt - spec;
+        while (*fmt && strchr("hljztL", *fmt)) fmt++;
+        char conv = *fmt ? *fmt++ : 's';
+
+        if (next >= rec->nargs) {
+            int n = snprintf(out + pos, size - pos, "<missing>");
+            pos += n > 0 ? (size_t)n : 0;
+            continue;
+        }
+        const LogArg *arg = &args[next++];
+        const char *str = arg->type == LOG_ARG_STR ? (const char *)rec + arg->v.u : NULL;
+        int n = format_arg(out + pos, size - pos, spec, spec_len, conv, arg, str);
+        if (n > 0) pos += (size_t)n < size - pos ? (size_t)n : size - pos - 1;
+    }
+    out[pos] = '\0';
+    return (int)pos;
+}
+
+static void emit(const LogRecord *rec) {
+    static const char level_chars[] = "DIWE";
+    static const int priorities[] = { LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERR };
+    char msg[MESSAGE_MAX];
+    int len = format_message(msg, sizeof(msg), rec);
+    if (rec->suppressed > 0 && len < (int)sizeof(msg)) {
+        snprintf(msg + len, sizeof(msg) - len, " [%u suppressed]", rec->suppressed);
+    }
+
+    if (log_sink == LOG_SINK_SYSLOG) {
+        syslog(priorities[rec->level], "%s", msg);
+    } else {
+        const char *file = strrchr(rec->site->file, '/');
+        double t = (double)(rec->t_ns - start_ns) / 1e9;
+        fprintf(stdout, "[%12.6f] %c %s:%d %s\n", t, level_chars[rec->level],
+                file ? file + 1 : rec->site->file, rec->site->line, msg);
+    }
+    atomic_fetch_add_explicit(&records_written, 1, memory_order_relaxed);
+}
+
+// ── Rings ─────────────────────────────────────────────────────────────────────
+
+static void ring_release(void *ring) {
+    // The drain thread keeps emptying it; a new thread may then reuse it
+    atomic_store_explicit(&((LogRing *)ring)->in_use, false, memory_order_release);
+}
+
+static void make_key(void) {
+    pthread_key_create(&ring_key, ring_release);
+}
+
+static LogRing *ring_for_thread(void) {
+    static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+    if (my_ring) {
+        return my_ring;
+    }
+    pthread_once(&key_once, make_key);
+
+    pthread_mutex_lock(&register_lock);
+    LogRing *ring = NULL;
+    int count = atomic_load(&ring_count);
+    for (int i = 0; i < count && !ring; i++) {
+        LogRing *r = rings[i];
+        if (!atomic_load(&r->in_use) && atomic_load(&r->head) == atomic_load(&r->tail)) {
+            ring = r;
+        }
+    }
+    if (!ring && count < LOG_MAX_THREADS) {
+        ring = aligned_alloc(64, sizeof(LogRing));
+        if (ring) {
+            memset(ring, 0, sizeof(*ring));
+            rings[count] = ring;
+            atomic_store_explicit(&ring_count, count + 1, memory_order_release);
+        }
+    }
+    if (ring) {
+        atomic_store(&ring->in_use, true);
+        pthread_setspecific(ring_key, ring);
+    }
+    pthread_mutex_unlock(&register_lock);
+
+    my_ring = ring;
+    return ring;
+}
+
+// Oldest unread record of a ring (skipping end-of-ring filler), or NULL
+static const LogRecord *ring_peek(LogRing *ring) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    while (tail != head) {
+        const LogRecord *rec = (const LogRecord *)(ring->buf + (tail & RING_MASK));
+        if (rec->level != PAD_LEVEL) {
+            return rec;
+        }
+        tail += rec->size;
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    return NULL;
+}
+
+static void ring_pop(LogRing *ring, const LogRecord *rec) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + rec->size, memory_order_release);
+}
+
+// Emit everything buffered, oldest first across all rings
+static void drain_rings(void) {
+    int count = atomic_load_explicit(&ring_count, memory_order_acquire);
+    bool wrote = false;
+
+    for (;;) {
+        LogRing *oldest = NULL;
+        const LogRecord *oldest_rec = NULL;
+        for (int i = 0; i < count; i++) {
+            const LogRecord *rec = ring_peek(rings[i]);
+            if (rec && (!oldest_rec || rec->t_ns < oldest_rec->t_ns)) {
+                oldest = rings[i];
+                oldest_rec = rec;
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        emit(oldest_rec);
+        ring_pop(oldest, oldest_rec);
+        wrote = true;
+    }
+    if (wrote && log_sink == LOG_SINK_STDOUT) {
+        fflush(stdout);
+    }
+}
+
+static void *drain_main(void *unused) {
+    (void)unused;
+    struct timespec interval = { 0, LOG_DRAIN_INTERVAL_MS * 1000000L };
+    while (!atomic_load(&stop_drain)) {
+        drain_rings();
+        nanosleep(&interval, NULL);
+    }
+    drain_rings();
+    return NULL;
+}
+
+// ── Public API ────────────────────────────────────────────────────────────────
+
+// Lay out a record at dst (room for `size` bytes, see record_size)
+static void record_build(char *dst, size_t size, const LogSite *site, int nargs,
+                         const LogArg *args, uint64_t t_ns, uint32_t suppressed) {
+    LogRecord *rec = (LogRecord *)dst;
+    LogArg *out = (LogArg *)(rec + 1);
+    size_t str_at = sizeof(LogRecord) + nargs * sizeof(LogArg);
+
+    rec->size = (uint32_t)size;
+    rec->level = (uint8_t)site->level;
+    rec->nargs = (uint8_t)nargs;
+    rec->t_ns = t_ns;
+    rec->site = site;
+    rec->suppressed = suppressed;
+
+    for (int i = 0; i < nargs; i++) {
+        out[i] = args[i];
+        if (args[i].type == LOG_ARG_STR) {
+            const char *s = args[i].v.s ? args[i].v.s : "(null)";
+            size_t len = strnlen(s, LOG_MAX_STRING - 1);
+            memcpy(dst + str_at, s, len);
+            dst[str_at + len] = '\0';
+            out[i].len = (uint32_t)(len + 1);
+            out[i].v.u = str_at;    // Offset from the record start
+            str_at += len + 1;
+        }
+    }
+}
+
+static size_t record_size(int nargs, const LogArg *args) {
+    size_t size = sizeof(LogRecord) + nargs * sizeof(LogArg);
+    for (int i = 0; i < nargs; i++) {
+        if (args[i].type == LOG_ARG_STR) {
+            size += (args[i].v.s ? strnlen(args[i].v.s, LOG_MAX_STRING - 1) : 6) + 1;
+        }
+    }
+    return (size + 7) & ~(size_t)7;
+}
+
+void log_write(LogSite *site, int nargs, const LogArg *args) {
+    if (site->level < atomic_load_explicit(&runtime_level, memory_order_relaxed)) {
+        return;
+    }
+    if (nargs > LOG_MAX_ARGS) {
+        nargs = LOG_MAX_ARGS;
+    }
+    uint64_t t = now_ns();
+
+    uint32_t suppressed = 0;
+    if (site->rate > 0) {
+        uint64_t second = t / 1000000000ULL;
+        uint_least64_t window = atomic_load_explicit(&site->window, memory_order_relaxed);
+        if (window != second &&
+            atomic_compare_exchange_strong_explicit(&site->window, &window, second,
+                                                    memory_order_relaxed, memory_order_relaxed)) {
+            atomic_store_explicit(&site->count, 0, memory_order_relaxed);
+        }
+        if (atomic_fetch_add_explicit(&site->count, 1, memory_order_relaxed) >= site->rate) {
+            atomic_fetch_add_explicit(&site->suppressed, 1, memory_order_relaxed);
+            LogRing *ring = ring_for_thread();
+            if (ring) atomic_fetch_add_explicit(&ring->suppressed, 1, memory_order_relaxed);
+            return;
+        }
+        suppressed = atomic_exchange_explicit(&site->suppressed, 0, memory_order_relaxed);
+    }
+
+    size_t size = record_size(nargs, args);
+
+    if (!atomic_load_explicit(&draining, memory_order_acquire)) {
+        // No drain thread: format right here
+        _Alignas(8) char buf[sizeof(LogRecord) + LOG_MAX_ARGS * (sizeof(LogArg) + LOG_MAX_STRING) + 8];
+        record_build(buf, size, site, nargs, args, t, suppressed);
+        pthread_mutex_lock(&sync_lock);
+        emit((const LogRecord *)buf);
+        if (log_sink == LOG_SINK_STDOUT) fflush(stdout);
+        pthread_mutex_unlock(&sync_lock);
+        return;
+    }
+
+    LogRing *ring = ring_for_thread();
+    if (!ring) {
+        return;     // More threads than LOG_MAX_THREADS
+    }
+
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    size_t offset = head & RING_MASK;
+    size_t contiguous = LOG_RING_SIZE - offset;
+    size_t needed = size > contiguous ? contiguous + size : size;
+
+    if (needed > LOG_RING_SIZE - (head - tail)) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    if (size > contiguous) {
+        // Records never wrap: fill the end and start over at offset 0
+        LogRecord *pad = (LogRecord *)(ring->buf + offset);
+        pad->size = (uint32_t)contiguous;
+        pad->level = PAD_LEVEL;
+        head += contiguous;
+        offset = 0;
+    }
+    record_build(ring->buf + offset, size, site, nargs, args, t, suppressed);
+    atomic_store_explicit(&ring->head, head + size, memory_order_release);
+}
+
+int log_init(LogSink sink, const char *ident) {
+    if (atomic_load(&draining)) {
+        return 0;
+    }
+    log_sink = sink;
+    start_ns = now_ns();
+    if (sink == LOG_SINK_SYSLOG) {
+        openlog(ident, LOG_PID, LOG_USER);
+    }
+
+    atomic_store(&stop_drain, false);
+    if (pthread_create(&drain_thread, NULL, drain_main, NULL) != 0) {
+        perror("log drain thread");
+        return -1;
+    }
+    atomic_store_explicit(&draining, true, memory_order_release);
+    return 0;
+}
+
+void log_shutdown(void) {
+    if (!atomic_load(&draining)) {
+        return;
+    }
+    // Later calls format synchronously; the final drain picks up the rest
+    atomic_store_explicit(&draining, false, memory_order_release);
+    atomic_store(&stop_drain, true);
+    pthread_join(drain_thread, NULL);
+    if (log_sink == LOG_SINK_SYSLOG) {
+        closelog();
+    }
+}
+
+void log_set_level(int level) {
+    atomic_store_explicit(&runtime_level, level, memory_order_relaxed);
+}
+
+void log_get_stats(LogStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->records = atomic_load(&records_written);
+    int count = atomic_load_explicit(&ring_count, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        stats->dropped += atomic_load(&rings[i]->dropped);
+        stats->suppressed += atomic_load(&rings[i]->suppressed);
+    }
+}
@@ -19,15 +19,26 @@
 #include <stdbool.h>
 #include <unistd.h>
 #include <string.h>
-#include <fcntl.h>
-#include <termios.h>
 #include <errno.h>
 #include <math.h>
 #include <time.h>
-#include <ctype.h>
 #include "../include/st7789_rpi.h"
 #include "../include/mpu6050.h"
 #include "../include/gps.h"
+#include "../include/nav_filter.h"
+#include "../include/startup.h"
+#include "../include/render_pool.h"
+#include "../include/attitude_predictor.h"
+#include "../include/latency_test.h"
+#include "../include/serial_comm.h"
+#include "../include/serial_link.h"
+#include "../include/clock_sync.h"
+#include "../include/logger.h"
+#include "../include/trace.h"
+#include "../include/opensky_http.h"
+#include "notch_filter.h"
+#include "attitude_estimator.h"
+#include "track_table.h"
 
 // Define M_PI if not available
 #ifndef M_PI
@@ -35,26 +46,24 @@
 #endif
 
 // Serial configuration
-#define PICO_DEVICE "/dev/ttyACM0"
-#define BAUD_RATE B115200
-#define BUFFER_SIZE 256
 
 // Attitude indicator configuration
-#define SCREEN_CENTER_X (LCD_WIDTH / 2)
-#define SCREEN_CENTER_Y (LCD_HEIGHT / 2)
-#define HORIZON_BAR_WIDTH LCD_WIDTH // Full screen width
+#define SCREEN_CENTER_X (lcd_width() / 2)
+#define SCREEN_CENTER_Y (lcd_height() / 2)
+#define HORIZON_BAR_WIDTH lcd_width() // Full screen width
 #define HORIZON_BAR_HEIGHT 4
 #define PITCH_SCALE 2 // pixels per degree
 #define AIRCRAFT_SYMBOL_SIZE 40
 
 // Speed/Altitude tape configuration
 #define TAPE_WIDTH 15
-#define TAPE_HEIGHT LCD_HEIGHT // Full screen height
+#define TAPE_HEIGHT lcd_height() // Full screen height
 #define TAPE_MARGIN 5
 
 // Global variables
 static volatile bool running = true;
-static int serial_fd = -1;
+static SerialLink pico_link;
+static bool pico_link_ready = false; // Set once the startup task has been adopted
 static int mpu6050_fd = -1;
 static int gps_fd = -1;
 
@@ -66,33 +75,87 @@ typedef struct
 } AttitudeData;
 
 static AttitudeData attitude = {0.0f, 0.0f};
-static AttitudeData display_attitude = {0.0f, 0.0f}; // Interpolated attitude for display
+static AttitudeData display_attitude = {0.0f, 0.0f}; // Predicted attitude for display
 static AttitudeData last_drawn_attitude = {999.0f, 999.0f}; // Force initial draw
 
-// Low-pass filter - very light smoothing since MPU6050 has hardware DLPF
-// Alpha = 0.95 provides minimal smoothing, maximum responsiveness
-#define FILTER_ALPHA 0.95f
+// Gyro/accel fusion (engine chosen at build time, see attitude_estimator.h)
+#define GYRO_CAL_SAMPLES 100 // 0.5 s at 200 Hz, sensor must be still
+static AttitudeEstimator estimator;
+static float gyro_bias[3] = {0.0f, 0.0f, 0.0f}; // deg/s
+static unsigned long attitude_last_us = 0;
+
+// Low-pass filter - engine vibration is removed by the notch bank below,
+// so this only trims residual sensor noise (alpha close to 1 = almost no lag)
+#define FILTER_ALPHA 0.98f
 static AttitudeData filtered_attitude = {0.0f, 0.0f};
 static bool filter_initialized = false;
 
 // Update rates - optimized for smooth display
 #define SENSOR_UPDATE_MS 5      // 200 Hz sensor reading
+#define SENSOR_RATE_HZ (1000.0f / SENSOR_UPDATE_MS) // Estimator and notch sample rate
 #define DISPLAY_UPDATE_MS 16    // ~60 FPS display refresh (smooth animation)
+#define RENDER_STATS_MS 10000   // Band timing report period (PILOT_RENDER_STATS)
 #define GPS_UPDATE_MS 200       // 5 Hz update rate
 #define TELEMETRY_UPDATE_MS 3000  // Send telemetry to Pico every 3 seconds
 #define ARLANDA_LATITUDE 59.6519f
 #define ARLANDA_LONGITUDE 17.9186f
-#define TRAFFIC_UPDATE_MS 10000  // Refresh traffic every 10 seconds
-#define TRAFFIC_RADIUS_KM 25.0f
-#define MAX_TRAFFIC_AIRCRAFT 8
+#define MAX_TRAFFIC_AIRCRAFT 8    // Sent to the Pico per telemetry message
 #define TRAFFIC_JSON_SIZE 2048
-#define API_RESPONSE_SIZE 32768
-
-// Motion interpolation - smoothly interpolate between sensor readings
-#define INTERPOLATION_FACTOR 0.3f  // How quickly display catches up to sensor (0.3 = smooth but responsive)
+#define SPLASH_IMAGE "../images/output.png" // Relative to the build directory
+
+// Vibration notch banks on the accelerometer and gyro axes. At 200 Hz the
+// tracker can follow 20-90 Hz; faster engine vibration aliases into that
+// band and is tracked there just the same.
+#define NOTCH_ACCEL_MIN_LEVEL 1e-5f // g^2 in-band before the tracker adapts
+#define NOTCH_GYRO_MIN_LEVEL 0.05f  // (deg/s)^2 in-band before the tracker adapts
+static NotchFilterBank accel_notch;
+static NotchFilterBank gyro_notch;
+
+// Display-time prediction: the HUD shows the attitude extrapolated to when
+// the screen centre (horizon and aircraft symbol) reaches the panel
+#define PHOTON_DELAY_INIT_US 12000.0f // Until the first frames are measured
+#define PHOTON_DELAY_ALPHA 0.1f       // EMA weight of each measured frame
+static AttitudePredictor predictor;
+static float photon_delay_us = PHOTON_DELAY_INIT_US;
+static unsigned long frame_start_us = 0;
+
+// Sensor-to-panel latency: sample time to the end of the frame's flush.
+// PILOT_LATENCY=1 shows p50/p95/p99 on the HUD and logs them every 10 s;
+// PILOT_LATENCY_TEST=<p95 limit ms> runs the synthetic step test instead of
+// reading the IMU and exits with the result (see latency_test.h)
+#define LATENCY_BIN_US 250
+#define LATENCY_OVERLAY_MS 1000
+#define LATENCY_LOG_MS 10000
+#define LATENCY_TEST_STEPS 40
+#define LATENCY_TEST_STEP_DEG 30.0f
+#define LATENCY_TEST_PERIOD_US 500000UL
+#define LATENCY_PROBE_DX 100 // Column (right of centre) where the test reads the horizon back
+static LatencyHist frame_latency;
+static bool latency_overlay = false;
+static char latency_text[32] = "";
+static LatencyTest latency_test;
+static bool latency_test_enabled = false;
+
+// Pico clock mapping from "sync" pings over the serial link (clock_sync.h).
+// Telemetry carries its send time on the Pico clock ("t", 0 until locked),
+// which the Pico's "link" command turns into Pi -> Pico latency; with
+// PILOT_LATENCY the 10 s log adds one-way link latency and jitter
+#define CLOCK_SYNC_PING_MS 1000
+#define CLOCK_SYNC_FAST_PING_MS 100 // Until the mapping locks
+static ClockSync pico_clock;
 
 // GPS data
-static GPSData gps_data = {0.0f, 0.0f, false, 0, 0.0f, 0.0f};
+static GPSData gps_data = {0};
+
+// GPS/inertial fusion for the speed and altitude tapes
+#define KNOTS_TO_MPS 0.514444f
+static NavFilter nav;
+static unsigned nav_alt_seen = 0;
+static unsigned nav_speed_seen = 0;
+static unsigned long nav_last_predict_us = 0;
+static unsigned long nav_last_gps_ms = 0;
+#define NAV_GPS_TIMEOUT_MS 2000 // Without GPS updates the tapes fall back to raw GPS
+static FILE *nav_log = NULL; // Optional CSV recording (PILOT_NAV_LOG), see nav_filter.h
 
 // Attitude offsets for calibration
 static float pitch_offset = 0.0f;
@@ -101,7 +164,13 @@ static float roll_offset = 0.0f;
 // WiFi status
 static bool wifi_connected = false;
 static char traffic_json[TRAFFIC_JSON_SIZE] = "[]";
-static unsigned long last_traffic_update = 0;
+static TrackTable traffic_tracks; // Every aircraft seen, by icao24 (track_table.h)
+
+// OpenSky polling: cadence, box and credit budget from the scheduler.
+// PILOT_OPENSKY_CREDITS=<per day> for a registered account,
+// PILOT_OPENSKY_URL=<API root> to talk to a mock server instead
+static OpenSkyScheduler traffic_sched;
+static const char *opensky_url = OPENSKY_API_URL;
 
 /**
  * Check if WiFi is connected by checking if wlan0 has an IP address
@@ -126,310 +195,79 @@ bool check_wifi_status(void)
     return false;
 }
 
-static float haversine_km(float lat1, float lon1, float lat2, float lon2)
-{
-    const float earth_radius_km = 6371.0f;
-    float dlat = (lat2 - lat1) * 0.0174532925f;
-    float dlon = (lon2 - lon1) * 0.0174532925f;
-    float a = sinf(dlat * 0.5f) * sinf(dlat * 0.5f) +
-              cosf(lat1 * 0.0174532925f) * cosf(lat2 * 0.0174532925f) *
-                  sinf(dlon * 0.5f) * sinf(dlon * 0.5f);
-    float c = 2.0f * atan2f(sqrtf(a), sqrtf(1.0f - a));
-    return earth_radius_km * c;
-}
-
-static void trim_whitespace(char *s)
-{
-    if (!s || s[0] == '\0')
-    {
-        return;
-    }
-
-    char *start = s;
-    while (*start && isspace((unsigned char)*start))
-    {
-        start++;
-    }
-
-    char *end = start + strlen(start);
-    while (end > start && isspace((unsigned char)*(end - 1)))
-    {
-        end--;
-    }
-    *end = '\0';
-
-    if (start != s)
-    {
-        memmove(s, start, strlen(start) + 1);
-    }
-}
-
-static void trim_callsign(char *s)
-{
-    if (!s)
-    {
-        return;
-    }
-
-    trim_whitespace(s);
-    size_t len = strlen(s);
-    if (len >= 2 && s[0] == '"' && s[len - 1] == '"')
-    {
-        s[len - 1] = '\0';
-        memmove(s, s + 1, len - 1);
-    }
-    trim_whitespace(s);
-}
-
-static bool extract_state_field(const char *entry, int target_index, char *out, size_t out_size)
+/**
+ * Traffic JSON for the telemetry link: the aircraft reported by the last
+ * fetch (seen at now_ms), most recently updated first
+ */
+static void build_traffic_json(float center_lat, float center_lon, unsigned long now_ms, char *out_json, size_t out_size)
 {
-    if (!entry || !out || out_size == 0 || target_index < 0)
-    {
-        return false;
-    }
-
-    int field_index = 0;
-    const char *field_start = entry;
-    bool in_quotes = false;
-    bool escaped = false;
+    size_t out_used = (size_t)snprintf(out_json, out_size, "[");
+    int aircraft_count = 0;
 
-    for (const char *p = entry;; p++)
+    for (const Track *t = track_table_first(&traffic_tracks);
+         t && t->last_seen_ms == (uint32_t)now_ms && aircraft_count < MAX_TRAFFIC_AIRCRAFT;
+         t = track_table_next(&traffic_tracks, t))
     {
-        char c = *p;
-        bool at_end = (c == '\0');
-        bool is_separator = (!in_quotes && c == ',');
-
-        if (!at_end)
+        double lat = geo_udeg_to_deg(t->state.lat);
+        double lon = geo_udeg_to_deg(t->state.lon);
+        float dist = opensky_distance_km(center_lat, center_lon, lat, lon);
+        int written = snprintf(out_json + out_used, out_size - out_used,
+                               "%s{\"icao24\":\"%06x\",\"callsign\":\"%s\",\"lat\":%.6f,\"lon\":%.6f,\"heading\":%.1f,\"altitude\":%.1f,\"speed_knots\":%d,\"distance_km\":%.2f}",
+                               aircraft_count ? "," : "",
+                               (unsigned)t->icao24,
+                               t->callsign[0] ? t->callsign : "N/A",
+                               lat,
+                               lon,
+                               geo_heading_to_deg(t->state.heading),
+                               geo_alt_to_ft(t->state.alt) / 3.28084f,
+                               (int)t->state.speed_kt,
+                               dist);
+        if (written <= 0 || (size_t)written >= out_size - out_used - 1)
         {
-            if (escaped)
-            {
-                escaped = false;
-            }
-            else if (c == '\\')
-            {
-                escaped = true;
-            }
-            else if (c == '"')
-            {
-                in_quotes = !in_quotes;
-            }
-        }
-
-        if (is_separator || at_end)
-        {
-            if (field_index == target_index)
-            {
-                size_t len = (size_t)(p - field_start);
-                if (len >= out_size)
-                {
-                    len = out_size - 1;
-                }
-                memcpy(out, field_start, len);
-                out[len] = '\0';
-                trim_whitespace(out);
-                return (out[0] != '\0' && strcmp(out, "null") != 0);
-            }
-            if (at_end)
-            {
-                break;
-            }
-            field_index++;
-            field_start = p + 1;
+            break;
         }
+        out_used += (size_t)written;
+        aircraft_count++;
     }
 
-    return false;
-}
-
-static bool parse_float_field(const char *entry, int index, float *out_value)
-{
-    char field[64];
-    if (!extract_state_field(entry, index, field, sizeof(field)))
-    {
-        return false;
-    }
-
-    char *end_ptr = NULL;
-    float value = strtof(field, &end_ptr);
-    if (end_ptr == field)
-    {
-        return false;
-    }
-
-    *out_value = value;
-    return true;
+    snprintf(out_json + out_used, out_size - out_used, "]");
 }
 
-static int fetch_traffic_from_opensky(float center_lat, float center_lon, float radius_km, char *out_json, size_t out_size)
+static void update_traffic_cache(float center_lat, float center_lon, float ground_speed_kt, unsigned long current_time_ms)
 {
-    if (!out_json || out_size == 0)
-    {
-        return 0;
-    }
-
-    out_json[0] = '\0';
-
-    float delta_deg = radius_km / 111.0f;
-    char command[512];
-    snprintf(command, sizeof(command),
-             "curl -s --max-time 5 \"https://opensky-network.org/api/states/all?lamin=%.6f&lamax=%.6f&lomin=%.6f&lomax=%.6f\"",
-             center_lat - delta_deg, center_lat + delta_deg, center_lon - delta_deg, center_lon + delta_deg);
-
-    FILE *fp = popen(command, "r");
-    if (!fp)
-    {
-        snprintf(out_json, out_size, "[]");
-        return 0;
-    }
-
-    char response[API_RESPONSE_SIZE];
-    size_t used = 0;
-    while (used < sizeof(response) - 1)
-    {
-        size_t n = fread(response + used, 1, sizeof(response) - 1 - used, fp);
-        if (n == 0)
-        {
-            break;
-        }
-        used += n;
-    }
-    response[used] = '\0';
-    pclose(fp);
-
-    const char *states_key = strstr(response, "\"states\":");
-    if (!states_key)
-    {
-        snprintf(out_json, out_size, "[]");
-        return 0;
-    }
-
-    const char *states_start = strchr(states_key, '[');
-    if (!states_start)
-    {
-        snprintf(out_json, out_size, "[]");
-        return 0;
-    }
-
-    size_t out_used = 0;
-    out_used += snprintf(out_json + out_used, out_size - out_used, "[");
-
-    int aircraft_count = 0;
-    bool first = true;
-    int depth = 0;
-    const char *entry_start = NULL;
-
-    for (const char *p = states_start; *p != '\0'; p++)
+    if (!wifi_connected)
     {
-        if (*p == '[')
-        {
-            depth++;
-            if (depth == 2)
-            {
-                entry_start = p + 1;
-            }
-        }
-        else if (*p == ']')
-        {
-            if (depth == 2 && entry_start)
-            {
-                size_t entry_len = (size_t)(p - entry_start);
-                if (entry_len > 0 && entry_len < 2048)
-                {
-                    char entry[2048];
-                    memcpy(entry, entry_start, entry_len);
-                    entry[entry_len] = '\0';
-
-                    float lon = 0.0f;
-                    float lat = 0.0f;
-                    float heading = 0.0f;
-                    if (parse_float_field(entry, 5, &lon) &&
-                        parse_float_field(entry, 6, &lat) &&
-                        parse_float_field(entry, 10, &heading))
-                    {
-                        float dist = haversine_km(center_lat, center_lon, lat, lon);
-                        if (dist <= radius_km)
-                        {
-                            char callsign[64];
-                            if (!extract_state_field(entry, 1, callsign, sizeof(callsign)))
-                            {
-                                snprintf(callsign, sizeof(callsign), "N/A");
-                            }
-                            trim_callsign(callsign);
-                            if (callsign[0] == '\0')
-                            {
-                                snprintf(callsign, sizeof(callsign), "N/A");
-                            }
-
-                            float altitude = 0.0f;
-                            float velocity = 0.0f;
-                            parse_float_field(entry, 7, &altitude);
-                            parse_float_field(entry, 9, &velocity);
-                            int speed_knots = (int)(velocity * 1.94384f);
-
-                            int written = snprintf(out_json + out_used, out_size - out_used,
-                                                   "%s{\"callsign\":\"%s\",\"lat\":%.6f,\"lon\":%.6f,\"heading\":%.1f,\"altitude\":%.1f,\"speed_knots\":%d,\"distance_km\":%.2f}",
-                                                   first ? "" : ",",
-                                                   callsign,
-                                                   lat,
-                                                   lon,
-                                                   heading,
-                                                   altitude,
-                                                   speed_knots,
-                                                   dist);
-                            if (written <= 0 || (size_t)written >= out_size - out_used)
-                            {
-                                break;
-                            }
-                            out_used += (size_t)written;
-                            first = false;
-                            aircraft_count++;
-                            if (aircraft_count >= MAX_TRAFFIC_AIRCRAFT)
-                            {
-                                break;
-                            }
-                        }
-                    }
-                }
-                entry_start = NULL;
-            }
-            depth--;
-            if (depth <= 0)
-            {
-                break;
-            }
-        }
+        snprintf(traffic_json, sizeof(traffic_json), "[]");
+        return;
     }
 
-    if (out_used < out_size - 2)
-    {
-        out_used += snprintf(out_json + out_used, out_size - out_used, "]");
-    }
-    else
+    OpenSkyQuery query;
+    if (!opensky_sched_poll(&traffic_sched, (uint32_t)current_time_ms, center_lat, center_lon, ground_speed_kt, &query))
     {
-        snprintf(out_json, out_size, "[]");
-        return 0;
+        return; // Not due, backing off, or saving credits; the last traffic stays
     }
 
-    return aircraft_count;
-}
+    // Targets missing from this response and the one before are dropped
+    uint32_t max_age_ms = (uint32_t)current_time_ms - traffic_sched.last_response_ms;
 
-static void update_traffic_cache(float center_lat, float center_lon, unsigned long current_time_ms)
-{
-    if (current_time_ms - last_traffic_update < TRAFFIC_UPDATE_MS)
-    {
-        return;
-    }
-    last_traffic_update = current_time_ms;
+    OpenSkyResponse response;
+    TRACE_BEGIN("opensky fetch");
+    int count = opensky_http_fetch(opensky_url, &query, &traffic_tracks, (uint32_t)current_time_ms, &response);
+    TRACE_END("opensky fetch");
+    opensky_sched_result(&traffic_sched, (uint32_t)current_time_ms, &query, &response);
 
-    if (!wifi_connected)
+    if (response.result != OPENSKY_OK)
     {
-        snprintf(traffic_json, sizeof(traffic_json), "[]");
+        printf("Traffic update failed: HTTP %d%s, %u errors, %u rate limited\n",
+               response.http_status, response.result == OPENSKY_RATE_LIMITED ? " (rate limited)" : "",
+               traffic_sched.errors, traffic_sched.rate_limited);
         return;
     }
 
-    int count = fetch_traffic_from_opensky(center_lat, center_lon, TRAFFIC_RADIUS_KM, traffic_json, sizeof(traffic_json));
-    printf("Traffic update: %d aircraft within %.0f km (lat=%.5f lon=%.5f)\n",
-           count, TRAFFIC_RADIUS_KM, center_lat, center_lon);
+    track_table_expire(&traffic_tracks, (uint32_t)current_time_ms, max_age_ms);
+    build_traffic_json(center_lat, center_lon, current_time_ms, traffic_json, sizeof(traffic_json));
+    printf("Traffic update: %d aircraft within %.0f km, %u tracked, %u credits used, %.0f left in bucket\n",
+           count, query.radius_km, (unsigned)traffic_tracks.count, traffic_sched.credits_used, traffic_sched.tokens);
 }
 
 // Signal handler for Ctrl+C
@@ -439,61 +277,11 @@ void handle_sigint(int sig)
     running = false;
 }
 
-/**
- * Initialize serial port for Pico communication
- */
-static int serial_init(const char *device)
+// SIGUSR1: write the trace rings to TRACE_DUMP_DIR
+void handle_sigusr1(int sig)
 {
-    int fd;
-    struct termios options;
-
-    // Open serial port
-    fd = open(device, O_RDWR | O_NOCTTY);
-    if (fd < 0)
-    {
-        perror("Failed to open serial device");
-        return -1;
-    }
-
-    // Get current options
-    if (tcgetattr(fd, &options) < 0)
-    {
-        perror("Failed to get serial attributes");
-        close(fd);
-        return -1;
-    }
-
-    // Set baud rate
-    cfsetispeed(&options, BAUD_RATE);
-    cfsetospeed(&options, BAUD_RATE);
-
-    // Configure for raw input
-    options.c_cflag |= (CLOCAL | CREAD);
-    options.c_cflag &= ~PARENB;
-    options.c_cflag &= ~CSTOPB;
-    options.c_cflag &= ~CSIZE;
-    options.c_cflag |= CS8;
-    options.c_cflag &= ~CRTSCTS;
-
-    options.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
-    options.c_iflag &= ~(IXON | IXOFF | IXANY);
-    options.c_iflag &= ~(INLCR | ICRNL);
-    options.c_oflag &= ~OPOST;
-
-    // Set to non-blocking (no timeout)
-    options.c_cc[VMIN] = 0;
-    options.c_cc[VTIME] = 0;
-
-    // Apply options
-    if (tcsetattr(fd, TCSANOW, &options) < 0)
-    {
-        perror("Failed to set serial attributes");
-        close(fd);
-        return -1;
-    }
-
-    tcflush(fd, TCIOFLUSH);
-    return fd;
+    (void)sig;
+    trace_request_dump();
 }
 
 /**
@@ -531,8 +319,8 @@ void draw_pitch_ladder(float pitch, float roll)
         int y2 = center_y + (int)(line_len_f * sin_roll + y_offset_f * cos_roll);
 
         // Quick bounds check - just verify it's somewhat on screen
-        if ((x1 >= -50 && x1 < LCD_WIDTH + 50 && y1 >= -50 && y1 < LCD_HEIGHT + 50) ||
-            (x2 >= -50 && x2 < LCD_WIDTH + 50 && y2 >= -50 && y2 < LCD_HEIGHT + 50))
+        if ((x1 >= -50 && x1 < lcd_width() + 50 && y1 >= -50 && y1 < lcd_height() + 50) ||
+            (x2 >= -50 && x2 < lcd_width() + 50 && y2 >= -50 && y2 < lcd_height() + 50))
         {
             lcd_fb_draw_line(x1, y1, x2, y2, color);
 
@@ -549,11 +337,11 @@ void draw_pitch_ladder(float pitch, float roll)
                 int text_x2 = x2 + 5;
                 int text_y2 = y2 - 3;
 
-                if (text_x1 >= 0 && text_x1 < LCD_WIDTH - 20 && text_y1 >= 0 && text_y1 < LCD_HEIGHT - 10)
+                if (text_x1 >= 0 && text_x1 < lcd_width() - 20 && text_y1 >= 0 && text_y1 < lcd_height() - 10)
                 {
                     lcd_fb_draw_string(text_x1, text_y1, pitch_str, color, COLOR_BLACK);
                 }
-                if (text_x2 >= 0 && text_x2 < LCD_WIDTH - 20 && text_y2 >= 0 && text_y2 < LCD_HEIGHT - 10)
+                if (text_x2 >= 0 && text_x2 < lcd_width() - 20 && text_y2 >= 0 && text_y2 < lcd_height() - 10)
                 {
                     lcd_fb_draw_string(text_x2, text_y2, pitch_str, color, COLOR_BLACK);
                 }
@@ -652,7 +440,7 @@ void draw_roll_indicator(float roll)
 void draw_speed_tape(float speed_knots)
 {
     // Position tape at right edge of screen, full height
-    uint16_t x = LCD_WIDTH - TAPE_WIDTH;
+    uint16_t x = lcd_width() - TAPE_WIDTH;
     uint16_t y = 0;
 
     // Draw tape background
@@ -673,7 +461,7 @@ void draw_speed_tape(float speed_knots)
         float offset = (mark_speed - speed_knots) * 3; // 3 pixels per knot
         int mark_y = SCREEN_CENTER_Y + (int)offset;
 
-        if (mark_y >= 0 && mark_y < LCD_HEIGHT)
+        if (mark_y >= 0 && mark_y < lcd_height())
         {
             // Draw tick mark - longer for 10 knot increments
             int tick_len = (mark_speed % 10 == 0) ? 8 : 5;
@@ -709,7 +497,7 @@ void draw_altitude_tape(float altitude_meters)
         float offset = (mark_alt - altitude_meters) * 2; // 2 pixels per meter
         int mark_y = SCREEN_CENTER_Y + (int)offset;
 
-        if (mark_y >= 0 && mark_y < LCD_HEIGHT)
+        if (mark_y >= 0 && mark_y < lcd_height())
         {
             // Draw tick mark - longer for 20 meter increments
             int tick_len = (mark_alt % 20 == 0) ? 8 : 5;
@@ -721,26 +509,167 @@ void draw_altitude_tape(float altitude_meters)
 }
 
 /**
- * Draw complete attitude indicator
- * Uses framebuffer for smooth, flicker-free updates with interpolation
+ * Draw vertical speed bar and readout next to the altitude tape
  */
-void draw_attitude_indicator(void)
+void draw_vsi(float vs_mps)
+{
+    int x = TAPE_WIDTH + 3;
+    int len = (int)(vs_mps * 10.0f); // 10 pixels per m/s
+    if (len > 60)
+        len = 60;
+    if (len < -60)
+        len = -60;
+
+    uint16_t color = (vs_mps >= 0.0f) ? COLOR_GREEN : COLOR_YELLOW;
+    if (len > 0)
+    {
+        lcd_fb_fill_rect(x, SCREEN_CENTER_Y - len, 3, len, color);
+    }
+    else if (len < 0)
+    {
+        lcd_fb_fill_rect(x, SCREEN_CENTER_Y, 3, -len, color);
+    }
+
+    char text[12];
+    snprintf(text, sizeof(text), "%+.1f", vs_mps);
+    lcd_fb_draw_string(x + 6, lcd_height() - 20, text, color, COLOR_BLACK);
+}
+
+static unsigned long monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000UL + ts.tv_nsec / 1000;
+}
+
+/**
+ * Estimator orientation to HUD pitch/roll (degrees, calibration applied)
+ * The HUD uses the accelerometer convention (pitch = atan2(x, z),
+ * roll = atan2(y, z)): estimator pitch is mirrored, roll matches.
+ */
+static AttitudeData attitude_from_quaternion(const Quaternion *q)
+{
+    const float r2d = 180.0f / (float)M_PI;
+    float roll, pitch, yaw;
+    quaternion_to_euler(q, &roll, &pitch, &yaw);
+
+    AttitudeData a;
+    a.pitch = -pitch * r2d + pitch_offset;
+    a.roll = roll * r2d + roll_offset;
+    return a;
+}
+
+/**
+ * Roll actually drawn, read back from the framebuffer: the row of the cyan
+ * horizon bar LATENCY_PROBE_DX pixels right of centre (latency test only;
+ * the pitch ladder never reaches that column)
+ */
+static bool probe_drawn_roll(float pitch, float *roll)
+{
+    const uint16_t *fb = lcd_get_displayed_framebuffer();
+    int x = SCREEN_CENTER_X + LATENCY_PROBE_DX;
+    int first = -1, last = -1;
+    for (int y = 0; y < lcd_height(); y++)
+    {
+        if (fb[y * lcd_width() + x] == COLOR_CYAN)
+        {
+            if (first < 0)
+                first = y;
+            last = y;
+        }
+    }
+    if (first < 0)
+    {
+        return false;
+    }
+
+    // The bar spans offsets -2..+1 around the horizon line
+    int horizon_y = SCREEN_CENTER_Y - (int)(pitch * PITCH_SCALE);
+    float dy = (first + last) * 0.5f + 0.5f - horizon_y;
+    *roll = atan2f(dy, LATENCY_PROBE_DX) * 180.0f / (float)M_PI - roll_offset;
+    return true;
+}
+
+/**
+ * Update the overlay text and log the percentiles (PILOT_LATENCY)
+ */
+static void latency_report(bool log)
+{
+    LatencySummary s;
+    latency_hist_summary(&frame_latency, &s);
+    if (s.count == 0)
+    {
+        return;
+    }
+    snprintf(latency_text, sizeof(latency_text), "LAT %.1f/%.1f/%.1f",
+             s.p50_us / 1000.0f, s.p95_us / 1000.0f, s.p99_us / 1000.0f);
+    if (log)
+    {
+        printf("Latency %u frames: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms (max %.1f ms)\n",
+               s.count, s.p50_us / 1000.0f, s.p95_us / 1000.0f, s.p99_us / 1000.0f,
+               s.max_us / 1000.0f);
+        latency_hist_reset(&frame_latency);
+    }
+}
+
+/**
+ * Send a finished band to the panel and time when the screen centre lands
+ */
+static void flush_hud_band(uint16_t y0, uint16_t y1)
 {
-    // Smooth interpolation: gradually move display toward actual sensor reading
-    // This creates fluid motion between sensor updates
-    display_attitude.pitch += (attitude.pitch - display_attitude.pitch) * INTERPOLATION_FACTOR;
-    display_attitude.roll += (attitude.roll - display_attitude.roll) * INTERPOLATION_FACTOR;
+    TRACE_BEGIN("spi flush");
+    lcd_display_framebuffer_rows(y0, y1);
+    TRACE_END("spi flush");
+    if (y0 <= SCREEN_CENTER_Y && SCREEN_CENTER_Y < y1)
+    {
+        float delay = (float)(monotonic_us() - frame_start_us);
+        photon_delay_us += PHOTON_DELAY_ALPHA * (delay - photon_delay_us);
+        TRACE_COUNTER("photon delay us", photon_delay_us);
+    }
+}
+
+// Per-frame values shared by all bands, computed once on the main thread
+typedef struct
+{
+    AttitudeData display;   // Predicted attitude
+    AttitudeData warn;      // Latest sensor attitude (warnings)
+    float speed_knots;
+    float altitude_m;
+    float bank_limit;
+    unsigned long sample_us; // Time of the newest IMU sample in this frame
+    const char *latency_text; // Overlay, or NULL
+} HudFrame;
+
+/**
+ * Draw the HUD into the rows [y0, y1) of the framebuffer
+ * Runs on the render pool threads; only reads the frame and globals the main
+ * thread leaves alone while render_pool_frame() runs.
+ */
+static void render_hud_band(void *arg, uint16_t y0, uint16_t y1)
+{
+    const HudFrame *frame = arg;
+    (void)y0;
+    (void)y1; // The framebuffer clip rows already restrict drawing to the band
 
     // Clear framebuffer to black
     lcd_fb_clear(COLOR_BLACK);
 
     // Draw components using interpolated attitude for smooth motion
-    draw_pitch_ladder(display_attitude.pitch, display_attitude.roll);
-    draw_horizon(display_attitude.pitch, display_attitude.roll);
-    draw_speed_tape(gps_data.speed_knots);
-    draw_altitude_tape(gps_data.altitude_meters);
+    draw_pitch_ladder(frame->display.pitch, frame->display.roll);
+    draw_horizon(frame->display.pitch, frame->display.roll);
+    draw_speed_tape(frame->speed_knots);
+    draw_altitude_tape(frame->altitude_m);
+    if (nav.alt_valid)
+    {
+        draw_vsi(nav.vs_mps);
+    }
     draw_aircraft_symbol();
-    draw_roll_indicator(display_attitude.roll);
+    draw_roll_indicator(frame->display.roll);
+
+    if (frame->latency_text)
+    {
+        lcd_fb_draw_string(TAPE_WIDTH + 6, 2, frame->latency_text, COLOR_WHITE, COLOR_BLACK);
+    }
 
     // Draw GPS fix status
     if (gps_data.has_fix)
@@ -753,36 +682,32 @@ void draw_attitude_indicator(void)
     }
 
     // Draw pitch warning if exceeding ±20 degrees
-    if (fabs(attitude.pitch) > 20.0f)
+    if (fabs(frame->warn.pitch) > 20.0f)
     {
         // Red warning box at bottom center
         int warning_width = 120;
         int warning_height = 30;
         int warning_x = SCREEN_CENTER_X - warning_width / 2;
-        int warning_y = LCD_HEIGHT - warning_height - 10;
+        int warning_y = lcd_height() - warning_height - 10;
 
         // Draw red background box
         lcd_fb_fill_rect(warning_x, warning_y, warning_width, warning_height, COLOR_RED);
 
         // Draw warning text
         char warning_text[20];
-        if (attitude.pitch > 20.0f)
+        if (frame->warn.pitch > 20.0f)
         {
-            snprintf(warning_text, sizeof(warning_text), "PITCH UP %.0f", attitude.pitch);
+            snprintf(warning_text, sizeof(warning_text), "PITCH UP %.0f", frame->warn.pitch);
         }
         else
         {
-            snprintf(warning_text, sizeof(warning_text), "PITCH DN %.0f", fabs(attitude.pitch));
+            snprintf(warning_text, sizeof(warning_text), "PITCH DN %.0f", fabs(frame->warn.pitch));
         }
         lcd_fb_draw_string(warning_x + 5, warning_y + 10, warning_text, COLOR_WHITE, COLOR_RED);
     }
 
     // Draw bank/roll warning - threshold depends on speed
-    // Low speed (≤85 knots): 20° bank limit (stall prevention)
-    // Higher speed (>85 knots): 30° bank limit
-    float bank_limit = (gps_data.speed_knots <= 85.0f) ? 20.0f : 30.0f;
-
-    if (fabs(attitude.roll) > bank_limit)
+    if (fabs(frame->warn.roll) > frame->bank_limit)
     {
         // Red warning box at top center
         int warning_width = 120;
@@ -795,41 +720,181 @@ void draw_attitude_indicator(void)
 
         // Draw warning text
         char warning_text[20];
-        if (attitude.roll > bank_limit)
+        if (frame->warn.roll > frame->bank_limit)
         {
-            snprintf(warning_text, sizeof(warning_text), "BANK R %.0f", attitude.roll);
+            snprintf(warning_text, sizeof(warning_text), "BANK R %.0f", frame->warn.roll);
         }
         else
         {
-            snprintf(warning_text, sizeof(warning_text), "BANK L %.0f", fabs(attitude.roll));
+            snprintf(warning_text, sizeof(warning_text), "BANK L %.0f", fabs(frame->warn.roll));
         }
         lcd_fb_draw_string(warning_x + 5, warning_y + 10, warning_text, COLOR_WHITE, COLOR_RED);
     }
+}
+
+/**
+ * Draw complete attitude indicator
+ * Uses framebuffer for smooth, flicker-free updates with interpolation.
+ * Bands are drawn in parallel by the render pool and each band goes to the
+ * panel as soon as it (and every band above it) is done.
+ */
+void draw_attitude_indicator(void)
+{
+    // Predict the attitude for the moment this frame is seen, from the
+    // measured render + flush delay of the previous frames
+    frame_start_us = monotonic_us();
+    Quaternion q_pred;
+    if (attitude_predictor_predict(&predictor, frame_start_us + (unsigned long)photon_delay_us, &q_pred))
+    {
+        display_attitude = attitude_from_quaternion(&q_pred);
+    }
+    else
+    {
+        display_attitude = attitude;
+    }
+
+    HudFrame frame;
+    frame.display = display_attitude;
+    frame.warn = attitude;
+    // Tapes use the GPS/inertial filter once it has a fix, raw GPS otherwise
+    frame.speed_knots = nav.speed_valid ? fmaxf(nav.speed_mps, 0.0f) / KNOTS_TO_MPS : gps_data.speed_knots;
+    frame.altitude_m = nav.alt_valid ? nav.alt_m : gps_data.altitude_meters;
+    // Low speed (≤85 knots): 20° bank limit (stall prevention)
+    // Higher speed (>85 knots): 30° bank limit
+    frame.bank_limit = (frame.speed_knots <= 85.0f) ? 20.0f : 30.0f;
+    frame.sample_us = predictor.t_us;
+    frame.latency_text = (latency_overlay && latency_text[0]) ? latency_text : NULL;
+
+    render_pool_frame(render_hud_band, &frame, flush_hud_band);
+
+    unsigned long flushed_us = monotonic_us();
+    if (predictor.valid)
+    {
+        latency_hist_add(&frame_latency, (uint32_t)(flushed_us - frame.sample_us));
+    }
+    float drawn_roll;
+    if (latency_test_enabled && probe_drawn_roll(frame.display.pitch, &drawn_roll) &&
+        latency_test_frame(&latency_test, drawn_roll, flushed_us))
+    {
+        running = false;
+    }
 
     // Update last drawn state
     last_drawn_attitude = attitude;
+}
+
+/**
+ * Average the gyro at rest to remove its zero-rate offset
+ */
+void calibrate_gyro_bias(int fd)
+{
+    float sum[3] = {0.0f, 0.0f, 0.0f};
+    int n = 0;
 
-    // Display framebuffer to screen (single SPI transfer)
-    lcd_display_framebuffer();
+    for (int i = 0; i < GYRO_CAL_SAMPLES; i++)
+    {
+        float gx, gy, gz;
+        if (mpu6050_read_gyro(fd, &gx, &gy, &gz) == 0)
+        {
+            sum[0] += gx;
+            sum[1] += gy;
+            sum[2] += gz;
+            n++;
+        }
+        usleep(SENSOR_UPDATE_MS * 1000);
+    }
+
+    if (n > 0)
+    {
+        for (int i = 0; i < 3; i++)
+            gyro_bias[i] = sum[i] / n;
+    }
+    printf("Gyro bias: X=%.2f Y=%.2f Z=%.2f deg/s (%d samples)\n",
+           gyro_bias[0], gyro_bias[1], gyro_bias[2], n);
 }
 
 /**
- * Update attitude from MPU-6050 sensor with low-pass filter for vibration rejection
- * Returns: true if attitude changed significantly
+ * Update attitude from MPU-6050 gyro and accelerometer through the attitude estimator
+ * Returns: true if a new sample was processed
  */
 bool update_attitude_from_sensor(void)
 {
     float x_g, y_g, z_g;
+    float gx, gy, gz;
     float raw_pitch, raw_roll;
 
-    // Read accelerometer data
-    if (mpu6050_read_accel(mpu6050_fd, &x_g, &y_g, &z_g) < 0)
+    // Read accelerometer and gyro data (synthetic steps in the latency test)
+    if (latency_test_enabled)
+    {
+        float accel_g[3], gyro_dps[3];
+        latency_test_sample(&latency_test, monotonic_us(), accel_g, gyro_dps);
+        x_g = accel_g[0];
+        y_g = accel_g[1];
+        z_g = accel_g[2];
+        gx = gyro_dps[0];
+        gy = gyro_dps[1];
+        gz = gyro_dps[2];
+    }
+    else if (mpu6050_read_accel(mpu6050_fd, &x_g, &y_g, &z_g) < 0 ||
+             mpu6050_read_gyro(mpu6050_fd, &gx, &gy, &gz) < 0)
     {
         return false;
     }
 
-    // Calculate pitch and roll from raw sensor data
-    mpu6050_calculate_attitude(x_g, y_g, z_g, &raw_pitch, &raw_roll);
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    unsigned long now_us = ts.tv_sec * 1000000UL + ts.tv_nsec / 1000;
+
+    // Remove engine/propeller vibration before fusion
+    float accel_ch[3] = {x_g, y_g, z_g};
+    float gyro_ch[3] = {gx, gy, gz};
+    notch_bank_apply(&accel_notch, accel_ch);
+    notch_bank_apply(&gyro_notch, gyro_ch);
+    x_g = accel_ch[0];
+    y_g = accel_ch[1];
+    z_g = accel_ch[2];
+    const float d2r = (float)M_PI / 180.0f;
+
+    if (!filter_initialized)
+    {
+        // Seed from the accelerometer so the estimator does not have to slew from level
+        Quaternion q0;
+        quaternion_from_euler(&q0, atan2f(y_g, z_g), atan2f(-x_g, sqrtf(y_g * y_g + z_g * z_g)), 0.0f);
+        estimator_set_quaternion(&estimator, &q0);
+    }
+    else
+    {
+        float dt = (now_us - attitude_last_us) / 1000000.0f;
+        if (dt <= 0.0f || dt > 0.1f)
+            dt = SENSOR_UPDATE_MS / 1000.0f;
+
+        estimator_update_imu(&estimator, dt,
+                             (gyro_ch[0] - gyro_bias[0]) * d2r,
+                             (gyro_ch[1] - gyro_bias[1]) * d2r,
+                             (gyro_ch[2] - gyro_bias[2]) * d2r,
+                             x_g, y_g, z_g);
+    }
+    attitude_last_us = now_us;
+
+    // Estimator angles to the accelerometer convention used here
+    // (pitch = atan2(x, z), roll = atan2(y, z)): pitch is mirrored, roll matches
+    float est_roll, est_pitch, est_yaw;
+    estimator_get_euler_deg(&estimator, &est_roll, &est_pitch, &est_yaw);
+    if (!isfinite(est_roll) || !isfinite(est_pitch))
+    {
+        estimator_init(&estimator, SENSOR_RATE_HZ);
+        attitude_predictor_init(&predictor);
+        filter_initialized = false;
+        return false;
+    }
+
+    attitude_predictor_update(&predictor, now_us, &estimator.q,
+                              (gyro_ch[0] - gyro_bias[0]) * d2r,
+                              (gyro_ch[1] - gyro_bias[1]) * d2r,
+                              (gyro_ch[2] - gyro_bias[2]) * d2r);
+
+    raw_pitch = -est_pitch;
+    raw_roll = est_roll;
 
     // Apply calibration offsets to raw data
     raw_pitch += pitch_offset;
@@ -854,9 +919,69 @@ bool update_attitude_from_sensor(void)
     attitude.pitch = filtered_attitude.pitch;
     attitude.roll = filtered_attitude.roll;
 
+    // Propagate speed/altitude with the accelerometer rotated to the level frame
+    float dt = nav_last_predict_us ? (now_us - nav_last_predict_us) / 1000000.0f : 0.0f;
+    nav_last_predict_us = now_us;
+
+    float accel_g[3] = {x_g, y_g, z_g};
+    float up[3];
+    quaternion_up_vector(&estimator.q, up);
+    nav_filter_predict(&nav, accel_g, up, dt);
+
+    if (nav_log)
+    {
+        fprintf(nav_log, "%.6f,%.5f,%.5f,%.5f,%.5f,%.5f,%.5f,,\n",
+                now_us / 1000000.0, x_g, y_g, z_g, up[0], up[1], up[2]);
+    }
+
     return true;
 }
 
+/**
+ * Feed fresh GPS altitude/speed into the navigation filter. Called every GPS
+ * period: without a fix, or with no update for NAV_GPS_TIMEOUT_MS, the filter
+ * is reset so dead reckoning on the accelerometer does not drift on screen.
+ */
+static void update_nav_from_gps(unsigned long now_ms)
+{
+    bool new_alt = gps_data.altitude_updates != nav_alt_seen;
+    bool new_speed = gps_data.speed_updates != nav_speed_seen;
+    nav_alt_seen = gps_data.altitude_updates;
+    nav_speed_seen = gps_data.speed_updates;
+
+    if (gps_data.has_fix && (new_alt || new_speed))
+    {
+        nav_last_gps_ms = now_ms;
+    }
+    if (!gps_data.has_fix || now_ms - nav_last_gps_ms > NAV_GPS_TIMEOUT_MS)
+    {
+        nav_filter_reset(&nav);
+        return;
+    }
+
+    if (new_alt)
+    {
+        nav_filter_update_altitude(&nav, gps_data.altitude_meters);
+    }
+    if (new_speed)
+    {
+        nav_filter_update_speed(&nav, gps_data.speed_knots * KNOTS_TO_MPS);
+    }
+
+    if (nav_log && (new_alt || new_speed))
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        fprintf(nav_log, "%.6f,,,,,,,", ts.tv_sec + ts.tv_nsec / 1e9);
+        if (new_alt)
+            fprintf(nav_log, "%.2f", gps_data.altitude_meters);
+        fputc(',', nav_log);
+        if (new_speed)
+            fprintf(nav_log, "%.3f", gps_data.speed_knots * KNOTS_TO_MPS);
+        fputc('\n', nav_log);
+    }
+}
+
 /**
  * Parse button message from Pico
  * Format: BTN:<button_name>:PRESSED or BTN:<button_name>:RELEASED
@@ -910,22 +1035,22 @@ void parse_cmd_message(const char *message)
     {
         int offset_value = atoi(cmd + 13);
         pitch_offset = (float)offset_value;
-        printf("Pitch offset set to: %.1f degrees\n", pitch_offset);
+        LOGI("Pitch offset set to: %.1f degrees", pitch_offset);
     }
     else if (strncmp(cmd, "OFFSET:ROLL:", 12) == 0)
     {
         int offset_value = atoi(cmd + 12);
         roll_offset = (float)offset_value;
-        printf("Roll offset set to: %.1f degrees\n", roll_offset);
+        LOGI("Roll offset set to: %.1f degrees", roll_offset);
     }
     else if (strcmp(cmd, "OFFSET_MODE") == 0)
     {
-        printf("Entering offset adjustment mode\n");
+        LOGI("Entering offset adjustment mode");
     }
     else if (strcmp(cmd, "OFFSET_EXIT") == 0)
     {
-        printf("Exiting offset adjustment mode\n");
-        printf("Final offsets - Pitch: %.1f, Roll: %.1f\n", pitch_offset, roll_offset);
+        LOGI("Exiting offset adjustment mode, final offsets pitch %.1f roll %.1f",
+             pitch_offset, roll_offset);
     }
 }
 
@@ -935,7 +1060,7 @@ void parse_cmd_message(const char *message)
  */
 void send_telemetry_to_pico(void)
 {
-    if (serial_fd < 0)
+    if (!pico_link_ready || !serial_link_connected(&pico_link))
     {
         return; // No serial connection
     }
@@ -950,15 +1075,16 @@ void send_telemetry_to_pico(void)
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
     unsigned long now_ms = ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
-    update_traffic_cache(telemetry_lat, telemetry_lon, now_ms);
+    update_traffic_cache(telemetry_lat, telemetry_lon, gps_data.has_fix ? gps_data.speed_knots : 0.0f, now_ms);
 
     // Build JSON telemetry string
     char telemetry[4096];
     snprintf(telemetry, sizeof(telemetry),
-             "{\"own\":{\"lat\":%.6f,\"lon\":%.6f,\"alt\":%.1f,\"pitch\":%.1f,\"roll\":%.1f,\"yaw\":0.0},"
+             "{\"t\":%llu,\"own\":{\"lat\":%.6f,\"lon\":%.6f,\"alt\":%.1f,\"pitch\":%.1f,\"roll\":%.1f,\"yaw\":0.0},"
              "\"traffic\":%s,"
              "\"status\":{\"wifi\":%s,\"gps\":%s,\"bluetooth\":false},"
              "\"warnings\":{\"bank\":%s,\"pitch\":%s}}\n",
+             pico_clock.locked ? (unsigned long long)clock_sync_pi_to_pico(&pico_clock, clock_sync_now_us()) : 0ULL,
              telemetry_lat,
              telemetry_lon,
              telemetry_alt,
@@ -970,168 +1096,406 @@ void send_telemetry_to_pico(void)
              bank_warning ? "true" : "false",
              pitch_warning ? "true" : "false");
 
-    // Display telemetry in terminal
-    printf("\n[TELEMETRY SENT]\n");
-    printf("  Attitude: Pitch=%.1f° Roll=%.1f°\n", attitude.pitch, attitude.roll);
-    printf("  Status: GPS=%s WiFi=%s\n",
-           gps_data.has_fix ? "OK" : "NO_FIX",
-           wifi_connected ? "OK" : "OFF");
-    printf("  Warnings: BANK=%s (limit=%.0f°) PITCH=%s\n",
-           bank_warning ? "ACTIVE" : "off",
-           bank_limit,
-           pitch_warning ? "ACTIVE" : "off");
-    printf("  Speed: %.1f knots\n", gps_data.speed_knots);
-    printf("  JSON: %s", telemetry);
+    // Logged off-thread; the JSON itself only in debug builds (LOG_LEVEL=debug)
+    LOGI("Telemetry sent: pitch %.1f° roll %.1f° GPS %s WiFi %s bank %s (limit %.0f°) pitch %s speed %.1f kt",
+         attitude.pitch, attitude.roll,
+         gps_data.has_fix ? "OK" : "NO_FIX",
+         wifi_connected ? "OK" : "OFF",
+         bank_warning ? "ACTIVE" : "off",
+         bank_limit,
+         pitch_warning ? "ACTIVE" : "off",
+         gps_data.speed_knots);
+    LOGD("Telemetry JSON: %s", telemetry);
 
     // Send to Pico via serial
-    write(serial_fd, telemetry, strlen(telemetry));
+    serial_link_write(&pico_link, telemetry, strlen(telemetry));
 }
 
 /**
- * Process serial input from Pico (non-blocking, time-limited)
+ * Process serial input from Pico (non-blocking)
+ * The link drains the tty in large reads; every complete line is handled.
  */
 void process_serial_input(void)
 {
-    static char buffer[BUFFER_SIZE];
-    static int buf_pos = 0;
-    char c;
-    int chars_read = 0;
-    const int MAX_CHARS_PER_CALL = 32; // Limit processing to prevent blocking
+    int events = serial_link_service(&pico_link);
+    uint64_t arrived_us = clock_sync_now_us();
+    if (events & (SERIAL_LINK_EV_CONNECTED | SERIAL_LINK_EV_DISCONNECTED))
+    {
+        clock_sync_init(&pico_clock); // A replugged Pico has a new clock
+    }
+    if (events & SERIAL_LINK_EV_CONNECTED)
+    {
+        LOGI("Pico connected on %s", pico_link.device);
+    }
+    if (events & SERIAL_LINK_EV_DISCONNECTED)
+    {
+        LOGW("Pico disconnected, waiting for it to come back");
+    }
 
-    // Read up to MAX_CHARS_PER_CALL characters to prevent blocking for too long
-    while (chars_read < MAX_CHARS_PER_CALL && read(serial_fd, &c, 1) > 0)
+    const char *line;
+    while ((line = serial_link_next_line(&pico_link, NULL)) != NULL)
     {
-        chars_read++;
+        if (clock_sync_handle_reply(&pico_clock, line, arrived_us))
+        {
+            continue;
+        }
 
-        if (c == '\n' || c == '\r')
+        // Parse CMD messages first
+        parse_cmd_message(line);
+
+        // Parse button press for controls
+        const char *button = parse_button_press(line);
+        if (button)
         {
-            if (buf_pos > 0)
+            LOGI("Button: %s", button);
+
+            // Exit on key4
+            if (strcmp(button, "key4") == 0)
             {
-                buffer[buf_pos] = '\0';
+                LOGI("Exit requested");
+                running = false;
+            }
+            // Other buttons could be used for menu navigation, etc.
+        }
+    }
+}
 
-                // Parse CMD messages first
-                parse_cmd_message(buffer);
+/**
+ * Main application
+ */
+// ── Startup tasks (worker threads, see startup.h) ────────────────────────────
+// Each returns its file descriptor (or status); main adopts the result. The
+// IMU task also fills gyro_bias, which main reads only after waiting for it.
 
-                // Parse button press for controls
-                const char *button = parse_button_press(buffer);
-                if (button)
-                {
-                    printf("Button: %s\n", button);
-
-                    // Exit on key4
-                    if (strcmp(button, "key4") == 0)
-                    {
-                        printf("Exit requested\n");
-                        running = false;
-                    }
-                    // Other buttons could be used for menu navigation, etc.
-                }
+static int imu_bringup(void *arg)
+{
+    (void)arg;
+    printf("Initializing MPU-6050 IMU...\n");
+    int fd = mpu6050_init();
+    if (fd >= 0)
+    {
+        calibrate_gyro_bias(fd);
+    }
+    return fd;
+}
 
-                buf_pos = 0;
-            }
+static int serial_bringup(void *arg)
+{
+    (void)arg;
+    printf("Connecting to Pico...\n");
+    return serial_link_init(&pico_link, NULL, 0);
+}
+
+static int gps_bringup(void *arg)
+{
+    (void)arg;
+    printf("Initializing GPS module...\n");
+    return gps_init();
+}
+
+static int wifi_bringup(void *arg)
+{
+    (void)arg;
+    return check_wifi_status();
+}
+
+/**
+ * Adopt results of finished startup tasks (once each)
+ * Returns true when all of them have been adopted.
+ */
+static bool adopt_startup_results(StartupTask *serial_task, StartupTask *gps_task, StartupTask *wifi_task)
+{
+    static bool serial_adopted = false, gps_adopted = false, wifi_adopted = false;
+
+    if (!serial_adopted && startup_task_done(serial_task))
+    {
+        pico_link_ready = startup_task_wait(serial_task) == 0;
+        serial_adopted = true;
+        if (pico_link_ready && serial_link_connected(&pico_link))
+        {
+            printf("✓ Connected to Pico on %s\n", pico_link.device);
+        }
+        else
+        {
+            fprintf(stderr, "⚠ Pico not connected%s\n",
+                    pico_link_ready ? ", it will be picked up when plugged in" : "");
+            fprintf(stderr, "⚠ Continuing without Pico (attitude indicator will still work)\n");
         }
-        else if (buf_pos < BUFFER_SIZE - 1)
+    }
+
+    if (!gps_adopted && startup_task_done(gps_task))
+    {
+        gps_fd = startup_task_wait(gps_task);
+        gps_adopted = true;
+        if (gps_fd >= 0)
         {
-            buffer[buf_pos++] = c;
+            printf("✓ GPS initialized\n");
         }
         else
         {
-            // Buffer overflow - reset
-            buf_pos = 0;
+            fprintf(stderr, "Warning: Failed to initialize GPS\n");
+            fprintf(stderr, "Continuing without GPS data\n");
         }
     }
+
+    if (!wifi_adopted && startup_task_done(wifi_task))
+    {
+        wifi_connected = startup_task_wait(wifi_task) > 0;
+        wifi_adopted = true;
+        printf(wifi_connected ? "✓ WiFi connected\n" : "⚠ WiFi not connected\n");
+    }
+
+    return serial_adopted && gps_adopted && wifi_adopted;
 }
 
 /**
- * Main application
+ * Wait for every startup task and release whatever was not adopted
+ */
+static void finish_startup(StartupTask *imu_task, StartupTask *serial_task,
+                           StartupTask *gps_task, StartupTask *wifi_task)
+{
+    startup_task_wait(imu_task);
+    startup_task_wait(serial_task);
+    startup_task_wait(gps_task);
+    startup_task_wait(wifi_task);
+    adopt_startup_results(serial_task, gps_task, wifi_task);
+
+    if (mpu6050_fd < 0 && imu_task->result >= 0)
+    {
+        mpu6050_close(imu_task->result);
+    }
+}
+
+static void close_links(void)
+{
+    if (pico_link_ready)
+    {
+        serial_link_close(&pico_link);
+        pico_link_ready = false;
+    }
+    if (gps_fd >= 0)
+    {
+        gps_cleanup(gps_fd);
+        gps_fd = -1;
+    }
+}
+
+/**
+ * Start the background logger (PILOT_LOG_SINK=syslog for journald
+ * priorities, PILOT_LOG_LEVEL=debug|info|warn|error)
  */
+static void start_logger(void)
+{
+    const char *sink = getenv("PILOT_LOG_SINK");
+    log_init(sink && strcmp(sink, "syslog") == 0 ? LOG_SINK_SYSLOG : LOG_SINK_STDOUT, "pilot_assistant");
+    atexit(log_shutdown);
+
+    const char *level = getenv("PILOT_LOG_LEVEL");
+    if (level)
+    {
+        static const char *const names[] = { "debug", "info", "warn", "error" };
+        for (int i = 0; i < 4; i++)
+        {
+            if (strcmp(level, names[i]) == 0)
+            {
+                log_set_level(LOG_LEVEL_DEBUG + i);
+            }
+        }
+    }
+}
+
+/**
+ * Orient the display for the way it is viewed, in the panel itself:
+ * PILOT_DISPLAY_ROTATION=0|90|180|270 (clockwise) and PILOT_DISPLAY_MIRROR=
+ * x|y|xy (x for a HUD seen in a combiner glass). The HUD lays itself out
+ * for whatever width and height result.
+ */
+static void apply_display_orientation(void)
+{
+    const char *rotation_env = getenv("PILOT_DISPLAY_ROTATION");
+    const char *mirror_env = getenv("PILOT_DISPLAY_MIRROR");
+    if (!rotation_env && !mirror_env)
+    {
+        return;
+    }
+
+    int degrees = rotation_env ? atoi(rotation_env) : 0;
+    LcdRotation rotation = (LcdRotation)(((degrees % 360 + 360) % 360) / 90);
+    uint8_t mirror = LCD_MIRROR_NONE;
+    if (mirror_env && strchr(mirror_env, 'x'))
+    {
+        mirror |= LCD_MIRROR_X;
+    }
+    if (mirror_env && strchr(mirror_env, 'y'))
+    {
+        mirror |= LCD_MIRROR_Y;
+    }
+
+    if (lcd_set_orientation(rotation, mirror) == 0)
+    {
+        printf("Display: rotated %d deg%s%s, %ux%u\n", rotation * 90,
+               (mirror & LCD_MIRROR_X) ? ", mirrored left-right" : "",
+               (mirror & LCD_MIRROR_Y) ? ", mirrored top-bottom" : "",
+               lcd_width(), lcd_height());
+    }
+    else
+    {
+        fprintf(stderr, "Display orientation not supported by this backend\n");
+    }
+}
+
+/**
+ * Start event tracing if asked for: PILOT_TRACE=1 keeps the last events in
+ * memory for a SIGUSR1 (and exit) snapshot, PILOT_TRACE_STREAM=<file> also
+ * writes them out continuously. Open the JSON in ui.perfetto.dev.
+ */
+static bool start_trace(void)
+{
+    const char *stream_path = getenv("PILOT_TRACE_STREAM");
+    const char *enable = getenv("PILOT_TRACE");
+    if (!stream_path && !(enable && strcmp(enable, "1") == 0))
+    {
+        return false;
+    }
+    if (trace_init(stream_path) < 0)
+    {
+        return false;
+    }
+    trace_thread_name("main");
+    signal(SIGUSR1, handle_sigusr1);
+    printf("Tracing: kill -USR1 %d dumps to %s%s%s\n", (int)getpid(), TRACE_DUMP_DIR,
+           stream_path ? ", streaming to " : "", stream_path ? stream_path : "");
+    return true;
+}
+
 int main(void)
 {
+    start_logger();
+    bool tracing = start_trace();
     printf("=== Pilot Assistant ===\n");
     printf("Raspberry Pi C Implementation\n");
-    printf("Pico Device: %s\n", PICO_DEVICE);
+    printf("Pico Device: %s (fallback %s)\n", SERIAL_PORT_PRIMARY, SERIAL_PORT_FALLBACK);
     printf("Press Ctrl+C to exit\n\n");
 
+    startup_timeline_init();
+
     // Set up signal handler
     signal(SIGINT, handle_sigint);
 
-    // Initialize display
+    // Device bring-up runs on worker threads; the HUD starts as soon as the
+    // IMU is calibrated and the Pico link, GPS and WiFi join when ready
+    StartupTask imu_task, serial_task, gps_task, wifi_task;
+    startup_task_start(&imu_task, "imu", imu_bringup, NULL);
+    startup_task_start(&serial_task, "pico link", serial_bringup, NULL);
+    startup_task_start(&gps_task, "gps", gps_bringup, NULL);
+    startup_task_start(&wifi_task, "wifi", wifi_bringup, NULL);
+
+    // Initialize display (main thread, meanwhile)
     printf("Initializing LCD...\n");
     if (lcd_init() < 0)
     {
         fprintf(stderr, "Failed to initialize LCD\n");
+        running = false;
+        finish_startup(&imu_task, &serial_task, &gps_task, &wifi_task);
+        close_links();
         return 1;
     }
+    startup_mark("lcd ready");
     printf("✓ LCD initialized\n");
+    apply_display_orientation();
 
-    // Display splash screen (disabled - PNG support not compiled)
-    // printf("Loading splash screen...\n");
-    // if (lcd_display_png("../images/output.png") == 0) {
-    //     printf("✓ Splash screen displayed\n");
-    //     sleep(2);
-    // } else {
-    //     printf("⚠ Could not load splash screen, continuing...\n");
-    // }
-
-    // Initialize serial connection to Pico (optional - attitude indicator works without it)
-    printf("Connecting to Pico...\n");
-    serial_fd = serial_init(PICO_DEVICE);
-    if (serial_fd < 0)
+    // Splash stays up while the IMU calibrates; after the first start it is
+    // only an mmap of the cached conversion (PILOT_SPLASH overrides the image)
+    const char *splash = getenv("PILOT_SPLASH");
+    if (lcd_display_png(splash ? splash : SPLASH_IMAGE) == 0)
     {
-        fprintf(stderr, "⚠ Failed to open serial connection to Pico\n");
-        fprintf(stderr, "⚠ Continuing without Pico (attitude indicator will still work)\n");
-        serial_fd = -1; // Mark as unavailable
+        startup_mark("splash shown");
+        printf("✓ Splash screen displayed\n");
     }
     else
     {
-        printf("✓ Connected to Pico\n");
+        printf("⚠ Could not load splash screen, continuing...\n");
     }
-    printf("\n");
 
-    // Initialize MPU-6050 IMU
-    printf("Initializing MPU-6050 IMU...\n");
-    mpu6050_fd = mpu6050_init();
-    if (mpu6050_fd < 0)
+    // HUD bands render on a worker pool (PILOT_RENDER_THREADS=1..4 to compare)
+    const char *render_threads_env = getenv("PILOT_RENDER_THREADS");
+    int render_threads = render_pool_init(render_threads_env ? atoi(render_threads_env) : 0);
+    printf("Render pool: %d thread(s), %d bands\n", render_threads, RENDER_BANDS);
+    bool render_stats = getenv("PILOT_RENDER_STATS") != NULL;
+
+    latency_hist_init(&frame_latency, LATENCY_BIN_US);
+    clock_sync_init(&pico_clock);
+    track_table_init(&traffic_tracks);
+    struct timespec sched_ts;
+    clock_gettime(CLOCK_MONOTONIC, &sched_ts);
+    const char *credits_env = getenv("PILOT_OPENSKY_CREDITS");
+    opensky_sched_init(&traffic_sched, credits_env ? (uint32_t)atoi(credits_env) : OPENSKY_CREDITS_ANONYMOUS,
+                       (uint32_t)(sched_ts.tv_sec * 1000UL + sched_ts.tv_nsec / 1000000));
+    if (getenv("PILOT_OPENSKY_URL"))
     {
-        fprintf(stderr, "Failed to initialize MPU-6050\n");
-        fprintf(stderr, "Make sure MPU-6050 is connected to I2C\n");
-        lcd_clear(COLOR_BLACK);
-        lcd_draw_string(40, 100, "ERROR:", COLOR_RED, COLOR_BLACK);
-        lcd_draw_string(20, 120, "MPU-6050 not found", COLOR_WHITE, COLOR_BLACK);
-        sleep(3);
-        if (serial_fd >= 0)
-            close(serial_fd);
-        lcd_cleanup();
-        return 1;
+        opensky_url = getenv("PILOT_OPENSKY_URL");
     }
-    printf("✓ MPU-6050 initialized\n\n");
-
-    // Initialize GPS module
-    printf("Initializing GPS module...\n");
-    gps_fd = gps_init();
-    if (gps_fd < 0)
+    latency_overlay = getenv("PILOT_LATENCY") != NULL;
+    const char *latency_test_env = getenv("PILOT_LATENCY_TEST");
+    if (latency_test_env)
     {
-        fprintf(stderr, "Warning: Failed to initialize GPS\n");
-        fprintf(stderr, "Continuing without GPS data\n");
-        gps_fd = -1; // Mark as unavailable
+        latency_test_init(&latency_test, LATENCY_TEST_STEPS, LATENCY_TEST_STEP_DEG,
+                          LATENCY_TEST_PERIOD_US, (float)atof(latency_test_env));
+        latency_test_enabled = true;
+        latency_overlay = true;
+        printf("Latency test: %d synthetic %.0f deg roll steps\n", LATENCY_TEST_STEPS, LATENCY_TEST_STEP_DEG);
     }
-    else
+
+    NotchConfig notch_cfg;
+    notch_default_config(&notch_cfg, 3, SENSOR_RATE_HZ);
+    notch_cfg.min_level = NOTCH_ACCEL_MIN_LEVEL;
+    notch_bank_init(&accel_notch, &notch_cfg);
+    notch_cfg.min_level = NOTCH_GYRO_MIN_LEVEL;
+    notch_bank_init(&gyro_notch, &notch_cfg);
+
+    estimator_init(&estimator, SENSOR_RATE_HZ);
+    attitude_predictor_init(&predictor);
+    printf("Attitude estimator: %s\n", ATTITUDE_ESTIMATOR_NAME);
+
+    nav_filter_init(&nav);
+    const char *nav_log_path = getenv("PILOT_NAV_LOG");
+    if (nav_log_path)
     {
-        printf("✓ GPS initialized\n");
+        nav_log = fopen(nav_log_path, "w");
+        if (nav_log)
+        {
+            fprintf(nav_log, "t_s,ax_g,ay_g,az_g,ux,uy,uz,gps_alt_m,gps_speed_mps\n");
+            printf("Recording navigation inputs to %s\n", nav_log_path);
+        }
+        else
+        {
+            perror("PILOT_NAV_LOG");
+        }
     }
 
-    // Check WiFi status
-    printf("Checking WiFi status...\n");
-    wifi_connected = check_wifi_status();
-    if (wifi_connected)
+    // The HUD needs the IMU: wait for it (and its gyro calibration) only
+    mpu6050_fd = startup_task_wait(&imu_task);
+    if (latency_test_enabled)
     {
-        printf("✓ WiFi connected\n");
+        // Synthetic samples have no bias (and the IMU may be absent)
+        gyro_bias[0] = gyro_bias[1] = gyro_bias[2] = 0.0f;
     }
-    else
+    else if (mpu6050_fd < 0)
     {
-        printf("⚠ WiFi not connected\n");
+        fprintf(stderr, "Failed to initialize MPU-6050\n");
+        fprintf(stderr, "Make sure MPU-6050 is connected to I2C\n");
+        lcd_clear(COLOR_BLACK);
+        lcd_draw_string(40, 100, "ERROR:", COLOR_RED, COLOR_BLACK);
+        lcd_draw_string(20, 120, "MPU-6050 not found", COLOR_WHITE, COLOR_BLACK);
+        sleep(3);
+        running = false;
+        finish_startup(&imu_task, &serial_task, &gps_task, &wifi_task);
+        close_links();
+        render_pool_shutdown();
+        lcd_cleanup();
+        return 1;
     }
-    printf("\n");
+    printf("✓ MPU-6050 initialized\n\n");
 
     // Display state
     unsigned long last_sensor_update = 0;
@@ -1139,21 +1503,27 @@ int main(void)
     unsigned long last_gps_update = 0;
     unsigned long last_telemetry_update = 0;
     unsigned long last_wifi_check = 0;
+    unsigned long last_render_stats = 0;
+    unsigned long last_latency_overlay = 0;
+    unsigned long last_latency_log = 0;
+    unsigned long last_clock_sync = 0;
+    {
+        // The first WiFi check is the startup task, not the periodic one
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        last_wifi_check = ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    }
 
     // Main loop
     printf("=== Attitude Indicator Active ===\n");
     printf("Reading attitude from MPU-6050 IMU\n");
     printf("Display updating at 60 FPS for smooth motion\n");
-    if (serial_fd >= 0)
-    {
-        printf("Press KEY4 on Pico to exit\n");
-    }
-    else
-    {
-        printf("Press Ctrl+C to exit (Pico not connected)\n");
-    }
+    printf("Press KEY4 on Pico (or Ctrl+C) to exit\n");
     printf("\n");
 
+    bool first_frame = false;
+    bool timeline_printed = false;
+
     while (running)
     {
         // Get current time in milliseconds
@@ -1161,17 +1531,30 @@ int main(void)
         clock_gettime(CLOCK_MONOTONIC, &ts);
         unsigned long current_time = ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 
+        // Pick up devices whose bring-up finished since the last pass
+        if (!timeline_printed &&
+            adopt_startup_results(&serial_task, &gps_task, &wifi_task) && first_frame)
+        {
+            startup_timeline_print(stdout);
+            timeline_printed = true;
+        }
+
         // Update attitude from sensor at regular intervals
         if (current_time - last_sensor_update >= SENSOR_UPDATE_MS)
         {
+            TRACE_BEGIN("imu update");
             update_attitude_from_sensor();
+            TRACE_END("imu update");
             last_sensor_update = current_time;
         }
 
         // Update GPS data at regular intervals (slower than attitude)
         if (gps_fd >= 0 && current_time - last_gps_update >= GPS_UPDATE_MS)
         {
+            TRACE_BEGIN("gps read");
             gps_read_data(gps_fd, &gps_data);
+            update_nav_from_gps(current_time);
+            TRACE_END("gps read");
             last_gps_update = current_time;
         }
 
@@ -1179,14 +1562,55 @@ int main(void)
         // This ensures we always see intermediate frames during fast movements
         if (current_time - last_display_update >= DISPLAY_UPDATE_MS)
         {
+            TRACE_BEGIN("hud frame");
             draw_attitude_indicator();
+            TRACE_END("hud frame");
             last_display_update = current_time;
+            if (!first_frame)
+            {
+                startup_mark("first HUD frame");
+                first_frame = true;
+            }
+        }
+
+        if (render_stats && current_time - last_render_stats >= RENDER_STATS_MS)
+        {
+            render_pool_print_stats(stdout);
+            last_render_stats = current_time;
+        }
+
+        if (latency_overlay && current_time - last_latency_overlay >= LATENCY_OVERLAY_MS)
+        {
+            bool log = current_time - last_latency_log >= LATENCY_LOG_MS;
+            latency_report(log);
+            last_latency_overlay = current_time;
+            if (log)
+            {
+                last_latency_log = current_time;
+                if (pico_link_ready && serial_link_connected(&pico_link))
+                {
+                    clock_sync_print(&pico_clock, stdout, true);
+                }
+            }
+        }
+
+        // Clock sync ping, faster until the mapping has locked
+        if (pico_link_ready && serial_link_connected(&pico_link) &&
+            current_time - last_clock_sync >= (pico_clock.locked ? CLOCK_SYNC_PING_MS : CLOCK_SYNC_FAST_PING_MS))
+        {
+            char ping[48];
+            int len = clock_sync_request(&pico_clock, ping, sizeof(ping));
+            serial_link_write(&pico_link, ping, len);
+            last_clock_sync = current_time;
         }
 
         // Send telemetry to Pico at regular intervals (only if connected)
-        if (serial_fd >= 0 && current_time - last_telemetry_update >= TELEMETRY_UPDATE_MS)
+        if (pico_link_ready && serial_link_connected(&pico_link) &&
+            current_time - last_telemetry_update >= TELEMETRY_UPDATE_MS)
         {
+            TRACE_BEGIN("telemetry");
             send_telemetry_to_pico();
+            TRACE_END("telemetry");
             last_telemetry_update = current_time;
         }
 
@@ -1197,10 +1621,12 @@ int main(void)
             last_wifi_check = current_time;
         }
 
-        // Process input from Pico (non-blocking, only if connected)
-        if (serial_fd >= 0)
+        // Process input from Pico (non-blocking; also picks up a replugged Pico)
+        if (pico_link_ready)
         {
+            TRACE_BEGIN("pico input");
             process_serial_input();
+            TRACE_END("pico input");
         }
 
         // No delay - run at maximum speed, sensor polling controls update rate
@@ -1209,10 +1635,24 @@ int main(void)
 
     // Cleanup
     printf("\nShutting down...\n");
+    finish_startup(&imu_task, &serial_task, &gps_task, &wifi_task);
+    render_pool_print_stats(stdout);
+    render_pool_shutdown();
+    bool latency_ok = true;
+    if (latency_test_enabled)
+    {
+        latency_ok = latency_test_report(&latency_test, stdout);
+    }
     lcd_clear(COLOR_BLACK);
-    if (serial_fd >= 0)
+    if (pico_link_ready)
     {
-        close(serial_fd);
+        const SerialLinkStats *link_stats = &pico_link.stats;
+        printf("Pico link: %llu bytes in %llu reads, %llu lines, %llu bytes dropped, %u reconnects\n",
+               (unsigned long long)link_stats->bytes, (unsigned long long)link_stats->reads,
+               (unsigned long long)link_stats->lines, (unsigned long long)link_stats->dropped_bytes,
+               link_stats->connects > 0 ? link_stats->connects - 1 : 0);
+        clock_sync_print(&pico_clock, stdout, false);
+        serial_link_close(&pico_link);
     }
     if (mpu6050_fd >= 0)
     {
@@ -1222,8 +1662,31 @@ int main(void)
     {
         gps_cleanup(gps_fd);
     }
+    if (nav_log)
+    {
+        fclose(nav_log);
+    }
     lcd_cleanup();
+
+    if (tracing)
+    {
+        char trace_path[64];
+        snprintf(trace_path, sizeof(trace_path), "%s/pilot_trace_exit.json", TRACE_DUMP_DIR);
+        int events = trace_dump(trace_path);
+        if (events >= 0)
+        {
+            printf("Trace: %d events written to %s\n", events, trace_path);
+        }
+        trace_shutdown();
+    }
+
+    log_shutdown();
+    LogStats log_stats;
+    log_get_stats(&log_stats);
+    printf("Log: %llu records, %llu dropped (ring full), %llu rate limited\n",
+           (unsigned long long)log_stats.records, (unsigned long long)log_stats.dropped,
+           (unsigned long long)log_stats.suppressed);
     printf("✓ Cleanup complete\n");
 
-    return 0;
+    return latency_ok ? 0 : 1;
 }
@@ -0,0 +1,167 @@
+/**
+ * GPS / Inertial Navigation Filter Implementation
+ */
+
+#include <math.h>
+#include <string.h>
+#include "../include/nav_filter.h"
+
+// Largest prediction step accepted (longer gaps are split)
+#define MAX_PREDICT_DT 0.05f
+
+/**
+ * Initialize filter with default tuning
+ */
+void nav_filter_init(NavFilter *nav) {
+    memset(nav, 0, sizeof(*nav));
+    nav->accel_noise = 0.5f;
+    nav->bias_walk = 0.02f;
+    nav->alt_noise = 4.0f;
+    nav->speed_noise = 0.5f;
+}
+
+void nav_filter_reset(NavFilter *nav) {
+    nav->alt_valid = false;
+    nav->speed_valid = false;
+}
+
+static void predict_vertical(NavFilter *nav, float a_up, float dt) {
+    float a = a_up - nav->bias_up;
+    float dt2 = 0.5f * dt * dt;
+
+    nav->alt_m += nav->vs_mps * dt + a * dt2;
+    nav->vs_mps += a * dt;
+
+    // P = F P F' + Q, F = [1 dt -dt2; 0 1 -dt; 0 0 1]
+    float F[3][3] = {{1.0f, dt, -dt2}, {0.0f, 1.0f, -dt}, {0.0f, 0.0f, 1.0f}};
+    float FP[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            FP[i][j] = F[i][0] * nav->Pv[0][j] + F[i][1] * nav->Pv[1][j] + F[i][2] * nav->Pv[2][j];
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            nav->Pv[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2];
+        }
+    }
+
+    // Acceleration noise enters through G = [dt2 dt 0]
+    float qa = nav->accel_noise * nav->accel_noise;
+    float G[2] = {dt2, dt};
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            nav->Pv[i][j] += qa * G[i] * G[j];
+        }
+    }
+    nav->Pv[2][2] += nav->bias_walk * nav->bias_walk * dt;
+}
+
+static void predict_speed(NavFilter *nav, float a_fwd, float dt) {
+    nav->speed_mps += (a_fwd - nav->bias_fwd) * dt;
+
+    // P = F P F' + Q, F = [1 -dt; 0 1]
+    float p00 = nav->Ps[0][0] - dt * (nav->Ps[1][0] + nav->Ps[0][1]) + dt * dt * nav->Ps[1][1];
+    float p01 = nav->Ps[0][1] - dt * nav->Ps[1][1];
+    nav->Ps[0][0] = p00 + nav->accel_noise * nav->accel_noise * dt * dt;
+    nav->Ps[0][1] = p01;
+    nav->Ps[1][0] = p01;
+    nav->Ps[1][1] += nav->bias_walk * nav->bias_walk * dt;
+}
+
+/**
+ * Propagate with one accelerometer sample
+ */
+void nav_filter_predict(NavFilter *nav, const float accel_g[3], const float up[3], float dt) {
+    if (!(dt > 0.0f)) return;
+
+    // Vertical: specific force along "up" minus 1 g
+    float f_up = accel_g[0] * up[0] + accel_g[1] * up[1] + accel_g[2] * up[2];
+    float a_up = (f_up - 1.0f) * NAV_GRAVITY;
+
+    // Along-track: body X axis projected onto the level plane
+    float fx = 1.0f - up[0] * up[0];
+    float fy = -up[0] * up[1];
+    float fz = -up[0] * up[2];
+    float fn = sqrtf(fx * fx + fy * fy + fz * fz);
+    float a_fwd = 0.0f;
+    if (fn > 1e-3f) {
+        a_fwd = (accel_g[0] * fx + accel_g[1] * fy + accel_g[2] * fz) / fn * NAV_GRAVITY;
+    }
+
+    if (!isfinite(a_up) || !isfinite(a_fwd)) return;
+
+    while (dt > 0.0f) {
+        float step = dt > MAX_PREDICT_DT ? MAX_PREDICT_DT : dt;
+        if (nav->alt_valid) predict_vertical(nav, a_up, step);
+        if (nav->speed_valid) predict_speed(nav, a_fwd, step);
+        dt -= step;
+    }
+}
+
+/**
+ * Correct with a new GPS altitude (meters)
+ */
+void nav_filter_update_altitude(NavFilter *nav, float alt_m) {
+    if (!isfinite(alt_m)) return;
+
+    if (!nav->alt_valid) {
+        nav->alt_m = alt_m;
+        nav->vs_mps = 0.0f;
+        nav->bias_up = 0.0f;
+        memset(nav->Pv, 0, sizeof(nav->Pv));
+        nav->Pv[0][0] = nav->alt_noise * nav->alt_noise;
+        nav->Pv[1][1] = 1.0f;
+        nav->Pv[2][2] = 0.01f;
+        nav->alt_valid = true;
+        return;
+    }
+
+    // H = [1 0 0]
+    float S = nav->Pv[0][0] + nav->alt_noise * nav->alt_noise;
+    float K[3] = {nav->Pv[0][0] / S, nav->Pv[1][0] / S, nav->Pv[2][0] / S};
+    float y = alt_m - nav->alt_m;
+
+    nav->alt_m += K[0] * y;
+    nav->vs_mps += K[1] * y;
+    nav->bias_up += K[2] * y;
+
+    float row0[3] = {nav->Pv[0][0], nav->Pv[0][1], nav->Pv[0][2]};
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            nav->Pv[i][j] -= K[i] * row0[j];
+        }
+    }
+}
+
+/**
+ * Correct with a new GPS ground speed (m/s)
+ */
+void nav_filter_update_speed(NavFilter *nav, float speed_mps) {
+    if (!isfinite(speed_mps)) return;
+
+    if (!nav->speed_valid) {
+        nav->speed_mps = speed_mps;
+        nav->bias_fwd = 0.0f;
+        memset(nav->Ps, 0, sizeof(nav->Ps));
+        nav->Ps[0][0] = nav->speed_noise * nav->speed_noise;
+        nav->Ps[1][1] = 0.01f;
+        nav->speed_valid = true;
+        return;
+    }
+
+    // H = [1 0]
+    float S = nav->Ps[0][0] + nav->speed_noise * nav->speed_noise;
+    float K0 = nav->Ps[0][0] / S;
+    float K1 = nav->Ps[1][0] / S;
+    float y = speed_mps - nav->speed_mps;
+
+    nav->speed_mps += K0 * y;
+    nav->bias_fwd += K1 * y;
+
+    float p00 = nav->Ps[0][0], p01 = nav->Ps[0][1];
+    nav->Ps[0][0] -= K0 * p00;
+    nav->Ps[0][1] -= K0 * p01;
+    nav->Ps[1][0] -= K1 * p00;
+    nav->Ps[1][1] -= K1 * p01;
+}
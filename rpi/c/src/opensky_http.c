@@ -0,0 +1,248 @@
+/**
+ * OpenSky States over HTTP Implementation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include "../include/opensky_http.h"
+
+#define STATE_ENTRY_SIZE 2048
+
+// Response buffer; only the traffic refresh fetches
+static char response_buf[OPENSKY_HTTP_RESPONSE_SIZE];
+
+static void trim_whitespace(char *s) {
+    if (!s || s[0] == '\0') {
+        return;
+    }
+
+    char *start = s;
+    while (*start && isspace((unsigned char)*start)) {
+        start++;
+    }
+
+    char *end = start + strlen(start);
+    while (end > start && isspace((unsigned char)*(end - 1))) {
+        end--;
+    }
+    *end = '\0';
+
+    if (start != s) {
+        memmove(s, start, strlen(start) + 1);
+    }
+}
+
+// Whitespace and surrounding quotes
+static void trim_string_field(char *s) {
+    trim_whitespace(s);
+    size_t len = strlen(s);
+    if (len >= 2 && s[0] == '"' && s[len - 1] == '"') {
+        s[len - 1] = '\0';
+        memmove(s, s + 1, len - 1);
+    }
+    trim_whitespace(s);
+}
+
+static bool extract_state_field(const char *entry, int target_index, char *out, size_t out_size) {
+    if (!entry || !out || out_size == 0 || target_index < 0) {
+        return false;
+    }
+
+    int field_index = 0;
+    const char *field_start = entry;
+    bool in_quotes = false;
+    bool escaped = false;
+
+    for (const char *p = entry;; p++) {
+        char c = *p;
+        bool at_end = (c == '\0');
+        bool is_separator = (!in_quotes && c == ',');
+
+        if (!at_end) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                in_quotes = !in_quotes;
+            }
+        }
+
+        if (is_separator || at_end) {
+            if (field_index == target_index) {
+                size_t len = (size_t)(p - field_start);
+                if (len >= out_size) {
+                    len = out_size - 1;
+                }
+                memcpy(out, field_start, len);
+                out[len] = '\0';
+                trim_whitespace(out);
+                return (out[0] != '\0' && strcmp(out, "null") != 0);
+            }
+            if (at_end) {
+                break;
+            }
+            field_index++;
+            field_start = p + 1;
+        }
+    }
+
+    return false;
+}
+
+static bool parse_float_field(const char *entry, int index, float *out_value) {
+    char field[64];
+    if (!extract_state_field(entry, index, field, sizeof(field))) {
+        return false;
+    }
+
+    char *end_ptr = NULL;
+    float value = strtof(field, &end_ptr);
+    if (end_ptr == field) {
+        return false;
+    }
+
+    *out_value = value;
+    return true;
+}
+
+// One state vector: [icao24, callsign, country, t_pos, t_contact, lon, lat, baro_alt, ground, velocity, track, ...]
+static bool parse_state(const char *entry, const OpenSkyQuery *query, TrackTable *tracks, uint32_t now_ms) {
+    char icao_hex[16];
+    if (!extract_state_field(entry, 0, icao_hex, sizeof(icao_hex))) {
+        return false;
+    }
+    trim_string_field(icao_hex);
+    uint32_t icao24 = track_parse_icao24(icao_hex);
+
+    float lat, lon, heading;
+    if (icao24 == 0 ||
+        !parse_float_field(entry, 5, &lon) ||
+        !parse_float_field(entry, 6, &lat) ||
+        !parse_float_field(entry, 10, &heading)) {
+        return false;
+    }
+    if (opensky_distance_km(query->lat, query->lon, lat, lon) > query->radius_km) {
+        return false;
+    }
+
+    char callsign[64];
+    if (!extract_state_field(entry, 1, callsign, sizeof(callsign))) {
+        callsign[0] = '\0';
+    }
+    trim_string_field(callsign);
+
+    float altitude = 0.0f;
+    float velocity = 0.0f;
+    parse_float_field(entry, 7, &altitude);
+    parse_float_field(entry, 9, &velocity);
+    TrackState state = {
+        .lat = geo_deg_to_udeg(lat),
+        .lon = geo_deg_to_udeg(lon),
+        .alt = geo_ft_to_alt(altitude * 3.28084f),
+        .speed_kt = geo_kt_to_speed(velocity * 1.94384f),
+        .heading = geo_deg_to_heading(heading),
+    };
+
+    track_table_update(tracks, icao24, callsign, &state, now_ms);
+    return true;
+}
+
+static int parse_states(const char *body, const OpenSkyQuery *query, TrackTable *tracks, uint32_t now_ms) {
+    const char *states_key = strstr(body, "\"states\":");
+    if (!states_key) {
+        return -1;
+    }
+    // "states":null when the box is empty
+    const char *states_start = strchr(states_key, '[');
+    if (!states_start) {
+        return 0;
+    }
+
+    int aircraft_count = 0;
+    int depth = 0;
+    const char *entry_start = NULL;
+
+    for (const char *p = states_start; *p != '\0'; p++) {
+        if (*p == '[') {
+            depth++;
+            if (depth == 2) {
+                entry_start = p + 1;
+            }
+        } else if (*p == ']') {
+            if (depth == 2 && entry_start) {
+                size_t entry_len = (size_t)(p - entry_start);
+                if (entry_len > 0 && entry_len < STATE_ENTRY_SIZE) {
+                    char entry[STATE_ENTRY_SIZE];
+                    memcpy(entry, entry_start, entry_len);
+                    entry[entry_len] = '\0';
+                    if (parse_state(entry, query, tracks, now_ms)) {
+                        aircraft_count++;
+                    }
+                }
+                entry_start = NULL;
+            }
+            depth--;
+            if (depth <= 0) {
+                break;
+            }
+        }
+    }
+    return aircraft_count;
+}
+
+int opensky_http_fetch(const char *base_url, const OpenSkyQuery *query, TrackTable *tracks,
+                       uint32_t now_ms, OpenSkyResponse *response) {
+    memset(response, 0, sizeof(*response));
+    response->result = OPENSKY_FAILED;
+    response->remaining_credits = -1;
+    response->retry_after_s = -1;
+
+    // -i: the head comes first, for the status and rate-limit headers
+    char command[512];
+    snprintf(command, sizeof(command),
+             "curl -s -i --max-time %d \"%s/states/all?lamin=%.6f&lamax=%.6f&lomin=%.6f&lomax=%.6f\"",
+             OPENSKY_HTTP_TIMEOUT_S, base_url ? base_url : OPENSKY_API_URL,
+             query->lamin, query->lamax, query->lomin, query->lomax);
+
+    FILE *fp = popen(command, "r");
+    if (!fp) {
+        return -1;
+    }
+
+    size_t used = 0;
+    while (used < sizeof(response_buf) - 1) {
+        size_t n = fread(response_buf + used, 1, sizeof(response_buf) - 1 - used, fp);
+        if (n == 0) {
+            break;
+        }
+        used += n;
+    }
+    response_buf[used] = '\0';
+    pclose(fp);
+
+    if (opensky_parse_headers(response_buf, response) != 200) {
+        return -1;
+    }
+
+    // Body after the last head (proxies add their own)
+    const char *body = response_buf;
+    const char *head_end;
+    while ((head_end = strstr(body, "\r\n\r\n")) != NULL) {
+        body = head_end + 4;
+        if (strncmp(body, "HTTP/", 5) != 0) {
+            break;
+        }
+    }
+
+    int count = parse_states(body, query, tracks, now_ms);
+    if (count < 0) {
+        response->result = OPENSKY_FAILED;
+        return -1;
+    }
+    response->traffic_count = count;
+    return count;
+}
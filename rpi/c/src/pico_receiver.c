@@ -5,8 +5,8 @@
  * and displays them on ST7789 LCD display.
  *
  * Features:
- * - Auto-reconnect on disconnect
- * - Low CPU usage with select()
+ * - Auto-reconnect on disconnect (udev hotplug events, see serial_link.h)
+ * - Low CPU usage: blocks in poll() on the tty and the hotplug socket
  * - Console logging for verification
  * - Real-time LCD display updates
  */
@@ -16,9 +16,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <signal.h>
-#include <sys/select.h>
-#include <time.h>
-#include "serial_comm.h"
+#include "serial_link.h"
 #include "pico_commands.h"
 #include "st7789_rpi.h"
 
@@ -73,6 +71,14 @@ void draw_command_screen(const char* command_text) {
     lcd_draw_string_scaled(x_pos, 100, command_text, COLOR_GREEN, COLOR_BLACK, 3);
 }
 
+// Draw the idle screen shown while connected
+void draw_connected_screen(void) {
+    lcd_clear(COLOR_BLACK);
+    lcd_draw_string_scaled(30, 20, "PICO RECEIVER", COLOR_CYAN, COLOR_BLACK, 2);
+    lcd_draw_string(10, 60, "Waiting for commands...", COLOR_WHITE, COLOR_BLACK);
+    lcd_draw_string(10, 200, "Press Ctrl+C to exit", COLOR_WHITE, COLOR_BLACK);
+}
+
 // Initialize the display
 void init_display(void) {
     printf("Initializing LCD display...\n");
@@ -84,11 +90,8 @@ void init_display(void) {
 }
 
 int main(void) {
-    int serial_fd = -1;
-    char line_buffer[SERIAL_READ_BUFFER_SIZE];
+    SerialLink link;
     PicoCommand cmd;
-    DisplayState display_state = DISPLAY_STATE_WAITING;
-    time_t last_reconnect_attempt = 0;
 
     // Setup signal handler for clean shutdown
     signal(SIGINT, signal_handler);
@@ -103,126 +106,68 @@ int main(void) {
     init_display();
     draw_status_screen(DISPLAY_STATE_WAITING);
 
-    // Try to open serial port
+    // Open the serial link; it keeps watching for the Pico if absent
     printf("Opening serial connection to Pico...\n");
-    serial_fd = serial_init();
+    if (serial_link_init(&link, NULL, 0) != 0) {
+        fprintf(stderr, "Failed to set up serial link\n");
+        lcd_cleanup();
+        return 1;
+    }
 
-    if (serial_fd < 0) {
+    if (!serial_link_connected(&link)) {
         printf("No Pico detected. Waiting for connection...\n");
     } else {
-        printf("Connected to Pico on serial port\n");
-        display_state = DISPLAY_STATE_CONNECTED;
-        lcd_clear(COLOR_BLACK);
-        lcd_draw_string_scaled(30, 20, "PICO RECEIVER", COLOR_CYAN, COLOR_BLACK, 2);
-        lcd_draw_string(10, 60, "Waiting for commands...", COLOR_WHITE, COLOR_BLACK);
-        lcd_draw_string(10, 200, "Press Ctrl+C to exit", COLOR_WHITE, COLOR_BLACK);
+        printf("Connected to Pico on %s\n", link.device);
+        draw_connected_screen();
     }
 
     // Main loop
     while (running) {
-        // Check if we need to reconnect
-        if (serial_fd < 0) {
-            time_t now = time(NULL);
-
-            // Try to reconnect every 2 seconds
-            if (now - last_reconnect_attempt >= 2) {
-                if (display_state != DISPLAY_STATE_DISCONNECTED) {
-                    display_state = DISPLAY_STATE_DISCONNECTED;
-                    draw_status_screen(DISPLAY_STATE_DISCONNECTED);
-                }
-
-                serial_fd = serial_reconnect();
-                last_reconnect_attempt = now;
-
-                if (serial_fd >= 0) {
-                    printf("Reconnected to Pico\n");
-                    display_state = DISPLAY_STATE_CONNECTED;
-                    lcd_clear(COLOR_BLACK);
-                    lcd_draw_string_scaled(30, 20, "PICO RECEIVER", COLOR_CYAN, COLOR_BLACK, 2);
-                    lcd_draw_string(10, 60, "Waiting for commands...", COLOR_WHITE, COLOR_BLACK);
-                    lcd_draw_string(10, 200, "Press Ctrl+C to exit", COLOR_WHITE, COLOR_BLACK);
-                }
-            }
-
-            // Sleep a bit before next check
-            usleep(100000);  // 100ms
-            continue;
-        }
-
-        // Use select() for efficient I/O with timeout
-        fd_set readfds;
-        struct timeval tv;
-
-        FD_ZERO(&readfds);
-        FD_SET(serial_fd, &readfds);
+        // Returns on data, hotplug/reconnect, or after 1 second
+        int events = serial_link_wait(&link, 1000);
 
-        // Timeout of 1 second
-        tv.tv_sec = 1;
-        tv.tv_usec = 0;
-
-        int ret = select(serial_fd + 1, &readfds, NULL, NULL, &tv);
-
-        if (ret < 0) {
-            // Error in select
-            perror("select");
-            break;
-        }
-
-        if (ret == 0) {
-            // Timeout - no data available
-            continue;
-        }
-
-        // Data available - read a line
-        int bytes_read = serial_read_line(serial_fd, line_buffer, sizeof(line_buffer), 100);
-
-        if (bytes_read < 0) {
-            // Error or disconnection
+        if (events & SERIAL_LINK_EV_DISCONNECTED) {
             printf("Serial connection lost\n");
-            serial_close(serial_fd);
-            serial_fd = -1;
-            display_state = DISPLAY_STATE_DISCONNECTED;
             draw_status_screen(DISPLAY_STATE_DISCONNECTED);
-            continue;
         }
-
-        if (bytes_read == 0) {
-            // No data (timeout)
-            continue;
+        if (events & SERIAL_LINK_EV_CONNECTED) {
+            printf("Reconnected to Pico on %s\n", link.device);
+            draw_connected_screen();
         }
 
-        // We received a line - print to console for verification
-        printf("Received: %s\n", line_buffer);
+        const char *line;
+        while ((line = serial_link_next_line(&link, NULL)) != NULL) {
+            // We received a line - print to console for verification
+            printf("Received: %s\n", line);
 
-        // Parse the command
-        if (parse_pico_command(line_buffer, &cmd)) {
-            // Valid command received
+            // Parse the command
+            if (parse_pico_command(line, &cmd)) {
+                // Valid command received
 
-            // For CMD: type commands, display them prominently
-            if (cmd.type == CMD_TYPE_CMD) {
-                printf("  -> High-level command: %s\n", cmd.display_text);
-                draw_command_screen(cmd.display_text);
-            }
-            // For button and joystick commands, just log and optionally display
-            else if (cmd.type == CMD_TYPE_BTN) {
-                printf("  -> Button event: %s\n", cmd.display_text);
-                // Optionally update a status line
-            }
-            else if (cmd.type == CMD_TYPE_JOY) {
-                printf("  -> Joystick event: %s\n", cmd.display_text);
-                // Optionally update a status line
+                // For CMD: type commands, display them prominently
+                if (cmd.type == CMD_TYPE_CMD) {
+                    printf("  -> High-level command: %s\n", cmd.display_text);
+                    draw_command_screen(cmd.display_text);
+                }
+                // For button and joystick commands, just log and optionally display
+                else if (cmd.type == CMD_TYPE_BTN) {
+                    printf("  -> Button event: %s\n", cmd.display_text);
+                    // Optionally update a status line
+                }
+                else if (cmd.type == CMD_TYPE_JOY) {
+                    printf("  -> Joystick event: %s\n", cmd.display_text);
+                    // Optionally update a status line
+                }
+            } else {
+                printf("  -> Unknown command format\n");
             }
-        } else {
-            printf("  -> Unknown command format\n");
         }
     }
 
     // Cleanup
     printf("\nShutting down...\n");
 
-    if (serial_fd >= 0) {
-        serial_close(serial_fd);
-    }
+    serial_link_close(&link);
 
     lcd_clear(COLOR_BLACK);
     lcd_draw_string_scaled(80, 100, "GOODBYE", COLOR_CYAN, COLOR_BLACK, 2);
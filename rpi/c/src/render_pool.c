@@ -0,0 +1,222 @@
+/**
+ * Banded Render Pool Implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/render_pool.h"
+#include "../include/st7789_rpi.h"
+#include "../include/trace.h"
+
+#define BAND_ROWS ((lcd_height() + RENDER_BANDS - 1) / RENDER_BANDS)
+
+static pthread_t workers[RENDER_MAX_THREADS];
+static int worker_count = 0;
+static char worker_names[RENDER_MAX_THREADS][16];  // Trace thread names
+
+// Everything below is guarded by pool_lock
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;    // New frame or shutdown
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;    // Band finished or worker idle
+static RenderBandFn frame_render;
+static void *frame_arg;
+static unsigned long frame_seq = 0;
+static int next_band = RENDER_BANDS;
+static bool band_ready[RENDER_BANDS];
+static int busy_workers = 0;
+static bool stopping = false;
+static RenderPoolStats stats;
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void band_rows(int band, uint16_t *y0, uint16_t *y1) {
+    *y0 = band * BAND_ROWS;
+    *y1 = (*y0 + BAND_ROWS > lcd_height()) ? lcd_height() : *y0 + BAND_ROWS;
+}
+
+// Render one band on the calling thread; returns its time in us
+static double render_band(RenderBandFn render, void *arg, int band) {
+    uint16_t y0, y1;
+    band_rows(band, &y0, &y1);
+
+    double t = now_us();
+    TRACE_BEGIN("render band");
+    lcd_fb_set_clip_rows(y0, y1);
+    render(arg, y0, y1);
+    lcd_fb_set_clip_rows(0, lcd_height());
+    TRACE_END("render band");
+    return now_us() - t;
+}
+
+// Caller holds pool_lock
+static void record_band(int band, double us) {
+    stats.band_last_us[band] = us;
+    stats.band_total_us[band] += us;
+    if (us > stats.band_max_us[band]) stats.band_max_us[band] = us;
+}
+
+static void *worker_main(void *name) {
+    unsigned long seen = 0;
+
+    trace_thread_name(name);
+
+    pthread_mutex_lock(&pool_lock);
+    while (true) {
+        while (!stopping && frame_seq == seen) {
+            pthread_cond_wait(&work_cond, &pool_lock);
+        }
+        if (stopping) break;
+        seen = frame_seq;
+        busy_workers++;
+
+        // Bands are handed out top to bottom so the flush can start early
+        while (next_band < RENDER_BANDS) {
+            int band = next_band++;
+            RenderBandFn render = frame_render;
+            void *arg = frame_arg;
+
+            pthread_mutex_unlock(&pool_lock);
+            double us = render_band(render, arg, band);
+            pthread_mutex_lock(&pool_lock);
+
+            record_band(band, us);
+            band_ready[band] = true;
+            pthread_cond_broadcast(&done_cond);
+        }
+
+        busy_workers--;
+        pthread_cond_broadcast(&done_cond);
+    }
+    pthread_mutex_unlock(&pool_lock);
+    return NULL;
+}
+
+int render_pool_init(int threads) {
+    if (threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? (int)cores : 1;
+    }
+    if (threads > RENDER_MAX_THREADS) threads = RENDER_MAX_THREADS;
+
+    memset(&stats, 0, sizeof(stats));
+    stopping = false;
+    worker_count = 0;
+    for (int i = 0; i < threads; i++) {
+        snprintf(worker_names[i], sizeof(worker_names[i]), "render %d", i);
+        if (pthread_create(&workers[i], NULL, worker_main, worker_names[i]) != 0) {
+            perror("pthread_create");
+            break;
+        }
+        worker_count++;
+    }
+    return worker_count;
+}
+
+void render_pool_frame(RenderBandFn render, void *arg, RenderFlushFn flush) {
+    double t0 = now_us();
+    double flush_us = 0.0;
+
+    if (worker_count == 0) {
+        // No workers: same bands, rendered inline between flushes
+        for (int band = 0; band < RENDER_BANDS; band++) {
+            double us = render_band(render, arg, band);
+            pthread_mutex_lock(&pool_lock);
+            record_band(band, us);
+            pthread_mutex_unlock(&pool_lock);
+
+            uint16_t y0, y1;
+            band_rows(band, &y0, &y1);
+            double tf = now_us();
+            flush(y0, y1);
+            flush_us += now_us() - tf;
+        }
+    } else {
+        pthread_mutex_lock(&pool_lock);
+        frame_render = render;
+        frame_arg = arg;
+        memset(band_ready, 0, sizeof(band_ready));
+        next_band = 0;
+        frame_seq++;
+        pthread_cond_broadcast(&work_cond);
+
+        for (int band = 0; band < RENDER_BANDS; band++) {
+            while (!band_ready[band]) {
+                pthread_cond_wait(&done_cond, &pool_lock);
+            }
+            pthread_mutex_unlock(&pool_lock);
+
+            uint16_t y0, y1;
+            band_rows(band, &y0, &y1);
+            double tf = now_us();
+            flush(y0, y1);
+            flush_us += now_us() - tf;
+
+            pthread_mutex_lock(&pool_lock);
+        }
+
+        // Nobody may still be looking at this frame's callback and argument
+        while (busy_workers > 0) {
+            pthread_cond_wait(&done_cond, &pool_lock);
+        }
+        pthread_mutex_unlock(&pool_lock);
+    }
+
+    double frame_us = now_us() - t0;
+    pthread_mutex_lock(&pool_lock);
+    stats.frames++;
+    stats.flush_total_us += flush_us;
+    stats.frame_total_us += frame_us;
+    if (frame_us > stats.frame_max_us) stats.frame_max_us = frame_us;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+void render_pool_get_stats(RenderPoolStats *out) {
+    pthread_mutex_lock(&pool_lock);
+    *out = stats;
+    pthread_mutex_unlock(&pool_lock);
+}
+
+void render_pool_print_stats(FILE *out) {
+    RenderPoolStats s;
+    pthread_mutex_lock(&pool_lock);
+    s = stats;
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_unlock(&pool_lock);
+
+    if (s.frames == 0) return;
+
+    fprintf(out, "=== Render: %d thread(s), %d bands, %lu frames ===\n",
+            worker_count, RENDER_BANDS, s.frames);
+    double render_sum = 0.0;
+    for (int band = 0; band < RENDER_BANDS; band++) {
+        uint16_t y0, y1;
+        band_rows(band, &y0, &y1);
+        fprintf(out, "band %d  rows %3u-%3u  avg %7.1f us  max %7.1f us\n",
+                band, y0, y1 - 1, s.band_total_us[band] / s.frames, s.band_max_us[band]);
+        render_sum += s.band_total_us[band];
+    }
+    fprintf(out, "render %.1f us/frame (sum of bands), flush %.1f us/frame\n",
+            render_sum / s.frames, s.flush_total_us / s.frames);
+    fprintf(out, "frame  avg %.1f us  max %.1f us\n",
+            s.frame_total_us / s.frames, s.frame_max_us);
+}
+
+void render_pool_shutdown(void) {
+    pthread_mutex_lock(&pool_lock);
+    stopping = true;
+    pthread_cond_broadcast(&work_cond);
+    pthread_mutex_unlock(&pool_lock);
+
+    for (int i = 0; i < worker_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    worker_count = 0;
+}
@@ -75,8 +75,7 @@ static int configure_serial(int fd) {
     return 0;
 }
 
-// Try to open a specific serial port
-static int try_open_port(const char* port_path) {
+int serial_open_port(const char* port_path) {
     // Check if device exists
     struct stat st;
     if (stat(port_path, &st) != 0) {
@@ -101,13 +100,13 @@ int serial_init(void) {
     int fd;
 
     // Try primary port first
-    fd = try_open_port(SERIAL_PORT_PRIMARY);
+    fd = serial_open_port(SERIAL_PORT_PRIMARY);
     if (fd >= 0) {
         return fd;
     }
 
     // Try fallback port
-    fd = try_open_port(SERIAL_PORT_FALLBACK);
+    fd = serial_open_port(SERIAL_PORT_FALLBACK);
     if (fd >= 0) {
         return fd;
     }
@@ -0,0 +1,387 @@
+/**
+ * Buffered Serial Link Implementation
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include "../include/serial_link.h"
+#include "../include/serial_comm.h"
+
+#define WRITE_TIMEOUT_MS 100
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// Map one memfd twice, back to back: ring[i] and ring[i + SIZE] are the same byte
+static char *ring_map(void) {
+    int fd = memfd_create("serial_link", MFD_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, SERIAL_LINK_RING_SIZE) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    char *base = mmap(NULL, 2 * SERIAL_LINK_RING_SIZE, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+    for (int half = 0; half < 2; half++) {
+        void *at = base + half * SERIAL_LINK_RING_SIZE;
+        if (mmap(at, SERIAL_LINK_RING_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            munmap(base, 2 * SERIAL_LINK_RING_SIZE);
+            close(fd);
+            return NULL;
+        }
+    }
+    close(fd);  // The mappings keep the memory alive
+    return base;
+}
+
+// Kernel uevents (multicast group 1); readable without privileges
+static int hotplug_open(void) {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1;
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool is_candidate(const SerialLink *link, const char *devname) {
+    for (int i = 0; i < link->path_count; i++) {
+        const char *slash = strrchr(link->paths[i], '/');
+        const char *base = slash ? slash + 1 : link->paths[i];
+        if (strcmp(base, devname) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Drain queued uevents; returns +1 if a candidate tty was added, -1 if one
+// was removed (last event wins), 0 otherwise
+static int hotplug_drain(SerialLink *link) {
+    char msg[4096];
+    int result = 0;
+
+    for (;;) {
+        ssize_t n = recv(link->hotplug_fd, msg, sizeof(msg) - 1, 0);
+        if (n <= 0) {
+            break;
+        }
+        msg[n] = '\0';
+
+        // "add@/devices/...\0ACTION=add\0SUBSYSTEM=tty\0DEVNAME=ttyACM0\0..."
+        const char *action = NULL, *subsystem = NULL, *devname = NULL;
+        for (const char *p = msg; p < msg + n; p += strlen(p) + 1) {
+            if (strncmp(p, "ACTION=", 7) == 0) action = p + 7;
+            else if (strncmp(p, "SUBSYSTEM=", 10) == 0) subsystem = p + 10;
+            else if (strncmp(p, "DEVNAME=", 8) == 0) devname = p + 8;
+        }
+        if (!action || !subsystem || !devname || strcmp(subsystem, "tty") != 0 ||
+            !is_candidate(link, devname)) {
+            continue;
+        }
+
+        link->stats.hotplug_events++;
+        if (strcmp(action, "add") == 0) {
+            result = 1;
+        } else if (strcmp(action, "remove") == 0) {
+            result = -1;
+        }
+    }
+    return result;
+}
+
+static bool try_connect(SerialLink *link) {
+    for (int i = 0; i < link->path_count; i++) {
+        int fd = serial_open_port(link->paths[i]);
+        if (fd >= 0) {
+            link->fd = fd;
+            link->device = link->paths[i];
+            link->head = link->tail = 0;
+            link->discarding = false;
+            link->hotplug_tries = 0;
+            link->stats.connects++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Buffered bytes stay readable until the next connect
+static void drop_connection(SerialLink *link) {
+    printf("Serial link lost: %s\n", link->device);
+    close(link->fd);
+    link->fd = -1;
+    link->device = NULL;
+    link->retry_at_us = now_us() + SERIAL_LINK_RETRY_MS * 1000ULL;
+    link->stats.disconnects++;
+}
+
+// Read until the tty is empty or the ring is full; -1 on hangup or error
+static int ring_fill(SerialLink *link) {
+    for (;;) {
+        size_t used = link->head - link->tail;
+        if (used == SERIAL_LINK_RING_SIZE) {
+            // Nobody is consuming: keep the newest data, resync on the next line
+            link->stats.dropped_bytes += used;
+            link->tail = link->head;
+            link->discarding = true;
+            used = 0;
+        }
+
+        // Contiguous thanks to the mirror mapping, even across the wrap
+        size_t room = SERIAL_LINK_RING_SIZE - used;
+        ssize_t n = read(link->fd, link->ring + link->head % SERIAL_LINK_RING_SIZE, room);
+        if (n > 0) {
+            link->head += n;
+            link->stats.bytes += n;
+            link->stats.reads++;
+            if ((size_t)n < room) {
+                return 0;
+            }
+            continue;
+        }
+        if (n == 0) {
+            // VMIN=0 makes an idle tty read 0 as well; only POLLHUP means gone
+            struct pollfd pfd = { .fd = link->fd, .events = POLLIN };
+            if (poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL))) {
+                return -1;
+            }
+            return 0;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+}
+
+int serial_link_init(SerialLink *link, const char *const *paths, int count) {
+    static const char *const default_paths[] = { SERIAL_PORT_PRIMARY, SERIAL_PORT_FALLBACK };
+
+    memset(link, 0, sizeof(*link));
+    link->fd = -1;
+    link->hotplug_fd = -1;
+
+    if (paths == NULL || count <= 0) {
+        paths = default_paths;
+        count = 2;
+    }
+    if (count > SERIAL_LINK_MAX_PATHS) {
+        count = SERIAL_LINK_MAX_PATHS;
+    }
+    for (int i = 0; i < count; i++) {
+        link->paths[i] = paths[i];
+    }
+    link->path_count = count;
+
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0 || SERIAL_LINK_RING_SIZE % page != 0) {
+        fprintf(stderr, "Serial link: ring size %d is not a multiple of the %ld byte page\n",
+                SERIAL_LINK_RING_SIZE, page);
+        return -1;
+    }
+    link->ring = ring_map();
+    if (link->ring == NULL) {
+        perror("Serial link ring");
+        return -1;
+    }
+
+    link->hotplug_fd = hotplug_open();
+    if (link->hotplug_fd < 0) {
+        printf("Serial link: no hotplug events, polling every %d ms\n", SERIAL_LINK_RETRY_MS);
+    }
+
+    if (!try_connect(link)) {
+        link->retry_at_us = now_us() + SERIAL_LINK_RETRY_MS * 1000ULL;
+    }
+    return 0;
+}
+
+void serial_link_close(SerialLink *link) {
+    if (link->fd >= 0) {
+        close(link->fd);
+        link->fd = -1;
+    }
+    if (link->hotplug_fd >= 0) {
+        close(link->hotplug_fd);
+        link->hotplug_fd = -1;
+    }
+    if (link->ring != NULL) {
+        munmap(link->ring, 2 * SERIAL_LINK_RING_SIZE);
+        link->ring = NULL;
+    }
+}
+
+int serial_link_service(SerialLink *link) {
+    int events = 0;
+    uint64_t now = now_us();
+
+    if (link->hotplug_fd >= 0) {
+        int change = hotplug_drain(link);
+        if (change < 0 && link->fd >= 0) {
+            drop_connection(link);
+            events |= SERIAL_LINK_EV_DISCONNECTED;
+        } else if (change > 0 && link->fd < 0) {
+            link->hotplug_tries = SERIAL_LINK_HOTPLUG_TRIES;
+            link->retry_at_us = now;
+        }
+    }
+
+    if (link->fd < 0 && now >= link->retry_at_us) {
+        if (try_connect(link)) {
+            events |= SERIAL_LINK_EV_CONNECTED;
+        } else if (link->hotplug_tries > 0) {
+            link->hotplug_tries--;
+            link->retry_at_us = now + SERIAL_LINK_HOTPLUG_RETRY_MS * 1000ULL;
+        } else {
+            link->retry_at_us = now + SERIAL_LINK_RETRY_MS * 1000ULL;
+        }
+    }
+
+    if (link->fd >= 0) {
+        size_t head = link->head;
+        if (ring_fill(link) < 0) {
+            drop_connection(link);
+            events |= SERIAL_LINK_EV_DISCONNECTED;
+        }
+        if (link->head != head) {
+            events |= SERIAL_LINK_EV_DATA;
+        }
+    }
+    return events;
+}
+
+int serial_link_wait(SerialLink *link, int timeout_ms) {
+    struct pollfd fds[2];
+    int nfds = 0;
+
+    if (link->fd >= 0) {
+        fds[nfds].fd = link->fd;
+        fds[nfds].events = POLLIN;
+        nfds++;
+    } else {
+        // Wake up for the next reconnect attempt
+        uint64_t now = now_us();
+        uint64_t until = link->retry_at_us > now ? (link->retry_at_us - now + 999) / 1000 : 0;
+        if (until < (uint64_t)timeout_ms) {
+            timeout_ms = (int)until;
+        }
+    }
+    if (link->hotplug_fd >= 0) {
+        fds[nfds].fd = link->hotplug_fd;
+        fds[nfds].events = POLLIN;
+        nfds++;
+    }
+
+    if (poll(fds, nfds, timeout_ms) < 0 && errno != EINTR) {
+        perror("poll");
+    }
+    return serial_link_service(link);
+}
+
+const char *serial_link_next_line(SerialLink *link, size_t *len) {
+    while (link->tail != link->head) {
+        char *start = link->ring + link->tail % SERIAL_LINK_RING_SIZE;
+        size_t avail = link->head - link->tail;
+
+        // The line ends at the first \r or \n
+        char *eol = memchr(start, '\n', avail);
+        char *cr = memchr(start, '\r', eol ? (size_t)(eol - start) : avail);
+        if (cr) {
+            eol = cr;
+        }
+
+        if (eol == NULL) {
+            if (link->discarding || avail >= SERIAL_LINK_MAX_LINE) {
+                link->stats.dropped_bytes += avail;
+                link->tail = link->head;
+                link->discarding = true;
+            }
+            return NULL;
+        }
+
+        size_t line_len = eol - start;
+        link->tail += line_len + 1;
+        if (link->discarding || line_len >= SERIAL_LINK_MAX_LINE) {
+            link->stats.dropped_bytes += line_len;
+            link->discarding = false;
+            continue;
+        }
+        if (line_len == 0) {
+            continue;  // Second half of \r\n, or a blank line
+        }
+
+        *eol = '\0';
+        link->stats.lines++;
+        if (len) {
+            *len = line_len;
+        }
+        return start;
+    }
+    return NULL;
+}
+
+const uint8_t *serial_link_peek(const SerialLink *link, size_t *len) {
+    *len = link->head - link->tail;
+    return (const uint8_t *)link->ring + link->tail % SERIAL_LINK_RING_SIZE;
+}
+
+void serial_link_consume(SerialLink *link, size_t n) {
+    size_t avail = link->head - link->tail;
+    link->tail += n < avail ? n : avail;
+}
+
+int serial_link_write(SerialLink *link, const char *data, size_t len) {
+    if (link->fd < 0) {
+        return -1;
+    }
+
+    // A hangup shows up on the next read; here a failure only drops this write
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = write(link->fd, data + done, len - done);
+        if (n > 0) {
+            done += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd = { .fd = link->fd, .events = POLLOUT };
+            if (poll(&pfd, 1, WRITE_TIMEOUT_MS) > 0) {
+                continue;
+            }
+        }
+        return -1;
+    }
+    return (int)len;
+}
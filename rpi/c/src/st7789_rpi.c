@@ -3,9 +3,9 @@
  * Uses Linux spidev and libgpiod
  */
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "../include/stb_image.h"
 #include "../include/st7789_rpi.h"
+#include "../include/image_cache.h"
+#include "../include/lcd_drm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +21,9 @@
 #define DC_PIN  25
 #define BL_PIN  24
 
+// MADCTL at init: landscape (MV=1, MX=1, ML=1, i.e. 0x70) for 320x240, as mounted
+#define MADCTL_LANDSCAPE (MADCTL_MX | MADCTL_MV | MADCTL_ML)
+
 // SPI configuration
 #define SPI_DEVICE   "/dev/spidev0.0"
 #define SPI_SPEED_HZ 40000000  // 40 MHz (stable speed)
@@ -38,6 +41,24 @@ static struct gpiod_line *bl_line = NULL;
 // Framebuffer for double buffering
 static uint16_t *framebuffer = NULL;
 
+static LcdBackend backend = LCD_BACKEND_SPIDEV;
+
+// DRM backend: the panel's RAM window, emulated on the front buffer
+static uint16_t win_x0, win_y0, win_x1, win_y1;
+static uint32_t win_pos;
+
+// Rows the framebuffer primitives may touch, per thread (banded rendering)
+static _Thread_local uint16_t clip_y0 = 0;
+static _Thread_local uint16_t clip_y1 = UINT16_MAX;
+
+// Current orientation's size (lcd_set_orientation)
+static uint16_t lcd_w = LCD_WIDTH;
+static uint16_t lcd_h = LCD_HEIGHT;
+
+static inline uint16_t clip_bottom(void) {
+    return clip_y1 < lcd_h ? clip_y1 : lcd_h;
+}
+
 // Simple 5x7 font
 static const uint8_t font_5x7[][5] = {
     {0x00, 0x00, 0x00, 0x00, 0x00}, // Space (32)
@@ -144,8 +165,31 @@ static void lcd_write_data(uint8_t data) {
     ioctl(spi_fd, SPI_IOC_MESSAGE(1), &tr);
 }
 
+// DRM backend: store wire-order pixels at the window cursor and send them
+static void drm_write_window(const uint8_t* buffer, size_t len) {
+    uint16_t *fb = lcd_drm_front();
+    uint32_t w = win_x1 - win_x0;
+    uint32_t first_row = win_y0 + win_pos / w;
+    uint32_t y = first_row;
+
+    for (size_t i = 0; i + 1 < len; i += 2, win_pos++) {
+        uint32_t x = win_x0 + win_pos % w;
+        y = win_y0 + win_pos / w;
+        if (y >= win_y1) break;
+        fb[y * lcd_w + x] = (uint16_t)(buffer[i] << 8 | buffer[i + 1]);
+    }
+    if (first_row < win_y1) {
+        lcd_drm_dirty(win_x0, first_row, win_x1, y < win_y1 ? y + 1 : win_y1);
+    }
+}
+
 // Write data buffer to LCD
 static void lcd_write_buffer(const uint8_t* buffer, size_t len) {
+    if (backend == LCD_BACKEND_DRM) {
+        drm_write_window(buffer, len);
+        return;
+    }
+
     gpio_set(dc_line, 1);  // Data mode
 
     const size_t CHUNK_SIZE = 4096;
@@ -168,6 +212,15 @@ static void lcd_write_buffer(const uint8_t* buffer, size_t len) {
 
 // Set address window
 static void lcd_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    if (backend == LCD_BACKEND_DRM) {
+        win_x0 = x0;
+        win_y0 = y0;
+        win_x1 = x1;
+        win_y1 = y1;
+        win_pos = 0;
+        return;
+    }
+
     lcd_write_cmd(0x2A);  // Column address set
     lcd_write_data(x0 >> 8);
     lcd_write_data(x0 & 0xFF);
@@ -183,7 +236,7 @@ static void lcd_set_window(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
     lcd_write_cmd(0x2C);  // Memory write
 }
 
-int lcd_init(void) {
+static int spidev_init(void) {
     // Initialize SPI
     spi_fd = open(SPI_DEVICE, O_RDWR);
     if (spi_fd < 0) {
@@ -247,7 +300,9 @@ int lcd_init(void) {
     lcd_write_data(0x55); // 16-bit RGB565
 
     lcd_write_cmd(0x36);  // Memory data access control
-    lcd_write_data(0x70); // Landscape mode (MV=1, MX=1, MY=1) for 320x240
+    lcd_write_data(MADCTL_LANDSCAPE);
+    lcd_w = LCD_WIDTH;
+    lcd_h = LCD_HEIGHT;
 
     lcd_write_cmd(0x2A);  // Column address set
     lcd_write_data(0x00);
@@ -283,7 +338,67 @@ int lcd_init(void) {
     return 0;
 }
 
+int lcd_init_backend(LcdBackend which) {
+    if (which == LCD_BACKEND_DRM) {
+        if (lcd_drm_open(getenv("PILOT_DRM_CARD"), LCD_WIDTH, LCD_HEIGHT) < 0) {
+            return -1;
+        }
+        backend = LCD_BACKEND_DRM;
+        framebuffer = lcd_drm_back();
+        return 0;
+    }
+
+    backend = LCD_BACKEND_SPIDEV;
+    return spidev_init();
+}
+
+int lcd_init(void) {
+    const char *which = getenv("PILOT_LCD_BACKEND");
+    if (which && strcmp(which, "drm") == 0) {
+        if (lcd_init_backend(LCD_BACKEND_DRM) == 0) {
+            return 0;
+        }
+        fprintf(stderr, "DRM display not available, falling back to spidev\n");
+    }
+    return lcd_init_backend(LCD_BACKEND_SPIDEV);
+}
+
+LcdBackend lcd_get_backend(void) {
+    return backend;
+}
+
+int lcd_set_orientation(LcdRotation rotation, uint8_t mirror) {
+    if (backend == LCD_BACKEND_DRM) {
+        // Fixed by the kernel driver (overlay rotation)
+        return (rotation == LCD_ROTATE_0 && mirror == LCD_MIRROR_NONE) ? 0 : -1;
+    }
+    if (spi_fd < 0) return -1;
+
+    bool portrait = lcd_orientation_is_portrait(rotation);
+    lcd_w = portrait ? LCD_HEIGHT : LCD_WIDTH;
+    lcd_h = portrait ? LCD_WIDTH : LCD_HEIGHT;
+
+    lcd_write_cmd(0x36);  // Memory data access control
+    lcd_write_data(lcd_orientation_madctl(MADCTL_LANDSCAPE, rotation, mirror));
+    lcd_set_window(0, 0, lcd_w, lcd_h);  // CASET/RASET for the new shape
+    return 0;
+}
+
+uint16_t lcd_width(void) {
+    return lcd_w;
+}
+
+uint16_t lcd_height(void) {
+    return lcd_h;
+}
+
 void lcd_cleanup(void) {
+    if (backend == LCD_BACKEND_DRM) {
+        lcd_drm_close();
+        framebuffer = NULL;
+        return;
+    }
+
     // Free framebuffer
     if (framebuffer) {
         free(framebuffer);
@@ -301,26 +416,36 @@ void lcd_cleanup(void) {
 }
 
 void lcd_clear(uint16_t color) {
-    lcd_fill_rect(0, 0, LCD_WIDTH, LCD_HEIGHT, color);
+    lcd_fill_rect(0, 0, lcd_w, lcd_h, color);
 }
 
 void lcd_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
-    if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
-    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
-    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    if (x >= lcd_w || y >= lcd_h) return;
+    if (x + w > lcd_w) w = lcd_w - x;
+    if (y + h > lcd_h) h = lcd_h - y;
 
     lcd_set_window(x, y, x + w, y + h);
 
-    uint8_t color_bytes[2] = {color >> 8, color & 0xFF};
+    // One repeated chunk instead of a transfer per pixel
+    const size_t CHUNK_PIXELS = 2048;
+    uint8_t buffer[CHUNK_PIXELS * 2];
     uint32_t total_pixels = (uint32_t)w * h;
+    uint32_t fill = total_pixels < CHUNK_PIXELS ? total_pixels : CHUNK_PIXELS;
+    for (uint32_t i = 0; i < fill; i++) {
+        buffer[i * 2] = color >> 8;
+        buffer[i * 2 + 1] = color & 0xFF;
+    }
 
-    for (uint32_t i = 0; i < total_pixels; i++) {
-        lcd_write_buffer(color_bytes, 2);
+    uint32_t pixels_sent = 0;
+    while (pixels_sent < total_pixels) {
+        uint32_t chunk_pixels = (total_pixels - pixels_sent) > fill ? fill : (total_pixels - pixels_sent);
+        lcd_write_buffer(buffer, chunk_pixels * 2);
+        pixels_sent += chunk_pixels;
     }
 }
 
 void lcd_draw_pixel(uint16_t x, uint16_t y, uint16_t color) {
-    if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
+    if (x >= lcd_w || y >= lcd_h) return;
 
     lcd_set_window(x, y, x + 1, y + 1);
     uint8_t color_bytes[2] = {color >> 8, color & 0xFF};
@@ -440,15 +565,10 @@ void lcd_draw_string_scaled(uint16_t x, uint16_t y, const char* str, uint16_t co
     }
 }
 
-// Convert RGB888 to RGB565
-static inline uint16_t rgb888_to_rgb565(uint8_t r, uint8_t g, uint8_t b) {
-    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
-}
-
 void lcd_draw_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t* image_data) {
-    if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
-    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
-    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    if (x >= lcd_w || y >= lcd_h) return;
+    if (x + w > lcd_w) w = lcd_w - x;
+    if (y + h > lcd_h) h = lcd_h - y;
 
     lcd_set_window(x, y, x + w, y + h);
 
@@ -474,61 +594,33 @@ void lcd_draw_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16
     }
 }
 
-int lcd_display_png(const char* filename) {
-    int width, height, channels;
+void lcd_draw_image_wire(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* pixels) {
+    if (x >= lcd_w || y >= lcd_h) return;
+    uint16_t src_w = w;
+    if (x + w > lcd_w) w = lcd_w - x;
+    if (y + h > lcd_h) h = lcd_h - y;
 
-    // Load the image
-    unsigned char* img = stbi_load(filename, &width, &height, &channels, 3);
-    if (!img) {
-        fprintf(stderr, "Failed to load image: %s\n", filename);
-        return -1;
+    lcd_set_window(x, y, x + w, y + h);
+    if (w == src_w) {
+        // Already in wire order: straight from the buffer to SPI
+        lcd_write_buffer(pixels, (size_t)w * h * 2);
+    } else {
+        for (uint16_t row = 0; row < h; row++) {
+            lcd_write_buffer(pixels + (size_t)row * src_w * 2, (size_t)w * 2);
+        }
     }
+}
 
-    printf("Loaded image: %dx%d, channels=%d\n", width, height, channels);
-
-    // Scale/center the image to fit the display
-    uint16_t display_w = width > LCD_WIDTH ? LCD_WIDTH : width;
-    uint16_t display_h = height > LCD_HEIGHT ? LCD_HEIGHT : height;
-    uint16_t offset_x = (LCD_WIDTH - display_w) / 2;
-    uint16_t offset_y = (LCD_HEIGHT - display_h) / 2;
-
-    // Allocate buffer for RGB565 data
-    uint16_t* rgb565_buffer = (uint16_t*)malloc(display_w * display_h * sizeof(uint16_t));
-    if (!rgb565_buffer) {
-        stbi_image_free(img);
+int lcd_display_png(const char* filename) {
+    CachedImage img;
+    if (image_cache_load(&img, filename, lcd_w, lcd_h, IMAGE_CONVERT_CYAN) < 0) {
         return -1;
     }
 
-    // Convert RGB888 to RGB565 with cyan tint
-    for (int dy = 0; dy < display_h; dy++) {
-        for (int dx = 0; dx < display_w; dx++) {
-            int src_y = (dy * height) / display_h;
-            int src_x = (dx * width) / display_w;
-            int src_idx = (src_y * width + src_x) * 3;
-
-            uint8_t r = img[src_idx];
-            uint8_t g = img[src_idx + 1];
-            uint8_t b = img[src_idx + 2];
-
-            // Convert to grayscale
-            uint8_t gray = (r * 30 + g * 59 + b * 11) / 100;
-
-            // Apply cyan tint (0 red, full green and blue)
-            uint8_t cyan_r = 0;
-            uint8_t cyan_g = gray;
-            uint8_t cyan_b = gray;
-
-            rgb565_buffer[dy * display_w + dx] = rgb888_to_rgb565(cyan_r, cyan_g, cyan_b);
-        }
-    }
-
-    // Display the image
-    lcd_draw_image(offset_x, offset_y, display_w, display_h, rgb565_buffer);
-
-    // Cleanup
-    free(rgb565_buffer);
-    stbi_image_free(img);
-
+    // Center the image on the display
+    lcd_draw_image_wire((lcd_w - img.width) / 2, (lcd_h - img.height) / 2,
+                        img.width, img.height, img.pixels);
+    image_cache_release(&img);
     return 0;
 }
 
@@ -540,16 +632,37 @@ uint16_t* lcd_get_framebuffer(void) {
     return framebuffer;
 }
 
+const uint16_t* lcd_get_displayed_framebuffer(void) {
+    return backend == LCD_BACKEND_DRM ? lcd_drm_front() : framebuffer;
+}
+
 void lcd_display_framebuffer(void) {
+    lcd_display_framebuffer_rows(0, lcd_h);
+}
+
+void lcd_display_framebuffer_rows(uint16_t y0, uint16_t y1) {
     if (!framebuffer) return;
+    if (y1 > lcd_h) y1 = lcd_h;
+    if (y0 >= y1) return;
+
+    // DRM: the whole frame is flipped once its bottom rows are done and
+    // the kernel sends it; drawing continues in a buffer that is neither
+    // on screen nor waiting to be
+    if (backend == LCD_BACKEND_DRM) {
+        if (y1 == lcd_h) {
+            lcd_drm_flip();
+            framebuffer = lcd_drm_back();
+        }
+        return;
+    }
 
-    // Set window to full screen
-    lcd_set_window(0, 0, LCD_WIDTH, LCD_HEIGHT);
+    // Set window to the rows being sent
+    lcd_set_window(0, y0, lcd_w, y1);
 
     // Optimized: Use larger chunks and loop unrolling for conversion
     const size_t CHUNK_PIXELS = 16384;  // 32KB chunks (16384 pixels * 2 bytes)
     uint8_t buffer[CHUNK_PIXELS * 2];
-    uint32_t total_pixels = LCD_WIDTH * LCD_HEIGHT;
+    uint32_t total_pixels = (uint32_t)lcd_w * (y1 - y0);
     uint32_t pixels_sent = 0;
 
     while (pixels_sent < total_pixels) {
@@ -557,7 +670,7 @@ void lcd_display_framebuffer(void) {
                                 CHUNK_PIXELS : (total_pixels - pixels_sent);
 
         // Fast conversion using pointer arithmetic and loop unrolling
-        uint16_t *src = framebuffer + pixels_sent;
+        uint16_t *src = framebuffer + y0 * lcd_w + pixels_sent;
         uint8_t *dst = buffer;
 
         // Process 4 pixels at a time for better CPU cache usage
@@ -594,17 +707,23 @@ void lcd_display_framebuffer(void) {
     }
 }
 
+void lcd_fb_set_clip_rows(uint16_t y0, uint16_t y1) {
+    clip_y0 = y0;
+    clip_y1 = y1 > lcd_h ? lcd_h : y1;
+}
+
 void lcd_fb_clear(uint16_t color) {
-    if (!framebuffer) return;
+    if (!framebuffer || clip_y0 >= clip_bottom()) return;
 
-    // Fast clear using optimized approach
+    // Fast clear using optimized approach (clip rows only)
     if (color == 0x0000) {
         // Black - use memset (fastest)
-        memset(framebuffer, 0, LCD_WIDTH * LCD_HEIGHT * sizeof(uint16_t));
+        memset(framebuffer + clip_y0 * lcd_w, 0,
+               (size_t)lcd_w * (clip_bottom() - clip_y0) * sizeof(uint16_t));
     } else {
         // Other colors - use optimized loop with unrolling
-        uint32_t total = LCD_WIDTH * LCD_HEIGHT;
-        uint16_t *fb = framebuffer;
+        uint32_t total = (uint32_t)lcd_w * (clip_bottom() - clip_y0);
+        uint16_t *fb = framebuffer + clip_y0 * lcd_w;
 
         // Process 8 pixels at a time
         uint32_t i;
@@ -628,21 +747,26 @@ void lcd_fb_clear(uint16_t color) {
 }
 
 void lcd_fb_draw_pixel(uint16_t x, uint16_t y, uint16_t color) {
-    if (!framebuffer || x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
-    framebuffer[y * LCD_WIDTH + x] = color;
+    if (!framebuffer || x >= lcd_w || y < clip_y0 || y >= clip_bottom()) return;
+    framebuffer[y * lcd_w + x] = color;
 }
 
 void lcd_fb_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color) {
     if (!framebuffer) return;
-    if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
-
-    // Clip to screen bounds
-    if (x + w > LCD_WIDTH) w = LCD_WIDTH - x;
-    if (y + h > LCD_HEIGHT) h = LCD_HEIGHT - y;
+    if (x >= lcd_w || y >= clip_bottom()) return;
+
+    // Clip to screen bounds and the clip rows
+    if (x + w > lcd_w) w = lcd_w - x;
+    if (y + h > clip_bottom()) h = clip_bottom() - y;
+    if (y < clip_y0) {
+        if (y + h <= clip_y0) return;
+        h -= clip_y0 - y;
+        y = clip_y0;
+    }
 
     // Optimized: fill row by row with pointer arithmetic
     for (uint16_t dy = 0; dy < h; dy++) {
-        uint16_t *row = framebuffer + (y + dy) * LCD_WIDTH + x;
+        uint16_t *row = framebuffer + (y + dy) * lcd_w + x;
 
         // Fill row using unrolled loop for speed
         uint16_t dx;
@@ -668,6 +792,10 @@ void lcd_fb_fill_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t c
 void lcd_fb_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
     if (!framebuffer) return;
 
+    // Rows are walked monotonically, so a line entirely above or below the
+    // clip rows never touches them
+    if ((y0 < clip_y0 && y1 < clip_y0) || (y0 >= clip_bottom() && y1 >= clip_bottom())) return;
+
     // Bresenham's line algorithm
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
@@ -694,6 +822,7 @@ void lcd_fb_draw_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16
 
 void lcd_fb_draw_string(uint16_t x, uint16_t y, const char* str, uint16_t color, uint16_t bg_color) {
     if (!framebuffer || !str) return;
+    if (y >= clip_bottom() || y + 8 <= clip_y0) return;
 
     while (*str) {
         // Draw character background
@@ -720,3 +849,29 @@ void lcd_fb_draw_string(uint16_t x, uint16_t y, const char* str, uint16_t color,
         str++;
     }
 }
+
+void lcd_fb_draw_image_wire(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* pixels) {
+    if (!framebuffer) return;
+    if (x >= lcd_w || y >= clip_bottom()) return;
+
+    // Clip to screen bounds and the clip rows
+    uint16_t src_w = w;
+    if (x + w > lcd_w) w = lcd_w - x;
+    if (y + h > clip_bottom()) h = clip_bottom() - y;
+    if (y < clip_y0) {
+        if (y + h <= clip_y0) return;
+        pixels += (size_t)(clip_y0 - y) * src_w * 2;
+        h -= clip_y0 - y;
+        y = clip_y0;
+    }
+
+    // Wire order is big-endian; the framebuffer holds native pixels
+    for (uint16_t dy = 0; dy < h; dy++) {
+        const uint8_t *src = pixels + (size_t)dy * src_w * 2;
+        uint16_t *row = framebuffer + (y + dy) * lcd_w + x;
+        for (uint16_t dx = 0; dx < w; dx++) {
+            row[dx] = (uint16_t)(src[0] << 8 | src[1]);
+            src += 2;
+        }
+    }
+}
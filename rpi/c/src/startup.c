@@ -0,0 +1,119 @@
+/**
+ * Startup Tasks and Timeline Implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include <time.h>
+#include "../include/startup.h"
+#include "../include/trace.h"
+
+#define MAX_STAGES 32
+
+typedef struct {
+    const char *stage;
+    const char *task;       // Task name for "start"/"done" entries, else NULL
+    double t_ms;
+} StageEntry;
+
+static StageEntry stages[MAX_STAGES];
+static int stage_count = 0;
+static pthread_mutex_t stage_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct timespec t0;
+
+static double elapsed_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec - t0.tv_sec) * 1000.0 + (ts.tv_nsec - t0.tv_nsec) / 1e6;
+}
+
+static void add_entry(const char *stage, const char *task) {
+    double t = elapsed_ms();
+    pthread_mutex_lock(&stage_lock);
+    if (stage_count < MAX_STAGES) {
+        stages[stage_count].stage = stage;
+        stages[stage_count].task = task;
+        stages[stage_count].t_ms = t;
+        stage_count++;
+    }
+    pthread_mutex_unlock(&stage_lock);
+}
+
+void startup_timeline_init(void) {
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    stage_count = 0;
+}
+
+void startup_mark(const char *stage) {
+    add_entry(stage, NULL);
+}
+
+static void *task_thread(void *arg) {
+    StartupTask *task = arg;
+    add_entry("start", task->name);
+    trace_thread_name(task->name);
+    TRACE_BEGIN(task->name);
+    task->result = task->fn(task->arg);
+    TRACE_END(task->name);
+    add_entry("done", task->name);
+    atomic_store(&task->done, true);
+    return NULL;
+}
+
+void startup_task_start(StartupTask *task, const char *name, StartupFn fn, void *arg) {
+    memset(task, 0, sizeof(*task));
+    task->name = name;
+    task->fn = fn;
+    task->arg = arg;
+    atomic_init(&task->done, false);
+
+    if (pthread_create(&task->thread, NULL, task_thread, task) == 0) {
+        task->started = true;
+    } else {
+        perror("pthread_create");
+        task_thread(task);
+        task->joined = true;
+    }
+}
+
+bool startup_task_done(StartupTask *task) {
+    return atomic_load(&task->done);
+}
+
+int startup_task_wait(StartupTask *task) {
+    if (task->started && !task->joined) {
+        pthread_join(task->thread, NULL);
+        task->joined = true;
+    }
+    return task->result;
+}
+
+void startup_timeline_print(FILE *out) {
+    StageEntry copy[MAX_STAGES];
+    int n;
+
+    pthread_mutex_lock(&stage_lock);
+    n = stage_count;
+    memcpy(copy, stages, n * sizeof(StageEntry));
+    pthread_mutex_unlock(&stage_lock);
+
+    // Entries from different threads can land slightly out of order
+    for (int i = 1; i < n; i++) {
+        StageEntry e = copy[i];
+        int j = i - 1;
+        while (j >= 0 && copy[j].t_ms > e.t_ms) {
+            copy[j + 1] = copy[j];
+            j--;
+        }
+        copy[j + 1] = e;
+    }
+
+    fprintf(out, "=== Startup timeline ===\n");
+    for (int i = 0; i < n; i++) {
+        if (copy[i].task) {
+            fprintf(out, "%8.1f ms  %-12s %s\n", copy[i].t_ms, copy[i].task, copy[i].stage);
+        } else {
+            fprintf(out, "%8.1f ms  %s\n", copy[i].t_ms, copy[i].stage);
+        }
+    }
+}
@@ -0,0 +1,303 @@
+/**
+ * Event Tracing Implementation
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include "../include/trace.h"
+
+#define RING_MASK (TRACE_RING_EVENTS - 1)
+#define TRACE_PID 1
+
+typedef struct {
+    uint64_t t_ns;
+    const char *name;
+    double value;
+    char phase;
+} TraceEvent;
+
+typedef struct {
+    _Alignas(64) atomic_uint_least64_t head;    // Events ever written (owner only)
+    _Atomic(const char *) thread_name;
+    int tid;
+    uint64_t streamed;                          // Stream cursor (writer only)
+    const char *named_as;                       // Name last written to the stream
+    TraceEvent events[TRACE_RING_EVENTS];
+} TraceRing;
+
+volatile bool trace_active = false;
+
+static TraceRing *rings[TRACE_MAX_THREADS];
+static atomic_int ring_count = 0;
+static pthread_mutex_t register_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local TraceRing *my_ring = NULL;
+static _Thread_local const char *my_name = NULL;   // Named before the ring exists
+
+static uint64_t start_ns = 0;
+static pthread_t writer_thread;
+static bool writer_running = false;
+static atomic_bool writer_stop = false;
+static volatile sig_atomic_t dump_requested = 0;
+static pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+static TraceEvent scratch[TRACE_RING_EVENTS];          // Under output_lock
+
+static FILE *stream = NULL;
+static uint64_t stream_events = 0;
+static uint64_t stream_lost = 0;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static TraceRing *ring_for_thread(void) {
+    if (my_ring) {
+        return my_ring;
+    }
+
+    pthread_mutex_lock(&register_lock);
+    int count = atomic_load(&ring_count);
+    TraceRing *ring = NULL;
+    if (count < TRACE_MAX_THREADS) {
+        ring = calloc(1, sizeof(TraceRing));
+        if (ring) {
+            ring->tid = count + 1;
+            atomic_store(&ring->thread_name, my_name);
+            rings[count] = ring;
+            atomic_store_explicit(&ring_count, count + 1, memory_order_release);
+        }
+    }
+    pthread_mutex_unlock(&register_lock);
+
+    my_ring = ring;
+    return ring;
+}
+
+void trace_event(char phase, const char *name, double value) {
+    TraceRing *ring = ring_for_thread();
+    if (!ring) {
+        return;
+    }
+    uint64_t i = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    TraceEvent *e = &ring->events[i & RING_MASK];
+    e->t_ns = now_ns();
+    e->name = name;
+    e->value = value;
+    e->phase = phase;
+    atomic_store_explicit(&ring->head, i + 1, memory_order_release);
+}
+
+void trace_thread_name(const char *name) {
+    my_name = name;
+    if (my_ring) {
+        atomic_store(&my_ring->thread_name, name);
+    }
+}
+
+// ── Export ────────────────────────────────────────────────────────────────────
+
+/**
+ * Copy the events of a ring from index `from` on into scratch. The owner
+ * keeps writing meanwhile, so whatever it may have overwritten during the
+ * copy is discarded. Returns the count; *first is the index of scratch[0].
+ */
+static int copy_ring(TraceRing *ring, uint64_t from, uint64_t *first, uint64_t *lost) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t start = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0;
+    if (from > start) start = from;
+
+    for (uint64_t i = start; i < head; i++) {
+        scratch[i - start] = ring->events[i & RING_MASK];
+    }
+
+    // Slot of index i is reused by index i + N, which may be half-written
+    uint64_t head_after = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t valid = head_after >= TRACE_RING_EVENTS ? head_after - TRACE_RING_EVENTS + 1 : 0;
+    uint64_t skip = valid > start ? valid - start : 0;
+    if (skip > head - start) skip = head - start;
+    if (skip > 0) {
+        memmove(scratch, scratch + skip, (head - start - skip) * sizeof(TraceEvent));
+    }
+
+    *lost = (start > from ? start - from : 0) + skip;
+    *first = start + skip;
+    return (int)(head - start - skip);
+}
+
+static void write_event(FILE *out, const TraceEvent *e, int tid) {
+    double ts = (double)(int64_t)(e->t_ns - start_ns) / 1000.0;
+    switch (e->phase) {
+    case 'C':
+        fprintf(out, "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"value\":%g}}",
+                e->name, ts, TRACE_PID, tid, e->value);
+        break;
+    case 'i':
+        fprintf(out, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                e->name, ts, TRACE_PID, tid);
+        break;
+    default:
+        fprintf(out, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}",
+                e->name, e->phase, ts, TRACE_PID, tid);
+        break;
+    }
+}
+
+static void write_thread_name(FILE *out, const TraceRing *ring, const char *name) {
+    fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            TRACE_PID, ring->tid, name);
+}
+
+static void write_process_name(FILE *out) {
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"pilot_assistant\"}}",
+            TRACE_PID);
+}
+
+int trace_dump(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror(path);
+        return -1;
+    }
+
+    pthread_mutex_lock(&output_lock);
+    fputs("[\n", out);
+    write_process_name(out);
+
+    int total = 0;
+    int count = atomic_load_explicit(&ring_count, memory_order_acquire);
+    for (int r = 0; r < count; r++) {
+        const char *name = atomic_load(&rings[r]->thread_name);
+        if (name) {
+            fputs(",\n", out);
+            write_thread_name(out, rings[r], name);
+        }
+        uint64_t first, lost;
+        int n = copy_ring(rings[r], 0, &first, &lost);
+        for (int i = 0; i < n; i++) {
+            fputs(",\n", out);
+            write_event(out, &scratch[i], rings[r]->tid);
+        }
+        total += n;
+    }
+    fputs("\n]\n", out);
+    pthread_mutex_unlock(&output_lock);
+
+    fclose(out);
+    return total;
+}
+
+// Append what was recorded since the last call; caller holds output_lock
+static void stream_new_events(void) {
+    int count = atomic_load_explicit(&ring_count, memory_order_acquire);
+    for (int r = 0; r < count; r++) {
+        TraceRing *ring = rings[r];
+        const char *name = atomic_load(&ring->thread_name);
+        if (name && name != ring->named_as) {
+            write_thread_name(stream, ring, name);
+            fputs(",\n", stream);
+            ring->named_as = name;
+        }
+
+        uint64_t first, lost;
+        int n = copy_ring(ring, ring->streamed, &first, &lost);
+        for (int i = 0; i < n; i++) {
+            write_event(stream, &scratch[i], ring->tid);
+            fputs(",\n", stream);
+        }
+        ring->streamed = first + n;
+        stream_events += n;
+        stream_lost += lost;
+    }
+    fflush(stream);
+}
+
+static void *writer_main(void *unused) {
+    (void)unused;
+    struct timespec interval = { 0, TRACE_STREAM_MS * 1000000L };
+    int dumps = 0;
+
+    trace_thread_name("trace writer");
+    while (!atomic_load(&writer_stop)) {
+        nanosleep(&interval, NULL);
+
+        if (dump_requested) {
+            dump_requested = 0;
+            char path[128];
+            snprintf(path, sizeof(path), "%s/pilot_trace_%ld_%d.json",
+                     TRACE_DUMP_DIR, (long)time(NULL), dumps++);
+            int n = trace_dump(path);
+            if (n >= 0) {
+                printf("Trace: %d events written to %s\n", n, path);
+            }
+        }
+
+        if (stream) {
+            pthread_mutex_lock(&output_lock);
+            stream_new_events();
+            pthread_mutex_unlock(&output_lock);
+        }
+    }
+    return NULL;
+}
+
+int trace_init(const char *stream_path) {
+    start_ns = now_ns();
+
+    if (stream_path) {
+        stream = fopen(stream_path, "w");
+        if (!stream) {
+            perror(stream_path);
+            return -1;
+        }
+        fputs("[\n", stream);
+        write_process_name(stream);
+        fputs(",\n", stream);
+    }
+
+    atomic_store(&writer_stop, false);
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0) {
+        perror("trace writer thread");
+        if (stream) {
+            fclose(stream);
+            stream = NULL;
+        }
+        return -1;
+    }
+    writer_running = true;
+    trace_active = true;
+    return 0;
+}
+
+void trace_shutdown(void) {
+    if (!writer_running) {
+        return;
+    }
+    trace_active = false;
+    atomic_store(&writer_stop, true);
+    pthread_join(writer_thread, NULL);
+    writer_running = false;
+
+    if (stream) {
+        pthread_mutex_lock(&output_lock);
+        stream_new_events();
+        // Close the array with an element so no trailing comma is left
+        fprintf(stream, "{\"name\":\"trace_end\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":%d,\"tid\":0}\n]\n",
+                (double)(now_ns() - start_ns) / 1000.0, TRACE_PID);
+        pthread_mutex_unlock(&output_lock);
+        fclose(stream);
+        stream = NULL;
+        printf("Trace: %llu events streamed, %llu lost to ring overrun\n",
+               (unsigned long long)stream_events, (unsigned long long)stream_lost);
+    }
+}
+
+void trace_request_dump(void) {
+    dump_requested = 1;
+}